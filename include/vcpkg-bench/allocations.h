@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+
+namespace vcpkg::Bench
+{
+    struct AllocationStats
+    {
+        // the most heap memory in use at once, beyond what was in use when measurement began
+        size_t peak_bytes = 0;
+        size_t allocation_count = 0;
+
+        std::string to_string() const;
+    };
+
+    // Measures the heap use of the whole process while it is alive, which vcpkg-bench tracks by replacing the global
+    // operator new and delete. Scopes must not overlap.
+    struct AllocationScope
+    {
+        AllocationScope();
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator=(const AllocationScope&) = delete;
+
+        AllocationStats stats() const;
+
+    private:
+        size_t m_start_bytes;
+        size_t m_start_count;
+    };
+}
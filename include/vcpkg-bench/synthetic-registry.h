@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vcpkg/base/fwd/files.h>
+
+#include <vcpkg/base/stringview.h>
+
+#include <vcpkg/packagespec.h>
+#include <vcpkg/portfileprovider.h>
+#include <vcpkg/sourceparagraph.h>
+#include <vcpkg/statusparagraphs.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vcpkg::Bench
+{
+    struct SyntheticRegistryOptions
+    {
+        int port_count = 2000;
+        // the number of distinct earlier ports each port depends on, where that many exist
+        int fan_out = 4;
+        // the percentage of ports with an optional feature, which depends on the feature of an earlier port
+        int feature_density = 30;
+        // the number of versions of each port; the baseline is the oldest, and some dependencies require newer ones
+        int version_depth = 3;
+        // the number of ports the top-level manifest pins to their newest version
+        int override_count = 50;
+
+        // Reads overrides of the defaults from a comma separated list like "ports=5000,fan-out=6", exiting with an
+        // error on unknown keys or invalid values.
+        static SyntheticRegistryOptions parse(StringView text);
+
+        // Parses VCPKG_BENCHMARK_REGISTRY if it is set, otherwise returns the defaults.
+        static SyntheticRegistryOptions from_environment();
+
+        std::string to_string() const;
+    };
+
+    // A deterministic, generated registry of ports named port-0 through port-N, where each port only depends on
+    // ports with smaller numbers. It serves as both the versioned registry and the classic ports tree.
+    struct SyntheticRegistry final : IBaselineProvider, IVersionedPortfileProvider
+    {
+        explicit SyntheticRegistry(const SyntheticRegistryOptions& options);
+
+        static std::string port_name(int idx);
+
+        ExpectedL<Version> get_baseline_version(StringView port_name) const override;
+        ExpectedL<const SourceControlFileAndLocation&> get_control_file(const VersionSpec& version_spec) const override;
+
+        // The newest version of every port, in the form MapPortFileProvider consumes
+        const std::unordered_map<std::string, SourceControlFileAndLocation>& latest_ports() const noexcept
+        {
+            return m_latest;
+        }
+
+        // A dependency on every port, which resolves the whole registry
+        std::vector<Dependency> all_dependencies() const;
+        std::vector<FullPackageSpec> all_specs(Triplet triplet) const;
+        const std::vector<DependencyOverride>& overrides() const noexcept { return m_overrides; }
+
+        // Status paragraphs for the newest version of every port and its default features, as if all were installed
+        StatusParagraphs installed_status(Triplet triplet) const;
+
+        const SyntheticRegistryOptions& options() const noexcept { return m_options; }
+
+    private:
+        SyntheticRegistryOptions m_options;
+        std::map<std::string, std::map<Version, SourceControlFileAndLocation, VersionMapLess>, std::less<>> m_versions;
+        std::unordered_map<std::string, SourceControlFileAndLocation> m_latest;
+        std::vector<DependencyOverride> m_overrides;
+    };
+
+    struct NoOverlays final : IOverlayProvider
+    {
+        Optional<const SourceControlFileAndLocation&> get_control_file(StringView) const override { return nullopt; }
+    };
+}
@@ -61,6 +61,13 @@ namespace vcpkg
 
         Command decompress_zip_archive_cmd(const Path& dst, const Path& archive_path) const;
 
+        // Extracts the package in `archive_path` over the top of `dst`, overwriting existing files and skipping the
+        // package metadata files which are not installed (CONTROL, BUILD_INFO, and vcpkg.json)
+        Command decompress_zip_archive_into_installed_cmd(const Path& dst, const Path& archive_path) const;
+
+        // Extracts only the top level file `entry` of `archive_path` into `dst`
+        Command decompress_zip_archive_entry_cmd(const Path& dst, const Path& archive_path, StringView entry) const;
+
     private:
 #if defined _WIN32
         Optional<Path> seven_zip;
@@ -68,4 +75,8 @@ namespace vcpkg
     };
 
     std::vector<ExpectedL<Unit>> decompress_in_parallel(View<Command> jobs);
+
+    // Returns the names of the entries recorded in the central directory of the zip archive `archive`, in the order
+    // they appear there, without extracting anything. Directory entries end with '/'.
+    ExpectedL<std::vector<std::string>> list_zip_archive_entries(const ReadOnlyFilesystem& fs, const Path& archive);
 }
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vcpkg/base/fwd/files.h>
+#include <vcpkg/base/fwd/span.h>
+
+#include <vcpkg/base/path.h>
+#include <vcpkg/base/stringview.h>
+
+#include <string.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace vcpkg
+{
+    // Encodes values for the binary caches vcpkg keeps between runs. Scalars are stored in native byte order, so the
+    // results are only meaningful on the kind of machine that wrote them; strings are a u32 length then their bytes.
+    struct BinaryWriter
+    {
+        template<class T>
+        void write_scalar(T value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only scalars can be written directly");
+            char bytes[sizeof(T)];
+            ::memcpy(bytes, &value, sizeof(T));
+            buffer.append(bytes, sizeof(T));
+        }
+
+        void write_string(StringView value);
+
+        std::string buffer;
+    };
+
+    // Decodes values written by BinaryWriter. Each read returns false, rather than reading past `last`, if the input
+    // is truncated.
+    struct BinaryReader
+    {
+        BinaryReader(const char* first, const char* last) noexcept : first(first), last(last) { }
+        explicit BinaryReader(StringView data) noexcept : first(data.begin()), last(data.end()) { }
+
+        template<class T>
+        bool read_scalar(T& value) noexcept
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only scalars can be read directly");
+            if (static_cast<std::size_t>(last - first) < sizeof(T))
+            {
+                return false;
+            }
+
+            ::memcpy(&value, first, sizeof(T));
+            first += sizeof(T);
+            return true;
+        }
+
+        bool read_string(std::string& value);
+        bool read_string(StringView& value) noexcept;
+
+        bool empty() const noexcept { return first == last; }
+
+        const char* first;
+        const char* last;
+    };
+
+    // A file of keyed binary records, each superseding any earlier record with the same key. Records are added by
+    // appending to the file, so a cache built up over a run needs no separate save step and concurrent vcpkg
+    // processes don't overwrite each other's work; appends and rewrites hold a lock on `path`.lock. The file starts
+    // with `header`, which must change whenever the record payloads change meaning. All failures are only reported
+    // with Debug::print, since the file is a cache.
+    struct BinaryRecordFile
+    {
+        // If `max_records` is nonzero and the file holds more records than that, load() rewrites it keeping only the
+        // most recently appended ones.
+        BinaryRecordFile(const Filesystem& fs, const Path& path, StringView header, std::size_t max_records = 0);
+
+        // Reads the latest record for each key. If the file is damaged, was written with a different header, is
+        // mostly superseded records, or holds too many records, it is rewritten with only the records returned.
+        std::map<std::string, std::string, std::less<>> load() const;
+
+        void append(StringView key, StringView payload) const;
+        // Appends all of `records` with a single write.
+        void append(View<std::pair<std::string, std::string>> records) const;
+        // Rewrites the file with `payload` as the only record for `key`, keeping the latest record for every other
+        // key. For records that are rewritten often, where appending would grow the file by a full record each time.
+        void replace(StringView key, StringView payload) const;
+
+        const Path& path() const noexcept { return m_path; }
+
+    private:
+        void append_serialized(StringView serialized) const;
+        void write_new_file(StringView contents) const;
+
+        const Filesystem* m_fs;
+        Path m_path;
+        std::string m_header;
+        std::size_t m_max_records;
+    };
+}
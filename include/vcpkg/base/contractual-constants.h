@@ -19,6 +19,7 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdArch = "arch";
     inline constexpr StringLiteral JsonIdArchiveCapitalLocation = "archiveLocation";
     inline constexpr StringLiteral JsonIdArtifact = "artifact";
+    inline constexpr StringLiteral JsonIdAttempts = "attempts";
     inline constexpr StringLiteral JsonIdBaseline = "baseline";
     inline constexpr StringLiteral JsonIdBuildtrees = "buildtrees";
     inline constexpr StringLiteral JsonIdBuiltin = "builtin";
@@ -26,10 +27,13 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdBuiltinError = "builtin-error";
     inline constexpr StringLiteral JsonIdBuiltinFiles = "builtin-files";
     inline constexpr StringLiteral JsonIdBuiltinGit = "builtin-git";
+    inline constexpr StringLiteral JsonIdBytes = "bytes";
     inline constexpr StringLiteral JsonIdCacheCapitalId = "cacheId";
     inline constexpr StringLiteral JsonIdCacheCapitalSize = "cacheSize";
+    inline constexpr StringLiteral JsonIdCalls = "calls";
     inline constexpr StringLiteral JsonIdChecksums = "checksums";
     inline constexpr StringLiteral JsonIdComment = "comment";
+    inline constexpr StringLiteral JsonIdCompression = "compression";
     inline constexpr StringLiteral JsonIdContacts = "contacts";
     inline constexpr StringLiteral JsonIdCorrelator = "correlator";
     inline constexpr StringLiteral JsonIdCreated = "created";
@@ -44,6 +48,7 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdDetectedCIEnvironment = "detected-ci-environment";
     inline constexpr StringLiteral JsonIdDetector = "detector";
     inline constexpr StringLiteral JsonIdDirect = "direct";
+    inline constexpr StringLiteral JsonIdDisplayName = "display-name";
     inline constexpr StringLiteral JsonIdDocumentation = "documentation";
     inline constexpr StringLiteral JsonIdDollarSchema = "$schema";
     inline constexpr StringLiteral JsonIdDownloads = "downloads";
@@ -54,6 +59,7 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdFilesystem = "filesystem";
     inline constexpr StringLiteral JsonIdGit = "git";
     inline constexpr StringLiteral JsonIdGitTree = "git-tree";
+    inline constexpr StringLiteral JsonIdHits = "hits";
     inline constexpr StringLiteral JsonIdHomepage = "homepage";
     inline constexpr StringLiteral JsonIdHost = "host";
     inline constexpr StringLiteral JsonIdHostTriplet = "host-triplet";
@@ -70,11 +76,15 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdManifests = "manifests";
     inline constexpr StringLiteral JsonIdMessage = "message";
     inline constexpr StringLiteral JsonIdMicrosoft = "microsoft";
+    inline constexpr StringLiteral JsonIdMisses = "misses";
     inline constexpr StringLiteral JsonIdName = "name";
+    inline constexpr StringLiteral JsonIdNextAttempt = "next-attempt";
     inline constexpr StringLiteral JsonIdOS = "os";
     inline constexpr StringLiteral JsonIdOverlayPorts = "overlay-ports";
     inline constexpr StringLiteral JsonIdOverlayTriplets = "overlay-triplets";
     inline constexpr StringLiteral JsonIdOverrides = "overrides";
+    inline constexpr StringLiteral JsonIdP50Us = "p50-us";
+    inline constexpr StringLiteral JsonIdP95Us = "p95-us";
     inline constexpr StringLiteral JsonIdPackages = "packages";
     inline constexpr StringLiteral JsonIdPackageUnderscoreName = "package_name";
     inline constexpr StringLiteral JsonIdPackageUnderscoreUrl = "package_url";
@@ -82,14 +92,20 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdPlatform = "platform";
     inline constexpr StringLiteral JsonIdPortUnderscoreVersion = "port_version";
     inline constexpr StringLiteral JsonIdPortVersion = "port-version";
+    inline constexpr StringLiteral JsonIdPrecheck = "precheck";
+    inline constexpr StringLiteral JsonIdProvider = "provider";
+    inline constexpr StringLiteral JsonIdProviders = "providers";
+    inline constexpr StringLiteral JsonIdRead = "read";
     inline constexpr StringLiteral JsonIdRef = "ref";
     inline constexpr StringLiteral JsonIdReference = "reference";
     inline constexpr StringLiteral JsonIdRegistries = "registries";
     inline constexpr StringLiteral JsonIdRelationship = "relationship";
     inline constexpr StringLiteral JsonIdRelationships = "relationships";
     inline constexpr StringLiteral JsonIdRepository = "repository";
+    inline constexpr StringLiteral JsonIdRequests = "requests";
     inline constexpr StringLiteral JsonIdRequires = "requires";
     inline constexpr StringLiteral JsonIdResolved = "resolved";
+    inline constexpr StringLiteral JsonIdRestore = "restore";
     inline constexpr StringLiteral JsonIdScanned = "scanned";
     inline constexpr StringLiteral JsonIdSchemaVersion = "schema-version";
     inline constexpr StringLiteral JsonIdSettings = "settings";
@@ -99,7 +115,9 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdSummary = "summary";
     inline constexpr StringLiteral JsonIdSupports = "supports";
     inline constexpr StringLiteral JsonIdTools = "tools";
+    inline constexpr StringLiteral JsonIdTotalUs = "total-us";
     inline constexpr StringLiteral JsonIdTriplet = "triplet";
+    inline constexpr StringLiteral JsonIdUpload = "upload";
     inline constexpr StringLiteral JsonIdUrl = "url";
     inline constexpr StringLiteral JsonIdVcpkgAssetSources = "vcpkg-asset-sources";
     inline constexpr StringLiteral JsonIdVcpkgConfiguration = "vcpkg-configuration";
@@ -117,6 +135,7 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdVersionsOutput = "versions-output";
     inline constexpr StringLiteral JsonIdVersionString = "version-string";
     inline constexpr StringLiteral JsonIdWarning = "warning";
+    inline constexpr StringLiteral JsonIdWrite = "write";
 
     // SPDX constants are JsonIds which follow capitalization and separation in the SPDX specification,
     // rather than the lowercase-dash convention used above.
@@ -186,6 +205,7 @@ namespace vcpkg
     inline constexpr StringLiteral SwitchAssetSources = "asset-sources";
     inline constexpr StringLiteral SwitchBaseline = "baseline";
     inline constexpr StringLiteral SwitchBin = "bin";
+    inline constexpr StringLiteral SwitchBinarycacheStats = "binarycache-stats";
     inline constexpr StringLiteral SwitchBinarycaching = "binarycaching";
     inline constexpr StringLiteral SwitchBinarysource = "binarysource";
     inline constexpr StringLiteral SwitchBuildtrees = "buildtrees";
@@ -202,6 +222,7 @@ namespace vcpkg
     inline constexpr StringLiteral SwitchCMakeArgs = "cmake-args";
     inline constexpr StringLiteral SwitchCMakeConfigureDebug = "cmake-configure-debug";
     inline constexpr StringLiteral SwitchCMakeDebug = "cmake-debug";
+    inline constexpr StringLiteral SwitchClear = "clear";
     inline constexpr StringLiteral SwitchConvertControl = "convert-control";
     inline constexpr StringLiteral SwitchCopiedFilesLog = "copied-files-log";
     inline constexpr StringLiteral SwitchDebug = "debug";
@@ -211,6 +232,7 @@ namespace vcpkg
     inline constexpr StringLiteral SwitchDisableMetrics = "disable-metrics";
     inline constexpr StringLiteral SwitchDot = "dot";
     inline constexpr StringLiteral SwitchDownloadsRoot = "downloads-root";
+    inline constexpr StringLiteral SwitchDrain = "drain";
     inline constexpr StringLiteral SwitchDryRun = "dry-run";
     inline constexpr StringLiteral SwitchEditable = "editable";
     inline constexpr StringLiteral SwitchEnforcePortChecks = "enforce-port-checks";
@@ -271,6 +293,7 @@ namespace vcpkg
     inline constexpr StringLiteral SwitchRaw = "raw";
     inline constexpr StringLiteral SwitchRecurse = "recurse";
     inline constexpr StringLiteral SwitchRegistriesCache = "registries-cache";
+    inline constexpr StringLiteral SwitchRestoreIntoInstalled = "restore-into-installed";
     inline constexpr StringLiteral SwitchScriptsRoot = "scripts-root";
     inline constexpr StringLiteral SwitchSendmetrics = "sendmetrics";
     inline constexpr StringLiteral SwitchSevenZip = "7zip";
@@ -340,6 +363,7 @@ namespace vcpkg
     inline constexpr StringLiteral FileInclude = "include";
     inline constexpr StringLiteral FileIncomplete = "incomplete";
     inline constexpr StringLiteral FileInfo = "info";
+    inline constexpr StringLiteral FileInstallPlanCacheDotBin = "install-plan-cache.bin";
     inline constexpr StringLiteral FileIssueBodyMD = "issue_body.md";
     inline constexpr StringLiteral FileLicense = "LICENSE";
     inline constexpr StringLiteral FileLicenseDotTxt = "LICENSE.txt";
@@ -548,6 +572,8 @@ namespace vcpkg
     inline constexpr StringLiteral EnvironmentVariableVSCmdSkipSendTelemetry = "VSCMD_SKIP_SENDTELEMETRY";
     inline constexpr StringLiteral EnvironmentVariableVsLang = "VSLANG";
     inline constexpr StringLiteral EnvironmentVariableXVcpkgAssetSources = "X_VCPKG_ASSET_SOURCES";
+    inline constexpr StringLiteral EnvironmentVariableXVcpkgCurlParallelMax = "X_VCPKG_CURL_PARALLEL_MAX";
+    inline constexpr StringLiteral EnvironmentVariableXVcpkgGitTreesCacheMaxMB = "X_VCPKG_GIT_TREES_CACHE_MAX_MB";
     inline constexpr StringLiteral EnvironmentVariableXVcpkgIgnoreLockFailures = "X_VCPKG_IGNORE_LOCK_FAILURES";
     inline constexpr StringLiteral EnvironmentVariableXVcpkgNuGetIDPrefix = "X_VCPKG_NUGET_ID_PREFIX";
     inline constexpr StringLiteral EnvironmentVariableXVcpkgRecursiveData = "X_VCPKG_RECURSIVE_DATA";
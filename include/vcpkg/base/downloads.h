@@ -3,6 +3,7 @@
 #include <vcpkg/base/fwd/downloads.h>
 #include <vcpkg/base/fwd/files.h>
 #include <vcpkg/base/fwd/messages.h>
+#include <vcpkg/base/fwd/system.process.h>
 
 #include <vcpkg/base/expected.h>
 #include <vcpkg/base/json.h>
@@ -47,6 +48,33 @@ namespace vcpkg
                                 StringLiteral prefix,
                                 StringView this_line);
 
+    // Parses a curl output line for curl invoked with --parallel and
+    // -w "PREFIX%{urlnum} %{http_code} %{exitcode} %{errormsg}"
+    // Parallel transfers complete in any order, so http_codes must already be sized to the number of operations; the
+    // entry at %{urlnum} is filled in.
+    // Returns: the %{urlnum} of the line if it was well formed; otherwise, nullopt.
+    Optional<size_t> parse_curl_parallel_status_line(DiagnosticContext& context,
+                                                     std::vector<int>& http_codes,
+                                                     StringLiteral prefix,
+                                                     StringView this_line);
+
+    // Returns the --parallel-max of each curl process to run at once for `batch_count` command lines of operations.
+    // Each process gets a share of `parallel_max`, so the total number of connections never exceeds it.
+    std::vector<unsigned int> split_curl_parallel_max(size_t batch_count, size_t concurrency, unsigned int parallel_max);
+
+    // Runs `operation_args` with curl --parallel, splitting them across as many command lines as they need and running
+    // up to get_concurrency() of those at once, with at most `parallel_max` connections in total.
+    // Returns one HTTP status code per operation, in order; 0 for operations that failed without one or that curl
+    // never reported on.
+    std::vector<int> curl_parallel_bulk_operation(DiagnosticContext& context,
+                                                  View<Command> operation_args,
+                                                  StringLiteral prefixArgs,
+                                                  View<std::string> headers,
+                                                  View<std::string> secrets,
+                                                  unsigned int parallel_max);
+
+    // Returns one HTTP status code per url, in order; 0 for operations that failed without one, including any that
+    // curl never reported on because it crashed or couldn't be launched.
     std::vector<int> download_files_no_cache(DiagnosticContext& context,
                                              View<std::pair<std::string, Path>> url_pairs,
                                              View<std::string> headers,
@@ -67,6 +95,7 @@ namespace vcpkg
 
     std::string format_url_query(StringView base_url, View<std::string> query_params);
 
+    // Returns one HTTP status code per url, as download_files_no_cache does
     std::vector<int> url_heads(DiagnosticContext& context,
                                View<std::string> urls,
                                View<std::string> headers,
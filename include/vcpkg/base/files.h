@@ -312,6 +312,14 @@ namespace vcpkg
                                  const Path& destination,
                                  CopyOptions options) const;
 
+        // Creates `destination` as a copy-on-write clone of the regular file `source`, sharing its data until either
+        // is written (a reflink). Fails with std::errc::not_supported, or the error the filesystem reports, where
+        // cloning isn't possible; `destination` is not left behind on failure.
+        virtual void clone_file(const Path& source, const Path& destination, std::error_code& ec) const = 0;
+
+        // Removes write permission on the file `target` for everyone (sets the read-only attribute on Windows).
+        virtual void make_read_only(const Path& target, std::error_code& ec) const = 0;
+
         virtual void copy_symlink(const Path& source, const Path& destination, std::error_code& ec) const = 0;
         void copy_symlink(const Path& source, const Path& destination, LineInfo li) const;
 
@@ -23,4 +23,6 @@ namespace vcpkg
     struct GitRepoLocator;
     struct GitLSTreeEntry;
     struct GitDiffTreeLine;
+    struct GitCatFileHeader;
+    struct GitObjectReader;
 }
@@ -14,7 +14,5 @@ namespace vcpkg
         FULLY_EXPLORED
     };
 
-    template<class V, class U>
-    struct AdjacencyProvider;
     struct GraphRandomizer;
 }
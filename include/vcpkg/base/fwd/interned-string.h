@@ -0,0 +1,7 @@
+#pragma once
+
+namespace vcpkg
+{
+    struct InternedStringInstance;
+    struct InternedString;
+}
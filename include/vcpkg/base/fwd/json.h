@@ -8,6 +8,7 @@ namespace vcpkg::Json
     struct Object;
     struct ParsedJson;
     struct Array;
+    struct StreamReader;
     struct Reader;
     template<class Type>
     struct IDeserializer;
@@ -26,6 +26,7 @@ namespace vcpkg
     struct CMakeVariable;
     struct Command;
     struct CommandLess;
+    struct Coprocess;
     struct ExitCodeAndOutput;
     struct Environment;
 
@@ -7,7 +7,9 @@
 #include <vcpkg/base/optional.h>
 #include <vcpkg/base/path.h>
 #include <vcpkg/base/stringview.h>
+#include <vcpkg/base/system.process.h>
 
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -48,6 +50,61 @@ namespace vcpkg
         friend bool operator!=(const GitDiffTreeLine& lhs, const GitDiffTreeLine& rhs) noexcept;
     };
 
+    // The header line `git cat-file --batch` and `git cat-file --batch-check` print for each object found
+    struct GitCatFileHeader
+    {
+        std::string object_id;
+        std::string type;
+        std::size_t size;
+    };
+
+    // Returns whether `header_line` is git's reply that `object` does not exist
+    bool is_git_cat_file_missing_reply(StringView object, StringView header_line) noexcept;
+
+    // Parses the header line printed in response to the request for `object`. Reports an error to `context` if the
+    // object doesn't exist or the line isn't a header.
+    Optional<GitCatFileHeader> parse_git_cat_file_header(DiagnosticContext& context,
+                                                         StringView object,
+                                                         StringView header_line);
+
+    // Parses the contents of a tree object, as printed by `git cat-file --batch`, into the names of its entries.
+    // Returns nullopt if the contents are malformed.
+    Optional<std::vector<std::string>> parse_git_tree_entry_names(StringView tree_contents, std::size_t object_id_size);
+
+    // Reads objects from one repository through long running `git cat-file --batch` and `git cat-file --batch-check`
+    // processes, started on first use, rather than launching git for every read. Thread safe.
+    struct GitObjectReader
+    {
+        GitObjectReader(const Path& git_exe, GitRepoLocatorKind locator_kind, const Path& locator_path);
+        GitObjectReader(const GitObjectReader&) = delete;
+        GitObjectReader& operator=(const GitObjectReader&) = delete;
+
+        // Returns the contents of `object`, which is any name git understands, such as
+        // "<commit>:versions/baseline.json". Like `git show <object>`, but reports an error if `object` is not a blob.
+        Optional<std::string> read_object(DiagnosticContext& context, StringView object);
+        // Returns the object id `object` resolves to, like `git rev-parse <object>`.
+        Optional<std::string> object_id(DiagnosticContext& context, StringView object);
+        // Returns the names of the entries of the tree `object`, like `git ls-tree --name-only <object>`, with a
+        // single request.
+        Optional<std::vector<std::string>> read_tree_entry_names(DiagnosticContext& context, StringView object);
+
+    private:
+        // Reads `object` through the --batch process, storing its header in `header`. m_mutex must be held.
+        Optional<std::string> read_batch(DiagnosticContext& context, StringView object, GitCatFileHeader& header);
+        // Sends `object` to `process` and returns the header line of the reply
+        Optional<std::string> request(DiagnosticContext& context,
+                                      Coprocess& process,
+                                      StringLiteral batch_arg,
+                                      StringView object);
+
+        Path m_git_exe;
+        GitRepoLocatorKind m_locator_kind;
+        Path m_locator_path;
+        std::mutex m_mutex;
+        Coprocess m_batch;
+        Coprocess m_batch_check;
+    };
+
     bool is_git_mode(StringView sv) noexcept;
 
     bool is_git_sha(StringView sv) noexcept;
@@ -93,6 +150,25 @@ namespace vcpkg
                           const Path& destination,
                           StringView treeish);
 
+    // Extracts `tree` into `destination` through the machine wide cache of extracted trees in `cache_root`. Each tree
+    // is checked out into cache_root/<tree> only once, with its files made read-only. Each file is then cloned into
+    // `destination` where the filesystem supports reflinks, otherwise hard linked, and otherwise copied, so the files
+    // in `destination` are read-only too; in every case evicting the tree from the cache doesn't affect the
+    // destination. Publishing a new tree evicts the least recently used ones until the cache holds at most
+    // `cache_max_size` bytes. Falls back to extracting directly into `destination` if the cache can't be used.
+    bool git_extract_tree_cached(DiagnosticContext& context,
+                                 const Filesystem& fs,
+                                 const Path& git_exe,
+                                 GitRepoLocator locator,
+                                 const Path& cache_root,
+                                 const Path& destination,
+                                 StringView tree,
+                                 std::uint64_t cache_max_size);
+
+    // Removes the least recently used trees in the cache in `cache_root` until the remaining ones total at most
+    // `max_size` bytes. Trees without a usage stamp count as the least recently used.
+    void trim_git_tree_cache(const Filesystem& fs, const Path& cache_root, std::uint64_t max_size);
+
     Optional<bool> git_check_is_commit(DiagnosticContext& context,
                                        const Path& git_exe,
                                        GitRepoLocator locator,
@@ -1,24 +1,19 @@
 #pragma once
 
 #include <vcpkg/base/fwd/graphs.h>
+#include <vcpkg/base/fwd/span.h>
 
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/lineinfo.h>
 #include <vcpkg/base/messages.h>
 
+#include <cstddef>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace vcpkg
 {
-    template<class V, class U>
-    struct AdjacencyProvider
-    {
-        virtual std::vector<V> adjacency_list(const U& vertex) const = 0;
-        virtual U load_vertex_data(const V& vertex) const = 0;
-    };
-
     struct GraphRandomizer
     {
         virtual int random(int max_exclusive) = 0;
@@ -42,63 +37,52 @@ namespace vcpkg
                 }
             }
         }
+    }
 
-        template<class V, class U>
-        void topological_sort_internal(const V& vertex,
-                                       const AdjacencyProvider<V, U>& f,
-                                       std::unordered_map<V, ExplorationStatus>& exploration_status,
-                                       std::vector<U>& sorted,
-                                       GraphRandomizer* randomizer)
-        {
-            ExplorationStatus& status = exploration_status[vertex];
-            switch (status)
-            {
-                case ExplorationStatus::FULLY_EXPLORED: return;
-                case ExplorationStatus::PARTIALLY_EXPLORED:
-                {
-                    msg::println(msgGraphCycleDetected, msg::package_name = vertex);
-                    for (auto&& node : exploration_status)
-                    {
-                        if (node.second == ExplorationStatus::PARTIALLY_EXPLORED)
-                        {
-                            msg::println(LocalizedString().append_indent().append_raw(node.first.to_string()));
-                        }
-                    }
-                    Checks::exit_fail(VCPKG_LINE_INFO);
-                }
-                case ExplorationStatus::NOT_EXPLORED:
-                {
-                    status = ExplorationStatus::PARTIALLY_EXPLORED;
-                    U vertex_data = f.load_vertex_data(vertex);
-                    auto neighbours = f.adjacency_list(vertex_data);
-                    details::shuffle(neighbours, randomizer);
-                    for (const V& neighbour : neighbours)
-                        topological_sort_internal(neighbour, f, exploration_status, sorted, randomizer);
+    // A graph of the vertices 0 to size() - 1 in compressed sparse row form: the vertices adjacent to vertex `v` are
+    // targets[offsets[v]] up to targets[offsets[v + 1]].
+    struct AdjacencyArrays
+    {
+        AdjacencyArrays();
 
-                    sorted.push_back(std::move(vertex_data));
-                    status = ExplorationStatus::FULLY_EXPLORED;
-                    return;
-                }
-                default: Checks::unreachable(VCPKG_LINE_INFO);
-            }
-        }
-    }
+        // Builds a graph of `vertex_count` vertices with an edge from each .first to .second of `edges`, keeping the
+        // order of the edges from each vertex
+        static AdjacencyArrays from_edges(std::size_t vertex_count, View<std::pair<std::size_t, std::size_t>> edges);
+
+        // Adds the vertex size(), adjacent to `adjacent`
+        void add_vertex(View<std::size_t> adjacent);
 
-    template<class Range, class V, class U>
-    std::vector<U> topological_sort(Range starting_vertices,
-                                    const AdjacencyProvider<V, U>& f,
-                                    GraphRandomizer* randomizer)
+        std::size_t size() const noexcept { return offsets.size() - 1; }
+
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> targets;
+    };
+
+    struct TopologicalOrder
     {
-        std::vector<U> sorted;
-        std::unordered_map<V, ExplorationStatus> exploration_status;
+        // Each vertex reachable from the starting vertices, after every vertex it is adjacent to
+        std::vector<std::size_t> sorted;
+        // If not empty, `sorted` is incomplete and these vertices form a cycle: each is adjacent to the next, and the
+        // last to the first
+        std::vector<std::size_t> cycle;
+    };
 
-        details::shuffle(starting_vertices, randomizer);
+    // Shuffles `starting_vertices` and each adjacency list with `randomizer`, if any, before visiting them. Doesn't
+    // recurse, so that long dependency chains cannot overflow the stack.
+    TopologicalOrder topological_sort(const AdjacencyArrays& graph,
+                                      View<std::size_t> starting_vertices,
+                                      GraphRandomizer* randomizer);
 
-        for (auto&& vertex : starting_vertices)
+    // Reports `cycle`, as found by topological_sort, naming each vertex with `vertex_name`
+    template<class VertexName>
+    [[noreturn]] void exit_graph_cycle(const std::vector<std::size_t>& cycle, VertexName vertex_name)
+    {
+        msg::println(msgGraphCycleDetected, msg::package_name = vertex_name(cycle.front()));
+        for (auto vertex : cycle)
         {
-            details::topological_sort_internal(vertex, f, exploration_status, sorted, randomizer);
+            msg::println(LocalizedString().append_indent().append_raw(vertex_name(vertex)));
         }
 
-        return sorted;
+        Checks::exit_fail(VCPKG_LINE_INFO);
     }
 }
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vcpkg/base/fwd/fmt.h>
+#include <vcpkg/base/fwd/interned-string.h>
+
+#include <vcpkg/base/stringview.h>
+
+#include <stddef.h>
+
+#include <string>
+
+namespace vcpkg
+{
+    struct InternedStringInstance
+    {
+        std::string value;
+        size_t hash;
+    };
+
+    // A string stored once for the whole process, like the names in a Triplet: copying one copies a pointer, equal
+    // strings compare equal by pointer, and the hash is computed once when a string is first interned. Interning is
+    // thread safe. Interned strings are never freed, so only intern names drawn from a bounded set, like the names of
+    // ports and features.
+    struct InternedString
+    {
+        InternedString() noexcept : m_instance(&EMPTY_INSTANCE) { }
+        explicit InternedString(StringView value);
+
+        const std::string& str() const noexcept { return m_instance->value; }
+        size_t hash_code() const noexcept { return m_instance->hash; }
+
+        operator StringView() const noexcept { return m_instance->value; }
+
+        bool operator==(InternedString other) const noexcept { return m_instance == other.m_instance; }
+        bool operator!=(InternedString other) const noexcept { return m_instance != other.m_instance; }
+        // Orders by value, as std::string does
+        bool operator<(InternedString other) const noexcept
+        {
+            return m_instance != other.m_instance && m_instance->value < other.m_instance->value;
+        }
+
+    private:
+        static const InternedStringInstance EMPTY_INSTANCE;
+
+        const InternedStringInstance* m_instance;
+    };
+}
+
+VCPKG_FORMAT_AS(vcpkg::InternedString, vcpkg::StringView);
+
+namespace std
+{
+    template<>
+    struct hash<vcpkg::InternedString>
+    {
+        size_t operator()(vcpkg::InternedString value) const noexcept { return value.hash_code(); }
+    };
+}
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <iterator>
 #include <memory>
 #include <string>
 #include <utility>
@@ -336,9 +337,61 @@ namespace vcpkg::Json
     };
 
     ExpectedL<ParsedJson> parse(StringView text, StringView origin);
+    // Parses `text` that starts at `init_rowcol` of `origin`, so that errors point into the whole file
+    ExpectedL<ParsedJson> parse(StringView text, StringView origin, TextRowCol init_rowcol);
     ParsedJson parse_file(LineInfo li, const ReadOnlyFilesystem&, const Path&);
     ExpectedL<Json::Object> parse_object(StringView text, StringView origin);
 
+    // Reads JSON text one token at a time, so that large files with a fixed shape can be deserialized straight into
+    // typed objects without building a Value tree first. The caller walks the text in order, asking for the token it
+    // expects next. StreamReader only accepts well-formed input that matches what the caller asks for: if the text is
+    // anything else, the read returns false and the reader is failed from then on. Errors are not described; callers
+    // are expected to fall back to parse() and Reader, which report them with their positions. Duplicate keys are not
+    // detected either, and must be rejected by the caller.
+    struct StreamReader
+    {
+        StreamReader(StringView text, StringView origin);
+        StreamReader(const StreamReader&) = delete;
+        StreamReader& operator=(const StreamReader&) = delete;
+        ~StreamReader();
+
+        bool start_object();
+        // Reads the key of the next member of the current object and the ':' after it, then returns true; or reads
+        // the closing '}' and returns false. `key` is only valid until the next read.
+        bool next_member(StringView& key);
+
+        bool start_array();
+        // Returns true if another element of the current array follows, or reads the closing ']' and returns false
+        bool next_element();
+
+        // `value` is only valid until the next read
+        bool read_string(StringView& value);
+        bool read_integer(int64_t& value);
+
+        // Returns true if nothing but whitespace is left in the text
+        bool finish();
+
+        bool failed() const noexcept;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+
+    // One member of an object located by scan_object_members()
+    struct ObjectMemberSpan
+    {
+        std::string key;
+        // The text of the member's value, within the scanned text
+        StringView value;
+    };
+
+    // Locates the members of the object `text` consists of in a single pass without building their values, so that
+    // callers can parse only the members they need. The syntax of the whole text is checked. Returns nullopt if
+    // `text` is not valid JSON, is not an object, has duplicate keys, or has a key that contains escape sequences;
+    // parse() describes the problem in that case.
+    Optional<std::vector<ObjectMemberSpan>> scan_object_members(StringView text);
+
     std::string stringify(const Value&);
     std::string stringify(const Value&, JsonStyle style);
     std::string stringify(const Object&);
@@ -354,6 +354,21 @@ DECLARE_MESSAGE(BaselineOnlyPlatformExpressionOrTriplet,
                 (),
                 "",
                 "You can not specify a platform expression and a triplet")
+DECLARE_MESSAGE(BinaryCacheQueueCleared, (msg::path), "", "Discarded all queued binary cache submissions in {path}")
+DECLARE_MESSAGE(BinaryCacheQueueDiscardedUnconfigured,
+                (msg::spec),
+                "",
+                "Discarding the queued binary cache submission of {spec} because none of the binary caches it failed "
+                "to upload to are configured")
+DECLARE_MESSAGE(BinaryCacheQueueEmpty, (msg::path), "", "There are no queued binary cache submissions in {path}")
+DECLARE_MESSAGE(BinaryCacheQueueEntry,
+                (msg::spec, msg::sha, msg::count, msg::value),
+                "{value} is a UTC date and time",
+                "{spec} (ABI {sha}): {count} failed attempts, next retry after {value}")
+DECLARE_MESSAGE(BinaryCacheStatsArg,
+                (),
+                "",
+                "Writes per-provider binary caching statistics as JSON to this file when vcpkg exits")
 DECLARE_MESSAGE(BinarySourcesArg,
                 (),
                 "'vcpkg help binarycaching' is a command line and should not be localized",
@@ -564,6 +579,12 @@ DECLARE_MESSAGE(CmdAddVersionOptOverwriteVersion, (), "", "Overwrites git-tree o
 DECLARE_MESSAGE(CmdAddVersionOptSkipFormatChk, (), "", "Skips the formatting check of vcpkg.json files")
 DECLARE_MESSAGE(CmdAddVersionOptSkipVersionFormatChk, (), "", "Skips the version format check")
 DECLARE_MESSAGE(CmdAddVersionOptVerbose, (), "", "Prints success messages rather than only errors")
+DECLARE_MESSAGE(CmdBinaryCacheQueueSwitchClear, (), "", "Discards all queued submissions")
+DECLARE_MESSAGE(CmdBinaryCacheQueueSwitchDrain, (), "", "Retries all queued submissions now, ignoring backoff")
+DECLARE_MESSAGE(CmdBinaryCacheQueueSynopsis,
+                (),
+                "",
+                "Lists, retries, or discards binary cache submissions queued after upload failures")
 DECLARE_MESSAGE(CmdBootstrapStandaloneSynopsis, (), "", "Bootstraps a vcpkg root from only a vcpkg binary")
 DECLARE_MESSAGE(CmdBuildExternalExample1,
                 (),
@@ -976,6 +997,11 @@ DECLARE_MESSAGE(
     "curl failed to return the expected number of exit codes; this can happen if something terminates curl "
     "before it has finished. curl exited with {exit_code} which is normally the result code for the last operation, "
     "but may be the result of a crash. The command line was {command_line}, and all output is below:")
+DECLARE_MESSAGE(CurlOperationsNotAttempted,
+                (msg::count),
+                "curl is the name of a program, see curl.se.",
+                "{count} curl operations were not attempted because they don't fit on a command line with the "
+                "configured headers.")
 DECLARE_MESSAGE(CurrentCommitBaseline,
                 (msg::commit_sha),
                 "",
@@ -1452,6 +1478,14 @@ DECLARE_MESSAGE(
     "",
     "The git registry \"{url}\" must have a \"baseline\" field that is a valid git commit SHA (40 hexadecimal "
     "characters).\nTo use the current latest versions, set baseline to that repo's HEAD, \"{commit_sha}\".")
+DECLARE_MESSAGE(GitObjectMissing,
+                (msg::value),
+                "{value} is a git object name, such as 'HEAD:versions/baseline.json'",
+                "git object {value} does not exist")
+DECLARE_MESSAGE(GitObjectNotBlob,
+                (msg::value, msg::actual),
+                "{value} is a git object name, such as 'HEAD:versions'. {actual} is a git object type, such as 'tree'",
+                "git object {value} is a {actual}, not a file")
 DECLARE_MESSAGE(GitUnexpectedCommandOutputCmd,
                 (msg::command_line),
                 "",
@@ -1803,6 +1837,7 @@ DECLARE_MESSAGE(InstallPackageInstruction,
                 "'{value}' is the nuget id.",
                 "With a project open, go to Tools->NuGet Package Manager->Package Manager Console and "
                 "paste:\n Install-Package \"{value}\" -Source \"{path}\"")
+DECLARE_MESSAGE(InstallPlanUpToDate, (), "", "All requested installations are up to date.")
 DECLARE_MESSAGE(InstallRootDir, (), "", "Installed directory (experimental)")
 DECLARE_MESSAGE(InstallSkippedUpToDateFile,
                 (msg::path_source, msg::path_destination),
@@ -2772,6 +2807,10 @@ DECLARE_MESSAGE(StartingFeatureTest,
                 "{value} is the position in the run, for example '1/4'",
                 "Feature Test [{value}] {feature_spec}")
 DECLARE_MESSAGE(StoreOptionMissingSha, (), "", "--store option is invalid without a sha512")
+DECLARE_MESSAGE(SubmittingBinaryCacheAbandoned,
+                (msg::spec, msg::count),
+                "",
+                "Giving up on queued binary cache submission of {spec} after {count} failed attempts")
 DECLARE_MESSAGE(SubmittingBinaryCacheBackground,
                 (msg::spec, msg::count),
                 "",
@@ -2780,6 +2819,15 @@ DECLARE_MESSAGE(SubmittingBinaryCacheComplete,
                 (msg::spec, msg::count, msg::elapsed),
                 "",
                 "Completed submission of {spec} to {count} binary cache(s) in {elapsed}")
+DECLARE_MESSAGE(SubmittingBinaryCacheQueued,
+                (msg::spec, msg::path),
+                "",
+                "Failed to submit {spec} to all binary caches; queued it in {path} to be retried by a later vcpkg run")
+DECLARE_MESSAGE(SubmittingBinaryCacheRetry,
+                (msg::spec, msg::count),
+                "",
+                "Retrying queued submission of {spec} to binary caches in the background (previously failed {count} "
+                "time(s))")
 DECLARE_MESSAGE(SuggestGitPull, (), "", "The result may be outdated. Run `git pull` to get the latest results.")
 DECLARE_MESSAGE(SuggestStartingBashShell,
                 (),
@@ -3348,3 +3396,7 @@ DECLARE_MESSAGE(WhileRunningAssetCacheScriptCommandLine, (), "", "while running
 DECLARE_MESSAGE(WhileValidatingVersion, (msg::version), "", "while validating version: {version}")
 DECLARE_MESSAGE(WindowsOnlyCommand, (), "", "This command only supports Windows.")
 DECLARE_MESSAGE(WroteNuGetPkgConfInfo, (msg::path), "", "Wrote NuGet package config information to {path}")
+DECLARE_MESSAGE(ZipCentralDirectoryInvalid,
+                (msg::path),
+                "",
+                "{path} is not a zip archive or its central directory is corrupt")
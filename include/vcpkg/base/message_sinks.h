@@ -81,6 +81,21 @@ namespace vcpkg
         virtual void println(Color color, LocalizedString&& line) override;
     };
 
+    // Stores printed lines so that they can be printed later, such as in a deterministic order after parallel work.
+    struct BufferedMessageSink final : MessageSink
+    {
+        BufferedMessageSink() = default;
+
+        virtual void println(const MessageLine& line) override;
+        virtual void println(MessageLine&& line) override;
+        using MessageSink::println;
+
+        // Prints the stored lines to `sink`, leaving this empty
+        void print_to(MessageSink& sink);
+
+        std::vector<MessageLine> lines;
+    };
+
     struct BGMessageSink final : MessageSink
     {
         BGMessageSink(MessageSink& out_sink) : out_sink(out_sink) { }
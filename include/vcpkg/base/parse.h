@@ -93,6 +93,8 @@ namespace vcpkg
         SourceLoc cur_loc() const { return {m_it, m_start_of_line, m_row, m_column}; }
         TextRowCol cur_rowcol() const { return {m_row, m_column}; }
         char32_t next();
+        // Advances over `count` bytes at once; they must all be ASCII characters other than tabs and line endings
+        void advance_ascii(size_t count);
         bool at_eof() const { return m_it == m_it.end(); }
 
         void add_error(LocalizedString&& message);
@@ -119,4 +121,7 @@ namespace vcpkg
 
         ParseMessages m_messages;
     };
+
+    // The row and column ParserBase reports for the character `offset` bytes into `text`
+    TextRowCol text_row_col_at(StringView text, std::size_t offset);
 }
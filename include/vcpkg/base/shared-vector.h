@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace vcpkg
+{
+    // An immutable vector whose copies refer to the same elements, so that equal lists can be stored once. Empty
+    // lists don't allocate.
+    template<class Ty>
+    struct SharedVector
+    {
+        using value_type = Ty;
+        using size_type = typename std::vector<Ty>::size_type;
+        using iterator = const Ty*;
+        using const_iterator = const Ty*;
+
+        SharedVector() = default;
+        SharedVector(const std::vector<Ty>& data) : SharedVector(std::vector<Ty>(data)) { }
+        SharedVector(std::vector<Ty>&& data)
+        {
+            if (!data.empty())
+            {
+                data.shrink_to_fit();
+                m_data = std::make_shared<const std::vector<Ty>>(std::move(data));
+            }
+        }
+        SharedVector(std::initializer_list<Ty> elements) : SharedVector(std::vector<Ty>(elements)) { }
+
+        const Ty* data() const noexcept { return m_data ? m_data->data() : nullptr; }
+        size_type size() const noexcept { return m_data ? m_data->size() : 0; }
+        bool empty() const noexcept { return !m_data; }
+
+        iterator begin() const noexcept { return data(); }
+        iterator end() const noexcept { return data() + size(); }
+        iterator cbegin() const noexcept { return begin(); }
+        iterator cend() const noexcept { return end(); }
+
+        const Ty& operator[](std::size_t i) const noexcept { return (*m_data)[i]; }
+
+        // Whether this and `other` are copies of the same list, rather than merely equal
+        bool shares_data_with(const SharedVector& other) const noexcept { return m_data == other.m_data; }
+
+        friend bool operator==(const SharedVector& lhs, const SharedVector& rhs)
+        {
+            return lhs.m_data == rhs.m_data || std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+        friend bool operator!=(const SharedVector& lhs, const SharedVector& rhs) { return !(lhs == rhs); }
+        friend bool operator<(const SharedVector& lhs, const SharedVector& rhs)
+        {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+    private:
+        std::shared_ptr<const std::vector<Ty>> m_data;
+    };
+}
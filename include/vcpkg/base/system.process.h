@@ -10,6 +10,7 @@
 #include <vcpkg/base/span.h>
 #include <vcpkg/base/stringview.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -236,6 +237,35 @@ namespace vcpkg
             data_cb);
     }
 
+    // A child process whose standard input and standard output are pipes held by vcpkg, for tools like
+    // `git cat-file --batch` which answer a stream of requests without being relaunched for each one.
+    // The child's standard error is inherited. Not thread safe.
+    struct Coprocess
+    {
+        Coprocess() noexcept;
+        Coprocess(const Coprocess&) = delete;
+        Coprocess& operator=(const Coprocess&) = delete;
+        // Calls finish() if the child is still running
+        ~Coprocess();
+
+        bool start(DiagnosticContext& context, const Command& cmd, const ProcessLaunchSettings& settings);
+        bool is_running() const noexcept;
+
+        bool write(DiagnosticContext& context, StringView data);
+        // Reads through the next '\n' and stores the line without it in `line`. Returns false if the child closed
+        // its standard output first.
+        bool read_line(DiagnosticContext& context, std::string& line);
+        // Reads exactly `size` bytes and appends them to `target`.
+        bool read_exact(DiagnosticContext& context, std::size_t size, std::string& target);
+
+        // Closes the child's standard input, discards any output it has not read yet, and waits for it to exit.
+        Optional<ExitCodeIntegral> finish(DiagnosticContext& context);
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+
     uint64_t get_subproccess_stats();
 
     void register_console_ctrl_handler();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vcpkg/base/fwd/files.h>
 #include <vcpkg/base/fwd/message_sinks.h>
 
 #include <vcpkg/fwd/binarycaching.h>
@@ -9,9 +10,12 @@
 #include <vcpkg/fwd/vcpkgpaths.h>
 
 #include <vcpkg/base/background-work-queue.h>
+#include <vcpkg/base/chrono.h>
 #include <vcpkg/base/downloads.h>
 #include <vcpkg/base/expected.h>
+#include <vcpkg/base/json.h>
 #include <vcpkg/base/message_sinks.h>
+#include <vcpkg/base/optional.h>
 #include <vcpkg/base/path.h>
 
 #include <vcpkg/archives.h>
@@ -20,6 +24,8 @@
 
 #include <chrono>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <thread>
@@ -56,6 +62,11 @@ namespace vcpkg
     struct BinaryPackageReadInfo
     {
         explicit BinaryPackageReadInfo(const InstallPlanAction& action);
+        BinaryPackageReadInfo(const PackageSpec& spec,
+                              const std::string& package_abi,
+                              const std::string& display_name,
+                              const Version& version,
+                              const Path& package_dir);
         std::string package_abi;
         PackageSpec spec;
         std::string display_name;
@@ -63,6 +74,16 @@ namespace vcpkg
         Path package_dir;
     };
 
+    // A zip archive fetched from a binary cache which has not been extracted yet, see --x-restore-into-installed
+    struct RestoredArchive
+    {
+        Path path;
+        // Set if `path` is a temporary download which should be deleted once it has been extracted
+        bool remove_after_use = false;
+        // The destination_id() of each read provider which reported that it does not have the package
+        std::vector<std::string> missing_from;
+    };
+
     struct BinaryPackageWriteInfo : BinaryPackageReadInfo
     {
         using BinaryPackageReadInfo::BinaryPackageReadInfo;
@@ -86,6 +107,17 @@ namespace vcpkg
 
         virtual bool needs_nuspec_data() const = 0;
         virtual bool needs_zip_file() const = 0;
+
+        /// The number of destinations push_success() attempts to store to. A return value from push_success() less
+        /// than this indicates that some uploads failed.
+        virtual size_t destination_count() const = 0;
+
+        /// The binary source kind this provider was configured from, such as "files" or "gcs".
+        virtual StringLiteral provider_name() const = 0;
+
+        /// Identifies each destination push_success() stores to, such as "files:/path/to/cache", in the same form as
+        /// IReadBinaryProvider::destination_id(). Must not contain credentials.
+        virtual std::vector<std::string> destination_ids() const = 0;
     };
 
     struct IReadBinaryProvider
@@ -110,6 +142,33 @@ namespace vcpkg
 
         virtual LocalizedString restored_message(size_t count,
                                                  std::chrono::high_resolution_clock::duration elapsed) const = 0;
+
+        /// The binary source kind this provider was configured from, such as "files" or "gcs".
+        virtual StringLiteral provider_name() const = 0;
+
+        /// Identifies the location this provider reads from, such as "files:/path/to/cache", so that it can be matched
+        /// with the IWriteBinaryProvider::destination_ids() of a provider storing to the same location.
+        virtual std::string destination_id() const = 0;
+
+        /// The total size in bytes of the archives restored by fetch() so far, or 0 if unknown.
+        virtual uint64_t restored_bytes() const { return 0; }
+
+        /// Like fetch(), but leaves each fetched package as a zip archive in out_archives[i] rather than extracting it
+        /// into its packages directory. Returns false without fetching anything if this provider does not fetch zip
+        /// archives.
+        virtual bool fetch_archives(View<const InstallPlanAction*>, Span<Optional<RestoredArchive>>) const
+        {
+            return false;
+        }
+
+        /// Like fetch(), but keeps the zip archive each package was extracted from and stores it in out_archives[i].
+        /// Returns false without fetching anything if this provider does not fetch zip archives.
+        virtual bool fetch_and_keep_archives(View<const InstallPlanAction*>,
+                                             Span<RestoreResult>,
+                                             Span<Optional<RestoredArchive>>) const
+        {
+            return false;
+        }
     };
 
     struct UrlTemplate
@@ -187,6 +246,107 @@ namespace vcpkg
         NuGetRepoInfo nuget_repo;
     };
 
+    // A binary cache submission which failed to upload and has been spooled to disk to be retried by a later run.
+    struct BinaryCacheRetryEntry
+    {
+        PackageSpec spec;
+        Version version;
+        std::string package_abi;
+        std::string display_name;
+        int64_t attempts = 0;
+        // Seconds since the Unix epoch before which this entry should not be retried.
+        int64_t next_attempt = 0;
+        // The destination_ids() of each write provider the upload failed for; sorted.
+        std::vector<std::string> providers;
+    };
+
+    Json::Object serialize_binary_cache_retry_entry(const BinaryCacheRetryEntry& entry);
+    Optional<BinaryCacheRetryEntry> parse_binary_cache_retry_entry(const Json::Object& obj);
+
+    // The number of seconds to wait before retrying an entry which has failed `attempts` times, or nullopt if the
+    // entry should be abandoned.
+    Optional<int64_t> binary_cache_retry_delay(int64_t attempts);
+
+    // Durable queue of binary cache submissions whose upload failed, stored in the downloads directory so that it
+    // survives between vcpkg runs. Each entry is the zip archive <abi>.zip plus <abi>.json describing the package.
+    // Only providers which consume the zip file can be retried from the queue.
+    // The background push thread and the thread submitting retries may use the same queue concurrently.
+    struct BinaryCacheRetryQueue
+    {
+        BinaryCacheRetryQueue(const Filesystem& fs, const Path& downloads);
+
+        const Path& root() const noexcept { return m_root; }
+        Path archive_path(StringView package_abi) const;
+
+        // Takes the lock which must be held to retry or discard entries, so that only one vcpkg process drains the
+        // queue at a time. Returns nullptr if the lock could not be taken; if `wait` is false, that includes when
+        // another process holds it.
+        std::unique_ptr<IExclusiveFileLock> lock(bool wait, MessageSink& status_sink) const;
+
+        // Returns all entries with an archive present, sorted by ABI.
+        std::vector<BinaryCacheRetryEntry> load_entries() const;
+        // Moves `zip_path` into the queue to be retried against `failed_providers`, merging them into any entry
+        // already queued for the same ABI; returns false if that failed.
+        bool enqueue(const BinaryPackageReadInfo& info,
+                     const Path& zip_path,
+                     std::vector<std::string>&& failed_providers,
+                     MessageSink& msg_sink) const;
+        // Records a failed retry of `entry` against its remaining `providers`; returns false if the entry was
+        // abandoned and removed. If the updated entry can't be written, sets `ec` and keeps the entry as it was.
+        bool record_failure(BinaryCacheRetryEntry& entry, std::error_code& ec) const;
+        void remove(StringView package_abi) const;
+        // Removes all entries; the caller must hold lock().
+        void clear() const;
+
+    private:
+        void remove_unlocked(StringView package_abi) const;
+
+        const Filesystem& m_fs;
+        Path m_root;
+        // Serializes reads and writes of the entries within this process
+        mutable std::mutex m_mutex;
+    };
+
+    // Counters for one kind of operation against a binary cache provider, reported by --x-binarycache-stats.
+    struct BinaryCacheOperationStats
+    {
+        uint64_t requests = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t bytes = 0;
+        // The number of calls into the provider; one call may cover several requests.
+        uint64_t calls = 0;
+        // The latency of each request in microseconds, in the same unit as `requests`: a call covering several requests
+        // contributes its wall clock time divided evenly among them.
+        std::vector<uint64_t> latencies_us;
+
+        // Records a call covering `request_count` requests which took `elapsed_us`.
+        void add_call(uint64_t elapsed_us, size_t request_count);
+        void add_call(const ElapsedTimer& timer, size_t request_count) { add_call(timer.us_64(), request_count); }
+    };
+
+    struct BinaryProviderStats
+    {
+        std::string provider;
+        // Read providers only
+        BinaryCacheOperationStats restore;
+        BinaryCacheOperationStats precheck;
+        // Write providers only
+        BinaryCacheOperationStats upload;
+    };
+
+    struct BinaryCacheStats
+    {
+        // Parallel to BinaryProviders::read and BinaryProviders::write
+        std::vector<BinaryProviderStats> read;
+        std::vector<BinaryProviderStats> write;
+        BinaryCacheOperationStats compression;
+    };
+
+    // Returns the nearest-rank `percentile` of `samples`, or 0 if there are none.
+    uint64_t latency_percentile(std::vector<uint64_t> samples, double percentile);
+    Json::Object serialize_binary_cache_stats(const BinaryCacheStats& stats);
+
     struct ReadOnlyBinaryCache
     {
         ReadOnlyBinaryCache() = default;
@@ -210,8 +370,28 @@ namespace vcpkg
         // more than once in a single invocation of vcpkg.
         void mark_all_unrestored();
 
+        const BinaryCacheStats& stats() const noexcept { return m_stats; }
+
+        /// If fetch() left the package for `ipa` as an unextracted archive, returns that archive and forgets it. The
+        /// caller becomes responsible for extracting and cleaning up the archive.
+        Optional<RestoredArchive> take_restored_archive(const InstallPlanAction& ipa);
+
     protected:
+        // The destination_id() of each read provider which reported that it does not have the package for `status`
+        std::vector<std::string> missing_from(const CacheStatus& status) const;
+
         BinaryProviders m_config;
+        BinaryCacheStats m_stats;
+
+        // If set, fetch() leaves zip archives unextracted so that they can be extracted straight into the installed
+        // tree
+        bool m_fetch_archives = false;
+        std::unordered_map<std::string, RestoredArchive> m_restored_archives;
+
+        // If set, fetch() keeps the archives packages were restored from so that push_success() can upload them to
+        // the other write providers without compressing the package again
+        bool m_keep_restored_archives = false;
+        std::unordered_map<std::string, RestoredArchive> m_kept_archives;
 
         std::unordered_map<std::string, CacheStatus> m_status;
     };
@@ -271,14 +451,31 @@ namespace vcpkg
         /// Called upon a successful build of `action` to store those contents in the binary cache.
         void push_success(CleanPackages clean_packages, const InstallPlanAction& action);
 
+        /// Submits up to `max_entries` entries of the retry queue to the background thread to be uploaded again to
+        /// the providers they failed for. Entries which are still backing off from a previous failure are skipped
+        /// unless `ignore_backoff`, and entries none of whose providers are still configured are discarded. Nothing
+        /// is submitted if another vcpkg process is draining the queue; if `wait`, waits for it to finish instead.
+        /// Returns the number of entries submitted.
+        size_t submit_queued_retries(size_t max_entries, bool ignore_backoff, bool wait);
+
         void print_updates();
         void wait_for_async_complete_and_join();
 
     private:
+        // Submits `archive`, which `action` was restored from, for upload to the write providers which need zip files
+        // other than the one it came from. Returns false if there are no such providers.
+        bool push_restored_archive(CleanPackages clean_packages,
+                                   const InstallPlanAction& action,
+                                   RestoredArchive&& archive);
+
         struct ActionToPush
         {
             BinaryPackageWriteInfo request;
             CleanPackages clean_after_push;
+            // Set if this action is a retry of an entry in m_retry_queue rather than a fresh build
+            Optional<BinaryCacheRetryEntry> retry_entry;
+            // Set if this action uploads the archive a package was restored from rather than a fresh build
+            Optional<RestoredArchive> restored_archive;
         };
 
         ZipTool m_zip_tool;
@@ -287,6 +484,14 @@ namespace vcpkg
 
         const Filesystem& m_fs;
 
+        Optional<BinaryCacheRetryQueue> m_retry_queue;
+        // Held from the first submission of a queued retry until the background thread has finished
+        std::unique_ptr<IExclusiveFileLock> m_retry_queue_lock;
+        std::set<std::string> m_submitted_retries;
+
+        // Written by wait_for_async_complete_and_join() if --x-binarycache-stats was passed
+        Optional<Path> m_stats_file;
+
         BGMessageSink m_bg_msg_sink;
         BackgroundWorkQueue<ActionToPush> m_actions_to_push;
         BinaryCacheSynchronizer m_synchronizer;
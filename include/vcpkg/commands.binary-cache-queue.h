@@ -0,0 +1,10 @@
+#pragma once
+
+#include <vcpkg/fwd/vcpkgcmdarguments.h>
+#include <vcpkg/fwd/vcpkgpaths.h>
+
+namespace vcpkg
+{
+    extern const CommandMetadata CommandBinaryCacheQueueMetadata;
+    void command_binary_cache_queue_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+}
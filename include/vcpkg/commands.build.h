@@ -272,7 +272,7 @@ namespace vcpkg
         Json::Object heuristic_resources;
     };
 
-    using PortDirAbiInfoCache = Cache<Path, PortDirAbiInfoCacheEntry>;
+    using PortDirAbiInfoCache = Cache<Path, std::shared_ptr<const PortDirAbiInfoCacheEntry>>;
 
     struct CompilerInfo
     {
@@ -285,18 +285,35 @@ namespace vcpkg
     struct AbiInfo
     {
         // These should always be known if an AbiInfo exists
-        std::unique_ptr<PreBuildInfo> pre_build_info;
+        // Shared between the actions of a plan whose triplets and triplet variables are the same
+        std::shared_ptr<const PreBuildInfo> pre_build_info;
         Optional<const Toolset&> toolset;
         // These might not be known if compiler tracking is turned off or the port is --editable
         Optional<const CompilerInfo&> compiler_info;
         Optional<const std::string&> triplet_abi;
         std::string package_abi;
         Optional<Path> abi_tag_file;
-        std::vector<Path> relative_port_files;
-        std::vector<std::string> relative_port_hashes;
-        std::vector<Json::Object> heuristic_resources;
+        // The port files, their hashes, and the SBOM resources, shared between the actions built from the same port
+        // directory. Only known with package_abi.
+        std::shared_ptr<const PortDirAbiInfoCacheEntry> port_dir_info;
     };
 
+    // An estimate of the heap memory held by the install actions of a plan
+    struct ActionPlanMemoryUsage
+    {
+        size_t install_actions = 0;
+        size_t action_bytes = 0;
+        // Data shared between actions is counted once, however many actions share it
+        size_t pre_build_infos = 0;
+        size_t port_dirs = 0;
+        size_t dependency_lists = 0;
+        size_t shared_bytes = 0;
+
+        std::string to_string() const;
+    };
+
+    ActionPlanMemoryUsage estimate_memory_usage(const ActionPlan& action_plan);
+
     void compute_all_abis(const VcpkgPaths& paths,
                           ActionPlan& action_plan,
                           const CMakeVars::CMakeVarProvider& var_provider,
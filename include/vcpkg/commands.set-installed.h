@@ -7,6 +7,7 @@
 #include <vcpkg/fwd/cmakevars.h>
 #include <vcpkg/fwd/commands.install.h>
 #include <vcpkg/fwd/dependencies.h>
+#include <vcpkg/fwd/installplancache.h>
 #include <vcpkg/fwd/statusparagraphs.h>
 #include <vcpkg/fwd/triplet.h>
 #include <vcpkg/fwd/vcpkgcmdarguments.h>
@@ -42,7 +43,8 @@ namespace vcpkg
                                            DryRun dry_run,
                                            PrintUsage print_usage,
                                            const Optional<Path>& maybe_pkgconfig,
-                                           bool include_manifest_in_github_issue);
+                                           bool include_manifest_in_github_issue,
+                                           InstallPlanCache* install_plan_cache);
     void command_set_installed_and_exit(const VcpkgCmdArguments& args,
                                         const VcpkgPaths& paths,
                                         Triplet default_triplet,
@@ -6,13 +6,17 @@
 #include <vcpkg/fwd/portfileprovider.h>
 
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/shared-vector.h>
 
 #include <vcpkg/commands.build.h>
 #include <vcpkg/packagespec.h>
 #include <vcpkg/statusparagraph.h>
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace vcpkg
@@ -26,10 +30,12 @@ namespace vcpkg
         PackageSpec spec;
     };
 
+    // The dependency and feature lists of actions are often equal, such as for the many ports that only depend on
+    // the same host tools, so a plan's actions share equal lists; see ActionPlan::share_dependency_lists
     struct PackageAction : BasicAction
     {
-        std::vector<PackageSpec> package_dependencies;
-        InternalFeatureSet feature_list;
+        SharedVector<PackageSpec> package_dependencies;
+        SharedVector<std::string> feature_list;
     };
 
     struct InstallPlanAction : PackageAction
@@ -70,7 +76,7 @@ namespace vcpkg
         UseHeadVersion use_head_version;
         Editable editable;
 
-        std::map<std::string, std::vector<FeatureSpec>> feature_dependencies;
+        std::map<std::string, SharedVector<FeatureSpec>> feature_dependencies;
         std::vector<LocalizedString> build_failure_messages;
 
         // only valid with source_control_file_and_location
@@ -101,6 +107,8 @@ namespace vcpkg
         bool empty() const { return remove_actions.empty() && already_installed.empty() && install_actions.empty(); }
         size_t size() const { return remove_actions.size() + already_installed.size() + install_actions.size(); }
         void print_unsupported_warnings();
+        // Makes the actions with equal dependency or feature lists refer to one copy of each list
+        void share_dependency_lists();
 
         std::vector<RemovePlanAction> remove_actions;
         std::vector<InstallPlanAction> already_installed;
@@ -129,6 +137,54 @@ namespace vcpkg
         Optional<InstalledPackageView> m_installed_package;
     };
 
+    // Numbers the packages of a plan densely, in the order they are added, so that a graph can keep the state of each
+    // package in an array indexed by its number, and find a package with one hash of its spec rather than a series of
+    // PackageSpec comparisons down a std::map.
+    struct PackageIds
+    {
+        // Returns the number of `spec`, and whether it was newly assigned
+        std::pair<std::size_t, bool> add(const PackageSpec& spec)
+        {
+            auto inserted = m_ids.emplace(spec, m_ids.size());
+            return {inserted.first->second, inserted.second};
+        }
+
+        Optional<std::size_t> find(const PackageSpec& spec) const
+        {
+            auto it = m_ids.find(spec);
+            if (it == m_ids.end())
+            {
+                return nullopt;
+            }
+
+            return it->second;
+        }
+
+        std::size_t size() const noexcept { return m_ids.size(); }
+
+    private:
+        std::unordered_map<PackageSpec, std::size_t> m_ids;
+    };
+
+    // Work that planning repeats for every plan built from the same ports: loaded manifests, the parsed versions and
+    // resolved platform contexts of packages, and the dependency edges of each port feature after platform filtering.
+    // Commands that build many similar plans, such as `ci` and `x-test-features`, pass one context to all of them
+    // through CreateInstallPlanOptions::resolution_context. A context must only be used with one set of port
+    // providers, one CMakeVarProvider, and one host triplet, none of which it may outlive.
+    struct ResolutionContext
+    {
+        ResolutionContext();
+        ResolutionContext(const ResolutionContext&) = delete;
+        ResolutionContext& operator=(const ResolutionContext&) = delete;
+        ~ResolutionContext();
+
+        struct Impl;
+        Impl& impl() const noexcept { return *m_impl; }
+
+    private:
+        std::unique_ptr<Impl> m_impl;
+    };
+
     struct CreateInstallPlanOptions
     {
         CreateInstallPlanOptions(GraphRandomizer* randomizer,
@@ -149,6 +205,8 @@ namespace vcpkg
         UnsupportedPortAction unsupported_port_action;
         UseHeadVersion use_head_version_if_user_requested;
         Editable editable_if_user_requested;
+        // If set, shared with other plans built from the same providers rather than recomputed
+        ResolutionContext* resolution_context = nullptr;
     };
 
     struct CreateUpgradePlanOptions
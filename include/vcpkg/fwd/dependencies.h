@@ -38,6 +38,7 @@ namespace vcpkg
     struct ActionPlan;
     struct ExportPlanAction;
     struct CreateInstallPlanOptions;
+    struct ResolutionContext;
     struct RemovePlan;
     struct FormattedPlan;
     struct StatusParagraphs;
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace vcpkg
+{
+    struct InstallPlanWatchedFile;
+    struct InstallPlanRecordAction;
+    struct InstallPlanRecord;
+    struct InstallPlanCache;
+}
@@ -10,6 +10,7 @@ namespace vcpkg
     struct VersionSpecHasher;
     struct DotVersion;
     struct DateVersion;
+    struct VersionKey;
     struct ParsedExternalVersion;
 
     enum class VerComp
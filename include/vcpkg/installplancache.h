@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vcpkg/base/fwd/files.h>
+
+#include <vcpkg/fwd/dependencies.h>
+#include <vcpkg/fwd/installplancache.h>
+#include <vcpkg/fwd/statusparagraphs.h>
+#include <vcpkg/fwd/vcpkgcmdarguments.h>
+#include <vcpkg/fwd/vcpkgpaths.h>
+
+#include <vcpkg/base/binary-records.h>
+#include <vcpkg/base/optional.h>
+#include <vcpkg/base/path.h>
+#include <vcpkg/base/stringview.h>
+
+#include <vcpkg/packagespec.h>
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace vcpkg
+{
+    // A file or directory whose last write time and size are compared rather than hashing its contents
+    struct InstallPlanWatchedFile
+    {
+        Path path;
+        int64_t last_write_time;
+        uint64_t size;
+    };
+
+    struct InstallPlanRecordAction
+    {
+        PackageSpec spec;
+        std::string package_abi;
+        bool user_requested;
+    };
+
+    // A resolved manifest mode install plan, along with what it was resolved from: `inputs_hash` covers the command
+    // line, manifest, configuration, and environment, `watched_files` the ports, triplets, scripts, and tools, and
+    // `tracked_environment` the SHA-256 of each environment variable the triplets pass through into ABIs, or an empty
+    // string if it was unset.
+    struct InstallPlanRecord
+    {
+        std::string inputs_hash;
+        std::vector<InstallPlanWatchedFile> watched_files;
+        std::vector<std::pair<std::string, std::string>> tracked_environment;
+        std::vector<InstallPlanRecordAction> actions;
+
+        std::string serialize() const;
+        // Returns nullopt if `payload` is truncated or malformed
+        static Optional<InstallPlanRecord> parse(StringView payload);
+
+        // Whether every watched file still has the same last write time and size, and every tracked environment
+        // variable the same value
+        bool inputs_unchanged(const Filesystem& fs) const;
+        // Whether exactly the packages in `actions` are installed, each with the recorded ABI
+        bool is_installed(const StatusParagraphs& status_db) const;
+    };
+
+    // Remembers the plan of the last successful manifest mode install in installed/vcpkg/, so that running the same
+    // install again can confirm that nothing needs to change without resolving versions, running CMake to load
+    // triplet variables, or computing ABIs.
+    struct InstallPlanCache
+    {
+        InstallPlanCache(const VcpkgCmdArguments& args,
+                         const VcpkgPaths& paths,
+                         Triplet default_triplet,
+                         Triplet host_triplet);
+
+        // If the remembered plan has the same inputs and is exactly what is installed, returns the packages the
+        // manifest requested, whose usage should be printed
+        Optional<std::vector<PackageSpec>> find_up_to_date(const StatusParagraphs& status_db) const;
+
+        // Captures `action_plan`, whose ABIs must already be computed, and the state of everything it was resolved
+        // from; save() then remembers it once it has been installed. Plans with unknown ABIs are never remembered.
+        void capture(const ActionPlan& action_plan);
+        void save() const;
+
+    private:
+        const VcpkgPaths* m_paths;
+        std::string m_key;
+        std::string m_inputs_hash;
+        BinaryRecordFile m_file;
+        Optional<InstallPlanRecord> m_captured;
+    };
+}
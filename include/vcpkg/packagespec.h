@@ -7,7 +7,9 @@
 #include <vcpkg/fwd/packagespec.h>
 
 #include <vcpkg/base/expected.h>
+#include <vcpkg/base/interned-string.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/span.h>
 #include <vcpkg/base/unicode.h>
 
 #include <vcpkg/platform-expression.h>
@@ -27,12 +29,13 @@ namespace vcpkg
     struct PackageSpec
     {
         PackageSpec() = default;
-        PackageSpec(const std::string& name, Triplet triplet) : m_name(name), m_triplet(triplet) { }
-        PackageSpec(std::string&& name, Triplet triplet) : m_name(std::move(name)), m_triplet(triplet) { }
+        PackageSpec(StringView name, Triplet triplet) : m_name(name), m_triplet(triplet) { }
+        PackageSpec(InternedString name, Triplet triplet) : m_name(name), m_triplet(triplet) { }
 
-        const std::string& name() const;
+        const std::string& name() const { return m_name.str(); }
+        InternedString interned_name() const { return m_name; }
 
-        Triplet triplet() const;
+        Triplet triplet() const { return m_triplet; }
 
         std::string dir() const;
 
@@ -41,13 +44,12 @@ namespace vcpkg
 
         bool operator<(const PackageSpec& other) const
         {
-            if (name() < other.name()) return true;
-            if (name() > other.name()) return false;
+            if (m_name != other.m_name) return m_name < other.m_name;
             return triplet() < other.triplet();
         }
 
     private:
-        std::string m_name;
+        InternedString m_name;
         Triplet m_triplet;
     };
 
@@ -62,13 +64,12 @@ namespace vcpkg
     ///
     struct FeatureSpec
     {
-        FeatureSpec(const PackageSpec& spec, StringView feature)
-            : m_spec(spec), m_feature(feature.data(), feature.size())
-        {
-        }
+        FeatureSpec(const PackageSpec& spec, StringView feature) : m_spec(spec), m_feature(feature) { }
+        FeatureSpec(const PackageSpec& spec, InternedString feature) : m_spec(spec), m_feature(feature) { }
 
         const std::string& port() const { return m_spec.name(); }
-        const std::string& feature() const { return m_feature; }
+        const std::string& feature() const { return m_feature.str(); }
+        InternedString interned_feature() const { return m_feature; }
         Triplet triplet() const { return m_spec.triplet(); }
 
         const PackageSpec& spec() const { return m_spec; }
@@ -78,23 +79,25 @@ namespace vcpkg
 
         bool operator<(const FeatureSpec& other) const
         {
-            if (port() < other.port()) return true;
-            if (port() > other.port()) return false;
-            if (feature() < other.feature()) return true;
-            if (feature() > other.feature()) return false;
+            if (m_spec.interned_name() != other.m_spec.interned_name())
+            {
+                return m_spec.interned_name() < other.m_spec.interned_name();
+            }
+
+            if (m_feature != other.m_feature) return m_feature < other.m_feature;
             return triplet() < other.triplet();
         }
 
         bool operator==(const FeatureSpec& other) const
         {
-            return triplet() == other.triplet() && port() == other.port() && feature() == other.feature();
+            return m_spec == other.m_spec && m_feature == other.m_feature;
         }
 
         bool operator!=(const FeatureSpec& other) const { return !(*this == other); }
 
     private:
         PackageSpec m_spec;
-        std::string m_feature;
+        InternedString m_feature;
     };
 
     std::string format_name_only_feature_spec(StringView package_name, StringView feature_name);
@@ -145,10 +148,17 @@ namespace vcpkg
     struct InternalFeatureSet : std::vector<std::string>
     {
         using std::vector<std::string>::vector;
+        explicit InternalFeatureSet(View<std::string> features)
+            : std::vector<std::string>(features.begin(), features.end())
+        {
+        }
 
         bool empty_or_only_core() const;
     };
 
+    // Whether `features` names no features, or only "core"
+    bool empty_or_only_core(View<std::string> features);
+
     InternalFeatureSet internalize_feature_list(View<Located<std::string>> fs, ImplicitDefault id);
 
     ///
@@ -230,7 +240,7 @@ struct std::hash<vcpkg::PackageSpec>
     size_t operator()(const vcpkg::PackageSpec& value) const
     {
         size_t hash = 17;
-        hash = hash * 31 + std::hash<std::string>()(value.name());
+        hash = hash * 31 + value.interned_name().hash_code();
         hash = hash * 31 + std::hash<vcpkg::Triplet>()(value.triplet());
         return hash;
     }
@@ -242,7 +252,7 @@ struct std::hash<vcpkg::FeatureSpec>
     size_t operator()(const vcpkg::FeatureSpec& value) const
     {
         size_t hash = std::hash<vcpkg::PackageSpec>()(value.spec());
-        hash = hash * 31 + std::hash<std::string>()(value.feature());
+        hash = hash * 31 + value.interned_feature().hash_code();
         return hash;
     }
 };
@@ -1,14 +1,21 @@
 #pragma once
 
 #include <vcpkg/base/fwd/expected.h>
+#include <vcpkg/base/fwd/files.h>
+#include <vcpkg/base/fwd/message_sinks.h>
 #include <vcpkg/base/fwd/stringview.h>
 
 #include <vcpkg/fwd/binaryparagraph.h>
 #include <vcpkg/fwd/paragraphparser.h>
+#include <vcpkg/fwd/paragraphs.h>
 #include <vcpkg/fwd/registries.h>
 
+#include <vcpkg/base/binary-records.h>
+
 #include <vcpkg/sourceparagraph.h>
 
+#include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -33,25 +40,65 @@ namespace vcpkg::Paragraphs
         std::string on_disk_contents;
     };
 
+    // Parsed port manifests from earlier runs, kept in `cache_file` and keyed by the SHA-256 of the manifest text, so
+    // that later runs skip parsing and validating unchanged manifests. Manifests that produce warnings are never
+    // recorded, so that the warnings are printed every time they're loaded. Safe to use from several threads.
+    struct ParsedManifestCache
+    {
+        ParsedManifestCache(const Filesystem& fs, const Path& cache_file);
+
+        std::unique_ptr<SourceControlFile> find(StringView key) const;
+        void add(StringView key, std::string&& payload) const;
+
+    private:
+        BinaryRecordFile m_file;
+        mutable std::mutex m_mtx;
+        mutable bool m_loaded = false;
+        mutable std::map<std::string, std::string, std::less<>> m_records;
+    };
+
+    // The sink that warnings from loading ports on the calling thread are printed to: out_sink, unless a
+    // PortWarningRedirect is active on this thread.
+    MessageSink& port_warning_sink();
+
+    // Sends the warnings from loading ports on this thread to `sink` while in scope, so that ports loaded in parallel
+    // can report their warnings in port order once all of them are loaded.
+    struct PortWarningRedirect
+    {
+        explicit PortWarningRedirect(MessageSink& sink);
+        PortWarningRedirect(const PortWarningRedirect&) = delete;
+        PortWarningRedirect& operator=(const PortWarningRedirect&) = delete;
+        ~PortWarningRedirect();
+
+    private:
+        MessageSink* m_previous;
+    };
+
+    // `manifest_cache` may be nullptr to always parse manifests.
     // If an error occurs, the Expected will be in the error state.
     // Otherwise, if the port is known, the maybe_scfl.get()->source_control_file contains the loaded port information.
     // Otherwise, maybe_scfl.get()->source_control_file is nullptr.
-    PortLoadResult try_load_port(const ReadOnlyFilesystem& fs, const PortLocation& port_location);
+    PortLoadResult try_load_port(const ReadOnlyFilesystem& fs,
+                                 const PortLocation& port_location,
+                                 const ParsedManifestCache* manifest_cache);
     // Identical to try_load_port, but the port unknown condition is mapped to an error.
     PortLoadResult try_load_port_required(const ReadOnlyFilesystem& fs,
                                           StringView port_name,
-                                          const PortLocation& port_location);
+                                          const PortLocation& port_location,
+                                          const ParsedManifestCache* manifest_cache);
     std::string builtin_port_spdx_location(StringView port_name);
     std::string builtin_git_tree_spdx_location(StringView git_tree);
     PortLoadResult try_load_builtin_port_required(const ReadOnlyFilesystem& fs,
                                                   StringView port_name,
-                                                  const Path& builtin_ports_directory);
+                                                  const Path& builtin_ports_directory,
+                                                  const ParsedManifestCache* manifest_cache);
     ExpectedL<std::unique_ptr<SourceControlFile>> try_load_project_manifest_text(StringView text,
                                                                                  StringView control_path,
                                                                                  MessageSink& warning_sink);
     ExpectedL<std::unique_ptr<SourceControlFile>> try_load_port_manifest_text(StringView text,
                                                                               StringView control_path,
-                                                                              MessageSink& warning_sink);
+                                                                              MessageSink& warning_sink,
+                                                                              const ParsedManifestCache* manifest_cache);
     ExpectedL<std::unique_ptr<SourceControlFile>> try_load_control_file_text(StringView text, StringView control_path);
 
     ExpectedL<BinaryControlFile> try_load_cached_package(const ReadOnlyFilesystem& fs,
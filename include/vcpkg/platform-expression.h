@@ -3,9 +3,12 @@
 #include <vcpkg/base/expected.h>
 #include <vcpkg/base/stringview.h>
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace vcpkg::PlatformExpression
@@ -17,6 +20,29 @@ namespace vcpkg::PlatformExpression
     {
         struct ExprImpl;
     }
+
+    struct Expr;
+    struct ResolvedContext;
+
+    // Looks up the value of every built-in identifier, and any VCPKG_DEP_INFO_OVERRIDE_VARS, in `context`.
+    // Evaluating expressions against the result needs no map lookups, so resolve a context once when evaluating many
+    // expressions for the same package.
+    ResolvedContext resolve_context(const Context& context);
+
+    struct ResolvedContext
+    {
+    private:
+        ResolvedContext() = default;
+        friend Expr;
+        friend ResolvedContext resolve_context(const Context& context);
+
+        // bit N holds the value of built-in identifier N
+        uint32_t identifiers = 0;
+        bool has_native = false;
+        // overrides of identifiers which are not built in
+        std::vector<std::pair<std::string, bool>> other_overrides;
+    };
+
     struct Expr
     {
         static Expr Identifier(StringView id);
@@ -35,6 +61,7 @@ namespace vcpkg::PlatformExpression
         ~Expr();
 
         bool evaluate(const Context& context) const;
+        bool evaluate(const ResolvedContext& context) const;
         bool is_empty() const { return !static_cast<bool>(underlying_); }
 
         // returns:
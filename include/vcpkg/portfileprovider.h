@@ -55,6 +55,11 @@ namespace vcpkg
         OverlayPortKind determine_kind(const ReadOnlyFilesystem& fs);
         const ExpectedL<SourceControlFileAndLocation>* try_load_port_cached_port(StringView port_name);
 
+        // Loads the overlay-port in the subdirectory `port_name` without touching the cache; safe to call concurrently.
+        // Returns nullopt if there is no port there.
+        Optional<ExpectedL<SourceControlFileAndLocation>> load_port_subdirectory(const ReadOnlyFilesystem& fs,
+                                                                                 StringView port_name) const;
+
         MapT::iterator try_load_port_subdirectory_uncached(MapT::iterator hint,
                                                            const ReadOnlyFilesystem& fs,
                                                            StringView port_name);
@@ -88,6 +93,10 @@ namespace vcpkg
 
         virtual ExpectedL<const SourceControlFileAndLocation&> get_control_file(
             const VersionSpec& version_spec) const = 0;
+
+        // Hints that `version_specs` will be requested soon, so that their manifests can be loaded together rather
+        // than one at a time. Failures to load are reported by get_control_file.
+        virtual void prefetch(View<VersionSpec> version_specs) const;
     };
 
     struct IFullVersionedPortfileProvider : IVersionedPortfileProvider
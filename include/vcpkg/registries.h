@@ -61,6 +61,8 @@ namespace vcpkg
         virtual ~RegistryEntry() = default;
     };
 
+    // get_port_entry, get_baseline_version and try_load_port on the returned entries are safe to call from several
+    // threads at once, except on git registries (kind() == "git"), which may fetch and update the shared lock file.
     struct RegistryImplementation
     {
         virtual StringLiteral kind() const = 0;
@@ -7,6 +7,7 @@
 #include <vcpkg/fwd/packagespec.h>
 #include <vcpkg/fwd/vcpkgcmdarguments.h>
 
+#include <vcpkg/base/expected.h>
 #include <vcpkg/base/json.h>
 #include <vcpkg/base/path.h>
 #include <vcpkg/base/stringview.h>
@@ -15,6 +16,10 @@
 #include <vcpkg/platform-expression.h>
 #include <vcpkg/versions.h>
 
+#include <functional>
+#include <memory>
+#include <mutex>
+
 namespace vcpkg
 {
     struct ManifestAndPath
@@ -220,10 +225,32 @@ namespace vcpkg
 
     Json::Object serialize_manifest(const SourceControlFile& scf);
 
+    // Encodes `scf` for the on-disk cache of parsed manifests. Returns nullopt if some part of it would not read
+    // back exactly, such as a platform expression that doesn't survive printing.
+    Optional<std::string> serialize_binary_source_control_file(const SourceControlFile& scf);
+    // Returns nullptr if `data` is damaged or was not produced by serialize_binary_source_control_file.
+    std::unique_ptr<SourceControlFile> deserialize_binary_source_control_file(StringView data);
+
     ExpectedL<ManifestConfiguration> parse_manifest_configuration(const Json::Object& manifest,
                                                                   StringView origin,
                                                                   MessageSink& warningsSink);
 
+    /// The directory of a port whose manifest was read without extracting the rest of its files, such as a historical
+    /// version read from git. The files are extracted the first time the directory is used.
+    struct DeferredPortDirectory
+    {
+        explicit DeferredPortDirectory(std::function<ExpectedL<Path>()>&& extract);
+        DeferredPortDirectory(const DeferredPortDirectory&) = delete;
+        DeferredPortDirectory& operator=(const DeferredPortDirectory&) = delete;
+
+        // Extracts the port's files if that has not happened yet. A failed extraction is retried by the next call.
+        ExpectedL<Unit> ensure_extracted();
+
+    private:
+        std::mutex m_mutex;
+        std::function<ExpectedL<Path>()> m_extract;
+    };
+
     /// <summary>
     /// Named pair of a SourceControlFile and the location of this file
     /// </summary>
@@ -234,8 +261,12 @@ namespace vcpkg
         VersionScheme scheme() const { return source_control_file->core_paragraph->version_scheme; }
         SchemedVersion schemed_version() const { return {scheme(), to_version()}; }
         VersionSpec to_version_spec() const { return source_control_file->to_version_spec(); }
+        // The directory of the port, which may not have been extracted yet; see extract_port_directory()
         Path port_directory() const { return control_path.parent_path(); }
 
+        // Returns port_directory() once the port's files are in it, extracting them first if necessary
+        ExpectedL<Path> extract_port_directory() const;
+
         SourceControlFileAndLocation clone() const
         {
             std::unique_ptr<SourceControlFile> scf;
@@ -244,7 +275,8 @@ namespace vcpkg
                 scf = std::make_unique<SourceControlFile>(source_control_file->clone());
             }
 
-            return SourceControlFileAndLocation{std::move(scf), control_path, spdx_location, kind};
+            return SourceControlFileAndLocation{
+                std::move(scf), control_path, spdx_location, kind, deferred_port_directory};
         }
 
         std::unique_ptr<SourceControlFile> source_control_file;
@@ -255,6 +287,10 @@ namespace vcpkg
         std::string spdx_location;
 
         PortSourceKind kind = PortSourceKind::Unknown;
+
+        /// If set, control_path has been read but the rest of the port directory is only extracted when
+        /// extract_port_directory() is first called. Shared between clones.
+        std::shared_ptr<DeferredPortDirectory> deferred_port_directory;
     };
 
     void print_error_message(const LocalizedString& message);
@@ -36,6 +36,8 @@ namespace vcpkg
         static constexpr StringLiteral PYTHON3_WITH_VENV = "python3_with_venv";
     }
 
+    // Lookups are safe to call from several threads. The first lookup of a tool finds or downloads it while holding
+    // the cache's lock, and exits if the tool can't be provided; later lookups of any tool wait for it.
     struct ToolCache
     {
         virtual ~ToolCache() = default;
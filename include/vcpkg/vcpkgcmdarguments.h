@@ -236,6 +236,7 @@ namespace vcpkg
 
         std::vector<std::string> cli_binary_sources;
         Optional<std::string> env_binary_sources;
+        Optional<std::string> binary_cache_stats_file;
         Optional<std::string> nuget_id_prefix;
         Optional<bool> use_nuget_cache;
         Optional<std::string> vcpkg_nuget_repository;
@@ -252,6 +253,8 @@ namespace vcpkg
         std::vector<std::string> cmake_args;
 
         Optional<bool> exact_abi_tools_versions;
+        // Extract zip archives restored from binary caches directly into the installed tree
+        Optional<bool> restore_into_installed;
 
         Optional<bool> debug = nullopt;
         Optional<bool> debug_env = nullopt;
@@ -12,6 +12,7 @@
 #include <vcpkg/fwd/configuration.h>
 #include <vcpkg/fwd/installedpaths.h>
 #include <vcpkg/fwd/packagespec.h>
+#include <vcpkg/fwd/paragraphs.h>
 #include <vcpkg/fwd/registries.h>
 #include <vcpkg/fwd/sourceparagraph.h>
 #include <vcpkg/fwd/tools.h>
@@ -90,6 +91,8 @@ namespace vcpkg
         const Path& downloads;
         const Path& tools;
         const Path builtin_registry_versions;
+        // Port manifests parsed by earlier runs, shared between vcpkg roots like the other registries caches
+        const Paragraphs::ParsedManifestCache& parsed_manifest_cache() const;
         ExpectedL<Path> versions_dot_git_dir() const;
         const Path prefab;
         const Path buildsystems;
@@ -114,11 +117,16 @@ namespace vcpkg
         const std::string& get_tool_version(StringView tool, MessageSink& status_messages) const;
 
         Command git_cmd_builder(const Path& dot_git_dir, const Path& work_tree) const;
+        // Returns the `git cat-file` coprocesses which read objects from `dot_git_dir`, starting them on first use.
+        // Safe to call from several threads.
+        GitObjectReader& git_object_reader(const Path& dot_git_dir) const;
 
         // Git manipulation in the vcpkg directory
         ExpectedL<std::string> get_current_git_sha() const;
         LocalizedString get_current_git_sha_baseline_message() const;
         ExpectedL<Path> git_checkout_port(StringView port_name, StringView git_tree, const Path& dot_git_dir) const;
+        // Returns the directory git_checkout_port() checks `git_tree` out into, without checking it out
+        Path git_checkout_port_directory(StringView port_name, StringView git_tree) const;
         ExpectedL<std::string> git_show(StringView treeish, const Path& dot_git_dir) const;
         Optional<std::vector<GitLSTreeEntry>> get_builtin_ports_directory_trees(DiagnosticContext& context) const;
 
@@ -133,6 +141,9 @@ namespace vcpkg
                                                                            const Path& relative_path_to_file) const;
         ExpectedL<Unit> git_read_tree(const Path& destination, StringView tree, const Path& dot_git_dir) const;
         ExpectedL<Path> git_extract_tree_from_remote_registry(StringView tree) const;
+        // Returns the directory git_extract_tree_from_remote_registry() extracts `tree` into, without extracting it
+        Path git_tree_directory_from_remote_registry(StringView tree) const;
+        GitObjectReader& git_object_reader_for_remote_registry() const;
 
         Optional<const ManifestAndPath&> get_manifest() const;
         bool manifest_mode_enabled() const;
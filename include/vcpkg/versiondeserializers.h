@@ -20,6 +20,27 @@ namespace vcpkg
                                                   Json::Reader& r,
                                                   const Json::Object& obj);
 
+    // Collects the versioning fields of an object read with Json::StreamReader. Accepts exactly the objects that
+    // visit_required_schemed_version accepts without errors, and produces the same SchemedVersion.
+    struct StreamedSchemedVersion
+    {
+        // Reads the value of the member `key` and returns true if `key` is a versioning field; otherwise returns
+        // false without reading anything.
+        bool read_field(Json::StreamReader& reader, StringView key);
+        // Returns nullopt if the fields read were not a valid version
+        Optional<SchemedVersion> finish();
+
+    private:
+        Optional<VersionScheme> m_scheme;
+        std::string m_text;
+        Optional<int> m_port_version;
+        bool m_invalid = false;
+    };
+
+    // Reads the object baseline_version_tag_deserializer deserializes, returning false if it isn't one which
+    // baseline_version_tag_deserializer accepts without errors.
+    bool stream_baseline_version_tag(Json::StreamReader& reader, Version& version);
+
     Version visit_version_override_version(const LocalizedString& parent_type,
                                            Json::Reader& r,
                                            const Json::Object& obj);
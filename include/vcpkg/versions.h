@@ -142,6 +142,27 @@ namespace vcpkg
 
     VerComp compare(const DateVersion& a, const DateVersion& b);
 
+    // A SchemedVersion parsed once into the parts that order it, for callers that compare the same versions many
+    // times. compare(VersionKey, VersionKey) agrees with compare_versions without reparsing any text.
+    struct VersionKey
+    {
+        VersionKey() noexcept { } // intentionally disable making this type an aggregate
+
+        VersionScheme scheme = VersionScheme::Missing;
+        int port_version = 0;
+        // semver and relaxed: the dotted numbers
+        // date: the date as the number yyyymmdd, followed by the dotted numbers after it
+        std::vector<uint64_t> numbers;
+        // semver and relaxed: the prerelease identifiers without the leading '-', or empty if there are none
+        // string: the whole version text
+        std::string text;
+
+        static ExpectedL<VersionKey> try_parse(VersionScheme scheme, const Version& version);
+        static ExpectedL<VersionKey> try_parse(const SchemedVersion& version);
+    };
+
+    VerComp compare(const VersionKey& a, const VersionKey& b);
+
     // Try parsing with all version schemas and return 'unk' if none match
     VerComp compare_any(const Version& a, const Version& b);
 
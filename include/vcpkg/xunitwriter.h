@@ -5,6 +5,7 @@
 #include <vcpkg/fwd/triplet.h>
 
 #include <vcpkg/base/chrono.h>
+#include <vcpkg/base/shared-vector.h>
 
 #include <chrono>
 #include <map>
@@ -27,7 +28,7 @@ namespace vcpkg
                               const ElapsedTime& elapsed_time,
                               const std::chrono::system_clock::time_point& start_time,
                               const std::string& abi_tag,
-                              const std::vector<std::string>& features);
+                              const SharedVector<std::string>& features);
 
         std::string build_xml(Triplet controlling_triplet) const;
 
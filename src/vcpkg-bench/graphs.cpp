@@ -0,0 +1,108 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/graphs.h>
+#include <vcpkg/base/span.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/packagespec.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace vcpkg;
+
+namespace
+{
+    // A graph of `vertex_count` packages named like the synthetic registry's ports, where each package depends on
+    // `fan_out` lower numbered packages
+    struct SyntheticGraph
+    {
+        SyntheticGraph(std::size_t vertex_count, std::size_t fan_out)
+        {
+            for (std::size_t vertex = 0; vertex < vertex_count; ++vertex)
+            {
+                specs.emplace_back("port-" + std::to_string(vertex), Test::X64_WINDOWS);
+                for (std::size_t i = 1; i <= fan_out && i <= vertex; ++i)
+                {
+                    edges.emplace_back(vertex, (vertex * 7 + i * 13) % vertex);
+                }
+            }
+        }
+
+        std::vector<PackageSpec> specs;
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+    };
+
+    // The topological sort the plan builders used before AdjacencyArrays, kept as a baseline: vertices are
+    // PackageSpecs, adjacency lists are copied out of a hash map, and the depth first search recurses. The synthetic
+    // graph only has edges to lower numbered packages, so there is no cycle to report.
+    struct MapKeyedGraph
+    {
+        explicit MapKeyedGraph(const SyntheticGraph& graph)
+        {
+            for (auto&& spec : graph.specs)
+            {
+                adjacent.emplace(spec, std::vector<PackageSpec>{});
+            }
+
+            for (auto&& edge : graph.edges)
+            {
+                adjacent[graph.specs[edge.first]].push_back(graph.specs[edge.second]);
+            }
+        }
+
+        std::vector<PackageSpec> topological_sort(const std::vector<PackageSpec>& starting_vertices) const
+        {
+            std::vector<PackageSpec> sorted;
+            std::unordered_map<PackageSpec, ExplorationStatus> exploration_status;
+            for (auto&& vertex : starting_vertices)
+            {
+                visit(vertex, exploration_status, sorted);
+            }
+
+            return sorted;
+        }
+
+        std::unordered_map<PackageSpec, std::vector<PackageSpec>> adjacent;
+
+    private:
+        void visit(const PackageSpec& vertex,
+                   std::unordered_map<PackageSpec, ExplorationStatus>& exploration_status,
+                   std::vector<PackageSpec>& sorted) const
+        {
+            ExplorationStatus& status = exploration_status[vertex];
+            if (status != ExplorationStatus::NOT_EXPLORED)
+            {
+                return;
+            }
+
+            status = ExplorationStatus::PARTIALLY_EXPLORED;
+            const auto neighbours = Util::copy_or_default(adjacent, vertex);
+            for (auto&& neighbour : neighbours)
+            {
+                visit(neighbour, exploration_status, sorted);
+            }
+
+            sorted.push_back(vertex);
+            exploration_status[vertex] = ExplorationStatus::FULLY_EXPLORED;
+        }
+    };
+}
+
+TEST_CASE ("topological sort", "[graphs]")
+{
+    const SyntheticGraph graph{10000, 8};
+    const MapKeyedGraph map_keyed{graph};
+    const auto arrays = AdjacencyArrays::from_edges(graph.specs.size(), graph.edges);
+    std::vector<std::size_t> all_vertices(graph.specs.size());
+    for (std::size_t vertex = 0; vertex < all_vertices.size(); ++vertex)
+    {
+        all_vertices[vertex] = vertex;
+    }
+
+    BENCHMARK("map keyed (baseline)") { return map_keyed.topological_sort(graph.specs).size(); };
+    BENCHMARK("AdjacencyArrays") { return topological_sort(arrays, all_vertices, nullptr).sorted.size(); };
+    BENCHMARK("AdjacencyArrays::from_edges") { return AdjacencyArrays::from_edges(graph.specs.size(), graph.edges); };
+}
@@ -0,0 +1,24 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/system.h>
+
+using namespace vcpkg;
+
+TEST_CASE ("JSON parse", "[json]")
+{
+    StringView json =
+#include "../vcpkg-test/large-json-document.json.inc"
+        ;
+
+    BENCHMARK("Json::parse") { return Json::parse(json, "test").has_value(); };
+
+    // Set VCPKG_BENCHMARK_BASELINE to a baseline.json, such as $VCPKG_ROOT/versions/baseline.json, to also measure it
+    auto maybe_baseline_path = get_environment_variable("VCPKG_BENCHMARK_BASELINE");
+    if (auto baseline_path = maybe_baseline_path.get())
+    {
+        const auto baseline = real_filesystem.read_contents(*baseline_path, VCPKG_LINE_INFO);
+        BENCHMARK("Json::parse baseline.json") { return Json::parse(baseline, "baseline").has_value(); };
+    }
+}
@@ -0,0 +1,90 @@
+#define CATCH_CONFIG_RUNNER
+#include <vcpkg-bench/allocations.h>
+
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/system.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <new>
+
+namespace
+{
+    // Each block starts with its size, so that operator delete can account for it
+    constexpr size_t block_header_size = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static_assert(block_header_size >= sizeof(size_t), "the block header must hold the block size");
+
+    std::atomic<size_t> g_current_bytes{0};
+    std::atomic<size_t> g_peak_bytes{0};
+    std::atomic<size_t> g_allocation_count{0};
+}
+
+void* operator new(size_t size)
+{
+    auto block = static_cast<char*>(::malloc(size + block_header_size));
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+
+    ::memcpy(block, &size, sizeof(size_t));
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    const auto current = g_current_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak = g_peak_bytes.load(std::memory_order_relaxed);
+    while (peak < current && !g_peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+    {
+    }
+
+    return block + block_header_size;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr)
+    {
+        auto block = static_cast<char*>(ptr) - block_header_size;
+        size_t size;
+        ::memcpy(&size, block, sizeof(size_t));
+        g_current_bytes.fetch_sub(size, std::memory_order_relaxed);
+        ::free(block);
+    }
+}
+
+void operator delete(void* ptr, size_t) noexcept { ::operator delete(ptr); }
+
+namespace vcpkg::Bench
+{
+    std::string AllocationStats::to_string() const
+    {
+        return fmt::format("peak {:.1f} KiB, {} allocations", peak_bytes / 1024.0, allocation_count);
+    }
+
+    AllocationScope::AllocationScope()
+        : m_start_bytes(g_current_bytes.load()), m_start_count(g_allocation_count.load())
+    {
+        g_peak_bytes.store(m_start_bytes);
+    }
+
+    AllocationStats AllocationScope::stats() const
+    {
+        const auto peak = g_peak_bytes.load();
+        return AllocationStats{peak > m_start_bytes ? peak - m_start_bytes : 0,
+                               g_allocation_count.load() - m_start_count};
+    }
+}
+
+namespace vcpkg::Checks
+{
+    void on_final_cleanup_and_exit() { }
+}
+
+int main(int argc, char** argv)
+{
+    // We set VCPKG_ROOT to an invalid value to ensure benchmarks do not attempt to instantiate VcpkgRoot
+    vcpkg::set_environment_variable("VCPKG_ROOT", "VCPKG_BENCHMARKS_SHOULD_NOT_USE_VCPKG_ROOT");
+
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,46 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/platform-expression.h>
+
+#include <vector>
+
+using namespace vcpkg;
+using namespace vcpkg::PlatformExpression;
+
+TEST_CASE ("platform-expression evaluation", "[platform-expression]")
+{
+    const Context context{{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"},
+                          {"VCPKG_TARGET_ARCHITECTURE", "x64"},
+                          {"VCPKG_LIBRARY_LINKAGE", "static"},
+                          {"VCPKG_CRT_LINKAGE", "dynamic"},
+                          {"Z_VCPKG_IS_NATIVE", "1"}};
+    std::vector<Expr> exprs;
+    for (auto&& expression : {"windows", "!uwp", "linux | osx", "!(windows & static)", "x64 & !(arm | uwp)"})
+    {
+        exprs.push_back(
+            parse_platform_expression(expression, MultipleBinaryOperators::Deny).value_or_exit(VCPKG_LINE_INFO));
+    }
+
+    BENCHMARK("Context")
+    {
+        int count = 0;
+        for (auto&& expr : exprs)
+        {
+            count += expr.evaluate(context);
+        }
+
+        return count;
+    };
+
+    BENCHMARK("ResolvedContext")
+    {
+        const auto resolved = resolve_context(context);
+        int count = 0;
+        for (auto&& expr : exprs)
+        {
+            count += expr.evaluate(resolved);
+        }
+
+        return count;
+    };
+}
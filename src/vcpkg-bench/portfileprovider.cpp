@@ -0,0 +1,69 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/portfileprovider.h>
+#include <vcpkg/sourceparagraph.h>
+
+#include <map>
+#include <string>
+
+using namespace vcpkg;
+
+TEST_CASE ("load all ports", "[portfileprovider]")
+{
+    // Set VCPKG_BENCHMARK_PORTS to a ports directory such as $VCPKG_ROOT/ports to measure a real ports tree;
+    // otherwise a synthetic one is generated
+    auto& fs = real_filesystem;
+    Path ports;
+    auto maybe_benchmark_ports = get_environment_variable("VCPKG_BENCHMARK_PORTS");
+    if (auto benchmark_ports = maybe_benchmark_ports.get())
+    {
+        ports = std::move(*benchmark_ports);
+    }
+    else
+    {
+        ports = Test::base_temporary_directory() / "load-all-ports-bench";
+        fs.remove_all(ports, VCPKG_LINE_INFO);
+        for (int idx = 0; idx < 2500; ++idx)
+        {
+            const auto name = fmt::format("port-{}", idx);
+            fs.create_directories(ports / name, VCPKG_LINE_INFO);
+            fs.write_contents(ports / name / "vcpkg.json",
+                              fmt::format(R"json({{"name": "{}", "version": "1.0", "dependencies": ["zlib"]}})json",
+                                          name),
+                              VCPKG_LINE_INFO);
+        }
+    }
+
+    auto port_directories = fs.get_directories_non_recursive(ports, VCPKG_LINE_INFO);
+
+    BENCHMARK("serial")
+    {
+        std::size_t loaded = 0;
+        for (auto&& port_directory : port_directories)
+        {
+            auto load_result =
+                Paragraphs::try_load_port(fs, PortLocation{port_directory, no_assertion, PortSourceKind::Overlay}, nullptr);
+            loaded += load_result.maybe_scfl.has_value();
+        }
+
+        return loaded;
+    };
+
+    BENCHMARK("OverlayPortIndexEntry::try_load_all_ports")
+    {
+        std::map<std::string, const SourceControlFileAndLocation*> out;
+        OverlayPortIndexEntry entry{OverlayPortKind::Directory, ports};
+        (void)entry.try_load_all_ports(fs, out);
+        return out.size();
+    };
+
+    if (!maybe_benchmark_ports)
+    {
+        fs.remove_all(ports, VCPKG_LINE_INFO);
+    }
+}
@@ -0,0 +1,53 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/jsonreader.h>
+
+#include <vcpkg/registries-parsing.h>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace vcpkg;
+
+TEST_CASE ("git versions files", "[registries]")
+{
+    auto& fs = real_filesystem;
+    const auto versions = Test::base_temporary_directory() / "git_versions_bench";
+    fs.remove_all(versions, VCPKG_LINE_INFO);
+    fs.create_directories(versions / "f-", VCPKG_LINE_INFO);
+    std::string contents = "{\n  \"versions\": [";
+    for (int idx = 0; idx < 2000; ++idx)
+    {
+        fmt::format_to(std::back_inserter(contents),
+                       "{}\n    {{\n      \"git-tree\": \"{:040x}\",\n      \"version\": \"1.{}.0\",\n"
+                       "      \"port-version\": {}\n    }}",
+                       idx == 0 ? "" : ",",
+                       idx,
+                       idx,
+                       idx % 3);
+    }
+
+    contents.append("\n  ]\n}\n");
+    fs.write_contents(versions / "f-" / "foo.json", contents, VCPKG_LINE_INFO);
+
+    BENCHMARK("load_git_versions_file")
+    {
+        return load_git_versions_file(fs, versions, "foo").entries.has_value();
+    };
+
+    BENCHMARK("Json::parse and GitVersionDbEntryArrayDeserializer")
+    {
+        auto file_contents = fs.read_contents(versions / "f-" / "foo.json", VCPKG_LINE_INFO);
+        auto json = Json::parse_object(file_contents, "foo.json").value_or_exit(VCPKG_LINE_INFO);
+        Json::Reader r("foo.json");
+        std::vector<GitVersionDbEntry> entries;
+        r.visit_in_key(*json.get(JsonIdVersions), JsonIdVersions, entries, GitVersionDbEntryArrayDeserializer{});
+        return entries.size();
+    };
+
+    fs.remove_all(versions, VCPKG_LINE_INFO);
+}
@@ -0,0 +1,183 @@
+#include <vcpkg-bench/allocations.h>
+#include <vcpkg-bench/synthetic-registry.h>
+
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/messages.h>
+
+#include <vcpkg/commands.build.h>
+#include <vcpkg/dependencies.h>
+#include <vcpkg/portfileprovider.h>
+
+#include <vector>
+
+#include <vcpkg-test/mockcmakevarprovider.h>
+
+using namespace vcpkg;
+using namespace vcpkg::Bench;
+
+namespace
+{
+    const CreateInstallPlanOptions install_options{
+        nullptr, Test::X64_WINDOWS, UnsupportedPortAction::Error, UseHeadVersion::No, Editable::No};
+
+    // Runs `resolve` once outside of the benchmark to report how much memory it needs
+    template<class Resolve>
+    auto measure_allocations(StringLiteral name, const SyntheticRegistry& registry, Resolve resolve)
+    {
+        AllocationScope scope;
+        auto result = resolve();
+        msg::write_unlocalized_text(
+            Color::none,
+            fmt::format("{} [{}]: {}\n", name, registry.options().to_string(), scope.stats().to_string()));
+        return result;
+    }
+}
+
+TEST_CASE ("create_feature_install_plan", "[resolution]")
+{
+    const SyntheticRegistry registry{SyntheticRegistryOptions::from_environment()};
+    MapPortFileProvider provider(registry.latest_ports());
+    Test::MockCMakeVarProvider var_provider;
+    const auto specs = registry.all_specs(Test::X86_WINDOWS);
+    const auto installed = registry.installed_status(Test::X86_WINDOWS);
+
+    auto resolve_from = [&](const StatusParagraphs& status_db) {
+        PackagesDirAssigner packages_dir_assigner{"pkgs"};
+        return create_feature_install_plan(
+            provider, var_provider, specs, status_db, packages_dir_assigner, install_options);
+    };
+
+    auto plan = measure_allocations("create_feature_install_plan", registry, [&] { return resolve_from({}); });
+    CHECK(plan.install_actions.size() == specs.size());
+
+    BENCHMARK("nothing installed") { return resolve_from({}).size(); };
+    BENCHMARK("everything installed") { return resolve_from(installed).size(); };
+}
+
+TEST_CASE ("create_versioned_install_plan", "[resolution]")
+{
+    const SyntheticRegistry registry{SyntheticRegistryOptions::from_environment()};
+    NoOverlays overlays;
+    Test::MockCMakeVarProvider var_provider;
+    const auto dependencies = registry.all_dependencies();
+    const PackageSpec toplevel{"toplevel-spec", Test::X86_WINDOWS};
+
+    auto resolve = [&](const std::vector<DependencyOverride>& overrides) {
+        PackagesDirAssigner packages_dir_assigner{"pkgs"};
+        return create_versioned_install_plan(registry,
+                                             registry,
+                                             overlays,
+                                             var_provider,
+                                             dependencies,
+                                             overrides,
+                                             toplevel,
+                                             packages_dir_assigner,
+                                             install_options)
+            .value_or_exit(VCPKG_LINE_INFO);
+    };
+
+    auto plan = measure_allocations(
+        "create_versioned_install_plan", registry, [&] { return resolve(registry.overrides()); });
+    CHECK(plan.install_actions.size() == dependencies.size());
+
+    BENCHMARK("without overrides") { return resolve({}).size(); };
+    BENCHMARK("with overrides") { return resolve(registry.overrides()).size(); };
+}
+
+// Like `ci` and `x-test-features`, builds a plan for each of several ports from the same providers, either resolving
+// each from scratch or sharing one ResolutionContext between all of them
+TEST_CASE ("repeated install plans", "[resolution]")
+{
+    const SyntheticRegistry registry{SyntheticRegistryOptions::from_environment()};
+    MapPortFileProvider provider(registry.latest_ports());
+    NoOverlays overlays;
+    Test::MockCMakeVarProvider var_provider;
+    const auto specs = registry.all_specs(Test::X86_WINDOWS);
+    const auto dependencies = registry.all_dependencies();
+    const PackageSpec toplevel{"toplevel-spec", Test::X86_WINDOWS};
+    // the highest numbered ports depend on the most others
+    constexpr std::size_t plan_count = 50;
+    const std::size_t first = specs.size() > plan_count ? specs.size() - plan_count : 0;
+
+    auto feature_plans = [&](ResolutionContext* resolution_context) {
+        CreateInstallPlanOptions options = install_options;
+        options.resolution_context = resolution_context;
+        std::size_t actions = 0;
+        for (std::size_t idx = first; idx < specs.size(); ++idx)
+        {
+            PackagesDirAssigner packages_dir_assigner{"pkgs"};
+            actions += create_feature_install_plan(
+                           provider, var_provider, {&specs[idx], 1}, {}, packages_dir_assigner, options)
+                           .size();
+        }
+
+        return actions;
+    };
+
+    auto versioned_plans = [&](ResolutionContext* resolution_context) {
+        CreateInstallPlanOptions options = install_options;
+        options.resolution_context = resolution_context;
+        std::size_t actions = 0;
+        for (std::size_t idx = first; idx < dependencies.size(); ++idx)
+        {
+            PackagesDirAssigner packages_dir_assigner{"pkgs"};
+            actions += create_versioned_install_plan(registry,
+                                                     registry,
+                                                     overlays,
+                                                     var_provider,
+                                                     {dependencies[idx]},
+                                                     {},
+                                                     toplevel,
+                                                     packages_dir_assigner,
+                                                     options)
+                           .value_or_exit(VCPKG_LINE_INFO)
+                           .size();
+        }
+
+        return actions;
+    };
+
+    const auto feature_actions = measure_allocations("repeated create_feature_install_plan", registry, [&] {
+        ResolutionContext resolution_context;
+        return feature_plans(&resolution_context);
+    });
+    CHECK(feature_actions == feature_plans(nullptr));
+    const auto versioned_actions = measure_allocations("repeated create_versioned_install_plan", registry, [&] {
+        ResolutionContext resolution_context;
+        return versioned_plans(&resolution_context);
+    });
+    CHECK(versioned_actions == versioned_plans(nullptr));
+
+    BENCHMARK("create_feature_install_plan from scratch") { return feature_plans(nullptr); };
+    BENCHMARK("create_feature_install_plan with a shared context")
+    {
+        ResolutionContext resolution_context;
+        return feature_plans(&resolution_context);
+    };
+    BENCHMARK("create_versioned_install_plan from scratch") { return versioned_plans(nullptr); };
+    BENCHMARK("create_versioned_install_plan with a shared context")
+    {
+        ResolutionContext resolution_context;
+        return versioned_plans(&resolution_context);
+    };
+}
+
+TEST_CASE ("create_remove_plan", "[resolution]")
+{
+    const SyntheticRegistry registry{SyntheticRegistryOptions::from_environment()};
+    const auto installed = registry.installed_status(Test::X86_WINDOWS);
+    // the lowest numbered ports have the most dependents, so removing them removes most of the registry
+    std::vector<PackageSpec> specs;
+    for (int idx = 0; idx * 20 < registry.options().port_count; ++idx)
+    {
+        specs.emplace_back(SyntheticRegistry::port_name(idx), Test::X86_WINDOWS);
+    }
+
+    auto plan = measure_allocations("create_remove_plan", registry, [&] {
+        return create_remove_plan(specs, installed);
+    });
+    CHECK(plan.remove.size() >= specs.size());
+
+    BENCHMARK("create_remove_plan") { return create_remove_plan(specs, installed).remove.size(); };
+}
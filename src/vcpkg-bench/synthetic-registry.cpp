@@ -0,0 +1,289 @@
+#include <vcpkg-bench/synthetic-registry.h>
+
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/fmt.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/util.h>
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <set>
+
+namespace
+{
+    using namespace vcpkg;
+
+    constexpr StringLiteral ExtraFeature = "extra";
+
+    // splitmix64; std::uniform_int_distribution is not specified exactly, so it would generate different registries
+    // on different standard libraries
+    struct Random
+    {
+        uint64_t state = 0;
+
+        int below(int bound)
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            z ^= z >> 31;
+            return static_cast<int>(z % static_cast<uint64_t>(bound));
+        }
+    };
+
+    Version numbered_version(int number) { return Version{fmt::format("{}", number), 0}; }
+
+    int parse_option_value(StringView key, StringView value, int minimum)
+    {
+        auto maybe_parsed = Strings::strto<int>(value);
+        if (auto parsed = maybe_parsed.get())
+        {
+            if (*parsed >= minimum)
+            {
+                return *parsed;
+            }
+        }
+
+        Checks::exit_with_message(VCPKG_LINE_INFO,
+                                  fmt::format("synthetic registry option {} must be an integer of at least {}, not {}",
+                                              key,
+                                              minimum,
+                                              value));
+    }
+}
+
+namespace vcpkg::Bench
+{
+    SyntheticRegistryOptions SyntheticRegistryOptions::parse(StringView text)
+    {
+        SyntheticRegistryOptions options;
+        for (auto&& option : Strings::split(text, ','))
+        {
+            const auto first = option.data();
+            const auto last = first + option.size();
+            const auto equals = std::find(first, last, '=');
+            const StringView key{first, equals};
+            const StringView value{equals == last ? last : equals + 1, last};
+            if (key == "ports")
+            {
+                options.port_count = parse_option_value(key, value, 1);
+            }
+            else if (key == "fan-out")
+            {
+                options.fan_out = parse_option_value(key, value, 0);
+            }
+            else if (key == "features")
+            {
+                options.feature_density = std::min(parse_option_value(key, value, 0), 100);
+            }
+            else if (key == "versions")
+            {
+                options.version_depth = parse_option_value(key, value, 1);
+            }
+            else if (key == "overrides")
+            {
+                options.override_count = parse_option_value(key, value, 0);
+            }
+            else
+            {
+                Checks::exit_with_message(
+                    VCPKG_LINE_INFO,
+                    fmt::format("unknown synthetic registry option {}; expected one of ports, fan-out, features, "
+                                "versions, or overrides",
+                                key));
+            }
+        }
+
+        return options;
+    }
+
+    SyntheticRegistryOptions SyntheticRegistryOptions::from_environment()
+    {
+        auto maybe_text = get_environment_variable("VCPKG_BENCHMARK_REGISTRY");
+        if (auto text = maybe_text.get())
+        {
+            return parse(*text);
+        }
+
+        return SyntheticRegistryOptions{};
+    }
+
+    std::string SyntheticRegistryOptions::to_string() const
+    {
+        return fmt::format("ports={},fan-out={},features={},versions={},overrides={}",
+                           port_count,
+                           fan_out,
+                           feature_density,
+                           version_depth,
+                           override_count);
+    }
+
+    std::string SyntheticRegistry::port_name(int idx) { return fmt::format("port-{}", idx); }
+
+    SyntheticRegistry::SyntheticRegistry(const SyntheticRegistryOptions& options) : m_options(options)
+    {
+        Random random;
+        std::vector<bool> has_feature;
+        has_feature.reserve(options.port_count);
+        for (int idx = 0; idx < options.port_count; ++idx)
+        {
+            auto name = port_name(idx);
+            has_feature.push_back(random.below(100) < options.feature_density);
+
+            std::set<int> dependency_indices;
+            const auto dependency_count = static_cast<std::size_t>(std::min(options.fan_out, idx));
+            while (dependency_indices.size() < dependency_count)
+            {
+                dependency_indices.insert(random.below(idx));
+            }
+
+            std::vector<Dependency> dependencies;
+            for (int dependency_idx : dependency_indices)
+            {
+                Dependency dependency{port_name(dependency_idx)};
+                if (options.version_depth > 1 && random.below(4) == 0)
+                {
+                    dependency.constraint = DependencyConstraint{
+                        VersionConstraintKind::Minimum, numbered_version(2 + random.below(options.version_depth - 1))};
+                }
+
+                dependencies.push_back(std::move(dependency));
+            }
+
+            std::vector<Dependency> feature_dependencies;
+            bool extra_is_default = false;
+            if (has_feature.back())
+            {
+                extra_is_default = random.below(2) == 0;
+                if (idx != 0)
+                {
+                    const auto feature_dependency_idx = random.below(idx);
+                    Dependency feature_dependency{port_name(feature_dependency_idx)};
+                    if (has_feature[feature_dependency_idx])
+                    {
+                        feature_dependency.features.push_back(DependencyRequestedFeature{ExtraFeature.to_string()});
+                    }
+
+                    feature_dependencies.push_back(std::move(feature_dependency));
+                }
+            }
+
+            auto&& port_versions = m_versions[name];
+            for (int version = 1; version <= options.version_depth; ++version)
+            {
+                auto core = std::make_unique<SourceParagraph>();
+                core->name = name;
+                core->version_scheme = VersionScheme::Relaxed;
+                core->version = numbered_version(version);
+                core->dependencies = dependencies;
+                auto scf = std::make_unique<SourceControlFile>();
+                if (has_feature.back())
+                {
+                    if (extra_is_default)
+                    {
+                        core->default_features.push_back(DependencyRequestedFeature{ExtraFeature.to_string()});
+                    }
+
+                    auto feature = std::make_unique<FeatureParagraph>();
+                    feature->name = ExtraFeature.to_string();
+                    feature->dependencies = feature_dependencies;
+                    scf->feature_paragraphs.push_back(std::move(feature));
+                }
+
+                scf->core_paragraph = std::move(core);
+                port_versions.emplace(numbered_version(version),
+                                      SourceControlFileAndLocation{
+                                          std::move(scf), Path(name) / "vcpkg.json", "", PortSourceKind::Builtin});
+            }
+
+            m_latest.emplace(name, port_versions.rbegin()->second.clone());
+        }
+
+        const auto override_count = std::min(options.override_count, options.port_count);
+        for (int override_idx = 0; override_idx < override_count; ++override_idx)
+        {
+            m_overrides.push_back(DependencyOverride{port_name(override_idx * options.port_count / override_count),
+                                                     numbered_version(options.version_depth)});
+        }
+    }
+
+    ExpectedL<Version> SyntheticRegistry::get_baseline_version(StringView port_name) const
+    {
+        auto it = m_versions.find(port_name);
+        if (it == m_versions.end())
+        {
+            return LocalizedString::from_raw(fmt::format("no baseline for {}", port_name));
+        }
+
+        return it->second.begin()->first;
+    }
+
+    ExpectedL<const SourceControlFileAndLocation&> SyntheticRegistry::get_control_file(
+        const VersionSpec& version_spec) const
+    {
+        auto it = m_versions.find(version_spec.port_name);
+        if (it != m_versions.end())
+        {
+            auto version_it = it->second.find(version_spec.version);
+            if (version_it != it->second.end())
+            {
+                return version_it->second;
+            }
+        }
+
+        return LocalizedString::from_raw(fmt::format("no such port version {}", version_spec));
+    }
+
+    std::vector<Dependency> SyntheticRegistry::all_dependencies() const
+    {
+        std::vector<Dependency> dependencies;
+        dependencies.reserve(m_versions.size());
+        for (auto&& port : m_versions)
+        {
+            dependencies.push_back(Dependency{port.first});
+        }
+
+        return dependencies;
+    }
+
+    std::vector<FullPackageSpec> SyntheticRegistry::all_specs(Triplet triplet) const
+    {
+        return Util::fmap(m_versions, [&](auto&& port) {
+            return FullPackageSpec{PackageSpec{port.first, triplet}, {FeatureNameCore.to_string()}};
+        });
+    }
+
+    StatusParagraphs SyntheticRegistry::installed_status(Triplet triplet) const
+    {
+        const auto& triplet_name = triplet.canonical_name();
+        std::vector<std::unique_ptr<StatusParagraph>> paragraphs;
+        for (auto&& port : m_latest)
+        {
+            const auto& scf = *port.second.source_control_file;
+            const auto depends = Strings::join(
+                ", ", scf.core_paragraph->dependencies, [](const Dependency& dependency) { return dependency.name; });
+            const auto default_features = Strings::join(
+                ", ", scf.core_paragraph->default_features, [](const DependencyRequestedFeature& feature) {
+                    return feature.name;
+                });
+            paragraphs.push_back(Test::make_status_pgh(
+                port.first.c_str(), depends.c_str(), default_features.c_str(), triplet_name.c_str()));
+            if (!scf.core_paragraph->default_features.empty())
+            {
+                const auto feature_depends = Strings::join(
+                    ", ", scf.feature_paragraphs.front()->dependencies, [](const Dependency& dependency) {
+                        return dependency.name;
+                    });
+                paragraphs.push_back(Test::make_status_feature_pgh(
+                    port.first.c_str(), ExtraFeature.c_str(), feature_depends.c_str(), triplet_name.c_str()));
+            }
+        }
+
+        return StatusParagraphs{std::move(paragraphs)};
+    }
+}
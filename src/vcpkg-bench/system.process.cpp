@@ -0,0 +1,43 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/diagnostics.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/diagnostics.h>
+#include <vcpkg/base/system.process.h>
+
+#include <string>
+
+using namespace vcpkg;
+
+TEST_CASE ("coprocess request latency", "[system.process]")
+{
+    auto test_program = Path(get_exe_path_of_current_process().parent_path()) / "reads-stdin";
+    const auto cmd = Command{test_program}.string_arg("read");
+    // 140 bytes is a whole number of both "example"s and reads-stdin's 20 byte reads, so each request gets 7 lines
+    std::string request;
+    for (int idx = 0; idx < 20; ++idx)
+    {
+        request.append("example");
+    }
+
+    BENCHMARK("launch per request")
+    {
+        RedirectedProcessLaunchSettings settings;
+        settings.stdin_content = request;
+        return cmd_execute_and_capture_output(cmd, settings).value_or_exit(VCPKG_LINE_INFO).output.size();
+    };
+
+    Coprocess coprocess;
+    REQUIRE(coprocess.start(console_diagnostic_context, cmd, {}));
+    std::string line;
+    BENCHMARK("coprocess request")
+    {
+        (void)coprocess.write(console_diagnostic_context, request);
+        for (int idx = 0; idx < 7; ++idx)
+        {
+            (void)coprocess.read_line(console_diagnostic_context, line);
+        }
+
+        return line.size();
+    };
+}
@@ -0,0 +1,154 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/fmt.h>
+#include <vcpkg/base/messages.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/registries.h>
+#include <vcpkg/versions.h>
+
+#include <string>
+#include <vector>
+
+using namespace vcpkg;
+
+namespace
+{
+    // The versions of each port, newest first as in a versions database
+    using VersionsDatabase = std::vector<std::vector<SchemedVersion>>;
+
+    VersionsDatabase load_versions_directory(const Path& registry_versions)
+    {
+        auto database = load_all_git_versions_files(real_filesystem, registry_versions).value_or_exit(VCPKG_LINE_INFO);
+        VersionsDatabase result;
+        for (auto&& port : database.cache())
+        {
+            const auto& maybe_entries = port.second.entries.value_or_exit(VCPKG_LINE_INFO);
+            const auto entries = maybe_entries.get();
+            if (entries && !entries->empty())
+            {
+                result.push_back(Util::fmap(*entries, [](const GitVersionDbEntry& entry) { return entry.version; }));
+            }
+        }
+
+        return result;
+    }
+
+    // A database shaped roughly like the curated registry: mostly relaxed versions, some semver, date, and string
+    // versions, 1 to 31 versions per port, and frequent port-versions
+    VersionsDatabase generate_versions_database()
+    {
+        constexpr int port_count = 2500;
+        VersionsDatabase result(port_count);
+        for (int port = 0; port < port_count; ++port)
+        {
+            auto&& versions = result[port];
+            for (int idx = port % 31; idx >= 0; --idx)
+            {
+                const int port_version = idx % 3;
+                const int release = idx / 3;
+                switch (port % 10)
+                {
+                    case 6:
+                        versions.emplace_back(VersionScheme::Semver,
+                                              release % 4 == 3 ? fmt::format("1.{}.0-rc.{}", release / 4 + 1, release)
+                                                               : fmt::format("1.{}.{}", release / 4, release % 4),
+                                              port_version);
+                        break;
+                    case 7:
+                    case 8:
+                        versions.emplace_back(VersionScheme::Date,
+                                              fmt::format("20{}-{:02}-01", 15 + release / 12, 1 + release % 12),
+                                              port_version);
+                        break;
+                    case 9:
+                        versions.emplace_back(VersionScheme::String, fmt::format("release-{}", release), port_version);
+                        break;
+                    default:
+                        versions.emplace_back(VersionScheme::Relaxed,
+                                              fmt::format("{}.{}.{}", port % 5, release / 4, release % 4),
+                                              port_version);
+                        break;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // Set VCPKG_BENCHMARK_VERSIONS to a versions directory such as $VCPKG_ROOT/versions to measure a real database
+    VersionsDatabase load_versions_database()
+    {
+        auto maybe_versions_path = get_environment_variable("VCPKG_BENCHMARK_VERSIONS");
+        if (auto versions_path = maybe_versions_path.get())
+        {
+            return load_versions_directory(*versions_path);
+        }
+
+        return generate_versions_database();
+    }
+}
+
+TEST_CASE ("versions database comparisons", "[versions]")
+{
+    const auto database = load_versions_database();
+    size_t version_count = 0;
+    for (auto&& versions : database)
+    {
+        version_count += versions.size();
+    }
+
+    msg::write_unlocalized_text(
+        Color::none, fmt::format("versions database: {} ports, {} versions\n", database.size(), version_count));
+
+    // Like resolution, compares each version to the selected one, which here is the newest version of its port
+    BENCHMARK("compare_versions")
+    {
+        size_t older = 0;
+        for (auto&& versions : database)
+        {
+            for (auto&& version : versions)
+            {
+                older += compare_versions(version, versions.front()) == VerComp::lt;
+            }
+        }
+
+        return older;
+    };
+
+    BENCHMARK("VersionKey::try_parse")
+    {
+        size_t numbers = 0;
+        for (auto&& versions : database)
+        {
+            for (auto&& version : versions)
+            {
+                numbers += VersionKey::try_parse(version).value_or_exit(VCPKG_LINE_INFO).numbers.size();
+            }
+        }
+
+        return numbers;
+    };
+
+    const auto keys = Util::fmap(database, [](const std::vector<SchemedVersion>& versions) {
+        return Util::fmap(versions, [](const SchemedVersion& version) {
+            return VersionKey::try_parse(version).value_or_exit(VCPKG_LINE_INFO);
+        });
+    });
+
+    BENCHMARK("compare VersionKeys")
+    {
+        size_t older = 0;
+        for (auto&& versions : keys)
+        {
+            for (auto&& version : versions)
+            {
+                older += compare(version, versions.front()) == VerComp::lt;
+            }
+        }
+
+        return older;
+    };
+}
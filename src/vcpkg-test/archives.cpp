@@ -17,3 +17,78 @@ TEST_CASE ("Testing guess_extraction_type", "[z-extract]")
     REQUIRE(guess_extraction_type(Path("/path/to/archive.unknown")) == ExtractionType::Unknown);
     REQUIRE(guess_extraction_type(Path("/path/to/archive.7z.exe")) == ExtractionType::SelfExtracting7z);
 }
+
+namespace
+{
+    void append_le16(std::string& out, uint16_t value)
+    {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    void append_le32(std::string& out, uint32_t value)
+    {
+        append_le16(out, static_cast<uint16_t>(value & 0xFFFF));
+        append_le16(out, static_cast<uint16_t>(value >> 16));
+    }
+
+    // Builds a zip archive consisting of only a central directory naming `names` and an end of central directory
+    // record; list_zip_archive_entries never looks at the local file headers or file data.
+    std::string make_zip_central_directory(const std::vector<std::string>& names, const std::string& comment)
+    {
+        std::string result = "some file data";
+        const auto directory_offset = static_cast<uint32_t>(result.size());
+        for (auto&& name : names)
+        {
+            result.append("PK\x01\x02");
+            result.append(24, '\0'); // versions, flags, method, time, date, crc, sizes
+            append_le16(result, static_cast<uint16_t>(name.size()));
+            append_le16(result, 0);  // extra field length
+            append_le16(result, 0);  // comment length
+            result.append(12, '\0'); // disk number, attributes, local header offset
+            result.append(name);
+        }
+
+        const auto directory_size = static_cast<uint32_t>(result.size()) - directory_offset;
+        result.append("PK\x05\x06");
+        append_le32(result, 0); // disk numbers
+        append_le16(result, static_cast<uint16_t>(names.size()));
+        append_le16(result, static_cast<uint16_t>(names.size()));
+        append_le32(result, directory_size);
+        append_le32(result, directory_offset);
+        append_le16(result, static_cast<uint16_t>(comment.size()));
+        result.append(comment);
+        return result;
+    }
+}
+
+TEST_CASE ("list_zip_archive_entries", "[z-extract]")
+{
+    using namespace vcpkg;
+    auto& fs = real_filesystem;
+    const auto temp_dir = Test::base_temporary_directory() / "list_zip_archive_entries";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    fs.create_directories(temp_dir, VCPKG_LINE_INFO);
+
+    const std::vector<std::string> names{"CONTROL", "include/", "include\\zlib.h", "lib/z.lib"};
+    const auto archive = temp_dir / "zlib.zip";
+    fs.write_contents(archive, make_zip_central_directory(names, "a comment"), VCPKG_LINE_INFO);
+    REQUIRE(list_zip_archive_entries(fs, archive).value_or_exit(VCPKG_LINE_INFO) ==
+            std::vector<std::string>{"CONTROL", "include/", "include/zlib.h", "lib/z.lib"});
+
+    const auto empty = temp_dir / "empty.zip";
+    fs.write_contents(empty, make_zip_central_directory({}, ""), VCPKG_LINE_INFO);
+    REQUIRE(list_zip_archive_entries(fs, empty).value_or_exit(VCPKG_LINE_INFO).empty());
+
+    const auto not_zip = temp_dir / "not-a-zip.zip";
+    fs.write_contents(not_zip, "this is not a zip archive", VCPKG_LINE_INFO);
+    REQUIRE(!list_zip_archive_entries(fs, not_zip).has_value());
+
+    auto truncated_contents = make_zip_central_directory(names, "");
+    truncated_contents.erase(20, 10);
+    const auto truncated = temp_dir / "truncated.zip";
+    fs.write_contents(truncated, truncated_contents, VCPKG_LINE_INFO);
+    REQUIRE(!list_zip_archive_entries(fs, truncated).has_value());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
@@ -0,0 +1,109 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/binary-records.h>
+#include <vcpkg/base/files.h>
+
+using namespace vcpkg;
+
+TEST_CASE ("binary reader and writer", "[binary-records]")
+{
+    BinaryWriter writer;
+    writer.write_scalar(uint32_t{42});
+    writer.write_string("hello");
+    writer.write_scalar(int64_t{-7});
+
+    BinaryReader reader{writer.buffer};
+    uint32_t small;
+    std::string text;
+    int64_t large;
+    REQUIRE(reader.read_scalar(small));
+    REQUIRE(reader.read_string(text));
+    REQUIRE(reader.read_scalar(large));
+    CHECK(small == 42);
+    CHECK(text == "hello");
+    CHECK(large == -7);
+    CHECK(reader.empty());
+    CHECK(!reader.read_scalar(small));
+
+    BinaryReader truncated{StringView{writer.buffer.data(), 6}};
+    REQUIRE(truncated.read_scalar(small));
+    CHECK(!truncated.read_string(text));
+}
+
+TEST_CASE ("binary record file", "[binary-records]")
+{
+    auto& fs = real_filesystem;
+    const auto directory = Test::base_temporary_directory() / "binary-record-file";
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+    const auto path = directory / "records.bin";
+
+    BinaryRecordFile records{fs, path, "test-records 1\n"};
+    CHECK(records.load().empty());
+    records.append("a", "first");
+    records.append("b", std::string("with\0nul", 8));
+    records.append("a", "second");
+
+    const std::map<std::string, std::string, std::less<>> expected{{"a", "second"}, {"b", std::string("with\0nul", 8)}};
+    CHECK(BinaryRecordFile{fs, path, "test-records 1\n"}.load() == expected);
+
+    // a different header discards the records
+    BinaryRecordFile new_records{fs, path, "test-records 2\n"};
+    CHECK(new_records.load().empty());
+    CHECK(fs.read_contents(path, VCPKG_LINE_INFO) == "test-records 2\n");
+
+    // a damaged tail is dropped, keeping the intact records before it
+    new_records.append("a", "first");
+    new_records.append("b", "second");
+    fs.write_contents(path, fs.read_contents(path, VCPKG_LINE_INFO) + "\x01\x02", VCPKG_LINE_INFO);
+    const std::map<std::string, std::string, std::less<>> intact{{"a", "first"}, {"b", "second"}};
+    CHECK(new_records.load() == intact);
+    CHECK(new_records.load() == intact);
+
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("binary record file trims to the most recent records", "[binary-records]")
+{
+    auto& fs = real_filesystem;
+    const auto directory = Test::base_temporary_directory() / "binary-record-file-trim";
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+    const auto path = directory / "records.bin";
+
+    BinaryRecordFile records{fs, path, "test-records 1\n", 4};
+    std::vector<std::pair<std::string, std::string>> batch;
+    for (char c = 'a'; c <= 'f'; ++c)
+    {
+        batch.emplace_back(std::string(1, c), std::string(2, c));
+    }
+
+    records.append(batch);
+    const std::map<std::string, std::string, std::less<>> newest{{"d", "dd"}, {"e", "ee"}, {"f", "ff"}};
+    CHECK(records.load() == newest);
+    CHECK(BinaryRecordFile{fs, path, "test-records 1\n", 4}.load() == newest);
+
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("binary record file replace", "[binary-records]")
+{
+    auto& fs = real_filesystem;
+    const auto directory = Test::base_temporary_directory() / "binary-record-file-replace";
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+    const auto path = directory / "records.bin";
+
+    BinaryRecordFile records{fs, path, "test-records 1\n"};
+    records.append("other", "kept");
+    records.replace("plan", "first");
+    const auto size_after_first = fs.file_size(path, VCPKG_LINE_INFO);
+    for (int idx = 0; idx < 10; ++idx)
+    {
+        records.replace("plan", "later");
+    }
+
+    // superseded records are not left behind
+    CHECK(fs.file_size(path, VCPKG_LINE_INFO) == size_after_first);
+    const std::map<std::string, std::string, std::less<>> expected{{"other", "kept"}, {"plan", "later"}};
+    CHECK(records.load() == expected);
+
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+}
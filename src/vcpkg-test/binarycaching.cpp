@@ -1,5 +1,6 @@
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/xmlserializer.h>
 
 #include <vcpkg/binarycaching.h>
@@ -9,6 +10,7 @@
 #include <vcpkg/sourceparagraph.h>
 
 #include <string>
+#include <thread>
 
 using namespace vcpkg;
 
@@ -36,6 +38,9 @@ struct KnowNothingBinaryProvider : IReadBinaryProvider
     {
         return LocalizedString::from_raw("Nothing");
     }
+
+    StringLiteral provider_name() const override { return "nothing"; }
+    std::string destination_id() const override { return "nothing:"; }
 };
 
 TEST_CASE ("CacheStatus operations", "[BinaryCache]")
@@ -360,6 +365,62 @@ Description:
     uut.fetch(install_plan); // should have no effects
 }
 
+namespace
+{
+    // Restores every other package of each batch it is asked for
+    struct EveryOtherBinaryProvider : KnowNothingBinaryProvider
+    {
+        void fetch(View<const InstallPlanAction*> actions, Span<RestoreResult> out_status) const override
+        {
+            REQUIRE(actions.size() == out_status.size());
+            for (size_t idx = 0; idx < out_status.size(); idx += 2)
+            {
+                out_status[idx] = RestoreResult::restored;
+            }
+        }
+
+        StringLiteral provider_name() const override { return "every-other"; }
+    };
+}
+
+TEST_CASE ("ReadOnlyBinaryCache stats count requests of a batch", "[BinaryCache]")
+{
+    ReadOnlyBinaryCache uut;
+    uut.install_read_provider(std::make_unique<EveryOtherBinaryProvider>());
+
+    SourceControlFileAndLocation scfl{Test::make_control_file("zlib", ""), Path()};
+    std::vector<InstallPlanAction> install_plan;
+    PackagesDirAssigner packages_dir_assigner{"test_packages_root"};
+    for (auto triplet : {Test::X64_WINDOWS, Test::X86_WINDOWS, Test::X64_LINUX})
+    {
+        auto& action = install_plan.emplace_back(PackageSpec{"zlib", triplet},
+                                                 scfl,
+                                                 packages_dir_assigner,
+                                                 RequestType::USER_REQUESTED,
+                                                 UseHeadVersion::No,
+                                                 Editable::No,
+                                                 std::map<std::string, std::vector<FeatureSpec>>{},
+                                                 std::vector<LocalizedString>{},
+                                                 std::vector<std::string>{});
+        action.abi_info.emplace().package_abi = "abi-" + triplet.canonical_name();
+    }
+
+    uut.fetch(install_plan);
+
+    // the provider was called once for all 3 packages, and each of them gets a latency sample
+    const auto& stats = uut.stats();
+    REQUIRE(stats.read.size() == 1);
+    CHECK(stats.read[0].provider == "every-other");
+    const auto& restore = stats.read[0].restore;
+    CHECK(restore.calls == 1);
+    CHECK(restore.requests == 3);
+    CHECK(restore.hits == 2);
+    CHECK(restore.misses == 1);
+    REQUIRE(restore.latencies_us.size() == 3);
+    const auto minmax = std::minmax_element(restore.latencies_us.begin(), restore.latencies_us.end());
+    CHECK(*minmax.second - *minmax.first <= 1);
+}
+
 TEST_CASE ("XmlSerializer", "[XmlSerializer]")
 {
     XmlSerializer xml;
@@ -529,3 +590,243 @@ TEST_CASE ("Synchronizer operations", "[BinaryCache]")
         REQUIRE(result.submission_complete);
     }
 }
+
+TEST_CASE ("BinaryCacheRetryEntry serialization", "[BinaryCache]")
+{
+    BinaryCacheRetryEntry entry{PackageSpec{"zlib", Test::X64_ANDROID},
+                                Version{"1.2.13", 1},
+                                "packageabi",
+                                "zlib:x64-android@1.2.13#1",
+                                3,
+                                1700000000,
+                                {"files:/cache", "http:https://example.com/{sha}.zip"}};
+    auto obj = serialize_binary_cache_retry_entry(entry);
+    auto maybe_parsed = parse_binary_cache_retry_entry(obj);
+    auto parsed = maybe_parsed.get();
+    REQUIRE(parsed);
+    REQUIRE(parsed->spec == entry.spec);
+    REQUIRE(parsed->version == entry.version);
+    REQUIRE(parsed->package_abi == "packageabi");
+    REQUIRE(parsed->display_name == "zlib:x64-android@1.2.13#1");
+    REQUIRE(parsed->attempts == 3);
+    REQUIRE(parsed->next_attempt == 1700000000);
+    REQUIRE(parsed->providers == entry.providers);
+
+    // entries queued before providers were recorded parse without any
+    auto without_providers = obj;
+    without_providers.remove(JsonIdProviders);
+    maybe_parsed = parse_binary_cache_retry_entry(without_providers);
+    REQUIRE(maybe_parsed.has_value());
+    REQUIRE(maybe_parsed.get()->providers.empty());
+
+    auto bad_providers = obj;
+    bad_providers.insert_or_replace(JsonIdProviders, Json::Value::string("files:/cache"));
+    REQUIRE_FALSE(parse_binary_cache_retry_entry(bad_providers).has_value());
+
+    obj.remove(JsonIdAbi);
+    REQUIRE_FALSE(parse_binary_cache_retry_entry(obj).has_value());
+
+    auto negative = serialize_binary_cache_retry_entry(entry);
+    negative.insert_or_replace(JsonIdPortVersion, Json::Value::integer(-1));
+    REQUIRE_FALSE(parse_binary_cache_retry_entry(negative).has_value());
+}
+
+TEST_CASE ("BinaryCacheRetryQueue", "[BinaryCache]")
+{
+    auto& fs = real_filesystem;
+    const auto downloads = Test::base_temporary_directory() / "binary-cache-retry-queue";
+    fs.remove_all(downloads, VCPKG_LINE_INFO);
+    fs.create_directories(downloads, VCPKG_LINE_INFO);
+    BinaryCacheRetryQueue queue(fs, downloads);
+    auto lock = queue.lock(false, null_sink);
+    REQUIRE(lock);
+
+    BinaryPackageReadInfo info{PackageSpec{"zlib", Test::X64_ANDROID},
+                               "packageabi",
+                               "zlib:x64-android@1.2.13",
+                               Version{"1.2.13", 0},
+                               downloads / "zlib"};
+    const auto zip_path = downloads / "zlib.zip";
+    fs.write_contents(zip_path, "first", VCPKG_LINE_INFO);
+    REQUIRE(queue.enqueue(info, zip_path, {"http:https://example.com/{sha}.zip"}, null_sink));
+    fs.write_contents(zip_path, "second", VCPKG_LINE_INFO);
+    REQUIRE(queue.enqueue(info, zip_path, {"files:/cache"}, null_sink));
+
+    // enqueueing the same ABI again merges the providers it failed for
+    auto entries = queue.load_entries();
+    REQUIRE(entries.size() == 1);
+    CHECK(entries[0].providers == std::vector<std::string>{"files:/cache", "http:https://example.com/{sha}.zip"});
+    CHECK(fs.read_contents(queue.archive_path("packageabi"), VCPKG_LINE_INFO) == "second");
+
+    std::error_code ec;
+    entries[0].providers = {"files:/cache"};
+    REQUIRE(queue.record_failure(entries[0], ec));
+    REQUIRE(!ec);
+    entries = queue.load_entries();
+    REQUIRE(entries.size() == 1);
+    CHECK(entries[0].attempts == 1);
+    CHECK(entries[0].providers == std::vector<std::string>{"files:/cache"});
+
+    entries[0].attempts = 11;
+    REQUIRE_FALSE(queue.record_failure(entries[0], ec));
+    CHECK(queue.load_entries().empty());
+
+    fs.write_contents(zip_path, "third", VCPKG_LINE_INFO);
+    REQUIRE(queue.enqueue(info, zip_path, {"files:/cache"}, null_sink));
+    queue.clear();
+    CHECK(queue.load_entries().empty());
+    CHECK(fs.exists(queue.root() / ".lock", VCPKG_LINE_INFO));
+}
+
+TEST_CASE ("BinaryCacheRetryQueue concurrent enqueue", "[BinaryCache]")
+{
+    // the push thread enqueues while the submitting thread reads and removes entries
+    auto& fs = real_filesystem;
+    const auto downloads = Test::base_temporary_directory() / "binary-cache-retry-queue-concurrent";
+    fs.remove_all(downloads, VCPKG_LINE_INFO);
+    fs.create_directories(downloads, VCPKG_LINE_INFO);
+    BinaryCacheRetryQueue queue(fs, downloads);
+    auto lock = queue.lock(false, null_sink);
+    REQUIRE(lock);
+
+    std::thread pusher([&] {
+        for (int idx = 0; idx < 50; ++idx)
+        {
+            const auto abi = fmt::format("abi{}", idx);
+            BinaryPackageReadInfo info{PackageSpec{"zlib", Test::X64_ANDROID},
+                                       abi,
+                                       "zlib:x64-android@1.2.13",
+                                       Version{"1.2.13", 0},
+                                       downloads / "zlib"};
+            const auto zip_path = downloads / (abi + ".staging");
+            fs.write_contents(zip_path, abi, VCPKG_LINE_INFO);
+            queue.enqueue(info, zip_path, {"files:/cache"}, null_sink);
+        }
+    });
+
+    size_t removed = 0;
+    while (removed < 25)
+    {
+        for (auto&& entry : queue.load_entries())
+        {
+            CHECK(entry.providers == std::vector<std::string>{"files:/cache"});
+            if (removed < 25)
+            {
+                queue.remove(entry.package_abi);
+                ++removed;
+            }
+        }
+    }
+
+    pusher.join();
+    auto entries = queue.load_entries();
+    CHECK(entries.size() == 25);
+    for (auto&& entry : entries)
+    {
+        CHECK(fs.read_contents(queue.archive_path(entry.package_abi), VCPKG_LINE_INFO) == entry.package_abi);
+    }
+}
+
+TEST_CASE ("binary_cache_retry_delay", "[BinaryCache]")
+{
+    REQUIRE(binary_cache_retry_delay(0).value_or_exit(VCPKG_LINE_INFO) == 300);
+    REQUIRE(binary_cache_retry_delay(1).value_or_exit(VCPKG_LINE_INFO) == 300);
+    REQUIRE(binary_cache_retry_delay(2).value_or_exit(VCPKG_LINE_INFO) == 600);
+    REQUIRE(binary_cache_retry_delay(5).value_or_exit(VCPKG_LINE_INFO) == 4800);
+    REQUIRE(binary_cache_retry_delay(11).value_or_exit(VCPKG_LINE_INFO) == 24 * 60 * 60);
+    REQUIRE_FALSE(binary_cache_retry_delay(12).has_value());
+}
+
+TEST_CASE ("latency_percentile", "[BinaryCache]")
+{
+    REQUIRE(latency_percentile({}, 50.0) == 0);
+    REQUIRE(latency_percentile({7}, 95.0) == 7);
+    std::vector<uint64_t> samples{10, 1, 9, 2, 8, 3, 7, 4, 6, 5};
+    REQUIRE(latency_percentile(samples, 50.0) == 5);
+    REQUIRE(latency_percentile(samples, 95.0) == 10);
+    REQUIRE(latency_percentile(samples, 0.0) == 1);
+}
+
+TEST_CASE ("BinaryCacheOperationStats::add_call", "[BinaryCache]")
+{
+    BinaryCacheOperationStats stats;
+    stats.add_call(10, 3);
+    stats.add_call(5, 1);
+    stats.add_call(7, 0);
+    CHECK(stats.calls == 3);
+    CHECK(stats.latencies_us == std::vector<uint64_t>{4, 3, 3, 5, 7});
+}
+
+TEST_CASE ("serialize_binary_cache_stats", "[BinaryCache]")
+{
+    BinaryCacheStats stats;
+    auto& read = stats.read.emplace_back();
+    read.provider = "files";
+    read.restore.requests = 3;
+    read.restore.hits = 2;
+    read.restore.misses = 1;
+    read.restore.bytes = 1024;
+    read.restore.calls = 1;
+    read.restore.latencies_us = {4, 2};
+    auto& write = stats.write.emplace_back();
+    write.provider = "http";
+    write.upload.requests = 1;
+    write.upload.misses = 1;
+    stats.compression.requests = 1;
+    stats.compression.hits = 1;
+
+    auto obj = serialize_binary_cache_stats(stats);
+    REQUIRE(Json::stringify(obj) == R"json({
+  "read": [
+    {
+      "provider": "files",
+      "restore": {
+        "requests": 3,
+        "hits": 2,
+        "misses": 1,
+        "bytes": 1024,
+        "calls": 1,
+        "total-us": 6,
+        "p50-us": 2,
+        "p95-us": 4
+      },
+      "precheck": {
+        "requests": 0,
+        "hits": 0,
+        "misses": 0,
+        "bytes": 0,
+        "calls": 0,
+        "total-us": 0,
+        "p50-us": 0,
+        "p95-us": 0
+      }
+    }
+  ],
+  "write": [
+    {
+      "provider": "http",
+      "upload": {
+        "requests": 1,
+        "hits": 0,
+        "misses": 1,
+        "bytes": 0,
+        "calls": 0,
+        "total-us": 0,
+        "p50-us": 0,
+        "p95-us": 0
+      }
+    }
+  ],
+  "compression": {
+    "requests": 1,
+    "hits": 1,
+    "misses": 0,
+    "bytes": 0,
+    "calls": 0,
+    "total-us": 0,
+    "p50-us": 0,
+    "p95-us": 0
+  }
+}
+)json");
+}
@@ -1,9 +1,49 @@
+#include <vcpkg-test/mockcmakevarprovider.h>
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/json.h>
+
+#include <vcpkg/bundlesettings.h>
 #include <vcpkg/commands.build.h>
+#include <vcpkg/dependencies.h>
+#include <vcpkg/sourceparagraph.h>
+#include <vcpkg/statusparagraphs.h>
+#include <vcpkg/vcpkgcmdarguments.h>
+#include <vcpkg/vcpkgpaths.h>
 
 using namespace vcpkg;
 
+namespace
+{
+    // A classic mode vcpkg root with no ports or triplets, for what needs VcpkgPaths but not a real tree
+    struct TestVcpkgRoot
+    {
+        explicit TestVcpkgRoot(const Path& root) : args(make_args(root)), paths(real_filesystem, args, BundleSettings{})
+        {
+        }
+
+        static VcpkgCmdArguments make_args(const Path& root)
+        {
+            real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+            real_filesystem.write_contents_and_dirs(root / ".vcpkg-root", "", VCPKG_LINE_INFO);
+            real_filesystem.create_directories(root / "scripts", VCPKG_LINE_INFO);
+            real_filesystem.create_directories(root / "triplets" / "community", VCPKG_LINE_INFO);
+            const std::string arguments[] = {fmt::format("--vcpkg-root={}", root),
+                                             fmt::format("--downloads-root={}", root / "downloads"),
+                                             fmt::format("--x-buildtrees-root={}", root / "buildtrees"),
+                                             fmt::format("--x-install-root={}", root / "installed"),
+                                             fmt::format("--x-packages-root={}", root / "packages"),
+                                             "--classic"};
+            return VcpkgCmdArguments::create_from_arg_sequence(std::begin(arguments), std::end(arguments));
+        }
+
+        VcpkgCmdArguments args;
+        VcpkgPaths paths;
+    };
+}
+
 TEST_CASE ("PackagesDirAssigner_generate", "[build]")
 {
     Path prefix{"example_prefix"};
@@ -45,3 +85,231 @@ TEST_CASE ("is_package_dir_match", "[build]")
     REQUIRE(!is_package_dir_match("non_empty", ""));
     REQUIRE(!is_package_dir_match("anotherpackage_123", "another"));
 }
+
+TEST_CASE ("estimate_memory_usage counts shared abi info once", "[build]")
+{
+    PackagesDirAssigner packages_dir_assigner{"test_packages_root"};
+    SourceControlFileAndLocation scfl;
+    auto& scf = *(scfl.source_control_file = std::make_unique<SourceControlFile>());
+    scf.core_paragraph = std::make_unique<SourceParagraph>();
+    scf.core_paragraph->name = "zlib";
+
+    auto port_dir_info = std::make_shared<PortDirAbiInfoCacheEntry>();
+    port_dir_info->files = {"a-port-file-with-a-name-too-long-for-inline-storage.cmake", "vcpkg.json"};
+    port_dir_info->hashes = {std::string(64, 'a'), std::string(64, 'b')};
+    port_dir_info->heuristic_resources.insert("name", Json::Value::string("zlib"));
+
+    ActionPlan plan;
+    for (auto triplet : {Test::X86_WINDOWS, Test::X64_WINDOWS})
+    {
+        auto& action = plan.install_actions.emplace_back(PackageSpec{"zlib", triplet},
+                                                         scfl,
+                                                         packages_dir_assigner,
+                                                         RequestType::USER_REQUESTED,
+                                                         UseHeadVersion::No,
+                                                         Editable::No,
+                                                         std::map<std::string, std::vector<FeatureSpec>>{},
+                                                         std::vector<LocalizedString>{},
+                                                         std::vector<std::string>{});
+        auto& abi_info = action.abi_info.emplace();
+        abi_info.package_abi = std::string(64, 'c');
+        abi_info.port_dir_info = port_dir_info;
+    }
+
+    const auto one_port_dir = estimate_memory_usage(plan);
+    CHECK(one_port_dir.install_actions == 2);
+    CHECK(one_port_dir.action_bytes >= 2 * (sizeof(InstallPlanAction) + 64));
+    CHECK(one_port_dir.pre_build_infos == 0);
+    CHECK(one_port_dir.port_dirs == 1);
+    CHECK(one_port_dir.shared_bytes > 2 * 64);
+
+    plan.install_actions[1].abi_info.get()->port_dir_info = std::make_shared<PortDirAbiInfoCacheEntry>(*port_dir_info);
+    const auto two_port_dirs = estimate_memory_usage(plan);
+    CHECK(two_port_dirs.action_bytes == one_port_dir.action_bytes);
+    CHECK(two_port_dirs.port_dirs == 2);
+    CHECK(two_port_dirs.shared_bytes == 2 * one_port_dir.shared_bytes);
+}
+
+TEST_CASE ("compute_all_abis shares pre-build infos", "[build]")
+{
+    auto& fs = real_filesystem;
+    const auto root = Test::base_temporary_directory() / "compute-all-abis-shares";
+    TestVcpkgRoot test_root{root};
+    const auto& paths = test_root.paths;
+
+    PackagesDirAssigner packages_dir_assigner{"test_packages_root"};
+    SourceControlFileAndLocation scfl;
+    auto& scf = *(scfl.source_control_file = std::make_unique<SourceControlFile>());
+    scf.core_paragraph = std::make_unique<SourceParagraph>();
+    scf.core_paragraph->name = "zlib";
+
+    Test::MockCMakeVarProvider var_provider;
+    ActionPlan plan;
+    const auto add_action = [&](StringView port_name, Triplet triplet, StringView toolchain) {
+        PackageSpec spec{port_name.to_string(), triplet};
+        var_provider.tag_vars[spec] = {{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"},
+                                       {"VCPKG_TARGET_ARCHITECTURE", "x64"},
+                                       {"VCPKG_CHAINLOAD_TOOLCHAIN_FILE", toolchain.to_string()}};
+        // --head actions stop computing their ABI right after the pre-build info is assigned
+        plan.install_actions.emplace_back(std::move(spec),
+                                          scfl,
+                                          packages_dir_assigner,
+                                          RequestType::USER_REQUESTED,
+                                          UseHeadVersion::Yes,
+                                          Editable::No,
+                                          std::map<std::string, std::vector<FeatureSpec>>{},
+                                          std::vector<LocalizedString>{},
+                                          std::vector<std::string>{});
+    };
+
+    add_action("zlib", Test::X64_LINUX, "a.cmake");
+    add_action("fmt", Test::X64_LINUX, "a.cmake");
+    add_action("curl", Test::X64_LINUX, "b.cmake");
+    add_action("zlib", Test::X64_OSX, "a.cmake");
+
+    StatusParagraphs status_db;
+    compute_all_abis(paths, plan, var_provider, status_db);
+    const auto pre_build_info = [&](size_t idx) {
+        return plan.install_actions[idx].abi_info.value_or_exit(VCPKG_LINE_INFO).pre_build_info;
+    };
+
+    REQUIRE(pre_build_info(0));
+    // equal triplets and tag variables share one pre-build info
+    CHECK(pre_build_info(0) == pre_build_info(1));
+    CHECK(pre_build_info(0)->external_toolchain_file.value_or_exit(VCPKG_LINE_INFO) == "a.cmake");
+    // different tag variables or triplets don't
+    CHECK(pre_build_info(2) != pre_build_info(0));
+    CHECK(pre_build_info(2)->external_toolchain_file.value_or_exit(VCPKG_LINE_INFO) == "b.cmake");
+    CHECK(pre_build_info(3) != pre_build_info(0));
+    CHECK(pre_build_info(3)->triplet == Test::X64_OSX);
+
+    const auto usage = estimate_memory_usage(plan);
+    CHECK(usage.install_actions == 4);
+    CHECK(usage.pre_build_infos == 3);
+
+    fs.remove_all(root, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("estimate_memory_usage of a synthetic plan", "[build]")
+{
+    // 400 ports with typical port directories and dependencies, each installed for 3 triplets, laid out as
+    // compute_all_abis and share_dependency_lists share them and as each action used to own them
+    const auto root = Test::base_temporary_directory() / "estimate-memory-synthetic";
+    TestVcpkgRoot test_root{root};
+    const std::unordered_map<std::string, std::string> tag_vars{
+        {"VCPKG_CMAKE_SYSTEM_NAME", "Linux"},
+        {"VCPKG_TARGET_ARCHITECTURE", "x64"},
+        {"VCPKG_ENV_PASSTHROUGH", "PATH;LD_LIBRARY_PATH;PKG_CONFIG_PATH"},
+        {"VCPKG_CHAINLOAD_TOOLCHAIN_FILE", "/opt/toolchains/linux-gcc-toolchain-with-a-long-name.cmake"}};
+    const Triplet triplets[] = {Test::X64_LINUX, Test::X64_OSX, Test::X86_WINDOWS};
+
+    PackagesDirAssigner packages_dir_assigner{"test_packages_root"};
+    std::vector<SourceControlFileAndLocation> scfls(400);
+    ActionPlan shared_plan;
+    ActionPlan private_plan;
+    std::vector<std::shared_ptr<const PreBuildInfo>> pre_build_infos;
+    for (auto triplet : triplets)
+    {
+        pre_build_infos.push_back(std::make_shared<const PreBuildInfo>(test_root.paths, triplet, tag_vars));
+    }
+
+    for (size_t port = 0; port < scfls.size(); ++port)
+    {
+        auto& scfl = scfls[port];
+        auto& scf = *(scfl.source_control_file = std::make_unique<SourceControlFile>());
+        scf.core_paragraph = std::make_unique<SourceParagraph>();
+        scf.core_paragraph->name = fmt::format("synthetic-port-{}", port);
+
+        auto port_dir_info = std::make_shared<PortDirAbiInfoCacheEntry>();
+        static constexpr StringLiteral files[] = {
+            "portfile.cmake", "vcpkg.json", "usage", "fix-build-with-newer-compilers.patch", "fix-install-paths.patch"};
+        for (auto&& file : files)
+        {
+            port_dir_info->files.emplace_back(file);
+            port_dir_info->hashes.push_back(std::string(64, 'a'));
+            port_dir_info->abi_entries.emplace_back(file, port_dir_info->hashes.back());
+        }
+
+        port_dir_info->heuristic_resources.insert("SPDXID", Json::Value::string("SPDXRef-resource-1"));
+        port_dir_info->heuristic_resources.insert(
+            "downloadLocation", Json::Value::string("git+https://github.com/example/synthetic-port@v1.2.3"));
+        // before sharing, actions copied the files, hashes and resources, but not the ABI entries
+        PortDirAbiInfoCacheEntry private_copy = *port_dir_info;
+        private_copy.abi_entries.clear();
+
+        for (size_t triplet_index = 0; triplet_index < 3; ++triplet_index)
+        {
+            const PackageSpec spec{scf.core_paragraph->name, triplets[triplet_index]};
+            // like most ports, depend on the CMake helper ports, and some on zlib or on openssl for a feature
+            const auto make_feature_dependencies = [&] {
+                std::map<std::string, std::vector<FeatureSpec>> feature_dependencies;
+                auto& core = feature_dependencies[FeatureNameCore.to_string()];
+                core.emplace_back(PackageSpec{"vcpkg-cmake", Test::X64_LINUX}, FeatureNameCore);
+                core.emplace_back(PackageSpec{"vcpkg-cmake-config", Test::X64_LINUX}, FeatureNameCore);
+                if (port % 3 == 0)
+                {
+                    core.emplace_back(PackageSpec{"zlib", spec.triplet()}, FeatureNameCore);
+                }
+
+                if (port % 5 == 0)
+                {
+                    feature_dependencies["ssl"].emplace_back(PackageSpec{"openssl", spec.triplet()},
+                                                             FeatureNameCore);
+                }
+
+                return feature_dependencies;
+            };
+
+            for (auto* plan : {&shared_plan, &private_plan})
+            {
+                auto& action = plan->install_actions.emplace_back(spec,
+                                                                  scfl,
+                                                                  packages_dir_assigner,
+                                                                  RequestType::USER_REQUESTED,
+                                                                  UseHeadVersion::No,
+                                                                  Editable::No,
+                                                                  make_feature_dependencies(),
+                                                                  std::vector<LocalizedString>{},
+                                                                  std::vector<std::string>{});
+                auto& abi_info = action.abi_info.emplace();
+                abi_info.package_abi = std::string(64, 'c');
+                abi_info.abi_tag_file.emplace(root / "buildtrees" / spec.name() /
+                                              fmt::format("{}.vcpkg_abi_info.txt", spec.triplet()));
+                if (plan == &shared_plan)
+                {
+                    abi_info.pre_build_info = pre_build_infos[triplet_index];
+                    abi_info.port_dir_info = port_dir_info;
+                }
+                else
+                {
+                    abi_info.pre_build_info =
+                        std::make_shared<const PreBuildInfo>(test_root.paths, spec.triplet(), tag_vars);
+                    abi_info.port_dir_info = std::make_shared<const PortDirAbiInfoCacheEntry>(private_copy);
+                }
+            }
+        }
+    }
+
+    shared_plan.share_dependency_lists();
+    const auto shared = estimate_memory_usage(shared_plan);
+    const auto owned = estimate_memory_usage(private_plan);
+    CHECK(shared.install_actions == 1200);
+    CHECK(shared.pre_build_infos == 3);
+    CHECK(shared.port_dirs == 400);
+    // package dependencies: 1 without zlib or openssl, and one per triplet for each of the 3 combinations with them;
+    // feature lists: with and without ssl; core feature dependencies: 1 without zlib, 3 with it; ssl dependencies: 3
+    CHECK(shared.dependency_lists == 10 + 2 + 4 + 3);
+    CHECK(owned.pre_build_infos == 1200);
+    CHECK(owned.port_dirs == 1200);
+    CHECK(owned.dependency_lists == 1200 * 3 + 3 * 80);
+    const auto shared_total = shared.action_bytes + shared.shared_bytes;
+    const auto owned_total = owned.action_bytes + owned.shared_bytes;
+    INFO("shared: " << shared.to_string() << "\nowned: " << owned.to_string());
+    // measured: 1617.8 KiB shared against 2778.5 KiB owned; the shared data itself shrinks 2.5x, but the fixed size of
+    // each action now dominates
+    CHECK(shared.action_bytes == owned.action_bytes);
+    CHECK(shared.shared_bytes * 2 < owned.shared_bytes);
+    CHECK(shared_total * 3 < owned_total * 2);
+
+    real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+}
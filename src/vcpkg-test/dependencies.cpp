@@ -707,6 +707,96 @@ TEST_CASE ("version install diamond relaxed", "[versionplan]")
     check_name_and_version(install_plan.install_actions[2], "a", {"3", 0});
 }
 
+struct PrefetchRecordingPortfileProvider : MockVersionedPortfileProvider
+{
+    // each batch of prefetched versions, sorted
+    mutable std::vector<std::vector<std::string>> prefetched;
+
+    void prefetch(View<VersionSpec> version_specs) const override
+    {
+        prefetched.push_back(Util::fmap(version_specs, [](const VersionSpec& spec) { return spec.to_string(); }));
+        Util::sort_unique_erase(prefetched.back());
+    }
+};
+
+TEST_CASE ("version install prefetches pending versions together", "[versionplan]")
+{
+    MockBaselineProvider bp;
+    bp.v["a"] = {"2", 0};
+    bp.v["b"] = {"3", 0};
+    bp.v["c"] = {"5", 1};
+
+    PrefetchRecordingPortfileProvider vp;
+    vp.emplace("a", {"2", 0}, VersionScheme::Relaxed);
+    vp.emplace("a", {"3", 0}, VersionScheme::Relaxed).source_control_file->core_paragraph->dependencies = {
+        Dependency{"b", {}, {}, DependencyConstraint{VersionConstraintKind::Minimum, Version{"2", 1}}},
+        Dependency{"c", {}, {}, DependencyConstraint{VersionConstraintKind::Minimum, Version{"5", 1}}},
+    };
+    vp.emplace("b", {"2", 1}, VersionScheme::Relaxed);
+    vp.emplace("b", {"3", 0}, VersionScheme::Relaxed).source_control_file->core_paragraph->dependencies = {
+        Dependency{"c", {}, {}, DependencyConstraint{VersionConstraintKind::Minimum, Version{"9", 2}}},
+    };
+    vp.emplace("c", {"5", 1}, VersionScheme::Relaxed);
+    vp.emplace("c", {"9", 2}, VersionScheme::Relaxed);
+
+    MockCMakeVarProvider var_provider;
+
+    WITH_EXPECTED(
+        install_plan,
+        create_versioned_install_plan(vp,
+                                      bp,
+                                      var_provider,
+                                      {
+                                          Dependency{"a", {}, {}, {VersionConstraintKind::Minimum, Version{"3", 0}}},
+                                          Dependency{"b", {}, {}, {VersionConstraintKind::Minimum, Version{"2", 1}}},
+                                      },
+                                      {},
+                                      toplevel_spec()));
+
+    REQUIRE(install_plan.size() == 3);
+    check_name_and_version(install_plan.install_actions[0], "c", {"9", 2});
+    check_name_and_version(install_plan.install_actions[1], "b", {"3", 0});
+    check_name_and_version(install_plan.install_actions[2], "a", {"3", 0});
+
+    // the baseline and minimum versions of the roots are loaded together, then both versions of c, which are first
+    // needed by b, along with the version a requires
+    const std::vector<std::vector<std::string>> expected{{"a@2", "a@3", "b@2#1", "b@3"}, {"c@5#1", "c@9#2"}};
+    CHECK(vp.prefetched == expected);
+}
+
+TEST_CASE ("version install does not prefetch minimum versions of overridden ports", "[versionplan]")
+{
+    MockBaselineProvider bp;
+    bp.v["a"] = {"2", 0};
+    bp.v["b"] = {"1", 0};
+
+    PrefetchRecordingPortfileProvider vp;
+    vp.emplace("a", {"2", 0}, VersionScheme::Relaxed).source_control_file->core_paragraph->dependencies = {
+        Dependency{"b", {}, {}, DependencyConstraint{VersionConstraintKind::Minimum, Version{"3", 0}}},
+    };
+    vp.emplace("b", {"1", 0}, VersionScheme::Relaxed);
+    vp.emplace("b", {"2", 0}, VersionScheme::Relaxed);
+    vp.emplace("b", {"3", 0}, VersionScheme::Relaxed);
+
+    MockCMakeVarProvider var_provider;
+
+    WITH_EXPECTED(install_plan,
+                  create_versioned_install_plan(vp,
+                                                bp,
+                                                var_provider,
+                                                {Dependency{"a"}},
+                                                {DependencyOverride{"b", Version{"2", 0}}},
+                                                toplevel_spec()));
+
+    REQUIRE(install_plan.size() == 2);
+    check_name_and_version(install_plan.install_actions[0], "b", {"2", 0});
+    check_name_and_version(install_plan.install_actions[1], "a", {"2", 0});
+
+    // the override of b is loaded, but not the minimum version a requires, which resolution ignores
+    const std::vector<std::vector<std::string>> expected{{"a@2"}, {"b@2"}};
+    CHECK(vp.prefetched == expected);
+}
+
 TEST_CASE ("version parse semver", "[versionplan]")
 {
     check_semver_version(DotVersion::try_parse_semver("1.2.3"), "1.2.3", "", 1, 2, 3, {});
@@ -892,6 +982,89 @@ TEST_CASE ("version compare string", "[versionplan]")
     CHECK(VerComp::unk == compare_versions(VersionScheme::String, a_1, VersionScheme::String, b_1));
 }
 
+TEST_CASE ("version compare keys", "[versionplan]")
+{
+    const std::vector<SchemedVersion> versions{
+        {VersionScheme::Relaxed, {"1", 0}},
+        {VersionScheme::Relaxed, {"1.0", 0}},
+        {VersionScheme::Relaxed, {"1.0.0", 1}},
+        {VersionScheme::Semver, {"1.0.0", 0}},
+        {VersionScheme::Semver, {"1.0.0+build.1", 0}},
+        {VersionScheme::Semver, {"1.0.0-alpha", 0}},
+        {VersionScheme::Semver, {"1.0.0-alpha.1", 0}},
+        {VersionScheme::Semver, {"1.0.0-alpha.beta", 0}},
+        {VersionScheme::Semver, {"1.0.0-beta.2", 0}},
+        {VersionScheme::Semver, {"1.0.0-beta.20", 0}},
+        {VersionScheme::Semver, {"1.0.0-0alpha", 0}},
+        {VersionScheme::Relaxed, {"1.0.0-1", 0}},
+        {VersionScheme::Relaxed, {"2.1-alpha.alpha", 0}},
+        {VersionScheme::Relaxed, {"1.10.1", 2}},
+        {VersionScheme::Date, {"2020-12-31", 0}},
+        {VersionScheme::Date, {"2021-01-01", 0}},
+        {VersionScheme::Date, {"2021-01-01.1", 0}},
+        {VersionScheme::Date, {"2021-01-01.1.0", 0}},
+        {VersionScheme::Date, {"2021-01-01.10", 3}},
+        {VersionScheme::String, {"a", 0}},
+        {VersionScheme::String, {"a", 1}},
+        {VersionScheme::String, {"b", 0}},
+        {VersionScheme::Missing, {"", 0}},
+    };
+
+    // compares by parsing the text each time
+    auto compare_texts = [](const SchemedVersion& a, const SchemedVersion& b) {
+        auto is_dot = [](VersionScheme scheme) {
+            return scheme == VersionScheme::Semver || scheme == VersionScheme::Relaxed;
+        };
+
+        VerComp texts = VerComp::unk;
+        if (is_dot(a.scheme) && is_dot(b.scheme))
+        {
+            texts = compare(DotVersion::try_parse(a.version.text, a.scheme).value_or_exit(VCPKG_LINE_INFO),
+                            DotVersion::try_parse(b.version.text, b.scheme).value_or_exit(VCPKG_LINE_INFO));
+        }
+        else if (a.scheme == VersionScheme::Date && b.scheme == VersionScheme::Date)
+        {
+            texts = compare(DateVersion::try_parse(a.version.text).value_or_exit(VCPKG_LINE_INFO),
+                            DateVersion::try_parse(b.version.text).value_or_exit(VCPKG_LINE_INFO));
+        }
+        else if (a.scheme == VersionScheme::String && b.scheme == VersionScheme::String &&
+                 a.version.text == b.version.text)
+        {
+            texts = VerComp::eq;
+        }
+
+        if (texts != VerComp::eq) return texts;
+        if (a.version.port_version == b.version.port_version) return VerComp::eq;
+        return a.version.port_version < b.version.port_version ? VerComp::lt : VerComp::gt;
+    };
+
+    const auto keys = Util::fmap(
+        versions, [](const SchemedVersion& v) { return VersionKey::try_parse(v).value_or_exit(VCPKG_LINE_INFO); });
+    for (size_t i = 0; i < versions.size(); ++i)
+    {
+        for (size_t j = 0; j < versions.size(); ++j)
+        {
+            INFO(versions[i].version.to_string() << " vs " << versions[j].version.to_string());
+            const auto expected = compare_texts(versions[i], versions[j]);
+            CHECK(compare(keys[i], keys[j]) == expected);
+            CHECK(compare_versions(versions[i], versions[j]) == expected);
+        }
+    }
+
+    CHECK(compare(keys[5], keys[3]) == VerComp::lt);
+    CHECK(compare(keys[3], keys[4]) == VerComp::eq);
+    CHECK(compare(keys[11], keys[10]) == VerComp::lt);
+    CHECK(compare(keys[10], keys[5]) == VerComp::lt);
+    CHECK(compare(keys[8], keys[9]) == VerComp::lt);
+    CHECK(compare(keys[15], keys[16]) == VerComp::lt);
+    CHECK(compare(keys[19], keys[21]) == VerComp::unk);
+    CHECK(compare(keys[14], keys[1]) == VerComp::unk);
+
+    CHECK(!VersionKey::try_parse({VersionScheme::Semver, {"1.0", 0}}).has_value());
+    CHECK(!VersionKey::try_parse({VersionScheme::Relaxed, {"1.0-", 0}}).has_value());
+    CHECK(!VersionKey::try_parse({VersionScheme::Date, {"2021-01-01.01", 0}}).has_value());
+}
+
 TEST_CASE ("version compare_any", "[versionplan]")
 {
     const Version a_0("a", 0);
@@ -1909,6 +2082,84 @@ TEST_CASE ("version install qualified features", "[versionplan]")
     check_name_and_version(install_plan.install_actions[2], "b", {"1", 0}, {"x"});
 }
 
+TEST_CASE ("version install shared resolution context", "[versionplan]")
+{
+    MockVersionedPortfileProvider vp;
+
+    auto& b_scf = vp.emplace("b", {"1", 0}, VersionScheme::Relaxed).source_control_file;
+    b_scf->feature_paragraphs.push_back(make_fpgh("x"));
+    b_scf->feature_paragraphs.back()->dependencies.push_back({"a", {}, parse_platform("!linux")});
+    b_scf->feature_paragraphs.back()->dependencies.push_back({"c", {{"z", parse_platform("linux")}}});
+
+    vp.emplace("a", {"1", 0}, VersionScheme::Relaxed);
+    vp.emplace("a", {"2", 0}, VersionScheme::Relaxed).source_control_file->core_paragraph->dependencies.push_back(
+        {"d"});
+
+    auto& c_scf = vp.emplace("c", {"1", 0}, VersionScheme::Relaxed).source_control_file;
+    c_scf->feature_paragraphs.push_back(make_fpgh("z"));
+    c_scf->feature_paragraphs.back()->dependencies.push_back({"d"});
+
+    vp.emplace("d", {"1", 0}, VersionScheme::Relaxed);
+
+    MockBaselineProvider bp;
+    bp.v["a"] = {"1", 0};
+    bp.v["b"] = {"1", 0};
+    bp.v["c"] = {"1", 0};
+    bp.v["d"] = {"1", 0};
+
+    const PackageSpec c_spec{"c", Test::X86_WINDOWS};
+    MockCMakeVarProvider shared_var_provider;
+    shared_var_provider.dep_info_vars[c_spec] = {{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}};
+    ResolutionContext resolution_context;
+    CreateInstallPlanOptions shared_options{
+        nullptr, Test::ARM_UWP, UnsupportedPortAction::Error, UseHeadVersion::No, Editable::No};
+    shared_options.resolution_context = &resolution_context;
+
+    struct Request
+    {
+        std::vector<Dependency> deps;
+        std::vector<DependencyOverride> overrides;
+    };
+
+    // Plans built one after another with the same context must match plans resolved from scratch, including after
+    // an override selects another version of a port
+    const Request requests[] = {
+        {{Dependency{"b", {{"x"}}}}, {}},
+        {{CoreDependency{"b"}, Dependency{"a"}}, {}},
+        {{Dependency{"b", {{"x"}}}}, {DependencyOverride{"a", Version{"2", 0}}}},
+        {{Dependency{"c", {{"z"}}}, Dependency{"a"}}, {}},
+        {{Dependency{"b", {{"x"}}}}, {}},
+    };
+
+    for (auto&& request : requests)
+    {
+        MockCMakeVarProvider var_provider;
+        var_provider.dep_info_vars[c_spec] = {{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}};
+        WITH_EXPECTED(expected,
+                      create_versioned_install_plan(
+                          vp, bp, var_provider, request.deps, request.overrides, toplevel_spec()));
+
+        PackagesDirAssigner packages_dir_assigner{"pkgs"};
+        WITH_EXPECTED(actual,
+                      create_versioned_install_plan(vp,
+                                                    bp,
+                                                    s_empty_mock_overlay,
+                                                    shared_var_provider,
+                                                    request.deps,
+                                                    request.overrides,
+                                                    toplevel_spec(),
+                                                    packages_dir_assigner,
+                                                    shared_options));
+
+        REQUIRE(actual.install_actions.size() == expected.install_actions.size());
+        for (std::size_t i = 0; i < actual.install_actions.size(); ++i)
+        {
+            CHECK(actual.install_actions[i].display_name() == expected.install_actions[i].display_name());
+            CHECK(actual.install_actions[i].package_dependencies == expected.install_actions[i].package_dependencies);
+        }
+    }
+}
+
 TEST_CASE ("version install self features", "[versionplan]")
 {
     MockBaselineProvider bp;
@@ -2597,3 +2848,44 @@ TEST_CASE ("dependency graph API snapshot: host and target")
     CHECK(relationship_a == "direct");
     CHECK(dependencies_a.size() == 0);
 }
+
+TEST_CASE ("versioned install plan order", "[versionplan]")
+{
+    MockBaselineProvider bp;
+    bp.v["a"] = {"1", 0};
+    bp.v["b"] = {"1", 0};
+    bp.v["c"] = {"1", 0};
+
+    MockVersionedPortfileProvider vp;
+    vp.emplace("a", {"1", 0}, VersionScheme::Relaxed).source_control_file->core_paragraph->dependencies = {
+        Dependency{"c", {}, {}, {VersionConstraintKind::Minimum, Version{"2", 0}}}};
+    vp.emplace("b", {"1", 0}, VersionScheme::Relaxed).source_control_file->core_paragraph->dependencies = {Dependency{"c"}};
+    vp.emplace("c", {"1", 0}, VersionScheme::Relaxed);
+    vp.emplace("c", {"2", 0}, VersionScheme::Relaxed);
+
+    MockCMakeVarProvider var_provider;
+    auto describe = [&](std::vector<Dependency> dependencies) {
+        auto plan = create_versioned_install_plan(vp, bp, var_provider, dependencies, {}, toplevel_spec())
+                        .value_or_exit(VCPKG_LINE_INFO);
+        std::vector<std::string> actions;
+        for (auto&& action : plan.install_actions)
+        {
+            actions.push_back(fmt::format("{}@{}:{}",
+                                          action.spec,
+                                          action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO)
+                                              .to_version(),
+                                          Strings::join(",", action.package_dependencies)));
+        }
+
+        return actions;
+    };
+
+    // independent packages follow the order they were requested in, whatever numbers they were given
+    const std::vector<std::string> a_first{
+        "c:x86-windows@2:", "a:x86-windows@1:c:x86-windows", "b:x86-windows@1:c:x86-windows"};
+    CHECK(describe({Dependency{"a"}, Dependency{"b"}}) == a_first);
+    const std::vector<std::string> b_first{
+        "c:x86-windows@2:", "b:x86-windows@1:c:x86-windows", "a:x86-windows@1:c:x86-windows"};
+    CHECK(describe({Dependency{"b"}, Dependency{"a"}}) == b_first);
+    CHECK(describe({Dependency{"b"}, Dependency{"c"}, Dependency{"a"}}) == b_first);
+}
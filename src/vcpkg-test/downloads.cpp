@@ -1,7 +1,16 @@
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/downloads.h>
 #include <vcpkg/base/expected.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/system.process.h>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif // ^^^ !_WIN32
 
 using namespace vcpkg;
 
@@ -162,6 +171,180 @@ TEST_CASE ("parse_curl_status_line", "[downloads]")
             "SEC_E_WRONG_PRINCIPAL (0x80090322) - The target principal name is incorrect.");
 }
 
+TEST_CASE ("parse_curl_parallel_status_line", "[downloads]")
+{
+    std::vector<int> http_codes(3, -1);
+    StringLiteral malformed_examples[] = {
+        "asdfasdf",                                      // wrong prefix
+        "curl: unknown --write-out variable: 'urlnum'", // wrong prefixes, and also what old curl does
+        "prefix",                                        // missing urlnum
+        "prefix1",                                       // missing space after urlnum
+        "prefix 200 0 ",                                 // missing urlnum
+        "prefix3 200 0 ",                                // urlnum out of range
+        "prefix1 200",                                   // missing space after http_code
+        "prefix1 200 2a",                                // non numeric exitcode
+        "prefix1 200  ",                                 // old curl that does not know %{exitcode}
+    };
+
+    FullyBufferedDiagnosticContext bdc;
+    for (auto&& malformed : malformed_examples)
+    {
+        REQUIRE(!parse_curl_parallel_status_line(bdc, http_codes, "prefix", malformed).has_value());
+        REQUIRE(http_codes == std::vector<int>{-1, -1, -1});
+        REQUIRE(bdc.empty());
+    }
+
+    // transfers complete out of order
+    REQUIRE(parse_curl_parallel_status_line(bdc, http_codes, "prefix", "prefix2 404 0 ") == Optional<size_t>{2});
+    REQUIRE(http_codes == std::vector<int>{-1, -1, 404});
+    REQUIRE(parse_curl_parallel_status_line(bdc, http_codes, "prefix", "prefix0 200 0 ") == Optional<size_t>{0});
+    REQUIRE(http_codes == std::vector<int>{200, -1, 404});
+    REQUIRE(bdc.empty());
+
+    REQUIRE(parse_curl_parallel_status_line(
+                bdc, http_codes, "prefix", "prefix1 0 7 Failed to connect to localhost port 9: Connection refused") ==
+            Optional<size_t>{1});
+    REQUIRE(http_codes == std::vector<int>{200, 0, 404});
+    REQUIRE(bdc.to_string() ==
+            "error: curl operation failed with error code 7. Failed to connect to localhost port 9: Connection "
+            "refused");
+}
+
+TEST_CASE ("split_curl_parallel_max", "[downloads]")
+{
+    CHECK(split_curl_parallel_max(0, 8, 16).empty());
+    // one command line keeps every connection in one curl
+    CHECK(split_curl_parallel_max(1, 8, 16) == std::vector<unsigned int>{16});
+    CHECK(split_curl_parallel_max(3, 8, 16) == std::vector<unsigned int>{6, 5, 5});
+    // no more processes than cores or connections
+    CHECK(split_curl_parallel_max(10, 2, 5) == std::vector<unsigned int>{3, 2});
+    CHECK(split_curl_parallel_max(10, 8, 3) == std::vector<unsigned int>{1, 1, 1});
+}
+
+#if !defined(_WIN32)
+TEST_CASE ("curl_parallel_bulk_operation", "[downloads]")
+{
+    // A fake curl on PATH that reports the last path segment of each url as its status code, in reverse order, and
+    // never reports urls ending in "unreported"
+    static constexpr StringLiteral fake_curl = R"sh(#!/bin/sh
+log="$(dirname "$0")/invocations"
+marker=
+connections=
+urlnum=0
+lines=
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -w) marker="${2%%%*}"; shift ;;
+        --parallel-max) connections="$2"; shift ;;
+        --retry|-H) shift ;;
+        -*) ;;
+        *)
+            case "${1##*/}" in
+                unreported) ;;
+                refused) lines="${marker}${urlnum} 0 7 Connection refused
+${lines}" ;;
+                *) lines="${marker}${urlnum} ${1##*/} 0 
+${lines}" ;;
+            esac
+            urlnum=$((urlnum + 1)) ;;
+    esac
+    shift
+done
+echo "$connections $urlnum" >> "$log"
+printf '%s' "$lines"
+)sh";
+
+    auto& fs = real_filesystem;
+    const auto fake_curl_dir = Test::base_temporary_directory() / "fake-curl";
+    fs.remove_all(fake_curl_dir, VCPKG_LINE_INFO);
+    fs.create_directories(fake_curl_dir, VCPKG_LINE_INFO);
+    const auto fake_curl_path = fake_curl_dir / "curl";
+    fs.write_contents(fake_curl_path, fake_curl, VCPKG_LINE_INFO);
+    REQUIRE(::chmod(fake_curl_path.c_str(), 0755) == 0);
+
+    // restores PATH however the test exits, so that later tests don't run the fake curl
+    struct PathResetter
+    {
+        Optional<std::string> old_path = get_environment_variable(EnvironmentVariablePath);
+        ~PathResetter() { set_environment_variable(EnvironmentVariablePath, old_path); }
+    } path_resetter;
+    set_environment_variable(
+        EnvironmentVariablePath,
+        fmt::format("{}:{}", fake_curl_dir.native(), path_resetter.old_path.value_or_exit(VCPKG_LINE_INFO)));
+
+    // urls long enough that the operations need several command lines
+    const std::string padding(2000, 'x');
+    std::vector<Command> operations;
+    std::vector<int> expected;
+    for (int idx = 0; idx < 40; ++idx)
+    {
+        std::string status;
+        if (idx % 10 == 3)
+        {
+            status = "unreported";
+            expected.push_back(0);
+        }
+        else if (idx % 10 == 7)
+        {
+            status = "refused";
+            expected.push_back(0);
+        }
+        else
+        {
+            status = std::to_string(200 + idx);
+            expected.push_back(200 + idx);
+        }
+
+        operations.push_back(Command{}.string_arg(fmt::format("https://localhost/{}/{}", padding, status)));
+    }
+
+    FullyBufferedDiagnosticContext bdc;
+    auto results = curl_parallel_bulk_operation(bdc, operations, "--head", {}, {}, 4);
+    CHECK(results == expected);
+
+    // every command line got a share of the 4 connections, and together they ran every operation once
+    auto invocations = Strings::split(fs.read_contents(fake_curl_dir / "invocations", VCPKG_LINE_INFO), '\n');
+    CHECK(invocations.size() > 1);
+    int operation_count = 0;
+    for (auto&& invocation : invocations)
+    {
+        auto fields = Strings::split(invocation, ' ');
+        REQUIRE(fields.size() == 2);
+        const auto connections = Strings::strto<int>(fields[0]).value_or_exit(VCPKG_LINE_INFO);
+        CHECK(connections >= 1);
+        CHECK(connections <= 4);
+        operation_count += Strings::strto<int>(fields[1]).value_or_exit(VCPKG_LINE_INFO);
+    }
+
+    CHECK(operation_count == 40);
+
+    // refused operations are reported in order, and each command line that left one out reports that
+    auto errors = bdc.to_string();
+    CHECK(errors.find("curl failed to return the expected number of exit codes") != std::string::npos);
+    int refused_count = 0;
+    for (auto&& line : Strings::split(errors, '\n'))
+    {
+        if (line == "error: curl operation failed with error code 7. Connection refused")
+        {
+            ++refused_count;
+        }
+    }
+
+    CHECK(refused_count == 4);
+
+    // operations that can't fit on any command line with the headers fail with an error instead of running curl
+    fs.remove(fake_curl_dir / "invocations", VCPKG_LINE_INFO);
+    const std::string huge_header = "X-Huge: " + std::string(Command::maximum_allowed, 'h');
+    FullyBufferedDiagnosticContext too_long_bdc;
+    results = curl_parallel_bulk_operation(too_long_bdc, operations, "--head", {&huge_header, 1}, {}, 4);
+    CHECK(results == std::vector<int>(40, 0));
+    CHECK(too_long_bdc.to_string() == "error: 40 curl operations were not attempted because they don't fit on a "
+                                      "command line with the configured headers.");
+    CHECK(!fs.exists(fake_curl_dir / "invocations", VCPKG_LINE_INFO));
+    fs.remove_all(fake_curl_dir, VCPKG_LINE_INFO);
+}
+#endif // ^^^ !_WIN32
+
 TEST_CASE ("download_files", "[downloads]")
 {
     auto const dst = Test::base_temporary_directory() / "download_files";
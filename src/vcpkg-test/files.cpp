@@ -616,6 +616,17 @@ static void set_readonly(const Path& target)
 #endif // ^^^ !_WIN32
 }
 
+static bool is_readonly(const Path& target)
+{
+#if defined(_WIN32)
+    const DWORD attributes = ::GetFileAttributesW(Strings::to_utf16(target.native()).c_str());
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_READONLY) != 0;
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+    struct stat s;
+    return ::stat(target.c_str(), &s) == 0 && (s.st_mode & 0222) == 0;
+#endif // ^^^ !_WIN32
+}
+
 TEST_CASE ("remove readonly", "[files]")
 {
     urbg_t urbg;
@@ -917,6 +928,81 @@ TEST_CASE ("copy_file", "[files]")
     CHECK_EC_ON_FILE(temp_dir, ec);
 }
 
+TEST_CASE ("clone_file", "[files]")
+{
+    urbg_t urbg;
+
+    auto& fs = setup();
+
+    auto temp_dir = base_temporary_directory() / get_random_filename(urbg, "_clone_file");
+    INFO("temp dir is: " << temp_dir.native());
+
+    fs.create_directory(temp_dir, VCPKG_LINE_INFO);
+    const auto existing_from = temp_dir / "a";
+    constexpr StringLiteral existing_from_contents = "hello there";
+    fs.write_contents(existing_from, existing_from_contents, VCPKG_LINE_INFO);
+    const auto existing_to = temp_dir / "already_existing";
+    constexpr StringLiteral existing_to_contents = "already existing file";
+    fs.write_contents(existing_to, existing_to_contents, VCPKG_LINE_INFO);
+
+    std::error_code ec;
+    fs.clone_file(temp_dir, temp_dir / "b", ec);
+    REQUIRE(ec);
+    REQUIRE(!fs.exists(temp_dir / "b", VCPKG_LINE_INFO));
+
+    // an existing destination is never replaced
+    fs.clone_file(existing_from, existing_to, ec);
+    REQUIRE(ec);
+    REQUIRE(fs.read_contents(existing_to, VCPKG_LINE_INFO) == existing_to_contents);
+
+    // whether cloning works depends on the filesystem, but it either makes an independent copy or leaves nothing
+    const auto clone = temp_dir / "clone";
+    fs.clone_file(existing_from, clone, ec);
+    if (ec)
+    {
+        REQUIRE(!fs.exists(clone, VCPKG_LINE_INFO));
+    }
+    else
+    {
+        REQUIRE(fs.read_contents(clone, VCPKG_LINE_INFO) == existing_from_contents);
+        fs.write_contents(clone, "changed", VCPKG_LINE_INFO);
+        REQUIRE(fs.read_contents(existing_from, VCPKG_LINE_INFO) == existing_from_contents);
+    }
+
+    Path fp;
+    fs.remove_all(temp_dir, ec, fp);
+    CHECK_EC_ON_FILE(fp, ec);
+}
+
+TEST_CASE ("make_read_only", "[files]")
+{
+    urbg_t urbg;
+
+    auto& fs = setup();
+
+    auto temp_dir = base_temporary_directory() / get_random_filename(urbg, "_make_read_only");
+    INFO("temp dir is: " << temp_dir.native());
+
+    fs.create_directory(temp_dir, VCPKG_LINE_INFO);
+    const auto target = temp_dir / "a";
+    fs.write_contents(target, "hello there", VCPKG_LINE_INFO);
+    REQUIRE(!is_readonly(target));
+
+    std::error_code ec;
+    fs.make_read_only(target, ec);
+    CHECK_EC_ON_FILE(target, ec);
+    CHECK(is_readonly(target));
+    CHECK(fs.read_contents(target, VCPKG_LINE_INFO) == "hello there");
+
+    fs.make_read_only(temp_dir / "missing", ec);
+    CHECK(ec);
+
+    // read-only files can still be removed
+    Path fp;
+    fs.remove_all(temp_dir, ec, fp);
+    CHECK_EC_ON_FILE(fp, ec);
+}
+
 TEST_CASE ("rename", "[files]")
 {
     urbg_t urbg;
@@ -1,9 +1,34 @@
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/files.h>
 #include <vcpkg/base/git.h>
+#include <vcpkg/base/system.process.h>
 
 using namespace vcpkg;
 
+namespace
+{
+    // Makes `repo`, with the files already written there, a git repository with them all in a single commit
+    void commit_test_repo(const Path& git_exe, const Path& repo)
+    {
+        auto run_git = [&](std::initializer_list<StringLiteral> args) {
+            Command cmd{git_exe};
+            cmd.string_arg("-C").string_arg(repo).string_arg("-c").string_arg("user.name=vcpkg");
+            cmd.string_arg("-c").string_arg("user.email=vcpkg@example.com");
+            for (auto&& arg : args)
+            {
+                cmd.string_arg(arg);
+            }
+
+            REQUIRE(cmd_execute_and_capture_output(cmd).value_or_exit(VCPKG_LINE_INFO).exit_code == 0);
+        };
+
+        run_git({"init", "-q"});
+        run_git({"add", "."});
+        run_git({"commit", "-q", "-m", "initial"});
+    }
+}
+
 TEST_CASE ("parse_git_ls_tree_output", "[git]")
 {
     static constexpr StringLiteral test_data =
@@ -294,3 +319,194 @@ TEST_CASE ("parse_git_diff_tree_line_failures", "[git]")
         ":100644 100644 abcd123abcd123abcd123abcd123abcd123 abcd123abcd123abcd123abcd123abcd123 M\0file1";
     REQUIRE(!parse_git_diff_tree_line(test_out, test_missing_term.begin(), test_missing_term.end()));
 }
+
+TEST_CASE ("parse_git_cat_file_header", "[git]")
+{
+    FullyBufferedDiagnosticContext bdc;
+    auto maybe_header = parse_git_cat_file_header(
+        bdc, "HEAD:versions/baseline.json", "7c8ffbd27ed5b5f5f0d93d5a46a0c8dfbdaf2e42 blob 1234");
+    auto header = maybe_header.get();
+    REQUIRE(header);
+    REQUIRE(header->object_id == "7c8ffbd27ed5b5f5f0d93d5a46a0c8dfbdaf2e42");
+    REQUIRE(header->type == "blob");
+    REQUIRE(header->size == 1234);
+    REQUIRE(bdc.empty());
+
+    REQUIRE(is_git_cat_file_missing_reply("HEAD:versions/nope.json", "HEAD:versions/nope.json missing"));
+    REQUIRE(!is_git_cat_file_missing_reply("HEAD:versions/nope.json", "HEAD:versions/nope.json ambiguous"));
+    REQUIRE(!is_git_cat_file_missing_reply("missing", "7c8ffbd27ed5b5f5f0d93d5a46a0c8dfbdaf2e42 blob 1234"));
+    REQUIRE(!parse_git_cat_file_header(bdc, "HEAD:versions/nope.json", "HEAD:versions/nope.json missing"));
+    REQUIRE(bdc.to_string() == "error: git object HEAD:versions/nope.json does not exist");
+
+    FullyBufferedDiagnosticContext bdc_ambiguous;
+    REQUIRE(!parse_git_cat_file_header(bdc_ambiguous, "abcd", "abcd ambiguous"));
+    REQUIRE(!bdc_ambiguous.empty());
+
+    FullyBufferedDiagnosticContext bdc_bad_size;
+    REQUIRE(!parse_git_cat_file_header(bdc_bad_size, "HEAD", "7c8ffbd27ed5b5f5f0d93d5a46a0c8dfbdaf2e42 commit lots"));
+    REQUIRE(!bdc_bad_size.empty());
+}
+
+TEST_CASE ("parse_git_tree_entry_names", "[git]")
+{
+    const std::string object_id(20, '\x7c');
+    const std::string tree = "100644 vcpkg.json" + std::string(1, '\0') + object_id + "40000 sub dir" +
+                             std::string(1, '\0') + object_id;
+    auto maybe_names = parse_git_tree_entry_names(tree, 20);
+    auto names = maybe_names.get();
+    REQUIRE(names);
+    REQUIRE(*names == std::vector<std::string>{"vcpkg.json", "sub dir"});
+
+    REQUIRE(parse_git_tree_entry_names("", 20).value_or_exit(VCPKG_LINE_INFO).empty());
+    // truncated object id
+    REQUIRE(!parse_git_tree_entry_names(StringView{tree}.substr(0, tree.size() - 1), 20));
+    REQUIRE(!parse_git_tree_entry_names("100644 vcpkg.json", 20));
+}
+
+TEST_CASE ("trim_git_tree_cache", "[git]")
+{
+    auto& fs = real_filesystem;
+    const auto cache_root = Test::base_temporary_directory() / "trim_git_tree_cache";
+    fs.remove_all(cache_root, VCPKG_LINE_INFO);
+    fs.create_directories(cache_root / "unrelated", VCPKG_LINE_INFO);
+    // extracted by an older vcpkg, so it has no stamp
+    static constexpr StringLiteral legacy_tree = "7c8ffbd27ed5b5f5f0d93d5a46a0c8dfbdaf2e42";
+    fs.create_directories(cache_root / legacy_tree, VCPKG_LINE_INFO);
+    fs.write_contents(cache_root / legacy_tree / "vcpkg.json", "0123456789", VCPKG_LINE_INFO);
+    static constexpr StringLiteral trees[] = {"aaaa", "bbbb", "cccc"};
+    for (auto&& tree : trees)
+    {
+        fs.create_directories(cache_root / tree, VCPKG_LINE_INFO);
+        fs.write_contents(cache_root / tree / "vcpkg.json", "{}", VCPKG_LINE_INFO);
+        fs.write_contents(cache_root / fmt::format("{}.stamp", tree), "10", VCPKG_LINE_INFO);
+    }
+
+    auto remaining_trees = [&] {
+        std::size_t remaining = 0;
+        for (auto&& tree : trees)
+        {
+            const bool has_stamp = fs.exists(cache_root / fmt::format("{}.stamp", tree), VCPKG_LINE_INFO);
+            REQUIRE(has_stamp == fs.exists(cache_root / tree, VCPKG_LINE_INFO));
+            remaining += has_stamp;
+        }
+
+        return remaining;
+    };
+
+    trim_git_tree_cache(fs, cache_root, 40);
+    REQUIRE(remaining_trees() == 3);
+    REQUIRE(fs.exists(cache_root / legacy_tree, VCPKG_LINE_INFO));
+    // trees without a stamp are evicted first
+    trim_git_tree_cache(fs, cache_root, 30);
+    REQUIRE(remaining_trees() == 3);
+    REQUIRE(!fs.exists(cache_root / legacy_tree, VCPKG_LINE_INFO));
+    trim_git_tree_cache(fs, cache_root, 25);
+    REQUIRE(remaining_trees() == 2);
+    trim_git_tree_cache(fs, cache_root, 0);
+    REQUIRE(remaining_trees() == 0);
+    // directories that aren't named after a tree weren't put there by vcpkg, so they're left alone
+    REQUIRE(fs.exists(cache_root / "unrelated", VCPKG_LINE_INFO));
+    // evicted trees are renamed away before they are deleted, and nothing of them is left
+    CHECK(fs.get_directories_non_recursive(cache_root, VCPKG_LINE_INFO) == std::vector<Path>{cache_root / "unrelated"});
+}
+
+TEST_CASE ("GitObjectReader reads only blobs", "[git]")
+{
+    auto& fs = real_filesystem;
+    const auto maybe_git = fs.find_from_PATH("git");
+    if (maybe_git.empty())
+    {
+        return;
+    }
+
+    const auto& git_exe = maybe_git.front();
+    const auto repo = Test::base_temporary_directory() / "git_object_reader";
+    fs.remove_all(repo, VCPKG_LINE_INFO);
+    fs.write_contents_and_dirs(repo / "versions" / "baseline.json", "{}\n", VCPKG_LINE_INFO);
+    commit_test_repo(git_exe, repo);
+
+    GitObjectReader reader{git_exe, GitRepoLocatorKind::CurrentDirectory, repo};
+    FullyBufferedDiagnosticContext context;
+    CHECK(reader.read_object(context, "HEAD:versions/baseline.json").value_or_exit(VCPKG_LINE_INFO) == "{}\n");
+    CHECK(context.lines.empty());
+
+    CHECK(!reader.read_object(context, "HEAD:versions"));
+    REQUIRE(context.lines.size() == 1);
+    CHECK(context.lines[0].to_string() == "error: git object HEAD:versions is a tree, not a file");
+
+    // the reader stays usable after the mismatch
+    CHECK(reader.read_tree_entry_names(context, "HEAD:versions").value_or_exit(VCPKG_LINE_INFO) ==
+          std::vector<std::string>{"baseline.json"});
+    fs.remove_all(repo, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("git_extract_tree_cached stamps trees as they are published", "[git]")
+{
+    auto& fs = real_filesystem;
+    const auto maybe_git = fs.find_from_PATH("git");
+    if (maybe_git.empty())
+    {
+        return;
+    }
+
+    const auto& git_exe = maybe_git.front();
+    const auto root = Test::base_temporary_directory() / "git_extract_tree_cached";
+    const auto repo = root / "repo";
+    const auto cache_root = root / "cache";
+    fs.remove_all(root, VCPKG_LINE_INFO);
+    fs.write_contents_and_dirs(repo / "port" / "vcpkg.json", "{}\n", VCPKG_LINE_INFO);
+    fs.write_contents_and_dirs(repo / "port" / "patches" / "fix.patch", "0123456789", VCPKG_LINE_INFO);
+    commit_test_repo(git_exe, repo);
+
+    const GitRepoLocator locator{GitRepoLocatorKind::CurrentDirectory, repo};
+    GitObjectReader reader{git_exe, GitRepoLocatorKind::CurrentDirectory, repo};
+    FullyBufferedDiagnosticContext context;
+    const auto tree = reader.object_id(context, "HEAD:port").value_or_exit(VCPKG_LINE_INFO);
+    const auto stamp_path = cache_root / fmt::format("{}.stamp", tree);
+    auto check_extracted = [&](const Path& destination) {
+        CHECK(fs.read_contents(destination / "vcpkg.json", VCPKG_LINE_INFO) == "{}\n");
+        CHECK(fs.read_contents(destination / "patches" / "fix.patch", VCPKG_LINE_INFO) == "0123456789");
+    };
+
+    REQUIRE(git_extract_tree_cached(context,
+                                    fs,
+                                    git_exe,
+                                    locator,
+                                    cache_root,
+                                    root / "first",
+                                    tree,
+                                    1000));
+    check_extracted(root / "first");
+    CHECK(fs.read_contents(stamp_path, VCPKG_LINE_INFO) == "13");
+    // nothing is left of the staged tree
+    CHECK(fs.get_directories_non_recursive(cache_root, VCPKG_LINE_INFO) == std::vector<Path>{cache_root / tree});
+
+    // a tree extracted by an older vcpkg is stamped when it is reused
+    fs.remove(stamp_path, VCPKG_LINE_INFO);
+    REQUIRE(git_extract_tree_cached(context,
+                                    fs,
+                                    git_exe,
+                                    locator,
+                                    cache_root,
+                                    root / "second",
+                                    tree,
+                                    1000));
+    check_extracted(root / "second");
+    CHECK(fs.read_contents(stamp_path, VCPKG_LINE_INFO) == "13");
+
+    // publishing into a full cache evicts the tree after it has been copied out
+    fs.remove_all(cache_root, VCPKG_LINE_INFO);
+    REQUIRE(git_extract_tree_cached(context,
+                                    fs,
+                                    git_exe,
+                                    locator,
+                                    cache_root,
+                                    root / "third",
+                                    tree,
+                                    0));
+    check_extracted(root / "third");
+    CHECK(fs.get_directories_non_recursive(cache_root, VCPKG_LINE_INFO).empty());
+    CHECK(!fs.exists(stamp_path, VCPKG_LINE_INFO));
+    CHECK(context.lines.empty());
+    fs.remove_all(root, VCPKG_LINE_INFO);
+}
@@ -0,0 +1,92 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/graphs.h>
+#include <vcpkg/base/span.h>
+
+#include <utility>
+#include <vector>
+
+using namespace vcpkg;
+
+namespace
+{
+    // Cycles through 0, 1, 2, ... modulo each `max_exclusive`
+    struct CountingRandomizer final : GraphRandomizer
+    {
+        int random(int max_exclusive) override { return next++ % max_exclusive; }
+
+        int next = 0;
+    };
+}
+
+TEST_CASE ("adjacency arrays from edges", "[graphs]")
+{
+    const std::vector<std::pair<std::size_t, std::size_t>> edges{{2, 0}, {0, 1}, {2, 1}, {0, 3}, {3, 1}};
+    const auto graph = AdjacencyArrays::from_edges(5, edges);
+
+    AdjacencyArrays expected;
+    expected.add_vertex(std::vector<std::size_t>{1, 3});
+    expected.add_vertex({});
+    expected.add_vertex(std::vector<std::size_t>{0, 1});
+    expected.add_vertex(std::vector<std::size_t>{1});
+    expected.add_vertex({});
+
+    CHECK(graph.size() == 5);
+    CHECK(graph.offsets == expected.offsets);
+    CHECK(graph.targets == expected.targets);
+}
+
+TEST_CASE ("topological sort of adjacency arrays", "[graphs]")
+{
+    // 0 -> 1 -> 3, 0 -> 2 -> 3, 4 -> 2; 5 is unreachable
+    AdjacencyArrays graph;
+    graph.add_vertex(std::vector<std::size_t>{1, 2});
+    graph.add_vertex(std::vector<std::size_t>{3});
+    graph.add_vertex(std::vector<std::size_t>{3});
+    graph.add_vertex({});
+    graph.add_vertex(std::vector<std::size_t>{2});
+    graph.add_vertex({});
+
+    const std::vector<std::size_t> starts{4, 0, 4};
+    auto order = topological_sort(graph, starts, nullptr);
+    CHECK(order.cycle.empty());
+    CHECK(order.sorted == std::vector<std::size_t>{3, 2, 4, 1, 0});
+
+    // the starting vertices are shuffled once, then only the adjacency list of 0 is long enough to shuffle: 2 before 1
+    CountingRandomizer randomizer;
+    order = topological_sort(graph, starts, &randomizer);
+    CHECK(order.cycle.empty());
+    CHECK(order.sorted == std::vector<std::size_t>{3, 2, 4, 1, 0});
+    CHECK(randomizer.next == 3);
+}
+
+TEST_CASE ("topological sort of adjacency arrays with a cycle", "[graphs]")
+{
+    // 0 -> 1 -> 2 -> 3 -> 1
+    AdjacencyArrays graph;
+    graph.add_vertex(std::vector<std::size_t>{1});
+    graph.add_vertex(std::vector<std::size_t>{2});
+    graph.add_vertex(std::vector<std::size_t>{3});
+    graph.add_vertex(std::vector<std::size_t>{1});
+
+    const std::vector<std::size_t> starts{0};
+    const auto order = topological_sort(graph, starts, nullptr);
+    CHECK(order.cycle == std::vector<std::size_t>{1, 2, 3});
+}
+
+TEST_CASE ("topological sort of a long chain", "[graphs]")
+{
+    // deep enough to overflow the stack if each vertex took a stack frame
+    constexpr std::size_t length = 1000000;
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for (std::size_t vertex = 1; vertex < length; ++vertex)
+    {
+        edges.emplace_back(vertex, vertex - 1);
+    }
+
+    const std::vector<std::size_t> starts{length - 1};
+    const auto order = topological_sort(AdjacencyArrays::from_edges(length, edges), starts, nullptr);
+    REQUIRE(order.sorted.size() == length);
+    CHECK(order.sorted.front() == 0);
+    CHECK(order.sorted.back() == length - 1);
+}
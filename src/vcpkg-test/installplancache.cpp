@@ -0,0 +1,123 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/system.h>
+
+#include <vcpkg/installplancache.h>
+#include <vcpkg/statusparagraphs.h>
+
+using namespace vcpkg;
+
+namespace
+{
+    InstallPlanWatchedFile stat_file(const Path& path)
+    {
+        return InstallPlanWatchedFile{path,
+                                      real_filesystem.last_write_time(path, VCPKG_LINE_INFO),
+                                      real_filesystem.file_size(path, VCPKG_LINE_INFO)};
+    }
+
+    std::unique_ptr<StatusParagraph> make_installed(const char* name, const char* abi)
+    {
+        auto status_pgh = Test::make_status_pgh(name);
+        status_pgh->package.abi = abi;
+        return status_pgh;
+    }
+}
+
+TEST_CASE ("install plan record serialization", "[install-plan-cache]")
+{
+    InstallPlanRecord record;
+    record.inputs_hash = "inputs";
+    record.watched_files.push_back(InstallPlanWatchedFile{"ports/a/portfile.cmake", -5, 42});
+    record.watched_files.push_back(InstallPlanWatchedFile{"scripts", 7, 0});
+    record.tracked_environment.emplace_back("UNSET", "");
+    record.tracked_environment.emplace_back("SET", "hash");
+    record.actions.push_back(InstallPlanRecordAction{{"a", Test::X86_WINDOWS}, "abi-a", false});
+    record.actions.push_back(InstallPlanRecordAction{{"b", Test::X64_WINDOWS}, "abi-b", true});
+
+    const auto payload = record.serialize();
+    auto maybe_parsed = InstallPlanRecord::parse(payload);
+    auto parsed = maybe_parsed.get();
+    REQUIRE(parsed);
+    CHECK(parsed->inputs_hash == "inputs");
+    REQUIRE(parsed->watched_files.size() == 2);
+    CHECK(parsed->watched_files[0].path == "ports/a/portfile.cmake");
+    CHECK(parsed->watched_files[0].last_write_time == -5);
+    CHECK(parsed->watched_files[0].size == 42);
+    CHECK(parsed->watched_files[1].path == "scripts");
+    CHECK(parsed->tracked_environment == record.tracked_environment);
+    REQUIRE(parsed->actions.size() == 2);
+    CHECK(parsed->actions[0].spec == PackageSpec{"a", Test::X86_WINDOWS});
+    CHECK(parsed->actions[0].package_abi == "abi-a");
+    CHECK(!parsed->actions[0].user_requested);
+    CHECK(parsed->actions[1].spec == PackageSpec{"b", Test::X64_WINDOWS});
+    CHECK(parsed->actions[1].user_requested);
+    CHECK(parsed->serialize() == payload);
+
+    CHECK(!InstallPlanRecord::parse(StringView{payload.data(), payload.size() - 1}).has_value());
+    CHECK(!InstallPlanRecord::parse(payload + "x").has_value());
+}
+
+TEST_CASE ("install plan record inputs", "[install-plan-cache]")
+{
+    auto& fs = real_filesystem;
+    const auto directory = Test::base_temporary_directory() / "install-plan-cache";
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+    fs.create_directories(directory / "port", VCPKG_LINE_INFO);
+    const auto portfile = directory / "port" / "portfile.cmake";
+    fs.write_contents(portfile, "# portfile", VCPKG_LINE_INFO);
+
+    static constexpr StringLiteral variable = "VCPKG_TEST_INSTALL_PLAN_CACHE_VARIABLE";
+    set_environment_variable(variable, "on");
+
+    InstallPlanRecord record;
+    record.watched_files.push_back(stat_file(directory / "port"));
+    record.watched_files.push_back(stat_file(portfile));
+    record.tracked_environment.emplace_back(variable.to_string(), Hash::get_string_sha256("on"));
+    CHECK(record.inputs_unchanged(fs));
+
+    set_environment_variable(variable, "off");
+    CHECK(!record.inputs_unchanged(fs));
+    set_environment_variable(variable, nullopt);
+    CHECK(!record.inputs_unchanged(fs));
+    record.tracked_environment.back().second.clear();
+    CHECK(record.inputs_unchanged(fs));
+
+    fs.write_contents(portfile, "# a longer portfile", VCPKG_LINE_INFO);
+    CHECK(!record.inputs_unchanged(fs));
+    record.watched_files.back() = stat_file(portfile);
+    CHECK(record.inputs_unchanged(fs));
+
+    fs.remove(portfile, VCPKG_LINE_INFO);
+    CHECK(!record.inputs_unchanged(fs));
+}
+
+TEST_CASE ("install plan record installed packages", "[install-plan-cache]")
+{
+    InstallPlanRecord record;
+    record.actions.push_back(InstallPlanRecordAction{{"a", Test::X86_WINDOWS}, "abi-a", true});
+    record.actions.push_back(InstallPlanRecordAction{{"b", Test::X86_WINDOWS}, "abi-b", false});
+
+    std::vector<std::unique_ptr<StatusParagraph>> exact;
+    exact.push_back(make_installed("a", "abi-a"));
+    exact.push_back(make_installed("b", "abi-b"));
+    exact.push_back(Test::make_status_feature_pgh("a", "feature"));
+    CHECK(record.is_installed(StatusParagraphs{std::move(exact)}));
+
+    std::vector<std::unique_ptr<StatusParagraph>> rebuilt;
+    rebuilt.push_back(make_installed("a", "abi-a"));
+    rebuilt.push_back(make_installed("b", "abi-b2"));
+    CHECK(!record.is_installed(StatusParagraphs{std::move(rebuilt)}));
+
+    std::vector<std::unique_ptr<StatusParagraph>> missing;
+    missing.push_back(make_installed("a", "abi-a"));
+    CHECK(!record.is_installed(StatusParagraphs{std::move(missing)}));
+
+    std::vector<std::unique_ptr<StatusParagraph>> extra;
+    extra.push_back(make_installed("a", "abi-a"));
+    extra.push_back(make_installed("b", "abi-b"));
+    extra.push_back(make_installed("c", "abi-c"));
+    CHECK(!record.is_installed(StatusParagraphs{std::move(extra)}));
+}
@@ -0,0 +1,67 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/interned-string.h>
+#include <vcpkg/base/parallel-algorithms.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/packagespec.h>
+
+#include <string>
+#include <vector>
+
+using namespace vcpkg;
+
+TEST_CASE ("interned strings", "[interned-string]")
+{
+    const std::string zlib = "zlib";
+    const InternedString a{zlib};
+    const InternedString b{StringView{"zlib-ng", 4}};
+    CHECK(a == b);
+    CHECK(&a.str() == &b.str());
+    CHECK(a.str() == "zlib");
+    CHECK(a.hash_code() == std::hash<std::string>()(zlib));
+
+    const InternedString c{"curl"};
+    CHECK(a != c);
+    CHECK(c < a);
+    CHECK(!(a < c));
+    CHECK(!(a < b));
+
+    CHECK(InternedString{} == InternedString{""});
+    CHECK(InternedString{}.str().empty());
+    CHECK(InternedString{} < c);
+}
+
+TEST_CASE ("interned strings from many threads", "[interned-string]")
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; ++i)
+    {
+        names.push_back("interned-string-test-" + std::to_string(i % 100));
+    }
+
+    const auto interned = Util::fmap(names, [](const std::string& name) { return InternedString{name}; });
+    std::vector<InternedString> interned_in_parallel(names.size());
+    execute_in_parallel(names.size(), [&](size_t idx) { interned_in_parallel[idx] = InternedString{names[idx]}; });
+    CHECK(interned == interned_in_parallel);
+}
+
+TEST_CASE ("specs share interned names", "[interned-string]")
+{
+    const PackageSpec zlib{"zlib", Test::X64_WINDOWS};
+    const PackageSpec zlib_again{std::string("zlib"), Test::X64_WINDOWS};
+    CHECK(&zlib.name() == &zlib_again.name());
+    CHECK(zlib.interned_name() == InternedString{"zlib"});
+
+    const FeatureSpec bzip2{zlib, "bzip2"};
+    const FeatureSpec bzip2_again{zlib_again, InternedString{"bzip2"}};
+    CHECK(bzip2 == bzip2_again);
+    CHECK(&bzip2.feature() == &bzip2_again.feature());
+    CHECK(std::hash<FeatureSpec>()(bzip2) == std::hash<FeatureSpec>()(bzip2_again));
+
+    // ordered by name, not by when the names were interned
+    const PackageSpec aaa{"interned-string-test-aaa-last", Test::X64_WINDOWS};
+    CHECK(aaa < zlib);
+    CHECK(FeatureSpec(aaa, "z") < FeatureSpec(zlib, "a"));
+    CHECK(FeatureSpec(zlib, "a") < FeatureSpec(zlib, "bzip2"));
+}
@@ -225,6 +225,135 @@ TEST_CASE ("JSON parse full file", "[json]")
     REQUIRE(res);
 }
 
+TEST_CASE ("JSON parse strings across scanning blocks", "[json]")
+{
+    // plain runs of every length up to a few blocks, followed by each kind of byte that ends a run
+    for (size_t size = 0; size < 40; ++size)
+    {
+        const std::string plain(size, 'a');
+        for (StringView tail : {"", "\\n", "\\u00e9", "\\\"", U8_STR("\u00e9"), U8_STR("\U0001F600")})
+        {
+            const auto text = fmt::format("[\"{}{}{}\", 1]", plain, tail, plain);
+            auto res = Json::parse(text, "test");
+            REQUIRE(res);
+            auto& arr = res.get()->value.array(VCPKG_LINE_INFO);
+            REQUIRE(arr.size() == 2);
+            auto expected_tail = tail.to_string();
+            if (tail == "\\n")
+            {
+                expected_tail = "\n";
+            }
+            else if (tail == "\\u00e9")
+            {
+                expected_tail = U8_STR("\u00e9");
+            }
+            else if (tail == "\\\"")
+            {
+                expected_tail = "\"";
+            }
+
+            CHECK(arr[0].string(VCPKG_LINE_INFO) == plain + expected_tail + plain);
+            CHECK(arr[1].integer(VCPKG_LINE_INFO) == 1);
+        }
+    }
+
+    // positions after skipped runs are still exact
+    auto res = Json::parse("{\n    \"key\":  \"abcdefghijklmnopqrstuvwxyz0123456789\" x}", "filename");
+    REQUIRE(!res);
+    CHECK(StringView{res.error().data()}.starts_with(
+        "filename:2:52: error: Unexpected character; expected property or close brace"));
+
+    res = Json::parse("[\"abcdefghijklmnopqrstuvwxyz\x01\"]", "filename");
+    REQUIRE(!res);
+    CHECK(StringView{res.error().data()}.starts_with("filename:1:29: error: Control character in string"));
+}
+
+TEST_CASE ("JSON stream reader", "[json]")
+{
+    Json::StreamReader reader(
+        R"json({"name": "a\u00e9\"b", "values": [1, -2, [], {}], "empty": {}, "last": [{"x": 3}] } )json", "test");
+    StringView key;
+    StringView text;
+    int64_t integer;
+    REQUIRE(reader.start_object());
+    REQUIRE(reader.next_member(key));
+    CHECK(key == "name");
+    REQUIRE(reader.read_string(text));
+    CHECK(text == U8_STR("a\u00e9\"b"));
+    REQUIRE(reader.next_member(key));
+    CHECK(key == "values");
+    REQUIRE(reader.start_array());
+    REQUIRE(reader.next_element());
+    REQUIRE(reader.read_integer(integer));
+    CHECK(integer == 1);
+    REQUIRE(reader.next_element());
+    REQUIRE(reader.read_integer(integer));
+    CHECK(integer == -2);
+    REQUIRE(reader.next_element());
+    REQUIRE(reader.start_array());
+    CHECK(!reader.next_element());
+    REQUIRE(reader.next_element());
+    REQUIRE(reader.start_object());
+    CHECK(!reader.next_member(key));
+    CHECK(!reader.next_element());
+    REQUIRE(reader.next_member(key));
+    CHECK(key == "empty");
+    REQUIRE(reader.start_object());
+    CHECK(!reader.next_member(key));
+    REQUIRE(reader.next_member(key));
+    CHECK(key == "last");
+    REQUIRE(reader.start_array());
+    REQUIRE(reader.next_element());
+    REQUIRE(reader.start_object());
+    REQUIRE(reader.next_member(key));
+    CHECK(key == "x");
+    REQUIRE(reader.read_integer(integer));
+    CHECK(integer == 3);
+    CHECK(!reader.next_member(key));
+    CHECK(!reader.next_element());
+    CHECK(!reader.next_member(key));
+    CHECK(!reader.failed());
+    CHECK(reader.finish());
+
+    // anything other than what was asked for fails the reader
+    auto fails_at_first_element = [](StringView json) {
+        Json::StreamReader reader(json, "test");
+        int64_t integer;
+        return reader.start_array() && reader.next_element() && !reader.read_integer(integer) && reader.failed() &&
+               !reader.next_element() && !reader.finish();
+    };
+
+    CHECK(fails_at_first_element("[1.5]"));
+    CHECK(fails_at_first_element("[\"1\"]"));
+    CHECK(fails_at_first_element("[true]"));
+    CHECK(fails_at_first_element("[99999999999999999999]"));
+    CHECK(fails_at_first_element("[-]"));
+
+    Json::StreamReader trailing_comma("[1,]", "test");
+    REQUIRE(trailing_comma.start_array());
+    REQUIRE(trailing_comma.next_element());
+    REQUIRE(trailing_comma.read_integer(integer));
+    CHECK(!trailing_comma.next_element());
+    CHECK(trailing_comma.failed());
+
+    Json::StreamReader missing_comma("{\"a\": 1 \"b\": 2}", "test");
+    REQUIRE(missing_comma.start_object());
+    REQUIRE(missing_comma.next_member(key));
+    REQUIRE(missing_comma.read_integer(integer));
+    CHECK(!missing_comma.next_member(key));
+    CHECK(missing_comma.failed());
+
+    Json::StreamReader unpaired_surrogate("\"\\ud800\"", "test");
+    CHECK(!unpaired_surrogate.read_string(text));
+
+    Json::StreamReader unterminated("\"abc", "test");
+    CHECK(!unterminated.read_string(text));
+
+    Json::StreamReader trailing_text("1 2", "test");
+    REQUIRE(trailing_text.read_integer(integer));
+    CHECK(!trailing_text.finish());
+}
+
 TEST_CASE ("JSON track newlines", "[json]")
 {
     auto res = Json::parse("{\n,", "filename");
@@ -269,3 +398,54 @@ TEST_CASE ("JSON support unicode characters in errors", "[json]")
   on expression: "é" ""
                       ^)"));
 }
+
+TEST_CASE ("JSON scan object members", "[json]")
+{
+    auto maybe_members = Json::scan_object_members(
+        R"json( { "a": {"b": [1, "}\"]", {"c": null}]}, "d" : "e\\\"", "f":-1.5e3 } )json");
+    auto members = maybe_members.get();
+    REQUIRE(members);
+    REQUIRE(members->size() == 3);
+    CHECK((*members)[0].key == "a");
+    CHECK((*members)[0].value == R"json({"b": [1, "}\"]", {"c": null}]})json");
+    CHECK((*members)[1].key == "d");
+    CHECK((*members)[1].value == R"json("e\\\"")json");
+    CHECK((*members)[2].key == "f");
+    CHECK((*members)[2].value == "-1.5e3");
+
+    maybe_members = Json::scan_object_members("\xEF\xBB\xBF{}");
+    members = maybe_members.get();
+    REQUIRE(members);
+    CHECK(members->empty());
+
+    CHECK(!Json::scan_object_members(""));
+    CHECK(!Json::scan_object_members("[]"));
+    CHECK(!Json::scan_object_members(R"json({"a": 1)json"));
+    CHECK(!Json::scan_object_members(R"json({"a": [1}})json"));
+    CHECK(!Json::scan_object_members(R"json({"a": 1,})json"));
+    CHECK(!Json::scan_object_members(R"json({"a": 1} 2)json"));
+    // escaped keys are left to the full parser
+    CHECK(!Json::scan_object_members(R"json({"\u0061": 1})json"));
+    // the syntax of values is checked too
+    CHECK(!Json::scan_object_members(R"json({"a": tru})json"));
+    CHECK(!Json::scan_object_members(R"json({"a": 01})json"));
+    CHECK(!Json::scan_object_members(R"json({"a": 1.})json"));
+    CHECK(!Json::scan_object_members(R"json({"a": "\q"})json"));
+    CHECK(!Json::scan_object_members("{\"a\": \"\n\"}"));
+    CHECK(!Json::scan_object_members(R"json({"a": {"b" 1}})json"));
+    CHECK(!Json::scan_object_members(R"json({"a": [1 2]})json"));
+    CHECK(!Json::scan_object_members(R"json({"a": 1, "b": 2, "a": 3})json"));
+}
+
+TEST_CASE ("JSON parse from a position", "[json]")
+{
+    const std::string text = "{\n  \"a\": {\"b\": tru}\n}";
+    const auto offset = text.find("{\"b\"");
+    CHECK(text_row_col_at(text, offset).row == 2);
+    CHECK(text_row_col_at(text, offset).column == 8);
+    auto res = Json::parse(StringView{text}.substr(offset), "filename", text_row_col_at(text, offset));
+    REQUIRE(!res);
+    CHECK(res.error() == LocalizedString::from_raw(R"(filename:2:17: error: Unexpected character in middle of keyword
+  on expression: {"b": tru}
+                          ^)"));
+}
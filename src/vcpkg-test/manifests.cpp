@@ -2,9 +2,11 @@
 
 #include <vcpkg/base/fwd/message_sinks.h>
 
+#include <vcpkg/base/files.h>
 #include <vcpkg/base/json.h>
 
 #include <vcpkg/documentation.h>
+#include <vcpkg/paragraphs.h>
 #include <vcpkg/sourceparagraph.h>
 #include <vcpkg/vcpkgcmdarguments.h>
 
@@ -1558,3 +1560,122 @@ TEST_CASE ("dependency-feature-name-empty-object errors", "[manifests]")
             "name. Feature names must be lowercase alphanumeric+hyphens and not reserved (see " +
                 docs::manifests_url + " for more information).");
 }
+
+TEST_CASE ("deferred port directory extracts on first use", "[manifests]")
+{
+    int extractions = 0;
+    SourceControlFileAndLocation scfl{
+        nullptr, "versions/zlib/abcd/vcpkg.json", std::string{}, PortSourceKind::Builtin, nullptr};
+    scfl.deferred_port_directory = std::make_shared<DeferredPortDirectory>([&]() -> ExpectedL<Path> {
+        ++extractions;
+        return Path{"versions/zlib/abcd"};
+    });
+
+    REQUIRE(extractions == 0);
+    auto clone = scfl.clone();
+    REQUIRE(scfl.port_directory() == "versions/zlib/abcd");
+    REQUIRE(extractions == 0);
+    REQUIRE(clone.extract_port_directory().value_or_exit(VCPKG_LINE_INFO) == "versions/zlib/abcd");
+    REQUIRE(extractions == 1);
+    REQUIRE(scfl.extract_port_directory().value_or_exit(VCPKG_LINE_INFO) == "versions/zlib/abcd");
+    REQUIRE(extractions == 1);
+}
+
+TEST_CASE ("deferred port directory reports extraction failures", "[manifests]")
+{
+    int extractions = 0;
+    SourceControlFileAndLocation scfl{
+        nullptr, "versions/zlib/abcd/vcpkg.json", std::string{}, PortSourceKind::Builtin, nullptr};
+    scfl.deferred_port_directory = std::make_shared<DeferredPortDirectory>([&]() -> ExpectedL<Path> {
+        if (++extractions == 1)
+        {
+            return LocalizedString::from_raw("error: git failed");
+        }
+
+        return Path{"versions/zlib/abcd"};
+    });
+
+    auto first = scfl.extract_port_directory();
+    REQUIRE(!first.has_value());
+    REQUIRE(first.error().data() == "error: git failed");
+    // a failed extraction is retried
+    REQUIRE(scfl.extract_port_directory().value_or_exit(VCPKG_LINE_INFO) == "versions/zlib/abcd");
+    REQUIRE(extractions == 2);
+}
+
+TEST_CASE ("binary source control file round trip", "[manifests]")
+{
+    auto m_pgh = test_parse_port_manifest(R"json({
+        "name": "zlib",
+        "version-semver": "1.2.3-beta.1",
+        "port-version": 2,
+        "description": ["a compression library", "with a second line"],
+        "maintainers": ["someone"],
+        "homepage": "https://example.com",
+        "documentation": "https://example.com/docs",
+        "license": "MIT OR Apache-2.0",
+        "supports": "!(uwp | arm) & (windows | linux)",
+        "$comment": {"numbers": [1, 2.5, -3], "nested": {"ok": true}},
+        "dependencies": [
+            "a",
+            {
+                "name": "b",
+                "features": ["x", {"name": "y", "platform": "osx"}],
+                "platform": "!windows",
+                "version>=": "1.0#3",
+                "default-features": false,
+                "$extra": null
+            },
+            {"name": "c", "host": true}
+        ],
+        "default-features": ["feature-a", {"name": "feature-b", "platform": "linux"}],
+        "overrides": [{"name": "d", "version": "2.0", "port-version": 1}],
+        "features": {
+            "feature-a": {"description": "the first feature", "dependencies": ["e"], "license": null},
+            "feature-b": {"description": ["the second", "feature"], "supports": "linux", "$extra": 1}
+        }
+    })json");
+    REQUIRE(m_pgh.has_value());
+    auto& scf = **m_pgh.get();
+
+    auto maybe_payload = serialize_binary_source_control_file(scf);
+    auto payload = maybe_payload.get();
+    REQUIRE(payload);
+    auto round_tripped = deserialize_binary_source_control_file(*payload);
+    REQUIRE(round_tripped);
+    CHECK(*round_tripped == scf);
+    CHECK(serialize_manifest(*round_tripped) == serialize_manifest(scf));
+
+    // every truncation is detected rather than producing a partial manifest
+    for (std::size_t size = 0; size < payload->size(); ++size)
+    {
+        CHECK(!deserialize_binary_source_control_file(StringView{payload->data(), size}));
+    }
+}
+
+TEST_CASE ("parsed manifest cache", "[manifests]")
+{
+    auto& fs = real_filesystem;
+    const auto directory = Test::base_temporary_directory() / "parsed-manifest-cache";
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+    const auto cache_file = directory / "manifest-cache.bin";
+
+    static constexpr StringLiteral manifest_text =
+        R"json({"name": "zlib", "version": "1.0", "dependencies": [{"name": "a", "platform": "windows"}]})json";
+    Paragraphs::ParsedManifestCache first_cache{fs, cache_file};
+    auto first = Paragraphs::try_load_port_manifest_text(manifest_text, "vcpkg.json", null_sink, &first_cache);
+    REQUIRE(first.has_value());
+    REQUIRE(fs.exists(cache_file, VCPKG_LINE_INFO));
+
+    // a new cache object reads the record written by the first load
+    Paragraphs::ParsedManifestCache second_cache{fs, cache_file};
+    auto second = Paragraphs::try_load_port_manifest_text(manifest_text, "vcpkg.json", null_sink, &second_cache);
+    REQUIRE(second.has_value());
+    CHECK(**second.get() == **first.get());
+
+    // errors are still reported
+    CHECK(!Paragraphs::try_load_port_manifest_text(
+        R"json({"name": "zlib"})json", "vcpkg.json", null_sink, &second_cache));
+
+    fs.remove_all(directory, VCPKG_LINE_INFO);
+}
@@ -98,9 +98,9 @@ TEST_CASE ("basic install scheme", "[plan]")
     std::vector<std::unique_ptr<StatusParagraph>> status_paragraphs;
 
     PackageSpecMap spec_map;
-    auto spec_a = spec_map.emplace("a", "b");
-    auto spec_b = spec_map.emplace("b", "c");
-    auto spec_c = spec_map.emplace("c");
+    spec_map.emplace("a", "b");
+    spec_map.emplace("b", "c");
+    spec_map.emplace("c");
 
     MapPortFileProvider map_port(spec_map.map);
     MockCMakeVarProvider var_provider;
@@ -218,16 +218,16 @@ TEST_CASE ("long install scheme", "[plan]")
 
     PackageSpecMap spec_map;
 
-    auto spec_a = spec_map.emplace("a", "b, c, d, e, f, g, h, j, k");
-    auto spec_b = spec_map.emplace("b", "c, d, e, f, g, h, j, k");
-    auto spec_c = spec_map.emplace("c", "d, e, f, g, h, j, k");
-    auto spec_d = spec_map.emplace("d", "e, f, g, h, j, k");
-    auto spec_e = spec_map.emplace("e", "f, g, h, j, k");
-    auto spec_f = spec_map.emplace("f", "g, h, j, k");
-    auto spec_g = spec_map.emplace("g", "h, j, k");
-    auto spec_h = spec_map.emplace("h", "j, k");
-    auto spec_j = spec_map.emplace("j", "k");
-    auto spec_k = spec_map.emplace("k");
+    spec_map.emplace("a", "b, c, d, e, f, g, h, j, k");
+    spec_map.emplace("b", "c, d, e, f, g, h, j, k");
+    spec_map.emplace("c", "d, e, f, g, h, j, k");
+    spec_map.emplace("d", "e, f, g, h, j, k");
+    spec_map.emplace("e", "f, g, h, j, k");
+    spec_map.emplace("f", "g, h, j, k");
+    spec_map.emplace("g", "h, j, k");
+    spec_map.emplace("h", "j, k");
+    spec_map.emplace("j", "k");
+    spec_map.emplace("k");
 
     MapPortFileProvider map_port(spec_map.map);
     MockCMakeVarProvider var_provider;
@@ -247,6 +247,37 @@ TEST_CASE ("long install scheme", "[plan]")
     REQUIRE(install_plan.at(7).spec.name() == "a");
 }
 
+TEST_CASE ("install actions share equal dependency lists", "[plan]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a", "c");
+    spec_map.emplace("b", "c");
+    spec_map.emplace("c");
+    spec_map.emplace("d", "c, e");
+    spec_map.emplace("e");
+
+    MapPortFileProvider map_port(spec_map.map);
+    MockCMakeVarProvider var_provider;
+
+    auto plan =
+        create_feature_install_plan(map_port, var_provider, Test::parse_test_fspecs("a b d"), StatusParagraphs{});
+    REQUIRE(plan.install_actions.size() == 5);
+    const auto find_action = [&](StringView name) -> const InstallPlanAction& {
+        return *Util::find_if(plan.install_actions,
+                              [&](const InstallPlanAction& action) { return action.spec.name() == name; });
+    };
+
+    const auto& a = find_action("a");
+    const auto& b = find_action("b");
+    const auto& d = find_action("d");
+    REQUIRE(a.package_dependencies.size() == 1);
+    CHECK(a.package_dependencies.shares_data_with(b.package_dependencies));
+    CHECK(!a.package_dependencies.shares_data_with(d.package_dependencies));
+    CHECK(a.feature_dependencies.at("core").shares_data_with(b.feature_dependencies.at("core")));
+    CHECK(a.feature_list.shares_data_with(find_action("c").feature_list));
+    CHECK(d.feature_list.shares_data_with(find_action("e").feature_list));
+}
+
 TEST_CASE ("basic feature test 1", "[plan]")
 {
     PackageSpecMap spec_map;
@@ -727,8 +758,8 @@ TEST_CASE ("install plan action dependencies", "[plan]")
     // Add a port "a" which depends on the core of "b", which was already
     // installed explicitly
     PackageSpecMap spec_map(Test::X64_WINDOWS);
-    auto spec_c = spec_map.emplace("c");
-    auto spec_b = spec_map.emplace("b", "c");
+    spec_map.emplace("c");
+    spec_map.emplace("b", "c");
     spec_map.emplace("a", "b");
 
     MapPortFileProvider map_port{spec_map.map};
@@ -757,8 +788,8 @@ TEST_CASE ("install plan action dependencies 2", "[plan]")
     // Add a port "a" which depends on the core of "b", which was already
     // installed explicitly
     PackageSpecMap spec_map(Test::X64_WINDOWS);
-    auto spec_c = spec_map.emplace("c");
-    auto spec_b = spec_map.emplace("b", "c");
+    spec_map.emplace("c");
+    spec_map.emplace("b", "c");
     spec_map.emplace("a", "c, b");
 
     MapPortFileProvider map_port{spec_map.map};
@@ -809,8 +840,8 @@ TEST_CASE ("install with default features", "[plan]")
     StatusParagraphs status_db(std::move(pghs));
 
     PackageSpecMap spec_map;
-    auto b_spec = spec_map.emplace("b", "", {{"0", ""}}, {"0"});
-    auto a_spec = spec_map.emplace("a", "b[core]", {{"0", ""}});
+    spec_map.emplace("b", "", {{"0", ""}}, {"0"});
+    spec_map.emplace("a", "b[core]", {{"0", ""}});
 
     MapPortFileProvider map_port{spec_map.map};
     MockCMakeVarProvider var_provider;
@@ -825,6 +856,54 @@ TEST_CASE ("install with default features", "[plan]")
     features_check(install_plan.install_actions.at(1), "a", {"0", "core"});
 }
 
+// Each install action of `plan` with its features, version, and dependencies
+static std::vector<std::string> describe_install_actions(const ActionPlan& plan)
+{
+    return Util::fmap(plan.install_actions, [](const InstallPlanAction& action) {
+        return fmt::format(
+            "{} -> {}",
+            action.display_name(),
+            Strings::join(" ", action.package_dependencies, [](const PackageSpec& spec) { return spec.to_string(); }));
+    });
+}
+
+TEST_CASE ("install plans sharing a resolution context", "[plan]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a", "b, c (linux)", {{"x", "d (!linux), c[y] (windows)"}});
+    spec_map.emplace("b", "", {{"y", "d"}});
+    spec_map.emplace("c", "", {{"y", ""}});
+    spec_map.emplace("d");
+    MapPortFileProvider map_port{spec_map.map};
+
+    const PackageSpec linux_a{"a", Test::X64_LINUX};
+    MockCMakeVarProvider shared_var_provider;
+    shared_var_provider.dep_info_vars[linux_a] = {{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}};
+    ResolutionContext resolution_context;
+    CreateInstallPlanOptions shared_options{
+        nullptr, Test::X64_ANDROID, UnsupportedPortAction::Error, UseHeadVersion::No, Editable::No};
+    shared_options.resolution_context = &resolution_context;
+
+    // Plans built one after another with the same context must match plans resolved from scratch
+    for (const char* specs : {"a", "a[x]", "a[x]:x64-linux", "b[y]", "a[core]:x64-linux", "a[x]"})
+    {
+        INFO(specs);
+        MockCMakeVarProvider var_provider;
+        var_provider.dep_info_vars[linux_a] = {{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}};
+        const auto expected =
+            create_feature_install_plan(map_port, var_provider, Test::parse_test_fspecs(specs), StatusParagraphs{});
+
+        PackagesDirAssigner packages_dir_assigner{"pkg"};
+        const auto actual = create_feature_install_plan(map_port,
+                                                        shared_var_provider,
+                                                        Test::parse_test_fspecs(specs),
+                                                        StatusParagraphs{},
+                                                        packages_dir_assigner,
+                                                        shared_options);
+        CHECK(describe_install_actions(actual) == describe_install_actions(expected));
+    }
+}
+
 TEST_CASE ("upgrade with default features 1", "[plan]")
 {
     std::vector<std::unique_ptr<StatusParagraph>> pghs;
@@ -1123,9 +1202,9 @@ TEST_CASE ("basic tool port scheme", "[plan]")
     std::vector<std::unique_ptr<StatusParagraph>> status_paragraphs;
 
     PackageSpecMap spec_map;
-    auto spec_a = spec_map.emplace("a", "b");
-    auto spec_b = spec_map.emplace("b", "c");
-    auto spec_c = spec_map.emplace("c");
+    spec_map.emplace("a", "b");
+    spec_map.emplace("b", "c");
+    spec_map.emplace("c");
 
     spec_map.map.at("a").source_control_file->core_paragraph->dependencies[0].host = true;
 
@@ -1159,7 +1238,7 @@ TEST_CASE ("basic existing tool port scheme", "[plan]")
     {
         PackageSpecMap spec_map;
         auto spec_a = spec_map.emplace("a", "b");
-        auto spec_b = spec_map.emplace("b");
+        spec_map.emplace("b");
 
         spec_map.map.at("a").source_control_file->core_paragraph->dependencies[0].host = true;
 
@@ -1197,7 +1276,7 @@ TEST_CASE ("basic existing tool port scheme", "[plan]")
     {
         PackageSpecMap spec_map;
         auto spec_a = spec_map.emplace("a", "b");
-        auto spec_b = spec_map.emplace("b");
+        spec_map.emplace("b");
 
         spec_map.map.at("a").source_control_file->core_paragraph->dependencies[0].host = true;
 
@@ -1215,8 +1294,8 @@ TEST_CASE ("basic existing tool port scheme", "[plan]")
     {
         PackageSpecMap spec_map;
         auto spec_a = spec_map.emplace("a", "b");
-        auto spec_b = spec_map.emplace("b", "c");
-        auto spec_c = spec_map.emplace("c");
+        spec_map.emplace("b", "c");
+        spec_map.emplace("c");
 
         spec_map.map.at("a").source_control_file->core_paragraph->dependencies[0].host = true;
 
@@ -1424,7 +1503,7 @@ TEST_CASE ("basic export scheme with recurse", "[plan]")
     StatusParagraphs status_db(std::move(pghs));
 
     PackageSpecMap spec_map;
-    auto spec_a = spec_map.emplace("a");
+    spec_map.emplace("a");
     auto spec_b = spec_map.emplace("b", "a");
 
     auto plan = create_export_plan({spec_b}, status_db);
@@ -1446,7 +1525,7 @@ TEST_CASE ("basic export scheme with bystander", "[plan]")
 
     PackageSpecMap spec_map;
     auto spec_a = spec_map.emplace("a");
-    auto spec_b = spec_map.emplace("b", "a");
+    spec_map.emplace("b", "a");
 
     auto plan = create_export_plan({spec_a}, status_db);
 
@@ -1490,3 +1569,52 @@ TEST_CASE ("basic export scheme with features", "[plan]")
     REQUIRE(plan.at(1).spec.name() == "a");
     REQUIRE(plan.at(1).plan_type == ExportPlanType::ALREADY_BUILT);
 }
+
+TEST_CASE ("package ids are dense and stable", "[plan]")
+{
+    PackageIds ids;
+    const PackageSpec a{"a", Test::X86_WINDOWS};
+    const PackageSpec b{"b", Test::X86_WINDOWS};
+    const PackageSpec a_host{"a", Test::X64_ANDROID};
+    CHECK(!ids.find(a).has_value());
+    CHECK(ids.add(a) == std::make_pair(std::size_t{0}, true));
+    CHECK(ids.add(b) == std::make_pair(std::size_t{1}, true));
+    CHECK(ids.add(a) == std::make_pair(std::size_t{0}, false));
+    CHECK(ids.add(a_host) == std::make_pair(std::size_t{2}, true));
+    CHECK(ids.size() == 3);
+    CHECK(ids.find(b).value_or_exit(VCPKG_LINE_INFO) == 1);
+    CHECK(ids.find(a_host).value_or_exit(VCPKG_LINE_INFO) == 2);
+}
+
+TEST_CASE ("install plans do not depend on request order", "[plan]")
+{
+    // the order in which packages are first seen decides their numbers, which must not leak into the plan
+    PackageSpecMap spec_map;
+    spec_map.emplace("a", "d, e[x]");
+    spec_map.emplace("b", "e, f", {{"y", "a"}});
+    spec_map.emplace("c", "f");
+    spec_map.emplace("d", "f");
+    spec_map.emplace("e", "", {{"x", "c"}});
+    spec_map.emplace("f");
+
+    MapPortFileProvider map_port(spec_map.map);
+    MockCMakeVarProvider var_provider;
+    auto describe = [&](StringView specs) {
+        auto plan = create_feature_install_plan(map_port, var_provider, Test::parse_test_fspecs(specs), {});
+        std::vector<std::string> actions;
+        for (auto&& action : plan.install_actions)
+        {
+            actions.push_back(fmt::format("{}[{}]:{}",
+                                          action.spec,
+                                          Strings::join(",", action.feature_list),
+                                          Strings::join(",", action.package_dependencies)));
+        }
+
+        return actions;
+    };
+
+    const auto expected = describe("a b[y] c");
+    REQUIRE(expected.size() == 6);
+    CHECK(describe("c b[y] a") == expected);
+    CHECK(describe("b[y] c a") == expected);
+}
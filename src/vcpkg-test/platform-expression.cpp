@@ -570,3 +570,72 @@ TEST_CASE ("invalid alternate expressions", "[platform-expression]")
     CHECK_FALSE(parse_expr("not! windows"));
     CHECK_FALSE(parse_expr("notx64 windows"));
 }
+
+TEST_CASE ("platform-expression-override-vars", "[platform-expression]")
+{
+    auto m_expr = parse_expr("(windows & !x64) | myplatform");
+    REQUIRE(m_expr);
+    auto& expr = *m_expr.get();
+
+    Context context{{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}, {"VCPKG_TARGET_ARCHITECTURE", "x64"}};
+    context["VCPKG_DEP_INFO_OVERRIDE_VARS"] = "myplatform";
+    CHECK(expr.evaluate(context));
+    context["VCPKG_DEP_INFO_OVERRIDE_VARS"] = "!myplatform;windows";
+    CHECK_FALSE(expr.evaluate(context));
+    context["VCPKG_DEP_INFO_OVERRIDE_VARS"] = "!myplatform;windows;!x64";
+    CHECK(expr.evaluate(context));
+    // the first override of an identifier wins
+    context["VCPKG_DEP_INFO_OVERRIDE_VARS"] = ";myplatform;!myplatform";
+    CHECK(expr.evaluate(context));
+}
+
+TEST_CASE ("platform-expression-resolved-context", "[platform-expression]")
+{
+    const Context contexts[] = {
+        {{"VCPKG_CMAKE_SYSTEM_NAME", ""}, {"VCPKG_TARGET_ARCHITECTURE", "x64"}, {"Z_VCPKG_IS_NATIVE", "1"}},
+        {{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}, {"VCPKG_TARGET_ARCHITECTURE", "arm64"}, {"Z_VCPKG_IS_NATIVE", "0"}},
+        {{"VCPKG_CMAKE_SYSTEM_NAME", "WindowsStore"},
+         {"VCPKG_TARGET_ARCHITECTURE", "arm"},
+         {"VCPKG_LIBRARY_LINKAGE", "static"},
+         {"Z_VCPKG_IS_NATIVE", "0"}},
+        {{"VCPKG_CMAKE_SYSTEM_NAME", "Darwin"},
+         {"VCPKG_TARGET_ARCHITECTURE", "arm64"},
+         {"VCPKG_CRT_LINKAGE", "static"},
+         {"Z_VCPKG_IS_NATIVE", "1"},
+         {"VCPKG_DEP_INFO_OVERRIDE_VARS", "!osx;linux"}},
+    };
+
+    const StringView expressions[] = {
+        "windows",
+        "!uwp & (arm | x86)",
+        "linux, osx",
+        "static & !staticcrt",
+        "native | (arm64 & !arm32)",
+        "!(windows | linux) & !(x64 | mips64)",
+    };
+
+    for (auto&& context : contexts)
+    {
+        // one resolved context gives the same answers as the context for every expression
+        const auto resolved = resolve_context(context);
+        for (auto&& expression : expressions)
+        {
+            INFO(expression.to_string());
+            auto m_expr = parse_expr(expression);
+            REQUIRE(m_expr);
+            auto& expr = *m_expr.get();
+            const Expr copied = expr;
+            Expr assigned;
+            assigned = expr;
+            CHECK(expr.evaluate(resolved) == expr.evaluate(context));
+            CHECK(copied.evaluate(resolved) == expr.evaluate(context));
+            CHECK(assigned.evaluate(resolved) == expr.evaluate(context));
+        }
+    }
+
+    const auto linux_x64 =
+        resolve_context({{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}, {"VCPKG_TARGET_ARCHITECTURE", "x64"}});
+    CHECK(Expr::Not(Expr::And({Expr::Identifier("windows"), Expr::Identifier("x64")})).evaluate(linux_x64));
+    CHECK_FALSE(Expr::Or({Expr::Identifier("windows"), Expr::Identifier("arm")}).evaluate(linux_x64));
+    CHECK(Expr{}.evaluate(linux_x64));
+}
@@ -0,0 +1,167 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/message_sinks.h>
+#include <vcpkg/base/strings.h>
+
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/portfileprovider.h>
+#include <vcpkg/registries.h>
+#include <vcpkg/sourceparagraph.h>
+
+using namespace vcpkg;
+
+namespace
+{
+    void write_test_port(const Filesystem& fs, const Path& directory, StringView port_name, StringView manifest_name)
+    {
+        fs.create_directories(directory / port_name, VCPKG_LINE_INFO);
+        fs.write_contents(directory / port_name / "vcpkg.json",
+                          fmt::format(R"json({{"name": "{}", "version": "1.0", "dependencies": ["zlib"]}})json",
+                                      manifest_name),
+                          VCPKG_LINE_INFO);
+    }
+}
+
+TEST_CASE ("overlay directory loads all ports in order", "[portfileprovider]")
+{
+    auto& fs = real_filesystem;
+    const auto overlay = Test::base_temporary_directory() / "overlay-load-all";
+    fs.remove_all(overlay, VCPKG_LINE_INFO);
+    for (int idx = 0; idx < 50; ++idx)
+    {
+        const auto name = fmt::format("port-{:02}", idx);
+        write_test_port(fs, overlay, name, name);
+    }
+
+    write_test_port(fs, overlay, "mismatched-a", "other-a");
+    write_test_port(fs, overlay, "mismatched-b", "other-b");
+    fs.create_directories(overlay / "not-a-port", VCPKG_LINE_INFO);
+
+    const SourceControlFileAndLocation already_loaded_scfl{};
+    const auto already_loaded = &already_loaded_scfl;
+    std::map<std::string, const SourceControlFileAndLocation*> out{{"port-07", already_loaded}};
+    OverlayPortIndexEntry entry{OverlayPortKind::Directory, overlay};
+    auto result = entry.try_load_all_ports(fs, out);
+    REQUIRE(!result);
+    const auto& error = result.error().data();
+    const auto first_error = error.find("other-a");
+    REQUIRE(first_error != std::string::npos);
+    CHECK(first_error < error.find("other-b"));
+
+    REQUIRE(out.size() == 50);
+    CHECK(out["port-07"] == already_loaded);
+    for (auto&& loaded : out)
+    {
+        if (loaded.second != already_loaded)
+        {
+            CHECK(loaded.second->to_name() == loaded.first);
+        }
+    }
+
+    // the second load is served from the cache and reports the same errors
+    out.clear();
+    auto second_result = entry.try_load_all_ports(fs, out);
+    REQUIRE(!second_result);
+    CHECK(second_result.error() == result.error());
+    CHECK(out.size() == 50);
+
+    fs.remove_all(overlay, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("overlay directory reports warnings in port order", "[portfileprovider]")
+{
+    auto& fs = real_filesystem;
+    const auto overlay = Test::base_temporary_directory() / "overlay-load-all-warnings";
+    fs.remove_all(overlay, VCPKG_LINE_INFO);
+    for (int idx = 0; idx < 30; ++idx)
+    {
+        const auto name = fmt::format("port-{:02}", idx);
+        fs.create_directories(overlay / name, VCPKG_LINE_INFO);
+        fs.write_contents(
+            overlay / name / "vcpkg.json",
+            fmt::format(R"json({{"name": "{}", "version": "1.0", "license": "Unknown-License-{}"}})json", name, idx),
+            VCPKG_LINE_INFO);
+    }
+
+    BufferedMessageSink warnings;
+    std::map<std::string, const SourceControlFileAndLocation*> out;
+    OverlayPortIndexEntry entry{OverlayPortKind::Directory, overlay};
+    {
+        Paragraphs::PortWarningRedirect redirect{warnings};
+        REQUIRE(entry.try_load_all_ports(fs, out));
+    }
+
+    REQUIRE(out.size() == 30);
+    REQUIRE(warnings.lines.size() == 30);
+    for (int idx = 0; idx < 30; ++idx)
+    {
+        CHECK(warnings.lines[idx].to_string().find(fmt::format("'Unknown-License-{}'", idx)) != std::string::npos);
+    }
+
+    fs.remove_all(overlay, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("versioned provider prefetch matches on demand loads", "[portfileprovider]")
+{
+    auto& fs = real_filesystem;
+    const auto root = Test::base_temporary_directory() / "versioned-prefetch";
+    fs.remove_all(root, VCPKG_LINE_INFO);
+    const auto write_version = [&](StringView port_name, StringView version, StringView manifest) {
+        const auto directory = root / "ports" / port_name / version;
+        fs.create_directories(directory, VCPKG_LINE_INFO);
+        fs.write_contents(directory / "vcpkg.json", manifest, VCPKG_LINE_INFO);
+    };
+
+    write_version("good", "1.0", R"json({"name": "good", "version": "1.0"})json");
+    write_version("good", "2.0", R"json({"name": "good", "version": "2.0"})json");
+    write_version("broken", "1.0", "{");
+    fs.create_directories(root / "versions" / "g-", VCPKG_LINE_INFO);
+    fs.create_directories(root / "versions" / "b-", VCPKG_LINE_INFO);
+    fs.write_contents(root / "versions" / "g-" / "good.json",
+                      R"json({"versions": [{"version": "2.0", "path": "$/ports/good/2.0"},
+                                           {"version": "1.0", "path": "$/ports/good/1.0"}]})json",
+                      VCPKG_LINE_INFO);
+    fs.write_contents(root / "versions" / "b-" / "broken.json",
+                      R"json({"versions": [{"version": "1.0", "path": "$/ports/broken/1.0"}]})json",
+                      VCPKG_LINE_INFO);
+    fs.write_contents(root / "versions" / "baseline.json",
+                      R"json({"default": {"good": {"baseline": "2.0"}, "broken": {"baseline": "1.0"}}})json",
+                      VCPKG_LINE_INFO);
+
+    const std::vector<VersionSpec> requests{
+        {"good", Version{"1.0", 0}},
+        {"good", Version{"2.0", 0}},
+        {"good", Version{"9.0", 0}},   // not in the versions database
+        {"broken", Version{"1.0", 0}}, // manifest fails to parse
+        {"missing", Version{"1.0", 0}} // no versions file
+    };
+
+    RegistrySet registries{make_filesystem_registry(fs, root, ""), {}};
+    auto on_demand = make_versioned_portfile_provider(registries);
+    auto prefetched = make_versioned_portfile_provider(registries);
+    prefetched->prefetch(requests);
+    for (auto&& request : requests)
+    {
+        INFO(request.to_string());
+        auto expected = on_demand->get_control_file(request);
+        auto actual = prefetched->get_control_file(request);
+        REQUIRE(expected.has_value() == actual.has_value());
+        if (auto expected_scfl = expected.get())
+        {
+            auto& actual_scfl = actual.value_or_exit(VCPKG_LINE_INFO);
+            CHECK(actual_scfl.to_version_spec() == expected_scfl->to_version_spec());
+            CHECK(actual_scfl.control_path == expected_scfl->control_path);
+            CHECK(actual_scfl.kind == expected_scfl->kind);
+        }
+        else
+        {
+            CHECK(actual.error() == expected.error());
+        }
+    }
+
+    CHECK(on_demand->get_control_file({"good", Version{"1.0", 0}}).has_value());
+    CHECK(!on_demand->get_control_file({"broken", Version{"1.0", 0}}).has_value());
+
+    fs.remove_all(root, VCPKG_LINE_INFO);
+}
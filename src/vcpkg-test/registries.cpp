@@ -1,11 +1,17 @@
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/json.h>
 #include <vcpkg/base/jsonreader.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/strings.h>
 
 #include <vcpkg/configuration.h>
 #include <vcpkg/documentation.h>
+#include <vcpkg/paragraphs.h>
 #include <vcpkg/registries-parsing.h>
+#include <vcpkg/versiondeserializers.h>
 
 using namespace vcpkg;
 
@@ -583,6 +589,364 @@ TEST_CASE ("git_version_db_parsing", "[registries]")
     CHECK(!r.messages().any_errors());
 }
 
+TEST_CASE ("git versions files are streamed", "[registries]")
+{
+    auto& fs = real_filesystem;
+    const auto versions = Test::base_temporary_directory() / "git_versions_streamed";
+    const auto versions_file = versions / "f-" / "foo.json";
+    fs.remove_all(versions, VCPKG_LINE_INFO);
+    fs.create_directories(versions / "f-", VCPKG_LINE_INFO);
+    auto load = [&](StringView contents) {
+        fs.write_contents(versions_file, contents, VCPKG_LINE_INFO);
+        return load_git_versions_file(fs, versions, "foo").entries;
+    };
+
+    auto check_loads = [&](StringView contents, std::vector<SchemedVersion> expected) {
+        auto loaded = load(contents);
+        auto& entries = loaded.value_or_exit(VCPKG_LINE_INFO).value_or_exit(VCPKG_LINE_INFO);
+        REQUIRE(entries.size() == expected.size());
+        for (size_t idx = 0; idx < entries.size(); ++idx)
+        {
+            CHECK(entries[idx].version == expected[idx]);
+            CHECK(entries[idx].git_tree == fmt::format("{:04}", idx));
+        }
+    };
+
+    check_loads("\xEF\xBB\xBF" R"json({"versions": [
+        {"git-tree": "0000", "version": "1.2.3.4", "port-version": 1},
+        {"version-semver": "1.2.3-beta", "git-tree": "0001"},
+        {"port-version": 2, "version-date": "2021-01-01", "git-tree": "\u0030002"},
+        {"version-string": "any thing", "git-tree": "0003"}
+    ]})json",
+                {SchemedVersion{VersionScheme::Relaxed, Version{"1.2.3.4", 1}},
+                 SchemedVersion{VersionScheme::Semver, Version{"1.2.3-beta", 0}},
+                 SchemedVersion{VersionScheme::Date, Version{"2021-01-01", 2}},
+                 SchemedVersion{VersionScheme::String, Version{"any thing", 0}}});
+    check_loads(R"json({"versions": []})json", {});
+
+    // files the stream doesn't recognize are still deserialized as before
+    check_loads(R"json({"$comment": "", "versions": [{"git-tree": "0000", "version": "1"}], "other": [1.5]})json",
+                {SchemedVersion{VersionScheme::Relaxed, Version{"1", 0}}});
+
+    // and the problems with them are reported as before
+    for (StringView malformed : {
+             R"json({"versions": [{"git-tree": "0000", "version": "1"},]})json",
+             R"json({"versions": [{"git-tree": "0000", "version": "1", "version": "2"}]})json",
+             R"json({"versions": [{"git-tree": "0000", "version": "1"}]} [])json",
+         })
+    {
+        auto loaded = load(malformed);
+        REQUIRE(!loaded);
+        CHECK(StringView{loaded.error().data()}.starts_with(Json::parse(malformed, versions_file).error().data()));
+    }
+
+    for (StringView invalid : {
+             R"json({"versions": [{"git-tree": "0000", "version": "1#1"}]})json",
+             R"json({"versions": [{"git-tree": "0000", "version": "1", "version-string": "1"}]})json",
+             R"json({"versions": [{"git-tree": "0000", "version": "1.2.3.a"}]})json",
+             R"json({"versions": [{"git-tree": "0000", "version-semver": "1.2"}]})json",
+             R"json({"versions": [{"git-tree": "0000", "version-date": "2021"}]})json",
+             R"json({"versions": [{"git-tree": "0000", "version": "1", "port-version": -1}]})json",
+             R"json({"versions": [{"git-tree": "0000", "version": "1", "color": "red"}]})json",
+             R"json({"versions": [{"git-tree": 0, "version": "1"}]})json",
+             R"json({"versions": [{"version": "1"}]})json",
+             R"json({"versions": {}})json",
+         })
+    {
+        CHECK(!load(invalid));
+    }
+
+    fs.remove_all(versions, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("baselines are streamed", "[registries]")
+{
+    auto& fs = real_filesystem;
+    const auto root = Test::base_temporary_directory() / "baselines_streamed";
+    fs.remove_all(root, VCPKG_LINE_INFO);
+    fs.create_directories(root / "versions", VCPKG_LINE_INFO);
+    auto lookup = [&](StringView contents, StringView port_name) {
+        fs.write_contents(root / "versions" / "baseline.json", contents, VCPKG_LINE_INFO);
+        return make_filesystem_registry(fs, root, "")->get_baseline_version(port_name);
+    };
+
+    static constexpr StringLiteral baseline = R"json({"default": {
+        "zlib": {"baseline": "1.3", "port-version": 1},
+        "fmt": {"port-version": 0, "baseline": "10.2.1"},
+        "extra": {"baseline": "1", "note": "ignored"}
+    }})json";
+    CHECK(lookup(baseline, "zlib").value_or_exit(VCPKG_LINE_INFO) == Version{"1.3", 1});
+    CHECK(lookup(baseline, "fmt").value_or_exit(VCPKG_LINE_INFO) == Version{"10.2.1", 0});
+    CHECK(lookup(baseline, "extra").value_or_exit(VCPKG_LINE_INFO) == Version{"1", 0});
+    CHECK(!lookup(baseline, "missing").value_or_exit(VCPKG_LINE_INFO).has_value());
+    CHECK(!lookup(R"json({"default": {"zlib": {"baseline": "1.3#1"}}})json", "zlib"));
+
+    // keys with escapes are read with the whole file
+    static constexpr StringLiteral escaped = R"json({"default": {"\u007alib": {"baseline": "1.3"}, "fmt": {}}})json";
+    CHECK(!lookup(escaped, "zlib"));
+    static constexpr StringLiteral escaped_valid = R"json({"default": {"\u007alib": {"baseline": "1.3"}}})json";
+    CHECK(lookup(escaped_valid, "zlib").value_or_exit(VCPKG_LINE_INFO) == Version{"1.3", 0});
+
+    // duplicate ports and syntax errors anywhere in the file are reported by the full parse
+    CHECK(!lookup(R"json({"default": {"zlib": {"baseline": "1"}, "zlib": {"baseline": "2"}}})json", "zlib"));
+    CHECK(!lookup(R"json({"default": {"zlib": {"baseline": "1"}, "fmt": {"baseline": 1.}}})json", "zlib"));
+
+    fs.remove_all(root, VCPKG_LINE_INFO);
+}
+
+namespace
+{
+    // The value tokens the streamed version readers are compared on, valid and invalid for each field
+    constexpr StringLiteral streamed_version_texts[] = {
+        R"("1.2.3")",
+        R"("1.2.3.4")",
+        R"("01.2")",
+        R"("1.2.3-beta")",
+        R"("2021-01-01")",
+        R"("2021-01-01.5")",
+        R"("2021-1-1")",
+        R"("any thing")",
+        R"("\u0031.2.3")",
+        R"("")",
+        R"("1.2#3")",
+        R"("#")",
+        "5",
+        "null",
+        "true",
+        "[]",
+    };
+
+    constexpr StringLiteral streamed_port_versions[] = {
+        "0", "7", "-0", "-1", "2147483647", "2147483648", "1.5", "1e2", R"("1")", "null", "{}"};
+
+    constexpr StringLiteral streamed_version_fields[] = {
+        JsonIdVersion, JsonIdVersionSemver, JsonIdVersionDate, JsonIdVersionString};
+
+    // Joins `members`, each already "key": value, into an object
+    std::string object_text(View<std::string> members) { return "{" + Strings::join(", ", members) + "}"; }
+
+    std::string member_text(StringView key, StringView value) { return fmt::format("\"{}\": {}", key, value); }
+
+    Optional<SchemedVersion> schemed_version_by_reader(StringView text)
+    {
+        Optional<SchemedVersion> result;
+        auto maybe_object = Json::parse_object(text, "test");
+        if (auto object = maybe_object.get())
+        {
+            Json::Reader r("test");
+            auto maybe_version = visit_optional_schemed_version(LocalizedString::from_raw("test"), r, *object);
+            if (!r.messages().any_errors())
+            {
+                result = std::move(maybe_version);
+            }
+        }
+
+        return result;
+    }
+
+    Optional<SchemedVersion> schemed_version_by_stream(StringView text)
+    {
+        Json::StreamReader reader(text, "test");
+        if (!reader.start_object())
+        {
+            return nullopt;
+        }
+
+        StreamedSchemedVersion version;
+        StringView key;
+        while (reader.next_member(key))
+        {
+            // the corpus only has versioning fields
+            REQUIRE(version.read_field(reader, key));
+        }
+
+        auto result = version.finish();
+        if (reader.failed() || !reader.finish())
+        {
+            return nullopt;
+        }
+
+        return result;
+    }
+
+    void check_schemed_version_agrees(View<std::string> members)
+    {
+        const auto text = object_text(members);
+        INFO(text);
+        const auto by_reader = schemed_version_by_reader(text);
+        const auto by_stream = schemed_version_by_stream(text);
+        REQUIRE(by_reader.has_value() == by_stream.has_value());
+        if (auto expected = by_reader.get())
+        {
+            CHECK(*expected == by_stream.value_or_exit(VCPKG_LINE_INFO));
+        }
+    }
+}
+
+TEST_CASE ("streamed schemed versions agree with visit_optional_schemed_version", "[registries]")
+{
+    std::vector<std::vector<std::string>> version_member_sets;
+    version_member_sets.emplace_back();
+    for (auto&& field : streamed_version_fields)
+    {
+        for (auto&& value : streamed_version_texts)
+        {
+            version_member_sets.push_back({member_text(field, value)});
+        }
+
+        // two versioning fields, or the same one twice
+        for (auto&& other_field : streamed_version_fields)
+        {
+            version_member_sets.push_back({member_text(field, R"("1.2.3")"), member_text(other_field, R"("1.2.3")")});
+        }
+    }
+
+    for (auto&& version_members : version_member_sets)
+    {
+        check_schemed_version_agrees(version_members);
+        for (auto&& port_version : streamed_port_versions)
+        {
+            auto members = version_members;
+            members.push_back(member_text(JsonIdPortVersion, port_version));
+            check_schemed_version_agrees(members);
+            // the order of the fields doesn't matter
+            std::rotate(members.begin(), members.end() - 1, members.end());
+            check_schemed_version_agrees(members);
+            // nor does a duplicate port-version go unnoticed
+            members.push_back(member_text(JsonIdPortVersion, "0"));
+            check_schemed_version_agrees(members);
+        }
+    }
+}
+
+TEST_CASE ("streamed baseline versions agree with baseline_version_tag_deserializer", "[registries]")
+{
+    std::vector<std::vector<std::string>> member_sets;
+    member_sets.emplace_back();
+    for (auto&& value : streamed_version_texts)
+    {
+        member_sets.push_back({member_text(JsonIdBaseline, value)});
+        for (auto&& port_version : streamed_port_versions)
+        {
+            member_sets.push_back({member_text(JsonIdBaseline, value), member_text(JsonIdPortVersion, port_version)});
+            member_sets.push_back({member_text(JsonIdPortVersion, port_version), member_text(JsonIdBaseline, value)});
+        }
+    }
+
+    member_sets.push_back({member_text(JsonIdBaseline, R"("1")"), member_text(JsonIdBaseline, R"("2")")});
+    member_sets.push_back({member_text(JsonIdBaseline, R"("1")"),
+                           member_text(JsonIdPortVersion, "1"),
+                           member_text(JsonIdPortVersion, "2")});
+
+    for (auto&& base_members : member_sets)
+    {
+        // the stream declines objects with other fields, which the deserializer ignores
+        for (bool extra_field : {false, true})
+        {
+            auto members = base_members;
+            if (extra_field)
+            {
+                members.push_back(member_text("note", "1"));
+            }
+
+            const auto text = object_text(members);
+            INFO(text);
+            bool reader_accepts = false;
+            Version by_reader;
+            auto maybe_object = Json::parse_object(text, "test");
+            if (auto object = maybe_object.get())
+            {
+                Json::Reader r("test");
+                auto maybe_version = baseline_version_tag_deserializer.visit(r, *object);
+                if (auto version = maybe_version.get())
+                {
+                    reader_accepts = !r.messages().any_errors();
+                    by_reader = std::move(*version);
+                }
+            }
+
+            Json::StreamReader reader(text, "test");
+            Version by_stream;
+            const bool stream_accepts = stream_baseline_version_tag(reader, by_stream) && reader.finish();
+            if (stream_accepts)
+            {
+                REQUIRE(reader_accepts);
+                CHECK(by_stream == by_reader);
+            }
+            else if (!extra_field)
+            {
+                CHECK(!reader_accepts);
+            }
+        }
+    }
+}
+
+TEST_CASE ("filesystem registry lookups are thread safe", "[registries]")
+{
+    auto& fs = real_filesystem;
+    const auto root = Test::base_temporary_directory() / "filesystem_registry_threads";
+    fs.remove_all(root, VCPKG_LINE_INFO);
+    static constexpr size_t port_count = 64;
+    std::vector<std::string> port_names;
+    std::string baseline = R"json({"default": {)json";
+    fs.create_directories(root / "versions" / "p-", VCPKG_LINE_INFO);
+    for (size_t idx = 0; idx < port_count; ++idx)
+    {
+        auto port_name = fmt::format("port-{}", idx);
+        fs.create_directories(root / "ports" / port_name, VCPKG_LINE_INFO);
+        // one port has a broken manifest, so that errors are collected too
+        fs.write_contents(root / "ports" / port_name / "vcpkg.json",
+                          idx == 7 ? std::string{"{"}
+                                   : fmt::format(R"json({{"name": "{}", "version": "1.{}"}})json", port_name, idx),
+                          VCPKG_LINE_INFO);
+        fs.write_contents(
+            root / "versions" / "p-" / (port_name + ".json"),
+            fmt::format(R"json({{"versions": [{{"version": "1.{}", "path": "$/ports/{}"}}]}})json", idx, port_name),
+            VCPKG_LINE_INFO);
+        if (idx != 0)
+        {
+            baseline.push_back(',');
+        }
+
+        fmt::format_to(std::back_inserter(baseline), R"json("{}": {{"baseline": "1.{}"}})json", port_name, idx);
+        port_names.push_back(std::move(port_name));
+    }
+
+    baseline.append("}}");
+    fs.write_contents(root / "versions" / "baseline.json", baseline, VCPKG_LINE_INFO);
+
+    auto registry = make_filesystem_registry(fs, root, "");
+    auto load = [&](size_t idx) -> std::string {
+        auto version = registry->get_baseline_version(port_names[idx]).value_or_exit(VCPKG_LINE_INFO);
+        auto entry = registry->get_port_entry(port_names[idx]).value_or_exit(VCPKG_LINE_INFO);
+        return entry->try_load_port(version.value_or_exit(VCPKG_LINE_INFO))
+            .map([](const SourceControlFileAndLocation& scfl) { return scfl.to_version().to_string(); })
+            .value_or("error");
+    };
+
+    std::vector<std::string> loaded_in_parallel(port_count);
+    execute_in_parallel(port_count, [&](size_t idx) { loaded_in_parallel[idx] = load(idx); });
+    for (size_t idx = 0; idx < port_count; ++idx)
+    {
+        CHECK(loaded_in_parallel[idx] == (idx == 7 ? std::string{"error"} : fmt::format("1.{}", idx)));
+        CHECK(load(idx) == loaded_in_parallel[idx]);
+    }
+
+    // try_load_all_registry_ports loads these ports on worker threads and reports them in name order
+    RegistrySet registries{make_filesystem_registry(fs, root, ""), {}};
+    auto results = Paragraphs::try_load_all_registry_ports(registries);
+    CHECK(results.paragraphs.size() == port_count - 1);
+    REQUIRE(results.errors.size() == 1);
+    CHECK(results.errors[0].first == "port-7");
+    CHECK(std::is_sorted(results.paragraphs.begin(),
+                         results.paragraphs.end(),
+                         [](const SourceControlFileAndLocation& lhs, const SourceControlFileAndLocation& rhs) {
+                             return lhs.to_name() < rhs.to_name();
+                         }));
+
+    fs.remove_all(root, VCPKG_LINE_INFO);
+}
+
 TEST_CASE ("filesystem_version_db_parsing", "[registries]")
 {
     FilesystemVersionDbEntryArrayDeserializer filesystem_version_db("a/b");
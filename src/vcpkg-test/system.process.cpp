@@ -97,6 +97,40 @@ TEST_CASE ("no closes-stdout crash", "[system.process]")
     REQUIRE(run.output == "hello world");
 }
 
+TEST_CASE ("coprocess round trips", "[system.process]")
+{
+    auto test_program = Path(get_exe_path_of_current_process().parent_path()) / "reads-stdin";
+    Coprocess coprocess;
+    REQUIRE(coprocess.start(console_diagnostic_context, Command{test_program}.string_arg("read"), {}));
+    REQUIRE(coprocess.is_running());
+
+    // reads-stdin answers every 20 bytes of input with a line
+    std::string line;
+    for (int idx = 0; idx < 3; ++idx)
+    {
+        REQUIRE(coprocess.write(console_diagnostic_context, "exampleexampleexampleexample"));
+        REQUIRE(coprocess.read_line(console_diagnostic_context, line));
+        Strings::inplace_trim_end(line);
+        REQUIRE(line == "read");
+    }
+
+    auto maybe_exit_code = coprocess.finish(console_diagnostic_context);
+    REQUIRE(!coprocess.is_running());
+    REQUIRE(maybe_exit_code.value_or_exit(VCPKG_LINE_INFO) == 0);
+}
+
+TEST_CASE ("coprocess exited", "[system.process]")
+{
+    auto test_program = Path(get_exe_path_of_current_process().parent_path()) / "closes-stdin";
+    Coprocess coprocess;
+    REQUIRE(coprocess.start(console_diagnostic_context, Command{test_program}, {}));
+    std::string line;
+    REQUIRE(!coprocess.read_line(null_diagnostic_context, line));
+    // the child may not have released its input yet, so this may or may not fail, but it must not raise SIGPIPE
+    (void)coprocess.write(null_diagnostic_context, "this is some input that will be intentionally not read");
+    REQUIRE(coprocess.finish(console_diagnostic_context).value_or_exit(VCPKG_LINE_INFO) == 0);
+}
+
 TEST_CASE ("command try_append", "[system.process]")
 {
     {
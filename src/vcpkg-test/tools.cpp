@@ -1,6 +1,10 @@
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/downloads.h>
+#include <vcpkg/base/files.h>
 #include <vcpkg/base/jsonreader.h>
+#include <vcpkg/base/message_sinks.h>
+#include <vcpkg/base/parallel-algorithms.h>
 
 #include <vcpkg/tools.h>
 #include <vcpkg/tools.test.h>
@@ -304,3 +308,25 @@ TEST_CASE ("parse_tool_data errors", "[tools]")
     CHECK("invalid_sha512.json: error: $.tools[0].sha512 (a SHA-512 hash): invalid SHA-512 hash: notasha512\n"
           "SHA-512 hash must be 128 characters long and contain only hexadecimal digits" == invalid_sha512.error());
 }
+
+TEST_CASE ("tool cache lookups are thread safe", "[tools]")
+{
+    const auto root = Test::base_temporary_directory() / "tool-cache-threads";
+    AssetCachingSettings asset_cache_settings;
+    auto cache = get_tool_cache(real_filesystem,
+                                asset_cache_settings,
+                                root / "downloads",
+                                root / "vcpkg-tools.json",
+                                root / "tools",
+                                RequireExactVersions::NO);
+
+    // every thread must see the one cached result, rather than racing to insert its own
+    std::vector<const Path*> found(32);
+    execute_in_parallel(found.size(), [&](size_t idx) { found[idx] = &cache->get_tool_path(Tools::TAR, null_sink); });
+    for (auto&& path : found)
+    {
+        CHECK(path == found[0]);
+    }
+
+    CHECK(*found[0] == find_system_tar(real_filesystem).value_or_exit(VCPKG_LINE_INFO));
+}
@@ -9,10 +9,57 @@
 #include <vcpkg/archives.h>
 #include <vcpkg/tools.h>
 
+#include <limits.h>
+
 namespace
 {
     using namespace vcpkg;
 
+    uint16_t load_le16(const char* p)
+    {
+        const auto* u = reinterpret_cast<const unsigned char*>(p);
+        return static_cast<uint16_t>(u[0] | (u[1] << 8));
+    }
+
+    uint32_t load_le32(const char* p)
+    {
+        return static_cast<uint32_t>(load_le16(p)) | (static_cast<uint32_t>(load_le16(p + 2)) << 16);
+    }
+
+    uint64_t load_le64(const char* p)
+    {
+        return static_cast<uint64_t>(load_le32(p)) | (static_cast<uint64_t>(load_le32(p + 4)) << 32);
+    }
+
+    // See APPNOTE.TXT, section 4.3
+    constexpr StringLiteral ZipEndOfCentralDirectorySignature = "PK\x05\x06";
+    constexpr size_t ZipEndOfCentralDirectorySize = 22;
+    constexpr size_t ZipMaxCommentSize = 0xFFFF;
+    constexpr StringLiteral Zip64EndOfCentralDirectoryLocatorSignature = "PK\x06\x07";
+    constexpr size_t Zip64EndOfCentralDirectoryLocatorSize = 20;
+    constexpr StringLiteral Zip64EndOfCentralDirectorySignature = "PK\x06\x06";
+    constexpr size_t Zip64EndOfCentralDirectorySize = 56;
+    constexpr StringLiteral ZipCentralDirectoryHeaderSignature = "PK\x01\x02";
+    constexpr size_t ZipCentralDirectoryHeaderSize = 46;
+
+    bool has_signature(const std::string& buffer, size_t offset, StringLiteral signature)
+    {
+        return buffer.size() >= offset + signature.size() &&
+               StringView{buffer.data() + offset, signature.size()} == signature;
+    }
+
+    ExpectedL<std::string> read_zip_range(ReadFilePointer& file, uint64_t offset, uint64_t size, const Path& archive)
+    {
+        if (size > UINT32_MAX || offset > static_cast<uint64_t>(LLONG_MAX))
+        {
+            return msg::format_error(msgZipCentralDirectoryInvalid, msg::path = archive);
+        }
+
+        std::string buffer(static_cast<size_t>(size), '\0');
+        return file.try_read_all_from(static_cast<long long>(offset), buffer.data(), static_cast<uint32_t>(size))
+            .map([&](Unit) { return std::move(buffer); });
+    }
+
 #if defined(_WIN32)
     void win32_extract_nupkg(const ToolCache& tools, MessageSink& status_sink, const Path& archive, const Path& to_path)
     {
@@ -369,6 +416,58 @@ namespace vcpkg
         return cmd;
     }
 
+    Command ZipTool::decompress_zip_archive_into_installed_cmd(const Path& dst, const Path& archive_path) const
+    {
+        Command cmd;
+#if defined(_WIN32)
+        cmd.string_arg(seven_zip.value_or_exit(VCPKG_LINE_INFO))
+            .string_arg("x")
+            .string_arg(archive_path)
+            .string_arg("-o" + dst.native())
+            .string_arg("-y")
+            .string_arg("-aoa");
+        for (auto&& excluded : {FileControl, FileBuildInfo, FileVcpkgDotJson})
+        {
+            cmd.string_arg(Strings::concat("-xr!", excluded));
+        }
+#else
+        cmd.string_arg("unzip").string_arg("-DD").string_arg("-qq").string_arg("-o").string_arg(archive_path);
+        cmd.string_arg("-x");
+        for (auto&& excluded : {FileControl, FileBuildInfo, FileVcpkgDotJson})
+        {
+            // unzip wildcards match across directory separators
+            cmd.string_arg(excluded).string_arg(Strings::concat("*/", excluded));
+        }
+
+        cmd.string_arg("-d" + dst.native());
+#endif
+        return cmd;
+    }
+
+    Command ZipTool::decompress_zip_archive_entry_cmd(const Path& dst,
+                                                      const Path& archive_path,
+                                                      StringView entry) const
+    {
+        Command cmd;
+#if defined(_WIN32)
+        cmd.string_arg(seven_zip.value_or_exit(VCPKG_LINE_INFO))
+            .string_arg("e")
+            .string_arg(archive_path)
+            .string_arg("-o" + dst.native())
+            .string_arg("-y")
+            .string_arg(entry);
+#else
+        cmd.string_arg("unzip")
+            .string_arg("-DD")
+            .string_arg("-qq")
+            .string_arg("-o")
+            .string_arg(archive_path)
+            .string_arg(entry)
+            .string_arg("-d" + dst.native());
+#endif
+        return cmd;
+    }
+
     std::vector<ExpectedL<Unit>> decompress_in_parallel(View<Command> jobs)
     {
         RedirectedProcessLaunchSettings settings;
@@ -383,4 +482,122 @@ namespace vcpkg
 
         return filtered_results;
     }
+
+    ExpectedL<std::vector<std::string>> list_zip_archive_entries(const ReadOnlyFilesystem& fs, const Path& archive)
+    {
+        std::error_code ec;
+        const auto archive_size = fs.file_size(archive, ec);
+        if (ec)
+        {
+            return format_filesystem_call_error(ec, "file_size", {archive});
+        }
+
+        auto maybe_file = fs.try_open_for_read(archive);
+        auto file = maybe_file.get();
+        if (!file)
+        {
+            return std::move(maybe_file).error();
+        }
+
+        // The end of central directory record is followed only by the archive comment, so search backwards for it
+        // from the end of the file.
+        const auto tail_size =
+            (std::min)(archive_size,
+                       static_cast<uint64_t>(ZipEndOfCentralDirectorySize + ZipMaxCommentSize +
+                                             Zip64EndOfCentralDirectoryLocatorSize));
+        const auto tail_offset = archive_size - tail_size;
+        auto maybe_tail = read_zip_range(*file, tail_offset, tail_size, archive);
+        auto tail = maybe_tail.get();
+        if (!tail)
+        {
+            return std::move(maybe_tail).error();
+        }
+
+        if (tail->size() < ZipEndOfCentralDirectorySize)
+        {
+            return msg::format_error(msgZipCentralDirectoryInvalid, msg::path = archive);
+        }
+
+        size_t eocd = tail->size() - ZipEndOfCentralDirectorySize;
+        while (!has_signature(*tail, eocd, ZipEndOfCentralDirectorySignature))
+        {
+            if (eocd == 0)
+            {
+                return msg::format_error(msgZipCentralDirectoryInvalid, msg::path = archive);
+            }
+
+            --eocd;
+        }
+
+        uint64_t entry_count = load_le16(tail->data() + eocd + 10);
+        uint64_t directory_size = load_le32(tail->data() + eocd + 12);
+        uint64_t directory_offset = load_le32(tail->data() + eocd + 16);
+        if (entry_count == 0xFFFF || directory_size == 0xFFFFFFFF || directory_offset == 0xFFFFFFFF)
+        {
+            if (eocd < Zip64EndOfCentralDirectoryLocatorSize ||
+                !has_signature(
+                    *tail, eocd - Zip64EndOfCentralDirectoryLocatorSize, Zip64EndOfCentralDirectoryLocatorSignature))
+            {
+                return msg::format_error(msgZipCentralDirectoryInvalid, msg::path = archive);
+            }
+
+            const auto zip64_eocd_offset =
+                load_le64(tail->data() + eocd - Zip64EndOfCentralDirectoryLocatorSize + 8);
+            auto maybe_zip64_eocd = read_zip_range(*file, zip64_eocd_offset, Zip64EndOfCentralDirectorySize, archive);
+            auto zip64_eocd = maybe_zip64_eocd.get();
+            if (!zip64_eocd)
+            {
+                return std::move(maybe_zip64_eocd).error();
+            }
+
+            if (!has_signature(*zip64_eocd, 0, Zip64EndOfCentralDirectorySignature))
+            {
+                return msg::format_error(msgZipCentralDirectoryInvalid, msg::path = archive);
+            }
+
+            entry_count = load_le64(zip64_eocd->data() + 32);
+            directory_size = load_le64(zip64_eocd->data() + 40);
+            directory_offset = load_le64(zip64_eocd->data() + 48);
+        }
+
+        if (directory_offset > archive_size || directory_size > archive_size - directory_offset)
+        {
+            return msg::format_error(msgZipCentralDirectoryInvalid, msg::path = archive);
+        }
+
+        auto maybe_directory = read_zip_range(*file, directory_offset, directory_size, archive);
+        auto directory = maybe_directory.get();
+        if (!directory)
+        {
+            return std::move(maybe_directory).error();
+        }
+
+        std::vector<std::string> entries;
+        size_t offset = 0;
+        for (uint64_t idx = 0; idx < entry_count; ++idx)
+        {
+            if (directory->size() - offset < ZipCentralDirectoryHeaderSize ||
+                !has_signature(*directory, offset, ZipCentralDirectoryHeaderSignature))
+            {
+                return msg::format_error(msgZipCentralDirectoryInvalid, msg::path = archive);
+            }
+
+            const char* header = directory->data() + offset;
+            const size_t name_size = load_le16(header + 28);
+            const size_t extra_size = load_le16(header + 30);
+            const size_t comment_size = load_le16(header + 32);
+            const size_t record_size = ZipCentralDirectoryHeaderSize + name_size + extra_size + comment_size;
+            if (directory->size() - offset < record_size)
+            {
+                return msg::format_error(msgZipCentralDirectoryInvalid, msg::path = archive);
+            }
+
+            auto& name = entries.emplace_back(header + ZipCentralDirectoryHeaderSize, name_size);
+            // Some Windows archivers write backslashes even though the format requires forward slashes
+            std::replace(name.begin(), name.end(), '\\', '/');
+            offset += record_size;
+        }
+
+        return entries;
+    }
 }
@@ -0,0 +1,343 @@
+#include <vcpkg/base/binary-records.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/fmt.h>
+#include <vcpkg/base/message_sinks.h>
+#include <vcpkg/base/span.h>
+#include <vcpkg/base/system.debug.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/util.h>
+
+#include <stdint.h>
+
+#include <mutex>
+
+namespace
+{
+    using namespace vcpkg;
+
+    std::string serialize_record(StringView key, StringView payload)
+    {
+        BinaryWriter body;
+        body.write_string(key);
+        body.buffer.append(payload.data(), payload.size());
+        BinaryWriter record;
+        record.write_scalar(static_cast<uint32_t>(body.buffer.size()));
+        record.buffer.append(body.buffer);
+        return std::move(record.buffer);
+    }
+
+    struct ParsedRecords
+    {
+        // The latest payload for each key, with the position of the record that provided it
+        std::map<std::string, std::pair<std::size_t, std::string>, std::less<>> records;
+        std::size_t record_count = 0;
+        bool intact = false;
+    };
+
+    ParsedRecords parse_records(StringView contents, StringView header)
+    {
+        ParsedRecords result;
+        result.intact = contents.starts_with(header);
+        if (!result.intact)
+        {
+            return result;
+        }
+
+        BinaryReader reader{contents.data() + header.size(), contents.data() + contents.size()};
+        while (!reader.empty())
+        {
+            uint32_t record_size;
+            StringView key;
+            if (!reader.read_scalar(record_size) || static_cast<std::size_t>(reader.last - reader.first) < record_size)
+            {
+                result.intact = false;
+                break;
+            }
+
+            BinaryReader record{reader.first, reader.first + record_size};
+            reader.first = record.last;
+            if (!record.read_string(key))
+            {
+                result.intact = false;
+                break;
+            }
+
+            result.records.insert_or_assign(key.to_string(),
+                                            std::make_pair(result.record_count, std::string{record.first, record.last}));
+            ++result.record_count;
+        }
+
+        return result;
+    }
+
+    bool needs_rewrite(const ParsedRecords& parsed, std::size_t max_records)
+    {
+        return !parsed.intact || parsed.record_count > parsed.records.size() * 2 + 64 ||
+               (max_records != 0 && parsed.records.size() > max_records);
+    }
+
+    std::map<std::string, std::string, std::less<>> take_payloads(ParsedRecords&& parsed)
+    {
+        std::map<std::string, std::string, std::less<>> result;
+        for (auto&& record : parsed.records)
+        {
+            result.emplace_hint(result.end(), record.first, std::move(record.second.second));
+        }
+
+        return result;
+    }
+
+    // Serializes record file writes between threads of this process, since the file lock is only polled
+    std::mutex g_record_files_mutex;
+
+    std::unique_ptr<IExclusiveFileLock> take_record_file_lock(const Filesystem& fs, const Path& path)
+    {
+        std::error_code ec;
+        fs.create_directories(path.parent_path(), ec);
+        std::unique_ptr<IExclusiveFileLock> lock;
+        if (!ec)
+        {
+            lock = fs.take_exclusive_file_lock(path + ".lock", null_sink, ec);
+        }
+
+        if (ec)
+        {
+            Debug::print("Failed to lock ", path, ": ", ec.message(), '\n');
+            lock.reset();
+        }
+
+        return lock;
+    }
+}
+
+namespace vcpkg
+{
+    void BinaryWriter::write_string(StringView value)
+    {
+        write_scalar(static_cast<uint32_t>(value.size()));
+        buffer.append(value.data(), value.size());
+    }
+
+    bool BinaryReader::read_string(std::string& value)
+    {
+        StringView view;
+        if (!read_string(view))
+        {
+            return false;
+        }
+
+        value.assign(view.data(), view.size());
+        return true;
+    }
+
+    bool BinaryReader::read_string(StringView& value) noexcept
+    {
+        uint32_t size;
+        if (!read_scalar(size) || static_cast<std::size_t>(last - first) < size)
+        {
+            return false;
+        }
+
+        value = StringView{first, size};
+        first += size;
+        return true;
+    }
+
+    BinaryRecordFile::BinaryRecordFile(const Filesystem& fs,
+                                       const Path& path,
+                                       StringView header,
+                                       std::size_t max_records)
+        : m_fs(&fs), m_path(path), m_header(header.data(), header.size()), m_max_records(max_records)
+    {
+    }
+
+    std::map<std::string, std::string, std::less<>> BinaryRecordFile::load() const
+    {
+        if (m_path.empty())
+        {
+            return {};
+        }
+
+        std::error_code ec;
+        auto contents = m_fs->read_contents(m_path, ec);
+        if (ec)
+        {
+            if (ec != std::errc::no_such_file_or_directory)
+            {
+                Debug::print("Failed to read ", m_path, ": ", ec.message(), '\n');
+            }
+
+            return {};
+        }
+
+        auto parsed = parse_records(contents, m_header);
+        if (!needs_rewrite(parsed, m_max_records))
+        {
+            return take_payloads(std::move(parsed));
+        }
+
+        // another process may be appending; rewrite what is there once it is done
+        std::lock_guard<std::mutex> in_process_lock(g_record_files_mutex);
+        auto file_lock = take_record_file_lock(*m_fs, m_path);
+        if (!file_lock)
+        {
+            return take_payloads(std::move(parsed));
+        }
+
+        contents = m_fs->read_contents(m_path, ec);
+        if (ec)
+        {
+            contents.clear();
+        }
+
+        parsed = parse_records(contents, m_header);
+        if (!needs_rewrite(parsed, m_max_records))
+        {
+            return take_payloads(std::move(parsed));
+        }
+
+        if (m_max_records != 0 && parsed.records.size() > m_max_records)
+        {
+            // keep the most recently appended three quarters, so that the next few appends don't rewrite it again
+            std::vector<std::pair<std::size_t, std::string>> by_age;
+            for (auto&& record : parsed.records)
+            {
+                by_age.emplace_back(record.second.first, record.first);
+            }
+
+            Util::sort(by_age);
+            const auto to_drop = by_age.size() - m_max_records * 3 / 4;
+            for (std::size_t idx = 0; idx < to_drop; ++idx)
+            {
+                parsed.records.erase(by_age[idx].second);
+            }
+        }
+
+        Debug::print("Rewriting ", m_path, '\n');
+        std::string rewritten = m_header;
+        for (auto&& record : parsed.records)
+        {
+            rewritten.append(serialize_record(record.first, record.second.second));
+        }
+
+        write_new_file(rewritten);
+        return take_payloads(std::move(parsed));
+    }
+
+    void BinaryRecordFile::append(StringView key, StringView payload) const
+    {
+        if (!m_path.empty())
+        {
+            append_serialized(serialize_record(key, payload));
+        }
+    }
+
+    void BinaryRecordFile::append(View<std::pair<std::string, std::string>> records) const
+    {
+        if (m_path.empty() || records.empty())
+        {
+            return;
+        }
+
+        std::string serialized;
+        for (auto&& record : records)
+        {
+            serialized.append(serialize_record(record.first, record.second));
+        }
+
+        append_serialized(serialized);
+    }
+
+    void BinaryRecordFile::replace(StringView key, StringView payload) const
+    {
+        if (m_path.empty())
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> in_process_lock(g_record_files_mutex);
+        auto file_lock = take_record_file_lock(*m_fs, m_path);
+        if (!file_lock)
+        {
+            return;
+        }
+
+        std::error_code ec;
+        auto contents = m_fs->read_contents(m_path, ec);
+        if (ec)
+        {
+            contents.clear();
+        }
+
+        auto parsed = parse_records(contents, m_header);
+        std::string rewritten = m_header;
+        for (auto&& record : parsed.records)
+        {
+            if (record.first != key)
+            {
+                rewritten.append(serialize_record(record.first, record.second.second));
+            }
+        }
+
+        rewritten.append(serialize_record(key, payload));
+        write_new_file(rewritten);
+    }
+
+    void BinaryRecordFile::append_serialized(StringView serialized) const
+    {
+        std::lock_guard<std::mutex> in_process_lock(g_record_files_mutex);
+        auto file_lock = take_record_file_lock(*m_fs, m_path);
+        if (!file_lock)
+        {
+            return;
+        }
+
+        std::error_code ec;
+        if (!m_fs->exists(m_path, ec))
+        {
+            if (!ec)
+            {
+                write_new_file(m_header + serialized.to_string());
+                return;
+            }
+        }
+        else
+        {
+            auto file = m_fs->open_for_write(m_path, Append::YES, ec);
+            if (!ec && file.write(serialized.data(), 1, serialized.size()) != serialized.size())
+            {
+                ec = std::make_error_code(std::errc::io_error);
+            }
+
+            if (!ec)
+            {
+                return;
+            }
+        }
+
+        Debug::print("Failed to append to ", m_path, ": ", ec.message(), '\n');
+    }
+
+    void BinaryRecordFile::write_new_file(StringView contents) const
+    {
+        // Publish with a rename so that concurrent readers never see a partial file
+        const Path temp = fmt::format("{}_{}.tmp", m_path, get_process_id());
+        std::error_code ec;
+        m_fs->create_directories(m_path.parent_path(), ec);
+        if (!ec)
+        {
+            m_fs->write_contents(temp, contents, ec);
+        }
+
+        if (!ec)
+        {
+            m_fs->rename(temp, m_path, ec);
+        }
+
+        if (ec)
+        {
+            Debug::print("Failed to write ", m_path, ": ", ec.message(), '\n');
+            m_fs->remove(temp, IgnoreErrors{});
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include <vcpkg/base/json.h>
 #include <vcpkg/base/lazy.h>
 #include <vcpkg/base/message_sinks.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/parse.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/stringview.h>
@@ -665,12 +666,224 @@ namespace vcpkg
         return true;
     }
 
+    static unsigned int get_curl_parallel_max()
+    {
+        static unsigned int parallel_max = [] {
+            auto maybe_user_parallel_max = get_environment_variable(EnvironmentVariableXVcpkgCurlParallelMax);
+            if (auto user_parallel_max = maybe_user_parallel_max.get())
+            {
+                auto maybe_res = Strings::strto<int>(*user_parallel_max);
+                auto res = maybe_res.get();
+                if (!res)
+                {
+                    Checks::msg_exit_with_message(VCPKG_LINE_INFO,
+                                                  msgOptionMustBeInteger,
+                                                  msg::option = EnvironmentVariableXVcpkgCurlParallelMax);
+                }
+
+                if (!(*res > 0))
+                {
+                    Checks::msg_exit_with_message(VCPKG_LINE_INFO,
+                                                  msgEnvInvalidMaxConcurrency,
+                                                  msg::env_var = EnvironmentVariableXVcpkgCurlParallelMax,
+                                                  msg::value = *res);
+                }
+
+                return static_cast<unsigned int>(*res);
+            }
+
+            // --parallel requires curl 7.66.0 and %{urlnum} requires curl 7.75.0, so this is opt-in
+            return 1u;
+        }();
+
+        return parallel_max;
+    }
+
+    std::vector<unsigned int> split_curl_parallel_max(size_t batch_count, size_t concurrency, unsigned int parallel_max)
+    {
+        const size_t lanes = (std::min)({batch_count, concurrency, static_cast<size_t>(parallel_max)});
+        std::vector<unsigned int> connections;
+        connections.reserve(lanes);
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            connections.push_back(static_cast<unsigned int>(parallel_max / lanes + (lane < parallel_max % lanes)));
+        }
+
+        return connections;
+    }
+
+    std::vector<int> curl_parallel_bulk_operation(DiagnosticContext& context,
+                                                  View<Command> operation_args,
+                                                  StringLiteral prefixArgs,
+                                                  View<std::string> headers,
+                                                  View<std::string> secrets,
+                                                  unsigned int parallel_max)
+    {
+#define GUID_MARKER "0c7fa5ea-6e5a-4e3c-9d3c-3a0a5a3e9b62"
+        static constexpr StringLiteral guid_marker = GUID_MARKER;
+        Command prefix_cmd{"curl"};
+        if (!prefixArgs.empty())
+        {
+            prefix_cmd.raw_arg(prefixArgs);
+        }
+
+        prefix_cmd.string_arg("--retry")
+            .string_arg("3")
+            .string_arg("-L")
+            .string_arg("-sS")
+            .string_arg("-w")
+            .string_arg(GUID_MARKER "%{urlnum} %{http_code} %{exitcode} %{errormsg}\\n");
+#undef GUID_MARKER
+        add_curl_headers(prefix_cmd, headers);
+        const auto with_parallel_max = [&](unsigned int connections) {
+            auto cmd = prefix_cmd;
+            cmd.string_arg("--parallel").string_arg("--parallel-max").string_arg(std::to_string(connections));
+            return cmd;
+        };
+
+        struct CurlBatch
+        {
+            size_t first_op;
+            size_t last_op;
+        };
+
+        // Form maximum length command lines of operations. Batches are measured with the largest --parallel-max so
+        // that they still fit with any smaller share of it.
+        const auto measure_cmd = with_parallel_max(parallel_max);
+        std::vector<CurlBatch> batches;
+        size_t next_op = 0;
+        while (next_op != operation_args.size())
+        {
+            auto batch_cmd = measure_cmd;
+            CurlBatch batch{next_op, next_op};
+            while (batch.last_op != operation_args.size() && batch_cmd.try_append(operation_args[batch.last_op]))
+            {
+                ++batch.last_op;
+            }
+
+            if (batch.last_op == batch.first_op)
+            {
+                // not even one operation fits with the configured headers; the remaining operations fail without
+                // running curl
+                break;
+            }
+
+            next_op = batch.last_op;
+            batches.push_back(batch);
+        }
+
+        // When the operations need several command lines, run some of them concurrently
+        const auto lane_connections = split_curl_parallel_max(batches.size(), get_concurrency(), parallel_max);
+        const size_t lanes = lane_connections.size();
+        std::vector<Command> batch_cmds;
+        batch_cmds.reserve(batches.size());
+        for (size_t batch_idx = 0; batch_idx < batches.size(); ++batch_idx)
+        {
+            auto batch_cmd = with_parallel_max(lane_connections[batch_idx % lanes]);
+            for (size_t op = batches[batch_idx].first_op; op != batches[batch_idx].last_op; ++op)
+            {
+                if (!batch_cmd.try_append(operation_args[op]))
+                {
+                    Checks::unreachable(VCPKG_LINE_INFO);
+                }
+            }
+
+            batch_cmds.push_back(std::move(batch_cmd));
+        }
+
+        // transfers complete in any order, so results are placed by %{urlnum} and diagnostics are buffered per
+        // operation so that they are reported in the same order as the serial implementation
+        static constexpr int no_result = -1;
+        std::vector<int> ret(operation_args.size(), no_result);
+        std::vector<std::vector<DiagnosticLine>> batch_diagnostics(batches.size());
+        const auto run_batch = [&](size_t batch_idx) {
+            auto& batch = batches[batch_idx];
+            BufferedDiagnosticContext batch_context{null_sink};
+            std::vector<int> batch_codes(batch.last_op - batch.first_op, no_result);
+            std::vector<std::vector<DiagnosticLine>> op_diagnostics(batch_codes.size());
+            std::vector<std::string> debug_lines;
+            auto maybe_this_batch_exit_code =
+                cmd_execute_and_stream_lines(batch_context, batch_cmds[batch_idx], [&](StringView line) {
+                    debug_lines.emplace_back(line.data(), line.size());
+                    BufferedDiagnosticContext line_context{null_sink};
+                    auto maybe_url_index =
+                        parse_curl_parallel_status_line(line_context, batch_codes, guid_marker, line);
+                    if (auto url_index = maybe_url_index.get())
+                    {
+                        Util::Vectors::append(op_diagnostics[*url_index], std::move(line_context.lines));
+                    }
+                });
+
+            for (auto&& diagnostics : op_diagnostics)
+            {
+                Util::Vectors::append(batch_context.lines, std::move(diagnostics));
+            }
+
+            if (auto this_batch_exit_code = maybe_this_batch_exit_code.get())
+            {
+                if (Util::any_of(batch_codes, [](int code) { return code == no_result; }))
+                {
+                    // curl didn't process everything we asked of it; this usually means curl crashed or is too old
+                    // to understand --parallel or %{urlnum}
+                    auto command_line = std::move(batch_cmds[batch_idx]).extract();
+                    replace_secrets(command_line, secrets);
+                    batch_context.report_error_with_log(Strings::join("\n", debug_lines),
+                                                        msgCurlFailedToReturnExpectedNumberOfExitCodes,
+                                                        msg::exit_code = *this_batch_exit_code,
+                                                        msg::command_line = command_line);
+                }
+            }
+
+            // each batch owns a disjoint range of ret
+            std::copy(batch_codes.begin(), batch_codes.end(), ret.begin() + batch.first_op);
+            batch_diagnostics[batch_idx] = std::move(batch_context.lines);
+        };
+
+        // each lane runs its batches one after another, so at most `lanes` curl processes run at once
+        execute_in_parallel(lanes, [&](size_t lane) {
+            for (size_t batch_idx = lane; batch_idx < batches.size(); batch_idx += lanes)
+            {
+                run_batch(batch_idx);
+            }
+        });
+
+        for (auto&& diagnostics : batch_diagnostics)
+        {
+            for (auto&& diagnostic : diagnostics)
+            {
+                context.report(std::move(diagnostic));
+            }
+        }
+
+        if (next_op != operation_args.size())
+        {
+            context.report_error(msgCurlOperationsNotAttempted, msg::count = operation_args.size() - next_op);
+        }
+
+        // operations curl never reported on failed, as in the serial implementation
+        for (auto&& code : ret)
+        {
+            if (code == no_result)
+            {
+                code = 0;
+            }
+        }
+
+        return ret;
+    }
+
     static std::vector<int> curl_bulk_operation(DiagnosticContext& context,
                                                 View<Command> operation_args,
                                                 StringLiteral prefixArgs,
                                                 View<std::string> headers,
                                                 View<std::string> secrets)
     {
+        const auto parallel_max = get_curl_parallel_max();
+        if (parallel_max > 1 && operation_args.size() > 1)
+        {
+            return curl_parallel_bulk_operation(context, operation_args, prefixArgs, headers, secrets, parallel_max);
+        }
+
 #define GUID_MARKER "5ec47b8e-6776-4d70-b9b3-ac2a57bc0a1c"
         static constexpr StringLiteral guid_marker = GUID_MARKER;
         Command prefix_cmd{"curl"};
@@ -688,9 +901,6 @@ namespace vcpkg
         add_curl_headers(prefix_cmd, headers);
         while (ret.size() != operation_args.size())
         {
-            // there's an edge case that we aren't handling here where not even one operation fits with the configured
-            // headers but this seems unlikely
-
             // form a maximum length command line of operations:
             auto batch_cmd = prefix_cmd;
             size_t last_try_op = ret.size();
@@ -699,6 +909,13 @@ namespace vcpkg
                 ++last_try_op;
             }
 
+            if (last_try_op == ret.size())
+            {
+                // not even one operation fits with the configured headers
+                context.report_error(msgCurlOperationsNotAttempted, msg::count = operation_args.size() - ret.size());
+                break;
+            }
+
             // actually run curl
             bool new_curl_seen = false;
             std::vector<std::string> debug_lines;
@@ -724,16 +941,18 @@ namespace vcpkg
                                                   msgCurlFailedToReturnExpectedNumberOfExitCodes,
                                                   msg::exit_code = *this_batch_exit_code,
                                                   msg::command_line = command_line);
-                    return ret;
+                    break;
                 }
             }
             else
             {
                 // couldn't even launch curl, record this as the last fatal error and give up
-                return ret;
+                break;
             }
         }
 
+        // operations curl never reported on failed, as in the parallel implementation
+        ret.resize(operation_args.size(), 0);
         return ret;
     }
 
@@ -1346,6 +1565,49 @@ namespace vcpkg
         }
     }
 
+    Optional<size_t> parse_curl_parallel_status_line(DiagnosticContext& context,
+                                                     std::vector<int>& http_codes,
+                                                     StringLiteral prefix,
+                                                     StringView this_line)
+    {
+        if (!this_line.starts_with(prefix))
+        {
+            return nullopt;
+        }
+
+        auto first = this_line.begin() + prefix.size();
+        const auto last = this_line.end();
+        const auto first_url_index = first;
+        while (first != last && ParserBase::is_ascii_digit(*first))
+        {
+            ++first;
+        }
+
+        if (first == first_url_index || first == last || *first != ' ')
+        {
+            // missing %{urlnum} or the space after it
+            return nullopt;
+        }
+
+        auto maybe_url_index = Strings::strto<unsigned long long>(StringView{first_url_index, first});
+        auto url_index = maybe_url_index.get();
+        if (!url_index || *url_index >= http_codes.size())
+        {
+            // not one of the operations we asked for
+            return nullopt;
+        }
+
+        std::vector<int> this_http_code;
+        if (!parse_curl_status_line(context, this_http_code, "", StringView{first + 1, last}))
+        {
+            return nullopt;
+        }
+
+        const auto result = static_cast<size_t>(*url_index);
+        http_codes[result] = this_http_code[0];
+        return result;
+    }
+
     static DownloadPrognosis download_file_azurl_asset_cache(DiagnosticContext& context,
                                                              MessageSink& machine_readable_progress,
                                                              const AssetCachingSettings& asset_cache_settings,
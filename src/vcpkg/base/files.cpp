@@ -23,9 +23,14 @@
 #endif // !_WIN32
 
 #if defined(__linux__)
+#include <linux/fs.h>
+
+#include <sys/ioctl.h>
 #include <sys/sendfile.h>
 #elif defined(__APPLE__)
 #include <copyfile.h>
+
+#include <sys/clonefile.h>
 #endif // ^^^ defined(__APPLE__)
 
 #include <algorithm>
@@ -3789,6 +3794,78 @@ namespace vcpkg
 #endif // ^^^ !_WIN32
         }
 
+        virtual void clone_file(const Path& source, const Path& destination, std::error_code& ec) const override
+        {
+#if defined(__APPLE__)
+            // clonefile also copies the mode and refuses to replace an existing destination
+            if (::clonefile(source.c_str(), destination.c_str(), 0) == 0)
+            {
+                ec.clear();
+            }
+            else
+            {
+                ec.assign(errno, std::generic_category());
+            }
+#elif defined(__linux__) && defined(FICLONE)
+            PosixFd source_fd{source.c_str(), O_RDONLY, ec};
+            if (ec)
+            {
+                return;
+            }
+
+            struct stat source_stat;
+            source_fd.fstat(&source_stat, ec);
+            if (ec)
+            {
+                return;
+            }
+
+            if (!S_ISREG(source_stat.st_mode))
+            {
+                ec = std::make_error_code(std::errc::invalid_argument);
+                return;
+            }
+
+            PosixFd destination_fd{destination.c_str(), O_WRONLY | O_CREAT | O_EXCL, source_stat.st_mode & 07777, ec};
+            if (ec)
+            {
+                return;
+            }
+
+            if (::ioctl(destination_fd.get(), FICLONE, source_fd.get()) == -1)
+            {
+                ec.assign(errno, std::generic_category());
+                destination_fd.close();
+                ::unlink(destination.c_str());
+            }
+#else  // ^^^ defined(__linux__) && defined(FICLONE) // other platforms vvv
+            (void)source;
+            (void)destination;
+            ec = std::make_error_code(std::errc::not_supported);
+#endif // ^^^ other platforms
+        }
+
+        virtual void make_read_only(const Path& target, std::error_code& ec) const override
+        {
+#if defined(_WIN32)
+            stdfs::permissions(to_stdfs_path(target),
+                               stdfs::perms::owner_write | stdfs::perms::group_write | stdfs::perms::others_write,
+                               stdfs::perm_options::remove,
+                               ec);
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+            struct stat target_stat;
+            if (::stat(target.c_str(), &target_stat) == 0 &&
+                ::chmod(target.c_str(), target_stat.st_mode & 07777 & ~(S_IWUSR | S_IWGRP | S_IWOTH)) == 0)
+            {
+                ec.clear();
+            }
+            else
+            {
+                ec.assign(errno, std::generic_category());
+            }
+#endif // _WIN32
+        }
+
         virtual void copy_symlink(const Path& source, const Path& destination, std::error_code& ec) const override
         {
 #if defined(_WIN32)
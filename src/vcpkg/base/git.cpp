@@ -5,12 +5,15 @@
 #include <vcpkg/base/parse.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/stringview.h>
+#include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/system.process.h>
+#include <vcpkg/base/util.h>
 
 #include <vcpkg/tools.h>
 
 #include <algorithm>
+#include <limits>
 
 // When making changes to this file, check that the git command lines intended do what is expected on
 // vcpkg's current minimum supported git version (2.7.4). You can get a version of git that old with docker:
@@ -48,6 +51,75 @@ namespace
         return result;
     }
 
+    // The total size of the files in the extracted tree `tree`
+    std::uint64_t git_tree_size(const Filesystem& fs, const Path& tree)
+    {
+        std::uint64_t size = 0;
+        for (auto&& file : fs.get_regular_files_recursive(tree, IgnoreErrors{}))
+        {
+            std::error_code ec;
+            const auto file_size = fs.file_size(file, ec);
+            if (!ec)
+            {
+                size += file_size;
+            }
+        }
+
+        return size;
+    }
+
+    // Makes the files of the extracted tree `tree` read-only. Destinations are hard linked to the cached files where
+    // possible, and this keeps an edit through one of those links from changing the cached tree for everyone.
+    void make_git_tree_read_only(const Filesystem& fs, const Path& tree)
+    {
+        for (auto&& file : fs.get_regular_files_recursive(tree, IgnoreErrors{}))
+        {
+            std::error_code ec;
+            fs.make_read_only(file, ec);
+        }
+    }
+
+    // The ways of materializing a cached file that are still worth trying for the rest of a tree
+    struct MaterializeStrategy
+    {
+        bool clone = true;
+        bool hard_link = true;
+    };
+
+    // Creates `target` with the contents of the read-only `cached_file`: as a reflink if the filesystem supports one,
+    // then as a hard link, and otherwise as a copy. Each keeps the file read-only. A way that fails isn't tried again
+    // for the rest of the tree, since the other files are on the same filesystems.
+    void materialize_cached_file(const Filesystem& fs,
+                                 const Path& cached_file,
+                                 const Path& target,
+                                 MaterializeStrategy& strategy,
+                                 std::error_code& ec)
+    {
+        if (strategy.clone)
+        {
+            fs.clone_file(cached_file, target, ec);
+            if (!ec)
+            {
+                return;
+            }
+
+            strategy.clone = false;
+        }
+
+        if (strategy.hard_link)
+        {
+            fs.create_hard_link(cached_file, target, ec);
+            if (!ec)
+            {
+                return;
+            }
+
+            strategy.hard_link = false;
+        }
+
+        fs.copy_file(cached_file, target, CopyOptions::none, ec);
+    }
+
     Optional<std::string> run_cmd_trim(vcpkg::DiagnosticContext& context,
                                        const Command& command,
                                        const RedirectedProcessLaunchSettings& launch_settings)
@@ -107,6 +179,194 @@ namespace vcpkg
 
     bool operator!=(const GitDiffTreeLine& lhs, const GitDiffTreeLine& rhs) noexcept { return !(lhs == rhs); }
 
+    bool is_git_cat_file_missing_reply(StringView object, StringView header_line) noexcept
+    {
+        return header_line.size() > object.size() && header_line.starts_with(object) &&
+               header_line.substr(object.size()) == " missing";
+    }
+
+    Optional<GitCatFileHeader> parse_git_cat_file_header(DiagnosticContext& context,
+                                                         StringView object,
+                                                         StringView header_line)
+    {
+        // <oid> SP <type> SP <size>, or <object> SP missing
+        if (is_git_cat_file_missing_reply(object, header_line))
+        {
+            context.report_error(msg::format(msgGitObjectMissing, msg::value = object));
+            return nullopt;
+        }
+
+        auto fields = Strings::split(header_line, ' ');
+        if (fields.size() == 3 && is_git_sha(fields[0]))
+        {
+            const auto maybe_size = Strings::strto<unsigned long long>(fields[2]);
+            if (auto size = maybe_size.get())
+            {
+                return GitCatFileHeader{std::move(fields[0]), std::move(fields[1]), static_cast<std::size_t>(*size)};
+            }
+        }
+
+        context.report_error_with_log(
+            header_line, msgGitUnexpectedCommandOutputCmd, msg::command_line = fmt::format("git cat-file {}", object));
+        return nullopt;
+    }
+
+    Optional<std::vector<std::string>> parse_git_tree_entry_names(StringView tree_contents, std::size_t object_id_size)
+    {
+        // each entry is <mode> SP <name> NUL <binary object id>
+        std::vector<std::string> names;
+        auto first = tree_contents.begin();
+        const auto last = tree_contents.end();
+        while (first != last)
+        {
+            const auto space = std::find(first, last, ' ');
+            const auto nul = std::find(space, last, '\0');
+            if (space == last || nul == last || static_cast<std::size_t>(last - nul) <= object_id_size)
+            {
+                return nullopt;
+            }
+
+            names.emplace_back(space + 1, nul);
+            first = nul + 1 + object_id_size;
+        }
+
+        return names;
+    }
+
+    GitObjectReader::GitObjectReader(const Path& git_exe, GitRepoLocatorKind locator_kind, const Path& locator_path)
+        : m_git_exe(git_exe), m_locator_kind(locator_kind), m_locator_path(locator_path)
+    {
+    }
+
+    Optional<std::string> GitObjectReader::read_object(DiagnosticContext& context, StringView object)
+    {
+        GitCatFileHeader header;
+        Optional<std::string> maybe_contents;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            maybe_contents = read_batch(context, object, header);
+        }
+
+        if (maybe_contents && header.type != "blob")
+        {
+            context.report_error(msg::format(msgGitObjectNotBlob, msg::value = object, msg::actual = header.type));
+            return nullopt;
+        }
+
+        return maybe_contents;
+    }
+
+    Optional<std::string> GitObjectReader::object_id(DiagnosticContext& context, StringView object)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto maybe_header_line = request(context, m_batch_check, "--batch-check", object);
+        if (auto header_line = maybe_header_line.get())
+        {
+            return parse_git_cat_file_header(context, object, *header_line).map([](GitCatFileHeader&& header) {
+                return std::move(header.object_id);
+            });
+        }
+
+        return nullopt;
+    }
+
+    Optional<std::vector<std::string>> GitObjectReader::read_tree_entry_names(DiagnosticContext& context,
+                                                                              StringView object)
+    {
+        GitCatFileHeader header;
+        Optional<std::string> maybe_contents;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            maybe_contents = read_batch(context, object, header);
+        }
+
+        auto contents = maybe_contents.get();
+        if (!contents)
+        {
+            return nullopt;
+        }
+
+        if (header.type == "tree")
+        {
+            // object ids are hex in the header but binary in tree entries
+            auto maybe_names = parse_git_tree_entry_names(*contents, header.object_id.size() / 2);
+            if (maybe_names)
+            {
+                return maybe_names;
+            }
+        }
+
+        context.report_error(msg::format(msgGitUnexpectedCommandOutputCmd,
+                                         msg::command_line = fmt::format("git cat-file --batch {}", object)));
+        return nullopt;
+    }
+
+    Optional<std::string> GitObjectReader::read_batch(DiagnosticContext& context,
+                                                      StringView object,
+                                                      GitCatFileHeader& header)
+    {
+        auto maybe_header_line = request(context, m_batch, "--batch", object);
+        auto header_line = maybe_header_line.get();
+        if (!header_line)
+        {
+            return nullopt;
+        }
+
+        auto maybe_header = parse_git_cat_file_header(context, object, *header_line);
+        if (auto parsed_header = maybe_header.get())
+        {
+            header = std::move(*parsed_header);
+            std::string contents;
+            contents.reserve(header.size);
+            std::string terminator;
+            if (m_batch.read_exact(context, header.size, contents) && m_batch.read_exact(context, 1, terminator) &&
+                terminator == "\n")
+            {
+                return contents;
+            }
+
+            context.report_error(msg::format(msgGitUnexpectedCommandOutputCmd,
+                                             msg::command_line = fmt::format("git cat-file --batch {}", object)));
+            (void)m_batch.finish(null_diagnostic_context);
+        }
+
+        return nullopt;
+    }
+
+    Optional<std::string> GitObjectReader::request(DiagnosticContext& context,
+                                                   Coprocess& process,
+                                                   StringLiteral batch_arg,
+                                                   StringView object)
+    {
+        if (object.empty() || Util::contains(object, '\n'))
+        {
+            context.report_error(msg::format(msgGitObjectMissing, msg::value = object));
+            return nullopt;
+        }
+
+        if (!process.is_running())
+        {
+            StringView args[] = {StringLiteral{"cat-file"}, batch_arg};
+            const auto cmd = make_git_command(m_git_exe, GitRepoLocator{m_locator_kind, m_locator_path}, args);
+            if (!process.start(context, cmd, ProcessLaunchSettings{}))
+            {
+                return nullopt;
+            }
+        }
+
+        std::string header_line;
+        if (!process.write(context, Strings::concat(object, '\n')) || !process.read_line(context, header_line))
+        {
+            // git exited; start over on the next request
+            context.report_error(msg::format(msgGitUnexpectedCommandOutputCmd,
+                                             msg::command_line = fmt::format("git cat-file {} {}", batch_arg, object)));
+            (void)process.finish(null_diagnostic_context);
+            return nullopt;
+        }
+
+        return header_line;
+    }
+
     bool is_git_mode(StringView sv) noexcept
     {
         return sv.size() == 6 &&
@@ -308,6 +568,226 @@ namespace vcpkg
         return false;
     }
 
+    bool git_extract_tree_cached(DiagnosticContext& context,
+                                 const Filesystem& fs,
+                                 const Path& git_exe,
+                                 GitRepoLocator locator,
+                                 const Path& cache_root,
+                                 const Path& destination,
+                                 StringView tree,
+                                 std::uint64_t cache_max_size)
+    {
+        if (!is_git_sha(tree))
+        {
+            // only object ids name the same tree in every repository
+            return git_extract_tree(context, fs, git_exe, locator, destination, tree);
+        }
+
+        const auto cached_tree = cache_root / tree;
+        const auto stamp_path = cache_root / fmt::format("{}.stamp", tree);
+        bool published = false;
+        if (!fs.exists(cached_tree, IgnoreErrors{}))
+        {
+            // The tree is stamped before it is renamed into place, so other processes never see it partial or
+            // unstamped, and a concurrent trim never mistakes it for a legacy tree.
+            Path staged_tree = fmt::format("{}_{}.publish", cached_tree, get_process_id());
+            staged_tree.make_generic();
+            fs.remove_all(staged_tree, IgnoreErrors{});
+            if (!git_extract_tree(context, fs, git_exe, locator, staged_tree, tree))
+            {
+                return false;
+            }
+
+            make_git_tree_read_only(fs, staged_tree);
+            fs.write_contents(stamp_path, fmt::format("{}", git_tree_size(fs, staged_tree)), IgnoreErrors{});
+            std::error_code ec;
+            // false without an error means another process published the tree first, which is just as good
+            (void)fs.rename_or_delete(staged_tree, cached_tree, ec);
+            if (ec)
+            {
+                fs.remove_all(staged_tree, IgnoreErrors{});
+                return git_extract_tree(context, fs, git_exe, locator, destination, tree);
+            }
+
+            published = true;
+        }
+        else if (!fs.exists(stamp_path, IgnoreErrors{}))
+        {
+            // extracted by an older vcpkg; stamp it before use so that it is no longer evicted first
+            make_git_tree_read_only(fs, cached_tree);
+            fs.write_contents(stamp_path, fmt::format("{}", git_tree_size(fs, cached_tree)), IgnoreErrors{});
+        }
+
+        std::error_code ec;
+        const auto cached_files = fs.get_files_recursive(cached_tree, ec);
+        bool copied = !ec;
+        Path temp = fmt::format("{}_{}.tmp", destination, get_process_id());
+        temp.make_generic();
+        if (copied)
+        {
+            fs.remove_all(temp, IgnoreErrors{});
+            fs.create_directories(temp, ec);
+            copied = !ec;
+        }
+
+        MaterializeStrategy strategy;
+        std::uint64_t tree_size = 0;
+        const auto prefix_size = cached_tree.native().size() + 1;
+        for (auto&& cached_file : cached_files)
+        {
+            if (!copied)
+            {
+                break;
+            }
+
+            const auto target = temp / StringView{cached_file.native()}.substr(prefix_size);
+            const auto file_type = fs.symlink_status(cached_file, ec);
+            if (!ec)
+            {
+                if (file_type == FileType::directory)
+                {
+                    fs.create_directories(target, ec);
+                }
+                else if (file_type == FileType::symlink)
+                {
+                    fs.create_directories(target.parent_path(), ec);
+                    fs.copy_symlink(cached_file, target, ec);
+                }
+                else
+                {
+                    tree_size += fs.file_size(cached_file, ec);
+                    if (!ec)
+                    {
+                        fs.create_directories(target.parent_path(), ec);
+                    }
+
+                    if (!ec)
+                    {
+                        materialize_cached_file(fs, cached_file, target, strategy, ec);
+                    }
+                }
+            }
+
+            copied = !ec;
+        }
+
+        if (copied)
+        {
+            // Trees are evicted by renaming them away, so a copy either finds every file or fails. Evictions that
+            // remove in place, such as by an older vcpkg, are caught by the tree or its stamp having gone.
+            copied = fs.exists(cached_tree, IgnoreErrors{}) && fs.exists(stamp_path, IgnoreErrors{});
+        }
+
+        if (copied)
+        {
+            // false without an error means another process published `destination` first, which is just as good
+            (void)fs.rename_or_delete(temp, destination, ec);
+            copied = !ec;
+        }
+
+        if (copied)
+        {
+            // the stamp's write time records when the tree was last used, and its contents the tree's size
+            fs.write_contents(stamp_path, fmt::format("{}", tree_size), IgnoreErrors{});
+            if (published)
+            {
+                trim_git_tree_cache(fs, cache_root, cache_max_size);
+            }
+
+            return true;
+        }
+
+        // the cached tree may have been evicted by another process while we were materializing it
+        Debug::print(
+            fmt::format("Could not materialize {} from {}, extracting it directly\n", destination, cached_tree));
+        fs.remove_all(temp, IgnoreErrors{});
+        return git_extract_tree(context, fs, git_exe, locator, destination, tree);
+    }
+
+    void trim_git_tree_cache(const Filesystem& fs, const Path& cache_root, std::uint64_t max_size)
+    {
+        struct CachedTree
+        {
+            Path stamp_path;
+            Path tree_path;
+            int64_t last_used;
+            std::uint64_t size;
+        };
+
+        std::vector<CachedTree> cached_trees;
+        std::uint64_t total_size = 0;
+        for (auto&& file : fs.get_files_non_recursive(cache_root, IgnoreErrors{}))
+        {
+            if (file.extension() != ".stamp")
+            {
+                continue;
+            }
+
+            std::error_code ec;
+            const auto last_used = fs.last_write_time(file, ec);
+            const auto maybe_size = Strings::strto<unsigned long long>(fs.read_contents(file, IgnoreErrors{}));
+            if (ec || !maybe_size.has_value())
+            {
+                continue;
+            }
+
+            const auto size = static_cast<std::uint64_t>(*maybe_size.get());
+            total_size += size;
+            cached_trees.push_back(CachedTree{file, cache_root / file.stem(), last_used, size});
+        }
+
+        // Trees without a stamp were extracted here by older versions of vcpkg, which used this directory directly
+        // for remote registry trees; they are reused (and stamped) if needed again, and otherwise evicted first.
+        for (auto&& directory : fs.get_directories_non_recursive(cache_root, IgnoreErrors{}))
+        {
+            const auto tree = directory.filename();
+            if (!is_git_sha(tree) || fs.exists(cache_root / fmt::format("{}.stamp", tree), IgnoreErrors{}))
+            {
+                continue;
+            }
+
+            const auto size = git_tree_size(fs, directory);
+            total_size += size;
+            cached_trees.push_back(CachedTree{Path{}, directory, std::numeric_limits<int64_t>::min(), size});
+        }
+
+        if (total_size <= max_size)
+        {
+            return;
+        }
+
+        std::sort(cached_trees.begin(), cached_trees.end(), [](const CachedTree& lhs, const CachedTree& rhs) {
+            return lhs.last_used < rhs.last_used;
+        });
+
+        for (auto&& cached_tree : cached_trees)
+        {
+            if (total_size <= max_size)
+            {
+                break;
+            }
+
+            // remove the stamp first so a concurrent trim doesn't count this tree again
+            if (!cached_tree.stamp_path.empty())
+            {
+                fs.remove(cached_tree.stamp_path, IgnoreErrors{});
+            }
+
+            // rename the tree away before deleting it, so that a process copying it out of the cache sees either
+            // every file or none, never a partially deleted tree
+            Path evicted_tree = fmt::format("{}_{}.evict", cached_tree.tree_path, get_process_id());
+            evicted_tree.make_generic();
+            std::error_code ec;
+            fs.rename(cached_tree.tree_path, evicted_tree, ec);
+            if (!ec)
+            {
+                fs.remove_all(evicted_tree, IgnoreErrors{});
+            }
+
+            total_size -= cached_tree.size;
+        }
+    }
+
     Optional<bool> git_check_is_commit(DiagnosticContext& context,
                                        const Path& git_exe,
                                        GitRepoLocator locator,
@@ -0,0 +1,130 @@
+#include <vcpkg/base/graphs.h>
+#include <vcpkg/base/span.h>
+
+namespace vcpkg
+{
+    AdjacencyArrays::AdjacencyArrays() : offsets{0} { }
+
+    AdjacencyArrays AdjacencyArrays::from_edges(std::size_t vertex_count,
+                                                View<std::pair<std::size_t, std::size_t>> edges)
+    {
+        // a counting sort of the edges by their source, which keeps the edges from each vertex in order
+        AdjacencyArrays result;
+        result.offsets.assign(vertex_count + 1, 0);
+        for (auto&& edge : edges)
+        {
+            ++result.offsets[edge.first + 1];
+        }
+
+        for (std::size_t vertex = 0; vertex < vertex_count; ++vertex)
+        {
+            result.offsets[vertex + 1] += result.offsets[vertex];
+        }
+
+        result.targets.resize(edges.size());
+        std::vector<std::size_t> next(result.offsets.begin(), result.offsets.end() - 1);
+        for (auto&& edge : edges)
+        {
+            result.targets[next[edge.first]++] = edge.second;
+        }
+
+        return result;
+    }
+
+    void AdjacencyArrays::add_vertex(View<std::size_t> adjacent)
+    {
+        targets.insert(targets.end(), adjacent.begin(), adjacent.end());
+        offsets.push_back(targets.size());
+    }
+
+    TopologicalOrder topological_sort(const AdjacencyArrays& graph,
+                                      View<std::size_t> starting_vertices,
+                                      GraphRandomizer* randomizer)
+    {
+        struct Frame
+        {
+            std::size_t vertex;
+            // the range of the vertices adjacent to `vertex` yet to be visited, in `targets`
+            std::size_t next;
+            std::size_t end;
+        };
+
+        TopologicalOrder result;
+        std::vector<ExplorationStatus> exploration_status(graph.size(), ExplorationStatus::NOT_EXPLORED);
+        std::vector<Frame> stack;
+        // when randomizing, a shuffled copy of the vertices adjacent to each vertex on the stack
+        std::vector<std::size_t> shuffled;
+        const std::vector<std::size_t>& targets = randomizer ? shuffled : graph.targets;
+
+        const auto explore = [&](std::size_t vertex) {
+            exploration_status[vertex] = ExplorationStatus::PARTIALLY_EXPLORED;
+            const auto first = graph.offsets[vertex];
+            const auto last = graph.offsets[vertex + 1];
+            if (randomizer)
+            {
+                const auto shuffled_first = shuffled.size();
+                shuffled.insert(shuffled.end(), graph.targets.begin() + first, graph.targets.begin() + last);
+                Span<std::size_t> neighbours{shuffled.data() + shuffled_first, last - first};
+                details::shuffle(neighbours, randomizer);
+                stack.push_back(Frame{vertex, shuffled_first, shuffled.size()});
+            }
+            else
+            {
+                stack.push_back(Frame{vertex, first, last});
+            }
+        };
+
+        std::vector<std::size_t> starts(starting_vertices.begin(), starting_vertices.end());
+        details::shuffle(starts, randomizer);
+        for (auto start : starts)
+        {
+            if (exploration_status[start] != ExplorationStatus::NOT_EXPLORED)
+            {
+                continue;
+            }
+
+            explore(start);
+            while (!stack.empty())
+            {
+                auto& top = stack.back();
+                if (top.next == top.end)
+                {
+                    if (randomizer)
+                    {
+                        shuffled.resize(shuffled.size() - (graph.offsets[top.vertex + 1] - graph.offsets[top.vertex]));
+                    }
+
+                    exploration_status[top.vertex] = ExplorationStatus::FULLY_EXPLORED;
+                    result.sorted.push_back(top.vertex);
+                    stack.pop_back();
+                    continue;
+                }
+
+                const auto neighbour = targets[top.next++];
+                switch (exploration_status[neighbour])
+                {
+                    case ExplorationStatus::FULLY_EXPLORED: break;
+                    case ExplorationStatus::PARTIALLY_EXPLORED:
+                    {
+                        auto cycle_start = stack.begin();
+                        while (cycle_start->vertex != neighbour)
+                        {
+                            ++cycle_start;
+                        }
+
+                        for (auto it = cycle_start; it != stack.end(); ++it)
+                        {
+                            result.cycle.push_back(it->vertex);
+                        }
+
+                        return result;
+                    }
+                    case ExplorationStatus::NOT_EXPLORED: explore(neighbour); break;
+                    default: Checks::unreachable(VCPKG_LINE_INFO);
+                }
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,53 @@
+#include <vcpkg/base/interned-string.h>
+
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace vcpkg
+{
+    const InternedStringInstance InternedString::EMPTY_INSTANCE{std::string(), std::hash<std::string>()({})};
+
+    namespace
+    {
+        struct InternTable
+        {
+            std::mutex mutex;
+            // a deque so that the keys of `instances_by_value`, which view the instances' values, stay valid
+            std::deque<InternedStringInstance> instances;
+            std::unordered_map<std::string_view, const InternedStringInstance*> instances_by_value;
+        };
+
+        InternTable& intern_table()
+        {
+            static InternTable table;
+            return table;
+        }
+    }
+
+    InternedString::InternedString(StringView value)
+    {
+        const std::string_view key{value.data(), value.size()};
+        if (key.empty())
+        {
+            m_instance = &EMPTY_INSTANCE;
+            return;
+        }
+
+        auto& table = intern_table();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto it = table.instances_by_value.find(key);
+        if (it != table.instances_by_value.end())
+        {
+            m_instance = it->second;
+            return;
+        }
+
+        // std::hash<std::string_view> agrees with std::hash<std::string>
+        auto& instance =
+            table.instances.emplace_back(InternedStringInstance{std::string(key), std::hash<std::string_view>()(key)});
+        table.instances_by_value.emplace(instance.value, &instance);
+        m_instance = &instance;
+    }
+}
@@ -11,6 +11,7 @@
 #include <vcpkg/documentation.h>
 
 #include <math.h>
+#include <string.h>
 
 #include <atomic>
 #include <type_traits>
@@ -70,6 +71,14 @@ namespace vcpkg::Json
 
             ~ValueImpl() { destroy_underlying(); }
 
+            // For strings the parser has already checked are valid UTF-8
+            static Value make_valid_string(std::string&& s)
+            {
+                Value val;
+                val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::String>(), std::move(s));
+                return val;
+            }
+
         private:
             template<class T>
             ValueImpl& internal_assign(ValueKind vk, T ValueImpl::*mp, ValueImpl& other) noexcept
@@ -544,8 +553,104 @@ namespace vcpkg::Json
     // auto parse() {
     namespace
     {
+        // Returns the number of bytes at the start of [first, last) that a string can copy without decoding: ASCII
+        // other than control characters, '"' and '\\'. Whole 8 byte blocks are checked at once; the block containing
+        // the first other byte is finished one byte at a time.
+        size_t plain_string_prefix(const char* first, const char* last) noexcept
+        {
+            const char* it = first;
+            constexpr uint64_t ones = 0x0101010101010101u;
+            constexpr uint64_t highs = 0x8080808080808080u;
+            while (last - it >= 8)
+            {
+                uint64_t word;
+                ::memcpy(&word, it, sizeof(word));
+                // each term is nonzero if and only if some byte is < 0x20, has its high bit set, or is '"' or '\\'
+                const uint64_t quotes = word ^ (ones * '"');
+                const uint64_t backslashes = word ^ (ones * '\\');
+                const uint64_t special = ((word - ones * 0x20) & ~word) | (word & highs) |
+                                         ((quotes - ones) & ~quotes) | ((backslashes - ones) & ~backslashes);
+                if ((special & highs) != 0)
+                {
+                    break;
+                }
+
+                it += 8;
+            }
+
+            while (it != last)
+            {
+                const auto ch = static_cast<unsigned char>(*it);
+                if (ch < 0x20 || ch >= 0x80 || ch == '"' || ch == '\\')
+                {
+                    break;
+                }
+
+                ++it;
+            }
+
+            return static_cast<size_t>(it - first);
+        }
+
+        // Builds the Value DOM for Parser
+        struct ValueBuilder
+        {
+            using value_type = Value;
+            using array_type = Array;
+            using object_type = Object;
+            using key_type = std::string;
+
+            Value null() noexcept { return Value(); }
+            Value boolean(bool b) noexcept { return Value::boolean(b); }
+            Value integer(int64_t i) noexcept { return Value::integer(i); }
+            Value number(double d) noexcept { return Value::number(d); }
+            Value string(StringView s, bool known_valid) noexcept
+            {
+                if (known_valid)
+                {
+                    return ValueImpl::make_valid_string(s.to_string());
+                }
+
+                return Value::string(s);
+            }
+
+            Array start_array() noexcept { return Array(); }
+            void push_element(Array& arr, Value&& value) noexcept { arr.push_back(std::move(value)); }
+            Value finish_array(Array&& arr) noexcept { return Value::array(std::move(arr)); }
+
+            std::string key(StringView key) noexcept { return key.to_string(); }
+            Object start_object() noexcept { return Object(); }
+            bool contains(const Object& obj, StringView key) const noexcept { return obj.contains(key); }
+            void insert_member(Object& obj, std::string&& key, Value&& value) noexcept
+            {
+                obj.insert(key, std::move(value));
+            }
+            Value finish_object(Object&& obj) noexcept { return Value::object(std::move(obj)); }
+        };
+
+        // Produces only the scalars read by StreamReader, which walks arrays and objects itself
+        struct TokenBuilder
+        {
+            struct Token
+            {
+                ValueKind kind;
+                int64_t integer;
+            };
+
+            using value_type = Token;
+            using key_type = StringView;
+
+            Token null() noexcept { return {VK::Null, 0}; }
+            Token boolean(bool) noexcept { return {VK::Boolean, 0}; }
+            Token integer(int64_t i) noexcept { return {VK::Integer, i}; }
+            Token number(double) noexcept { return {VK::Number, 0}; }
+        };
+
+        template<class Builder>
         struct Parser : private ParserBase
         {
+            using value_type = typename Builder::value_type;
+
             Parser(StringView text, StringView origin, TextRowCol init_rowcol)
                 : ParserBase(text, origin, init_rowcol), style_()
             {
@@ -559,6 +664,29 @@ namespace vcpkg::Json
                 return ParserBase::next();
             }
 
+            // Skips runs of spaces, such as indentation, without decoding them one at a time
+            void skip_whitespace() noexcept
+            {
+                for (;;)
+                {
+                    const char* first = it().pointer_to_current();
+                    const char* const last = text().end();
+                    const char* space_last = first;
+                    while (space_last != last && *space_last == ' ')
+                    {
+                        ++space_last;
+                    }
+
+                    advance_ascii(static_cast<size_t>(space_last - first));
+                    if (!is_whitespace(cur()))
+                    {
+                        return;
+                    }
+
+                    ParserBase::next();
+                }
+            }
+
             static bool is_number_start(char32_t code_point) noexcept
             {
                 return code_point == '-' || is_ascii_digit(code_point);
@@ -656,15 +784,30 @@ namespace vcpkg::Json
                 }
             }
 
-            std::string parse_string() noexcept
+            // The result is only valid until the next call
+            StringView parse_string() noexcept
             {
                 Checks::check_exit(VCPKG_LINE_INFO, cur() == '"');
                 next();
 
-                std::string res;
+                std::string& res = string_buffer_;
+                res.clear();
+                string_is_valid_ = true;
                 char32_t previous_leading_surrogate = Unicode::end_of_file;
                 while (!at_eof())
                 {
+                    if (previous_leading_surrogate == Unicode::end_of_file)
+                    {
+                        const char* plain_first = it().pointer_to_current();
+                        const size_t plain_size = plain_string_prefix(plain_first, text().end());
+                        if (plain_size != 0)
+                        {
+                            res.append(plain_first, plain_size);
+                            advance_ascii(plain_size);
+                            continue;
+                        }
+                    }
+
                     auto code_point = parse_string_code_point();
 
                     if (previous_leading_surrogate != Unicode::end_of_file)
@@ -680,6 +823,7 @@ namespace vcpkg::Json
                         else
                         {
                             Unicode::utf8_append_code_point(res, previous_leading_surrogate);
+                            string_is_valid_ = false;
                         }
                     }
                     previous_leading_surrogate = Unicode::end_of_file;
@@ -694,6 +838,7 @@ namespace vcpkg::Json
                     }
                     else
                     {
+                        string_is_valid_ &= !Unicode::utf16_is_surrogate_code_point(code_point);
                         Unicode::utf8_append_code_point(res, code_point);
                     }
                 }
@@ -702,7 +847,7 @@ namespace vcpkg::Json
                 return res;
             }
 
-            Value parse_number() noexcept
+            value_type parse_number() noexcept
             {
                 Checks::check_exit(VCPKG_LINE_INFO, is_number_start(cur()));
 
@@ -719,7 +864,7 @@ namespace vcpkg::Json
                     if (current == Unicode::end_of_file)
                     {
                         add_error(msg::format(msgUnexpectedEOFAfterMinus));
-                        return Value();
+                        return builder_.null();
                     }
                 }
 
@@ -735,17 +880,17 @@ namespace vcpkg::Json
                     else if (is_ascii_digit(current))
                     {
                         add_error(msg::format(msgUnexpectedDigitsAfterLeadingZero));
-                        return Value();
+                        return builder_.null();
                     }
                     else
                     {
                         if (negative)
                         {
-                            return Value::number(-0.0);
+                            return builder_.number(-0.0);
                         }
                         else
                         {
-                            return Value::integer(0);
+                            return builder_.integer(0);
                         }
                     }
                 }
@@ -763,7 +908,7 @@ namespace vcpkg::Json
                     if (!is_ascii_digit(current))
                     {
                         add_error(msg::format(msgExpectedDigitsAfterDecimal));
-                        return Value();
+                        return builder_.null();
                     }
                     while (is_ascii_digit(current))
                     {
@@ -779,7 +924,7 @@ namespace vcpkg::Json
                     {
                         if (std::abs(*res) < INFINITY)
                         {
-                            return Value::number(*res);
+                            return builder_.number(*res);
                         }
                         else
                         {
@@ -796,7 +941,7 @@ namespace vcpkg::Json
                     auto opt = Strings::strto<int64_t>(number_to_parse);
                     if (auto res = opt.get())
                     {
-                        return Value::integer(*res);
+                        return builder_.integer(*res);
                     }
                     else
                     {
@@ -804,27 +949,27 @@ namespace vcpkg::Json
                     }
                 }
 
-                return Value();
+                return builder_.null();
             }
 
-            Value parse_keyword() noexcept
+            value_type parse_keyword() noexcept
             {
                 char32_t current = cur();
                 const char32_t* rest;
-                Value val;
+                value_type val;
                 switch (current)
                 {
                     case 't': // parse true
                         rest = U"rue";
-                        val = Value::boolean(true);
+                        val = builder_.boolean(true);
                         break;
                     case 'f': // parse false
                         rest = U"alse";
-                        val = Value::boolean(false);
+                        val = builder_.boolean(false);
                         break;
                     case 'n': // parse null
                         rest = U"ull";
-                        val = Value::null(nullptr);
+                        val = builder_.null();
                         break;
                     default: vcpkg::Checks::unreachable(VCPKG_LINE_INFO);
                 }
@@ -836,7 +981,7 @@ namespace vcpkg::Json
                     if (current == Unicode::end_of_file)
                     {
                         add_error(msg::format(msgUnexpectedEOFMidKeyword));
-                        return Value();
+                        return builder_.null();
                     }
                     if (current != *rest_it)
                     {
@@ -848,12 +993,12 @@ namespace vcpkg::Json
                 return val;
             }
 
-            Value parse_array() noexcept
+            value_type parse_array() noexcept
             {
                 Checks::check_exit(VCPKG_LINE_INFO, cur() == '[');
                 next();
 
-                Array arr;
+                auto arr = builder_.start_array();
                 bool first = true;
                 for (;;)
                 {
@@ -863,12 +1008,12 @@ namespace vcpkg::Json
                     if (current == Unicode::end_of_file)
                     {
                         add_error(msg::format(msgUnexpectedEOFMidArray));
-                        return Value();
+                        return builder_.null();
                     }
                     if (current == ']')
                     {
                         next();
-                        return Value::array(std::move(arr));
+                        return builder_.finish_array(std::move(arr));
                     }
 
                     if (first)
@@ -884,12 +1029,12 @@ namespace vcpkg::Json
                         if (current == Unicode::end_of_file)
                         {
                             add_error(msg::format(msgUnexpectedEOFMidArray));
-                            return Value();
+                            return builder_.null();
                         }
                         if (current == ']')
                         {
                             add_error(msg::format(msgTrailingCommaInArray), comma_loc);
-                            return Value::array(std::move(arr));
+                            return builder_.finish_array(std::move(arr));
                         }
                     }
                     else if (current == '/')
@@ -900,20 +1045,20 @@ namespace vcpkg::Json
                     else
                     {
                         add_error(msg::format(msgUnexpectedCharMidArray));
-                        return Value();
+                        return builder_.null();
                     }
 
-                    arr.push_back(parse_value());
+                    builder_.push_element(arr, parse_value());
                 }
             }
 
-            std::pair<std::string, Value> parse_kv_pair() noexcept
+            std::pair<typename Builder::key_type, value_type> parse_kv_pair() noexcept
             {
                 skip_whitespace();
 
                 auto current = cur();
 
-                std::pair<std::string, Value> res = {std::string(""), Value()};
+                std::pair<typename Builder::key_type, value_type> res = {builder_.key(StringView{}), builder_.null()};
 
                 if (current == Unicode::end_of_file)
                 {
@@ -925,7 +1070,7 @@ namespace vcpkg::Json
                     add_error(msg::format(msgUnexpectedCharExpectedName));
                     return res;
                 }
-                res.first = parse_string();
+                res.first = builder_.key(parse_string());
 
                 skip_whitespace();
                 current = cur();
@@ -955,14 +1100,14 @@ namespace vcpkg::Json
                 return res;
             }
 
-            Value parse_object() noexcept
+            value_type parse_object() noexcept
             {
                 char32_t current = cur();
 
                 Checks::check_exit(VCPKG_LINE_INFO, current == '{');
                 next();
 
-                Object obj;
+                auto obj = builder_.start_object();
                 bool first = true;
                 for (;;)
                 {
@@ -971,12 +1116,12 @@ namespace vcpkg::Json
                     if (current == Unicode::end_of_file)
                     {
                         add_error(msg::format(msgUnexpectedEOFExpectedCloseBrace));
-                        return Value();
+                        return builder_.null();
                     }
                     else if (current == '}')
                     {
                         next();
-                        return Value::object(std::move(obj));
+                        return builder_.finish_object(std::move(obj));
                     }
 
                     if (first)
@@ -992,12 +1137,12 @@ namespace vcpkg::Json
                         if (current == Unicode::end_of_file)
                         {
                             add_error(msg::format(msgUnexpectedEOFExpectedProp));
-                            return Value();
+                            return builder_.null();
                         }
                         else if (current == '}')
                         {
                             add_error(msg::format(msgTrailingCommaInObj), comma_loc);
-                            return Value();
+                            return builder_.null();
                         }
                     }
                     else if (current == '/')
@@ -1013,30 +1158,34 @@ namespace vcpkg::Json
 
                     auto keyPairLoc = cur_loc();
                     auto val = parse_kv_pair();
-                    if (obj.contains(val.first))
+                    if (builder_.contains(obj, val.first))
                     {
                         add_error(msg::format(msgDuplicatedKeyInObj, msg::value = val.first), keyPairLoc);
-                        return Value();
+                        return builder_.null();
                     }
-                    obj.insert(val.first, std::move(val.second));
+                    builder_.insert_member(obj, std::move(val.first), std::move(val.second));
                 }
             }
 
-            Value parse_value() noexcept
+            value_type parse_value() noexcept
             {
                 skip_whitespace();
                 char32_t current = cur();
                 if (current == Unicode::end_of_file)
                 {
                     add_error(msg::format(msgUnexpectedEOFExpectedValue));
-                    return Value();
+                    return builder_.null();
                 }
 
                 switch (current)
                 {
                     case '{': return parse_object();
                     case '[': return parse_array();
-                    case '"': return Value::string(parse_string());
+                    case '"':
+                    {
+                        auto str = parse_string();
+                        return builder_.string(str, string_is_valid_);
+                    }
                     case 'n':
                     case 't':
                     case 'f': return parse_keyword();
@@ -1045,7 +1194,7 @@ namespace vcpkg::Json
                         add_error(std::move(msg::format(msgUnexpectedCharExpectedValue)
                                                 .append_raw('\n')
                                                 .append(msgInvalidCommentStyle)));
-                        return Value();
+                        return builder_.null();
                     }
                     default:
                         if (is_number_start(current))
@@ -1055,39 +1204,44 @@ namespace vcpkg::Json
                         else
                         {
                             add_error(msg::format(msgUnexpectedCharExpectedValue));
-                            return Value();
+                            return builder_.null();
                         }
                 }
             }
 
-            static ExpectedL<ParsedJson> parse(StringView json, StringView origin)
+            // Parses all of the text as one value. Returns nullopt after adding an error if that fails.
+            Optional<value_type> parse_whole_text() noexcept
             {
-                StatsTimer t(g_json_parsing_stats);
-
-                json.remove_bom();
-
-                auto parser = Parser(json, origin, {1, 1});
+                auto val = parse_value();
 
-                auto val = parser.parse_value();
-
-                parser.skip_whitespace();
-                if (!parser.at_eof())
+                skip_whitespace();
+                if (!at_eof())
                 {
-                    parser.add_error(msg::format(msgUnexpectedEOFExpectedChar));
+                    add_error(msg::format(msgUnexpectedEOFExpectedChar));
                 }
 
-                if (parser.messages().any_errors())
+                if (messages().any_errors())
                 {
-                    return parser.messages().join();
+                    return nullopt;
                 }
 
-                return ParsedJson{std::move(val), parser.style()};
+                return val;
             }
 
+            using ParserBase::at_eof;
+            using ParserBase::cur;
+            using ParserBase::messages;
+
             JsonStyle style() const noexcept { return style_; }
+            bool last_string_is_valid() const noexcept { return string_is_valid_; }
+
+            Builder builder_;
 
         private:
             JsonStyle style_;
+            std::string string_buffer_;
+            // whether the last string parsed is known to be valid UTF-8, which is only false for unpaired surrogates
+            bool string_is_valid_ = true;
         };
     }
 
@@ -1180,7 +1334,190 @@ namespace vcpkg::Json
         return parse(disk_contents, json_file).value_or_exit(VCPKG_LINE_INFO);
     }
 
-    ExpectedL<ParsedJson> parse(StringView json, StringView origin) { return Parser::parse(json, origin); }
+    ExpectedL<ParsedJson> parse(StringView json, StringView origin) { return parse(json, origin, {1, 1}); }
+
+    ExpectedL<ParsedJson> parse(StringView json, StringView origin, TextRowCol init_rowcol)
+    {
+        StatsTimer t(g_json_parsing_stats);
+        json.remove_bom();
+        Parser<ValueBuilder> parser(json, origin, init_rowcol);
+        auto maybe_val = parser.parse_whole_text();
+        if (auto val = maybe_val.get())
+        {
+            return ParsedJson{std::move(*val), parser.style()};
+        }
+
+        return parser.messages().join();
+    }
+
+    struct StreamReader::Impl : Parser<TokenBuilder>
+    {
+        using Parser::Parser;
+
+        bool good() const noexcept { return !failed && !messages().any_errors(); }
+
+        bool fail() noexcept
+        {
+            failed = true;
+            return false;
+        }
+
+        bool read_char(char32_t expected) noexcept
+        {
+            skip_whitespace();
+            if (cur() != expected)
+            {
+                return fail();
+            }
+
+            next();
+            return good();
+        }
+
+        // Reads the ',' before every element or member but the first; or the closing `close_char`, returning false
+        bool next_item(char32_t close_char) noexcept
+        {
+            skip_whitespace();
+            if (cur() == close_char)
+            {
+                next();
+                first_item = false;
+                return false;
+            }
+
+            if (first_item)
+            {
+                first_item = false;
+                return good();
+            }
+
+            if (cur() != ',')
+            {
+                return fail();
+            }
+
+            next();
+            skip_whitespace();
+            // rejects trailing commas
+            if (cur() == close_char)
+            {
+                return fail();
+            }
+
+            return good();
+        }
+
+        bool failed = false;
+        // whether the array or object being read has not had an element or member yet; once one has, so has every
+        // enclosing array or object
+        bool first_item = false;
+    };
+
+    StreamReader::StreamReader(StringView text, StringView origin)
+    {
+        text.remove_bom();
+        m_impl = std::make_unique<Impl>(text, origin, TextRowCol{1, 1});
+    }
+
+    StreamReader::~StreamReader() = default;
+
+    bool StreamReader::start_object()
+    {
+        if (!m_impl->good() || !m_impl->read_char('{'))
+        {
+            return false;
+        }
+
+        m_impl->first_item = true;
+        return true;
+    }
+
+    bool StreamReader::next_member(StringView& key)
+    {
+        if (!m_impl->good() || !m_impl->next_item('}'))
+        {
+            return false;
+        }
+
+        if (m_impl->cur() != '"')
+        {
+            return m_impl->fail();
+        }
+
+        key = m_impl->parse_string();
+        return m_impl->good() && m_impl->read_char(':');
+    }
+
+    bool StreamReader::start_array()
+    {
+        if (!m_impl->good() || !m_impl->read_char('['))
+        {
+            return false;
+        }
+
+        m_impl->first_item = true;
+        return true;
+    }
+
+    bool StreamReader::next_element() { return m_impl->good() && m_impl->next_item(']'); }
+
+    bool StreamReader::read_string(StringView& value)
+    {
+        if (!m_impl->good())
+        {
+            return false;
+        }
+
+        m_impl->skip_whitespace();
+        if (m_impl->cur() != '"')
+        {
+            return m_impl->fail();
+        }
+
+        value = m_impl->parse_string();
+        if (!m_impl->last_string_is_valid())
+        {
+            return m_impl->fail();
+        }
+
+        return m_impl->good();
+    }
+
+    bool StreamReader::read_integer(int64_t& value)
+    {
+        if (!m_impl->good())
+        {
+            return false;
+        }
+
+        m_impl->skip_whitespace();
+        if (!Impl::is_number_start(m_impl->cur()))
+        {
+            return m_impl->fail();
+        }
+
+        const auto token = m_impl->parse_number();
+        if (token.kind != VK::Integer)
+        {
+            return m_impl->fail();
+        }
+
+        value = token.integer;
+        return m_impl->good();
+    }
+
+    bool StreamReader::finish()
+    {
+        if (!m_impl->good())
+        {
+            return false;
+        }
+
+        m_impl->skip_whitespace();
+        return m_impl->at_eof() && m_impl->good();
+    }
+
+    bool StreamReader::failed() const noexcept { return !m_impl->good(); }
 
     ExpectedL<Json::Object> parse_object(StringView text, StringView origin)
     {
@@ -1194,6 +1531,321 @@ namespace vcpkg::Json
             return msg::format(msgJsonErrorMustBeAnObject, msg::path = origin);
         });
     }
+
+    namespace
+    {
+        bool is_json_whitespace(char ch) noexcept { return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n'; }
+
+        void skip_json_whitespace(const char*& first, const char* last) noexcept
+        {
+            while (first != last && is_json_whitespace(*first))
+            {
+                ++first;
+            }
+        }
+
+        bool is_json_digit(char ch) noexcept { return ch >= '0' && ch <= '9'; }
+
+        bool is_json_hex_digit(char ch) noexcept
+        {
+            return is_json_digit(ch) || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+        }
+
+        // `first` points at an opening quote; advances past the closing quote
+        bool skip_json_string(const char*& first, const char* last) noexcept
+        {
+            ++first;
+            while (first != last)
+            {
+                const auto ch = *first++;
+                if (ch == '"')
+                {
+                    return true;
+                }
+
+                if (static_cast<unsigned char>(ch) < 0x20)
+                {
+                    return false;
+                }
+
+                if (ch != '\\')
+                {
+                    continue;
+                }
+
+                if (first == last)
+                {
+                    return false;
+                }
+
+                switch (*first++)
+                {
+                    case '"':
+                    case '\\':
+                    case '/':
+                    case 'b':
+                    case 'f':
+                    case 'n':
+                    case 'r':
+                    case 't': break;
+                    case 'u':
+                        for (int idx = 0; idx < 4; ++idx)
+                        {
+                            if (first == last || !is_json_hex_digit(*first))
+                            {
+                                return false;
+                            }
+
+                            ++first;
+                        }
+
+                        break;
+                    default: return false;
+                }
+            }
+
+            return false;
+        }
+
+        bool skip_json_digits(const char*& first, const char* last) noexcept
+        {
+            const auto start = first;
+            while (first != last && is_json_digit(*first))
+            {
+                ++first;
+            }
+
+            return first != start;
+        }
+
+        bool skip_json_number(const char*& first, const char* last) noexcept
+        {
+            if (first != last && *first == '-')
+            {
+                ++first;
+            }
+
+            if (first != last && *first == '0')
+            {
+                ++first;
+            }
+            else if (!skip_json_digits(first, last))
+            {
+                return false;
+            }
+
+            if (first != last && *first == '.')
+            {
+                ++first;
+                if (!skip_json_digits(first, last))
+                {
+                    return false;
+                }
+            }
+
+            if (first != last && (*first == 'e' || *first == 'E'))
+            {
+                ++first;
+                if (first != last && (*first == '+' || *first == '-'))
+                {
+                    ++first;
+                }
+
+                if (!skip_json_digits(first, last))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool skip_json_keyword(const char*& first, const char* last, StringLiteral keyword) noexcept
+        {
+            if (static_cast<std::size_t>(last - first) < keyword.size() ||
+                !std::equal(keyword.begin(), keyword.end(), first))
+            {
+                return false;
+            }
+
+            first += keyword.size();
+            return true;
+        }
+
+        // Deeper documents are left to parse()
+        constexpr int max_scan_depth = 256;
+
+        // Checks the syntax of the value at `first` and advances past it, without building it
+        bool skip_json_value(const char*& first, const char* last, int depth) noexcept
+        {
+            if (first == last || depth > max_scan_depth)
+            {
+                return false;
+            }
+
+            switch (*first)
+            {
+                case '"': return skip_json_string(first, last);
+                case 't': return skip_json_keyword(first, last, "true");
+                case 'f': return skip_json_keyword(first, last, "false");
+                case 'n': return skip_json_keyword(first, last, "null");
+                case '{':
+                case '[':
+                {
+                    const bool is_object = *first == '{';
+                    const char closer = is_object ? '}' : ']';
+                    ++first;
+                    skip_json_whitespace(first, last);
+                    if (first != last && *first == closer)
+                    {
+                        ++first;
+                        return true;
+                    }
+
+                    for (;;)
+                    {
+                        if (is_object)
+                        {
+                            if (first == last || *first != '"' || !skip_json_string(first, last))
+                            {
+                                return false;
+                            }
+
+                            skip_json_whitespace(first, last);
+                            if (first == last || *first != ':')
+                            {
+                                return false;
+                            }
+
+                            ++first;
+                            skip_json_whitespace(first, last);
+                        }
+
+                        if (!skip_json_value(first, last, depth + 1))
+                        {
+                            return false;
+                        }
+
+                        skip_json_whitespace(first, last);
+                        if (first == last)
+                        {
+                            return false;
+                        }
+
+                        if (*first == closer)
+                        {
+                            ++first;
+                            return true;
+                        }
+
+                        if (*first != ',')
+                        {
+                            return false;
+                        }
+
+                        ++first;
+                        skip_json_whitespace(first, last);
+                    }
+                }
+                default: return skip_json_number(first, last);
+            }
+        }
+    }
+
+    Optional<std::vector<ObjectMemberSpan>> scan_object_members(StringView text)
+    {
+        StatsTimer t(g_json_parsing_stats);
+        text.remove_bom();
+        const char* first = text.begin();
+        const char* const last = text.end();
+        std::vector<ObjectMemberSpan> result;
+        skip_json_whitespace(first, last);
+        if (first == last || *first != '{')
+        {
+            return nullopt;
+        }
+
+        ++first;
+        skip_json_whitespace(first, last);
+        if (first != last && *first == '}')
+        {
+            ++first;
+        }
+        else
+        {
+            for (;;)
+            {
+                if (first == last || *first != '"')
+                {
+                    return nullopt;
+                }
+
+                const auto key_first = first + 1;
+                if (!skip_json_string(first, last))
+                {
+                    return nullopt;
+                }
+
+                StringView key{key_first, first - 1};
+                if (Util::contains(key, '\\'))
+                {
+                    return nullopt;
+                }
+
+                skip_json_whitespace(first, last);
+                if (first == last || *first != ':')
+                {
+                    return nullopt;
+                }
+
+                ++first;
+                skip_json_whitespace(first, last);
+                const auto value_first = first;
+                if (!skip_json_value(first, last, 1))
+                {
+                    return nullopt;
+                }
+
+                result.push_back(ObjectMemberSpan{key.to_string(), StringView{value_first, first}});
+                skip_json_whitespace(first, last);
+                if (first != last && *first == ',')
+                {
+                    ++first;
+                    skip_json_whitespace(first, last);
+                    continue;
+                }
+
+                if (first != last && *first == '}')
+                {
+                    ++first;
+                    break;
+                }
+
+                return nullopt;
+            }
+        }
+
+        skip_json_whitespace(first, last);
+        if (first != last)
+        {
+            return nullopt;
+        }
+
+        std::vector<StringView> keys;
+        keys.reserve(result.size());
+        for (auto&& member : result)
+        {
+            keys.emplace_back(member.key);
+        }
+
+        Util::sort(keys);
+        if (std::adjacent_find(keys.begin(), keys.end()) != keys.end())
+        {
+            return nullopt;
+        }
+
+        return result;
+    }
     // } auto parse()
 
     namespace
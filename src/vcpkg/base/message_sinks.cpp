@@ -281,6 +281,20 @@ namespace vcpkg
         m_second.println(color, std::move(line));
     }
 
+    void BufferedMessageSink::println(const MessageLine& line) { lines.push_back(line); }
+
+    void BufferedMessageSink::println(MessageLine&& line) { lines.push_back(std::move(line)); }
+
+    void BufferedMessageSink::print_to(MessageSink& sink)
+    {
+        for (auto&& line : lines)
+        {
+            sink.println(std::move(line));
+        }
+
+        lines.clear();
+    }
+
     void BGMessageSink::println(const MessageLine& line)
     {
         std::lock_guard<std::mutex> lk(m_published_lock);
@@ -253,6 +253,25 @@ namespace vcpkg
         return cur();
     }
 
+    void ParserBase::advance_ascii(size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (m_row != 0 || m_column != 0)
+        {
+            m_column += static_cast<int>(count);
+        }
+
+        m_it = Unicode::Utf8Decoder(m_it.pointer_to_current() + count, m_text.end());
+        if (m_it != m_it.end() && Unicode::utf16_is_surrogate_code_point(*m_it))
+        {
+            m_it = m_it.end();
+        }
+    }
+
     void ParserBase::add_error(LocalizedString&& message) { add_error(std::move(message), cur_loc()); }
 
     void ParserBase::add_error(LocalizedString&& message, const SourceLoc& loc)
@@ -295,4 +314,19 @@ namespace vcpkg
             m_messages.add_line(DiagnosticLine{kind, std::move(message)});
         }
     }
+
+    TextRowCol text_row_col_at(StringView text, std::size_t offset)
+    {
+        TextRowCol result{1, 1};
+        for (auto ch : text.substr(0, offset))
+        {
+            // count code points rather than bytes, skipping UTF-8 continuation bytes
+            if ((static_cast<unsigned char>(ch) & 0xC0) != 0x80)
+            {
+                advance_rowcol(static_cast<char32_t>(static_cast<unsigned char>(ch)), result.row, result.column);
+            }
+        }
+
+        return result;
+    }
 }
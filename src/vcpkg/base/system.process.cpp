@@ -34,6 +34,7 @@ extern char** environ;
 #else
 #include <fcntl.h>
 #include <poll.h>
+#include <signal.h>
 #include <spawn.h>
 
 #include <sys/wait.h>
@@ -1216,6 +1217,71 @@ namespace
         }
     };
 
+    // Writing to a pipe whose reader has exited raises SIGPIPE, which would terminate vcpkg. Blocks SIGPIPE on this
+    // thread while alive, and discards it if it was raised in the meantime, so that the write fails with EPIPE instead.
+    struct SigpipeBlocker
+    {
+        SigpipeBlocker()
+        {
+            sigemptyset(&sigpipe_set);
+            sigaddset(&sigpipe_set, SIGPIPE);
+            sigset_t pending;
+            sigemptyset(&pending);
+            sigpending(&pending);
+            already_pending = sigismember(&pending, SIGPIPE) == 1;
+            pthread_sigmask(SIG_BLOCK, &sigpipe_set, &old_mask);
+        }
+
+        SigpipeBlocker(const SigpipeBlocker&) = delete;
+        SigpipeBlocker& operator=(const SigpipeBlocker&) = delete;
+
+        ~SigpipeBlocker()
+        {
+            if (!already_pending)
+            {
+                sigset_t pending;
+                sigemptyset(&pending);
+                sigpending(&pending);
+                if (sigismember(&pending, SIGPIPE) == 1)
+                {
+                    int signal;
+                    sigwait(&sigpipe_set, &signal);
+                }
+            }
+
+            pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+        }
+
+    private:
+        sigset_t sigpipe_set;
+        sigset_t old_mask;
+        bool already_pending;
+    };
+
+    // Prefixes the command line of `cmd` with the shell commands to apply `working_directory` and `environment`
+    std::string make_posix_command_line(const Command& cmd,
+                                        const Optional<Path>& working_directory,
+                                        const Optional<Environment>& environment)
+    {
+        std::string actual_cmd_line;
+        if (auto wd = working_directory.get())
+        {
+            actual_cmd_line.append("cd ");
+            append_shell_escaped(actual_cmd_line, *wd);
+            actual_cmd_line.append(" && ");
+        }
+
+        if (auto env_unpacked = environment.get())
+        {
+            actual_cmd_line.append(env_unpacked->get());
+            actual_cmd_line.push_back(' ');
+        }
+
+        const auto unwrapped_to_execute = cmd.command_line();
+        actual_cmd_line.append(unwrapped_to_execute.data(), unwrapped_to_execute.size());
+        return actual_cmd_line;
+    }
+
     struct PosixPid
     {
         pid_t pid;
@@ -1668,23 +1734,7 @@ namespace
         return process_info.wait_and_stream_output(debug_id, stdin_content.data(), stdin_content_size, raw_cb);
 #else  // ^^^ _WIN32 // !_WIN32 vvv
 
-        std::string actual_cmd_line;
-        if (auto wd = settings.working_directory.get())
-        {
-            actual_cmd_line.append("cd ");
-            append_shell_escaped(actual_cmd_line, *wd);
-            actual_cmd_line.append(" && ");
-        }
-
-        if (auto env_unpacked = settings.environment.get())
-        {
-            actual_cmd_line.append(env_unpacked->get());
-            actual_cmd_line.push_back(' ');
-        }
-
-        const auto unwrapped_to_execute = cmd.command_line();
-        actual_cmd_line.append(unwrapped_to_execute.data(), unwrapped_to_execute.size());
-
+        const auto actual_cmd_line = make_posix_command_line(cmd, settings.working_directory, settings.environment);
         Debug::print(fmt::format("{}: execute_process({})\n", debug_id, actual_cmd_line));
         // Flush stdout before launching external process
         fflush(stdout);
@@ -1933,6 +1983,335 @@ namespace vcpkg
             .map([&](ExitCodeIntegral exit_code) { return ExitCodeAndOutput{exit_code, std::move(output)}; });
     }
 
+    struct Coprocess::Impl
+    {
+        int32_t debug_id = debug_id_counter.fetch_add(1, std::memory_order_relaxed);
+#if defined(_WIN32)
+        ProcessInfo process_info;
+        HANDLE child_stdin = INVALID_HANDLE_VALUE;
+        HANDLE child_stdout = INVALID_HANDLE_VALUE;
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+        PosixPid pid;
+        int child_stdin = -1;
+        int child_stdout = -1;
+#endif // ^^^ !_WIN32
+        // Output of the child which has been read but not yet consumed starts at buffer[buffer_offset]
+        std::string buffer;
+        std::size_t buffer_offset = 0;
+
+        Impl() = default;
+        Impl(const Impl&) = delete;
+        Impl& operator=(const Impl&) = delete;
+        ~Impl() { close_pipes(); }
+
+        void close_pipes() noexcept
+        {
+#if defined(_WIN32)
+            close_handle_mark_invalid(child_stdin);
+            close_handle_mark_invalid(child_stdout);
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+            close_mark_invalid(child_stdin);
+            close_mark_invalid(child_stdout);
+#endif // ^^^ !_WIN32
+        }
+
+        // Reads whatever output the child has produced next into `buffer`. Returns false at end of file.
+        bool fill(DiagnosticContext& context)
+        {
+            if (buffer_offset == buffer.size())
+            {
+                buffer.clear();
+                buffer_offset = 0;
+            }
+
+            char buf[4096];
+#if defined(_WIN32)
+            DWORD read_amount;
+            if (!ReadFile(child_stdout, buf, static_cast<DWORD>(sizeof(buf)), &read_amount, nullptr))
+            {
+                const auto error = GetLastError();
+                if (error != ERROR_BROKEN_PIPE)
+                {
+                    context.report_system_error("ReadFile", error);
+                }
+
+                return false;
+            }
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+            ssize_t read_amount;
+            do
+            {
+                read_amount = read(child_stdout, buf, sizeof(buf));
+            } while (read_amount < 0 && errno == EINTR);
+
+            if (read_amount < 0)
+            {
+                context.report_system_error("read", errno);
+                return false;
+            }
+#endif // ^^^ !_WIN32
+
+            if (read_amount == 0)
+            {
+                return false;
+            }
+
+            buffer.append(buf, static_cast<std::size_t>(read_amount));
+            return true;
+        }
+    };
+
+    Coprocess::Coprocess() noexcept = default;
+
+    Coprocess::~Coprocess()
+    {
+        if (is_running())
+        {
+            (void)finish(null_diagnostic_context);
+        }
+    }
+
+    bool Coprocess::start(DiagnosticContext& context, const Command& cmd, const ProcessLaunchSettings& settings)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, !is_running());
+        auto impl = std::make_unique<Impl>();
+        AnonymousPipe child_input;
+        if (!child_input.create(context))
+        {
+            return false;
+        }
+
+        AnonymousPipe child_output;
+        if (!child_output.create(context))
+        {
+            return false;
+        }
+
+#if defined(_WIN32)
+        SpawnProcessGuard spawn_process_guard;
+        STARTUPINFOEXW startup_info_ex{};
+        startup_info_ex.StartupInfo.cb = sizeof(STARTUPINFOEXW);
+        startup_info_ex.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+        startup_info_ex.StartupInfo.hStdInput = child_input.read_pipe;
+        startup_info_ex.StartupInfo.hStdOutput = child_output.write_pipe;
+
+        // The child shares our standard error, which needs an inheritable handle to be passed along
+        HANDLE child_stderr = INVALID_HANDLE_VALUE;
+        const HANDLE our_stderr = GetStdHandle(STD_ERROR_HANDLE);
+        if (our_stderr != INVALID_HANDLE_VALUE && our_stderr &&
+            !DuplicateHandle(GetCurrentProcess(),
+                             our_stderr,
+                             GetCurrentProcess(),
+                             &child_stderr,
+                             0,
+                             TRUE,
+                             DUPLICATE_SAME_ACCESS))
+        {
+            child_stderr = INVALID_HANDLE_VALUE;
+        }
+
+        HANDLE handles_to_inherit[3] = {child_input.read_pipe, child_output.write_pipe, child_stderr};
+        DWORD handles_to_inherit_count = 2;
+        if (child_stderr != INVALID_HANDLE_VALUE)
+        {
+            startup_info_ex.StartupInfo.hStdError = child_stderr;
+            handles_to_inherit_count = 3;
+        }
+
+        ProcAttributeList proc_attribute_list;
+        bool created = proc_attribute_list.create(context, 1) &&
+                       proc_attribute_list.update_attribute(context,
+                                                            PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+                                                            handles_to_inherit,
+                                                            handles_to_inherit_count * sizeof(HANDLE));
+        if (created)
+        {
+            startup_info_ex.lpAttributeList = proc_attribute_list.get();
+            created = windows_create_process(context,
+                                             impl->debug_id,
+                                             impl->process_info,
+                                             cmd.command_line(),
+                                             settings.working_directory,
+                                             settings.environment,
+                                             TRUE,
+                                             CREATE_NO_WINDOW,
+                                             startup_info_ex);
+        }
+
+        close_handle_mark_invalid(child_stderr);
+        if (!created)
+        {
+            return false;
+        }
+
+        close_handle_mark_invalid(impl->process_info.hThread);
+        impl->child_stdin = std::exchange(child_input.write_pipe, INVALID_HANDLE_VALUE);
+        impl->child_stdout = std::exchange(child_output.read_pipe, INVALID_HANDLE_VALUE);
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+        const auto actual_cmd_line = make_posix_command_line(cmd, settings.working_directory, settings.environment);
+        Debug::print(fmt::format("{}: start_coprocess({})\n", impl->debug_id, actual_cmd_line));
+        // Flush stdout before launching external process
+        fflush(stdout);
+
+        PosixSpawnFileActions actions;
+        if (!actions.adddup2(context, child_input.pipefd[0], 0) || !actions.adddup2(context, child_output.pipefd[1], 1))
+        {
+            return false;
+        }
+
+        std::vector<std::string> argv_builder;
+        argv_builder.reserve(3);
+        argv_builder.emplace_back("sh"); // as if by system()
+        argv_builder.emplace_back("-c");
+        argv_builder.emplace_back(actual_cmd_line.data(), actual_cmd_line.size());
+
+        std::vector<char*> argv;
+        argv.reserve(argv_builder.size() + 1);
+        for (std::string& arg : argv_builder)
+        {
+            argv.emplace_back(arg.data());
+        }
+
+        argv.emplace_back(nullptr);
+
+        int error = posix_spawn(&impl->pid.pid, "/bin/sh", &actions.actions, nullptr, argv.data(), environ);
+        if (error)
+        {
+            context.report_system_error("posix_spawn", error);
+            return false;
+        }
+
+        impl->child_stdin = std::exchange(child_input.pipefd[1], -1);
+        impl->child_stdout = std::exchange(child_output.pipefd[0], -1);
+#endif // ^^^ !_WIN32
+
+        m_impl = std::move(impl);
+        return true;
+    }
+
+    bool Coprocess::is_running() const noexcept { return static_cast<bool>(m_impl); }
+
+    bool Coprocess::write(DiagnosticContext& context, StringView data)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, is_running());
+        while (!data.empty())
+        {
+#if defined(_WIN32)
+            DWORD written;
+            const auto to_write = static_cast<DWORD>((std::min)(data.size(), static_cast<std::size_t>(MAXDWORD)));
+            if (!WriteFile(m_impl->child_stdin, data.data(), to_write, &written, nullptr))
+            {
+                context.report_system_error("WriteFile", GetLastError());
+                return false;
+            }
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+            SigpipeBlocker sigpipe_blocker;
+            const auto written = ::write(m_impl->child_stdin, data.data(), data.size());
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                context.report_system_error("write", errno);
+                return false;
+            }
+#endif // ^^^ !_WIN32
+
+            data = data.substr(static_cast<std::size_t>(written));
+        }
+
+        return true;
+    }
+
+    bool Coprocess::read_line(DiagnosticContext& context, std::string& line)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, is_running());
+        auto& impl = *m_impl;
+        std::size_t searched = impl.buffer_offset;
+        for (;;)
+        {
+            const auto newline = impl.buffer.find('\n', searched);
+            if (newline != std::string::npos)
+            {
+                line.assign(impl.buffer, impl.buffer_offset, newline - impl.buffer_offset);
+                impl.buffer_offset = newline + 1;
+                return true;
+            }
+
+            // fill() may move the unconsumed output to the front of the buffer
+            searched = impl.buffer.size() - impl.buffer_offset;
+            if (impl.buffer_offset != 0)
+            {
+                impl.buffer.erase(0, impl.buffer_offset);
+                impl.buffer_offset = 0;
+            }
+
+            if (!impl.fill(context))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool Coprocess::read_exact(DiagnosticContext& context, std::size_t size, std::string& target)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, is_running());
+        auto& impl = *m_impl;
+        for (;;)
+        {
+            const auto available = (std::min)(size, impl.buffer.size() - impl.buffer_offset);
+            target.append(impl.buffer, impl.buffer_offset, available);
+            impl.buffer_offset += available;
+            size -= available;
+            if (size == 0)
+            {
+                return true;
+            }
+
+            if (!impl.fill(context))
+            {
+                return false;
+            }
+        }
+    }
+
+    Optional<ExitCodeIntegral> Coprocess::finish(DiagnosticContext& context)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, is_running());
+        auto impl = std::move(m_impl);
+        // Closing the child's input asks it to exit; its remaining output is discarded rather than left to fill the
+        // pipe or raise SIGPIPE in the child
+#if defined(_WIN32)
+        close_handle_mark_invalid(impl->child_stdin);
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+        close_mark_invalid(impl->child_stdin);
+#endif // ^^^ !_WIN32
+        while (impl->fill(null_diagnostic_context))
+        {
+            impl->buffer.clear();
+            impl->buffer_offset = 0;
+        }
+
+        impl->close_pipes();
+#if defined(_WIN32)
+        const ExitCodeIntegral exit_code = impl->process_info.wait();
+        (void)context;
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+        const auto maybe_exit_code = impl->pid.wait_for_termination(context);
+        const auto exit_code_ptr = maybe_exit_code.get();
+        if (!exit_code_ptr)
+        {
+            return nullopt;
+        }
+
+        const ExitCodeIntegral exit_code = *exit_code_ptr;
+#endif // ^^^ !_WIN32
+        Debug::print(fmt::format("{}: coprocess exited with {}\n", impl->debug_id, exit_code));
+        return exit_code;
+    }
+
     uint64_t get_subproccess_stats() { return g_subprocess_stats.load(); }
 
 #if defined(_WIN32)
@@ -210,9 +210,59 @@ namespace
         return buildtrees / fmt::format("{}_{}.zip", spec.name(), abi);
     }
 
+    int64_t seconds_since_epoch_now()
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    template<class Provider>
+    void extend_provider_stats(std::vector<BinaryProviderStats>& stats,
+                               const std::vector<std::unique_ptr<Provider>>& providers)
+    {
+        for (size_t i = stats.size(); i < providers.size(); ++i)
+        {
+            stats.emplace_back().provider = providers[i]->provider_name().to_string();
+        }
+    }
+
+    Json::Value stats_integer(uint64_t value) { return Json::Value::integer(static_cast<int64_t>(value)); }
+
+    Json::Object serialize_operation_stats(const BinaryCacheOperationStats& stats)
+    {
+        uint64_t total_us = 0;
+        for (auto latency : stats.latencies_us)
+        {
+            total_us += latency;
+        }
+
+        Json::Object obj;
+        obj.insert(JsonIdRequests, stats_integer(stats.requests));
+        obj.insert(JsonIdHits, stats_integer(stats.hits));
+        obj.insert(JsonIdMisses, stats_integer(stats.misses));
+        obj.insert(JsonIdBytes, stats_integer(stats.bytes));
+        obj.insert(JsonIdCalls, stats_integer(stats.calls));
+        obj.insert(JsonIdTotalUs, stats_integer(total_us));
+        obj.insert(JsonIdP50Us, stats_integer(latency_percentile(stats.latencies_us, 50.0)));
+        obj.insert(JsonIdP95Us, stats_integer(latency_percentile(stats.latencies_us, 95.0)));
+        return obj;
+    }
+
     Path files_archive_parent_path(const std::string& abi) { return Path(abi.substr(0, 2)); }
     Path files_archive_subpath(const std::string& abi) { return files_archive_parent_path(abi) / (abi + ".zip"); }
 
+    std::string files_destination_id(const Path& dir) { return "files:" + dir.native(); }
+    std::string http_destination_id(const UrlTemplate& templ)
+    {
+        // the query string may carry credentials such as SAS tokens
+        return "http:" + templ.url_template.substr(0, templ.url_template.find('?'));
+    }
+    std::string upkg_destination_id(const AzureUpkgSource& source)
+    {
+        return Strings::concat("upkg:", source.organization, '/', source.project, '/', source.feed);
+    }
+
     struct FilesWriteBinaryProvider : IWriteBinaryProvider
     {
         FilesWriteBinaryProvider(const Filesystem& fs, std::vector<Path>&& dirs) : m_fs(fs), m_dirs(std::move(dirs)) { }
@@ -267,6 +317,12 @@ namespace
 
         bool needs_nuspec_data() const override { return false; }
         bool needs_zip_file() const override { return true; }
+        size_t destination_count() const override { return m_dirs.size(); }
+        StringLiteral provider_name() const override { return "files"; }
+        std::vector<std::string> destination_ids() const override
+        {
+            return Util::fmap(m_dirs, files_destination_id);
+        }
 
     private:
         const Filesystem& m_fs;
@@ -296,6 +352,23 @@ namespace
         ZipReadBinaryProvider(ZipTool zip, const Filesystem& fs) : m_zip(std::move(zip)), m_fs(fs) { }
 
         void fetch(View<const InstallPlanAction*> actions, Span<RestoreResult> out_status) const override
+        {
+            fetch_impl(actions, out_status, {});
+        }
+
+        bool fetch_and_keep_archives(View<const InstallPlanAction*> actions,
+                                     Span<RestoreResult> out_status,
+                                     Span<Optional<RestoredArchive>> out_archives) const override
+        {
+            fetch_impl(actions, out_status, out_archives);
+            return true;
+        }
+
+        // If out_archives is not empty, the archives of successfully restored packages are stored there rather than
+        // being cleaned up.
+        void fetch_impl(View<const InstallPlanAction*> actions,
+                        Span<RestoreResult> out_status,
+                        Span<Optional<RestoredArchive>> out_archives) const
         {
             const ElapsedTimer timer;
             std::vector<Optional<ZipResource>> zip_paths(actions.size(), nullopt);
@@ -322,6 +395,13 @@ namespace
                 {
                     Debug::print("Restored ", zip_path.path, '\n');
                     out_status[i] = RestoreResult::restored;
+                    m_restored_bytes += m_fs.file_size(zip_path.path, IgnoreErrors{});
+                    if (!out_archives.empty())
+                    {
+                        out_archives[i].emplace(
+                            RestoredArchive{zip_path.path, zip_path.to_remove == RemoveWhen::always});
+                        continue;
+                    }
                 }
                 else
                 {
@@ -332,6 +412,24 @@ namespace
             }
         }
 
+        bool fetch_archives(View<const InstallPlanAction*> actions,
+                            Span<Optional<RestoredArchive>> out_archives) const override
+        {
+            std::vector<Optional<ZipResource>> zip_paths(actions.size(), nullopt);
+            acquire_zips(actions, zip_paths);
+            for (size_t i = 0; i < actions.size(); ++i)
+            {
+                if (auto zip_path = zip_paths[i].get())
+                {
+                    m_restored_bytes += m_fs.file_size(zip_path->path, IgnoreErrors{});
+                    out_archives[i].emplace(
+                        RestoredArchive{std::move(zip_path->path), zip_path->to_remove == RemoveWhen::always});
+                }
+            }
+
+            return true;
+        }
+
         void post_decompress(const ZipResource& r) const
         {
             if (r.to_remove == RemoveWhen::always)
@@ -347,9 +445,12 @@ namespace
         virtual void acquire_zips(View<const InstallPlanAction*> actions,
                                   Span<Optional<ZipResource>> out_zips) const = 0;
 
+        uint64_t restored_bytes() const override { return m_restored_bytes; }
+
     protected:
         ZipTool m_zip;
         const Filesystem& m_fs;
+        mutable uint64_t m_restored_bytes = 0;
     };
 
     struct FilesReadBinaryProvider : ZipReadBinaryProvider
@@ -398,6 +499,9 @@ namespace
                                msg::path = m_dir);
         }
 
+        StringLiteral provider_name() const override { return "files"; }
+        std::string destination_id() const override { return files_destination_id(m_dir); }
+
     private:
         Path m_dir;
     };
@@ -431,6 +535,9 @@ namespace
 
         bool needs_nuspec_data() const override { return false; }
         bool needs_zip_file() const override { return true; }
+        size_t destination_count() const override { return m_urls.size(); }
+        StringLiteral provider_name() const override { return "http"; }
+        std::vector<std::string> destination_ids() const override { return Util::fmap(m_urls, http_destination_id); }
 
     private:
         std::vector<UrlTemplate> m_urls;
@@ -501,6 +608,9 @@ namespace
             return msg::format(msgRestoredPackagesFromHTTP, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
+        StringLiteral provider_name() const override { return "http"; }
+        std::string destination_id() const override { return http_destination_id(m_url_template); }
+
         Path m_buildtrees;
         UrlTemplate m_url_template;
         std::vector<std::string> m_secrets;
@@ -708,6 +818,10 @@ namespace
             return msg::format(msgRestoredPackagesFromNuGet, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
+        StringLiteral provider_name() const override { return "nuget"; }
+        std::string destination_id() const override { return "nuget:" + m_src.value; }
+        uint64_t restored_bytes() const override { return m_restored_bytes; }
+
         void fetch(View<const InstallPlanAction*> actions, Span<RestoreResult> out_status) const override
         {
             auto packages_config = m_buildtrees / "packages.config";
@@ -721,6 +835,7 @@ namespace
                 const auto nupkg_path = m_packages / refs[i].id / refs[i].id + ".nupkg";
                 if (m_fs.exists(nupkg_path, IgnoreErrors{}))
                 {
+                    m_restored_bytes += m_fs.file_size(nupkg_path, IgnoreErrors{});
                     m_fs.remove(nupkg_path, VCPKG_LINE_INFO);
                     const auto nuget_dir = actions[i]->spec.dir();
                     if (nuget_dir != refs[i].id)
@@ -734,6 +849,9 @@ namespace
                 }
             }
         }
+
+    private:
+        mutable uint64_t m_restored_bytes = 0;
     };
 
     struct NugetBinaryPushProvider : IWriteBinaryProvider, private NugetBaseBinaryProvider
@@ -750,6 +868,18 @@ namespace
 
         bool needs_nuspec_data() const override { return true; }
         bool needs_zip_file() const override { return false; }
+        size_t destination_count() const override { return m_sources.size() + m_configs.size(); }
+        StringLiteral provider_name() const override { return "nuget"; }
+        std::vector<std::string> destination_ids() const override
+        {
+            auto ids = Util::fmap(m_sources, [](const std::string& source) { return "nuget:" + source; });
+            for (auto&& config : m_configs)
+            {
+                ids.push_back("nuget:" + config.native());
+            }
+
+            return ids;
+        }
 
         size_t push_success(const BinaryPackageWriteInfo& request, MessageSink& msg_sink) override
         {
@@ -846,6 +976,7 @@ namespace
 
         virtual LocalizedString restored_message(size_t count,
                                                  std::chrono::high_resolution_clock::duration elapsed) const = 0;
+        virtual StringLiteral provider_name() const = 0;
         virtual ExpectedL<CacheAvailability> stat(StringView url) const = 0;
         virtual ExpectedL<RestoreResult> download_file(StringView object, const Path& archive) const = 0;
         virtual ExpectedL<Unit> upload_file(StringView object, const Path& archive) const = 0;
@@ -917,6 +1048,9 @@ namespace
             return m_tool->restored_message(count, elapsed);
         }
 
+        StringLiteral provider_name() const override { return m_tool->provider_name(); }
+        std::string destination_id() const override { return Strings::concat(provider_name(), ':', m_prefix); }
+
         Path m_buildtrees;
         std::string m_prefix;
         std::shared_ptr<const IObjectStorageTool> m_tool;
@@ -955,6 +1089,13 @@ namespace
 
         bool needs_nuspec_data() const override { return false; }
         bool needs_zip_file() const override { return true; }
+        size_t destination_count() const override { return m_prefixes.size(); }
+        StringLiteral provider_name() const override { return m_tool->provider_name(); }
+        std::vector<std::string> destination_ids() const override
+        {
+            return Util::fmap(m_prefixes,
+                              [&](const std::string& prefix) { return Strings::concat(provider_name(), ':', prefix); });
+        }
 
         std::vector<std::string> m_prefixes;
         std::shared_ptr<const IObjectStorageTool> m_tool;
@@ -970,6 +1111,8 @@ namespace
             return msg::format(msgRestoredPackagesFromGCS, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
+        StringLiteral provider_name() const override { return "gcs"; }
+
         ExpectedL<CacheAvailability> stat(StringView url) const override
         {
             return flatten_generic(
@@ -1011,6 +1154,8 @@ namespace
             return msg::format(msgRestoredPackagesFromAWS, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
+        StringLiteral provider_name() const override { return "aws"; }
+
         ExpectedL<CacheAvailability> stat(StringView url) const override
         {
             auto cmd = Command{m_tool}.string_arg("s3").string_arg("ls").string_arg(url);
@@ -1091,6 +1236,8 @@ namespace
             return msg::format(msgRestoredPackagesFromCOS, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
+        StringLiteral provider_name() const override { return "cos"; }
+
         ExpectedL<CacheAvailability> stat(StringView url) const override
         {
             return flatten_generic(cmd_execute_and_capture_output(Command{m_tool}.string_arg("ls").string_arg(url)),
@@ -1227,6 +1374,9 @@ namespace
 
         bool needs_nuspec_data() const override { return false; }
         bool needs_zip_file() const override { return true; }
+        size_t destination_count() const override { return m_sources.size(); }
+        StringLiteral provider_name() const override { return "upkg"; }
+        std::vector<std::string> destination_ids() const override { return Util::fmap(m_sources, upkg_destination_id); }
 
     private:
         AzureUpkgTool m_azure_tool;
@@ -1258,6 +1408,9 @@ namespace
             return msg::format(msgRestoredPackagesFromAZUPKG, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
+        StringLiteral provider_name() const override { return "upkg"; }
+        std::string destination_id() const override { return upkg_destination_id(m_source); }
+
         void acquire_zips(View<const InstallPlanAction*> actions, Span<Optional<ZipResource>> out_zips) const override
         {
             for (size_t i = 0; i < actions.size(); ++i)
@@ -1970,13 +2123,30 @@ namespace vcpkg
                 get_environment_variable(EnvironmentVariableGitHubSha).value_or("")};
     }
 
+    std::vector<std::string> ReadOnlyBinaryCache::missing_from(const CacheStatus& status) const
+    {
+        std::vector<std::string> result;
+        for (auto&& provider : m_config.read)
+        {
+            if (status.is_unavailable(provider.get()))
+            {
+                result.push_back(provider->destination_id());
+            }
+        }
+
+        return result;
+    }
+
     void ReadOnlyBinaryCache::fetch(View<InstallPlanAction> actions)
     {
+        extend_provider_stats(m_stats.read, m_config.read);
         std::vector<const InstallPlanAction*> action_ptrs;
         std::vector<RestoreResult> restores;
+        std::vector<Optional<RestoredArchive>> archives;
         std::vector<CacheStatus*> statuses;
-        for (auto&& provider : m_config.read)
+        for (size_t provider_idx = 0; provider_idx < m_config.read.size(); ++provider_idx)
         {
+            auto& provider = m_config.read[provider_idx];
             action_ptrs.clear();
             restores.clear();
             statuses.clear();
@@ -1996,7 +2166,48 @@ namespace vcpkg
             if (action_ptrs.empty()) continue;
 
             ElapsedTimer timer;
-            provider->fetch(action_ptrs, restores);
+            const auto bytes_before = provider->restored_bytes();
+            archives.assign(action_ptrs.size(), nullopt);
+            if (m_fetch_archives && provider->fetch_archives(action_ptrs, archives))
+            {
+                for (size_t i = 0; i < archives.size(); ++i)
+                {
+                    if (auto archive = archives[i].get())
+                    {
+                        restores[i] = RestoreResult::restored;
+                        archive->missing_from = missing_from(*statuses[i]);
+                        const auto& abi = action_ptrs[i]->package_abi().value_or_exit(VCPKG_LINE_INFO);
+                        if (m_keep_restored_archives)
+                        {
+                            // push_success() rather than the install owns the archive
+                            m_kept_archives.insert_or_assign(abi, *archive);
+                            archive->remove_after_use = false;
+                        }
+
+                        m_restored_archives.insert_or_assign(abi, std::move(*archive));
+                    }
+                }
+            }
+            else if (m_keep_restored_archives && provider->fetch_and_keep_archives(action_ptrs, restores, archives))
+            {
+                for (size_t i = 0; i < archives.size(); ++i)
+                {
+                    if (auto archive = archives[i].get())
+                    {
+                        archive->missing_from = missing_from(*statuses[i]);
+                        m_kept_archives.insert_or_assign(action_ptrs[i]->package_abi().value_or_exit(VCPKG_LINE_INFO),
+                                                         std::move(*archive));
+                    }
+                }
+            }
+            else
+            {
+                provider->fetch(action_ptrs, restores);
+            }
+
+            auto& provider_stats = m_stats.read[provider_idx].restore;
+            provider_stats.add_call(timer, restores.size());
+            provider_stats.bytes += provider->restored_bytes() - bytes_before;
             size_t num_restored = 0;
             for (size_t i = 0; i < restores.size(); ++i)
             {
@@ -2010,6 +2221,9 @@ namespace vcpkg
                     ++num_restored;
                 }
             }
+            provider_stats.requests += restores.size();
+            provider_stats.hits += num_restored;
+            provider_stats.misses += restores.size() - num_restored;
             msg::println(provider->restored_message(
                 num_restored, timer.elapsed().as<std::chrono::high_resolution_clock::duration>()));
         }
@@ -2030,8 +2244,25 @@ namespace vcpkg
         m_config.read.push_back(std::move(provider));
     }
 
+    Optional<RestoredArchive> ReadOnlyBinaryCache::take_restored_archive(const InstallPlanAction& ipa)
+    {
+        if (auto abi = ipa.package_abi().get())
+        {
+            auto it = m_restored_archives.find(*abi);
+            if (it != m_restored_archives.end())
+            {
+                Optional<RestoredArchive> result{std::move(it->second)};
+                m_restored_archives.erase(it);
+                return result;
+            }
+        }
+
+        return nullopt;
+    }
+
     void ReadOnlyBinaryCache::mark_all_unrestored()
     {
+        m_restored_archives.clear();
         for (auto& entry : m_status)
         {
             entry.second.mark_unrestored();
@@ -2046,11 +2277,13 @@ namespace vcpkg
             return &m_status[*action->package_abi().get()];
         });
 
+        extend_provider_stats(m_stats.read, m_config.read);
         std::vector<const InstallPlanAction*> action_ptrs;
         std::vector<CacheAvailability> cache_result;
         std::vector<size_t> indexes;
-        for (auto&& provider : m_config.read)
+        for (size_t provider_idx = 0; provider_idx < m_config.read.size(); ++provider_idx)
         {
+            auto& provider = m_config.read[provider_idx];
             action_ptrs.clear();
             cache_result.clear();
             indexes.clear();
@@ -2065,7 +2298,11 @@ namespace vcpkg
             }
             if (action_ptrs.empty()) continue;
 
+            ElapsedTimer timer;
             provider->precheck(action_ptrs, cache_result);
+            auto& provider_stats = m_stats.read[provider_idx].precheck;
+            provider_stats.add_call(timer, action_ptrs.size());
+            provider_stats.requests += action_ptrs.size();
 
             for (size_t i = 0; i < action_ptrs.size(); ++i)
             {
@@ -2073,10 +2310,12 @@ namespace vcpkg
                 if (cache_result[i] == CacheAvailability::available)
                 {
                     this_status.mark_available(provider.get());
+                    ++provider_stats.hits;
                 }
                 else if (cache_result[i] == CacheAvailability::unavailable)
                 {
                     this_status.mark_unavailable(provider.get());
+                    ++provider_stats.misses;
                 }
             }
         }
@@ -2145,10 +2384,355 @@ namespace vcpkg
         return (state & SubmittedMask) - ((state & CompletedMask) >> UpperShift);
     }
 
+    void BinaryCacheOperationStats::add_call(uint64_t elapsed_us, size_t request_count)
+    {
+        ++calls;
+        if (request_count == 0)
+        {
+            request_count = 1;
+        }
+
+        // spread the remainder over the first requests so that the latencies still add up to the elapsed time
+        const auto share = elapsed_us / request_count;
+        const auto remainder = elapsed_us % request_count;
+        for (size_t request = 0; request < request_count; ++request)
+        {
+            latencies_us.push_back(share + (request < remainder));
+        }
+    }
+
+    uint64_t latency_percentile(std::vector<uint64_t> samples, double percentile)
+    {
+        if (samples.empty())
+        {
+            return 0;
+        }
+
+        Util::sort(samples);
+        auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(samples.size())));
+        if (rank != 0)
+        {
+            --rank;
+        }
+
+        return samples[(std::min)(rank, samples.size() - 1)];
+    }
+
+    Json::Object serialize_binary_cache_stats(const BinaryCacheStats& stats)
+    {
+        Json::Object obj;
+        auto& read = obj.insert(JsonIdRead, Json::Array{});
+        for (auto&& provider : stats.read)
+        {
+            auto& provider_obj = read.push_back(Json::Object{});
+            provider_obj.insert(JsonIdProvider, provider.provider);
+            provider_obj.insert(JsonIdRestore, serialize_operation_stats(provider.restore));
+            provider_obj.insert(JsonIdPrecheck, serialize_operation_stats(provider.precheck));
+        }
+
+        auto& write = obj.insert(JsonIdWrite, Json::Array{});
+        for (auto&& provider : stats.write)
+        {
+            auto& provider_obj = write.push_back(Json::Object{});
+            provider_obj.insert(JsonIdProvider, provider.provider);
+            provider_obj.insert(JsonIdUpload, serialize_operation_stats(provider.upload));
+        }
+
+        obj.insert(JsonIdCompression, serialize_operation_stats(stats.compression));
+        return obj;
+    }
+
+    Json::Object serialize_binary_cache_retry_entry(const BinaryCacheRetryEntry& entry)
+    {
+        Json::Object obj;
+        obj.insert(JsonIdName, entry.spec.name());
+        obj.insert(JsonIdTriplet, entry.spec.triplet().canonical_name());
+        obj.insert(JsonIdVersion, entry.version.text);
+        obj.insert(JsonIdPortVersion, Json::Value::integer(entry.version.port_version));
+        obj.insert(JsonIdAbi, entry.package_abi);
+        obj.insert(JsonIdDisplayName, entry.display_name);
+        obj.insert(JsonIdAttempts, Json::Value::integer(entry.attempts));
+        obj.insert(JsonIdNextAttempt, Json::Value::integer(entry.next_attempt));
+        auto& providers = obj.insert(JsonIdProviders, Json::Array{});
+        for (auto&& provider : entry.providers)
+        {
+            providers.push_back(Json::Value::string(provider));
+        }
+
+        return obj;
+    }
+
+    Optional<BinaryCacheRetryEntry> parse_binary_cache_retry_entry(const Json::Object& obj)
+    {
+        auto name = obj.get(JsonIdName);
+        auto triplet = obj.get(JsonIdTriplet);
+        auto version = obj.get(JsonIdVersion);
+        auto port_version = obj.get(JsonIdPortVersion);
+        auto abi = obj.get(JsonIdAbi);
+        auto display_name = obj.get(JsonIdDisplayName);
+        auto attempts = obj.get(JsonIdAttempts);
+        auto next_attempt = obj.get(JsonIdNextAttempt);
+        if (!name || !name->is_string() || !triplet || !triplet->is_string() || !version || !version->is_string() ||
+            !port_version || !port_version->is_integer() || !abi || !abi->is_string() || !display_name ||
+            !display_name->is_string() || !attempts || !attempts->is_integer() || !next_attempt ||
+            !next_attempt->is_integer())
+        {
+            return nullopt;
+        }
+
+        auto port_version_value = port_version->integer(VCPKG_LINE_INFO);
+        if (port_version_value < 0 || port_version_value > INT_MAX)
+        {
+            return nullopt;
+        }
+
+        BinaryCacheRetryEntry entry{
+            PackageSpec{name->string(VCPKG_LINE_INFO).to_string(),
+                        Triplet::from_canonical_name(triplet->string(VCPKG_LINE_INFO).to_string())},
+            Version{version->string(VCPKG_LINE_INFO).to_string(), static_cast<int>(port_version_value)},
+            abi->string(VCPKG_LINE_INFO).to_string(),
+            display_name->string(VCPKG_LINE_INFO).to_string(),
+            attempts->integer(VCPKG_LINE_INFO),
+            next_attempt->integer(VCPKG_LINE_INFO),
+            {}};
+
+        // entries queued before providers were recorded have none, and are discarded when retried
+        if (auto providers = obj.get(JsonIdProviders))
+        {
+            if (!providers->is_array())
+            {
+                return nullopt;
+            }
+
+            for (auto&& provider : providers->array(VCPKG_LINE_INFO))
+            {
+                if (!provider.is_string())
+                {
+                    return nullopt;
+                }
+
+                entry.providers.push_back(provider.string(VCPKG_LINE_INFO).to_string());
+            }
+
+            Util::sort_unique_erase(entry.providers);
+        }
+
+        return entry;
+    }
+
+    Optional<int64_t> binary_cache_retry_delay(int64_t attempts)
+    {
+        // 5 minutes, doubling with each failure up to a day, giving up after 12 attempts
+        static constexpr int64_t first_delay = 5 * 60;
+        static constexpr int64_t max_delay = 24 * 60 * 60;
+        static constexpr int64_t max_attempts = 12;
+        if (attempts >= max_attempts)
+        {
+            return nullopt;
+        }
+
+        int64_t delay = first_delay;
+        for (int64_t i = 1; i < attempts && delay < max_delay; ++i)
+        {
+            delay *= 2;
+        }
+
+        return (std::min)(delay, max_delay);
+    }
+
+    BinaryCacheRetryQueue::BinaryCacheRetryQueue(const Filesystem& fs, const Path& downloads)
+        : m_fs(fs), m_root(downloads / "binary-cache-retry-queue")
+    {
+    }
+
+    Path BinaryCacheRetryQueue::archive_path(StringView package_abi) const
+    {
+        return m_root / Strings::concat(package_abi, ".zip");
+    }
+
+    static Path retry_entry_path(const Path& root, StringView package_abi)
+    {
+        return root / Strings::concat(package_abi, ".json");
+    }
+
+    static Optional<BinaryCacheRetryEntry> try_load_retry_entry(const Filesystem& fs, const Path& file)
+    {
+        auto maybe_contents = fs.try_read_contents(file);
+        auto contents = maybe_contents.get();
+        if (!contents)
+        {
+            return nullopt;
+        }
+
+        auto maybe_obj = Json::parse_object(contents->content, contents->origin);
+        auto obj = maybe_obj.get();
+        if (!obj)
+        {
+            Debug::print("Ignoring malformed binary cache retry entry ", file, '\n');
+            return nullopt;
+        }
+
+        return parse_binary_cache_retry_entry(*obj);
+    }
+
+    std::unique_ptr<IExclusiveFileLock> BinaryCacheRetryQueue::lock(bool wait, MessageSink& status_sink) const
+    {
+        std::error_code ec;
+        m_fs.create_directories(m_root, ec);
+        std::unique_ptr<IExclusiveFileLock> result;
+        if (!ec)
+        {
+            const auto lock_file = m_root / ".lock";
+            result = wait ? m_fs.take_exclusive_file_lock(lock_file, status_sink, ec)
+                          : m_fs.try_take_exclusive_file_lock(lock_file, status_sink, ec);
+        }
+
+        if (ec)
+        {
+            Debug::print("Failed to lock the binary cache retry queue ", m_root, ": ", ec.message(), '\n');
+            result.reset();
+        }
+
+        return result;
+    }
+
+    std::vector<BinaryCacheRetryEntry> BinaryCacheRetryQueue::load_entries() const
+    {
+        std::vector<BinaryCacheRetryEntry> entries;
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto files = m_fs.get_regular_files_non_recursive(m_root, IgnoreErrors{});
+        for (auto&& file : files)
+        {
+            if (file.extension() != ".json")
+            {
+                continue;
+            }
+
+            auto maybe_entry = try_load_retry_entry(m_fs, file);
+            auto entry = maybe_entry.get();
+            if (!entry || !m_fs.exists(archive_path(entry->package_abi), IgnoreErrors{}))
+            {
+                Debug::print("Ignoring incomplete binary cache retry entry ", file, '\n');
+                continue;
+            }
+
+            entries.push_back(std::move(*entry));
+        }
+
+        Util::sort(entries, [](const BinaryCacheRetryEntry& lhs, const BinaryCacheRetryEntry& rhs) {
+            return lhs.package_abi < rhs.package_abi;
+        });
+        return entries;
+    }
+
+    bool BinaryCacheRetryQueue::enqueue(const BinaryPackageReadInfo& info,
+                                        const Path& zip_path,
+                                        std::vector<std::string>&& failed_providers,
+                                        MessageSink& msg_sink) const
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        std::error_code ec;
+        m_fs.create_directories(m_root, ec);
+        const auto target_archive = archive_path(info.package_abi);
+        if (!ec)
+        {
+            m_fs.rename(zip_path, target_archive, ec);
+            if (ec)
+            {
+                // probably buildtrees and downloads are on different filesystems
+                m_fs.copy_file(zip_path, target_archive, CopyOptions::overwrite_existing, ec);
+            }
+        }
+
+        const auto entry_path = retry_entry_path(m_root, info.package_abi);
+        BinaryCacheRetryEntry entry{
+            info.spec, info.version, info.package_abi, info.display_name, 0, 0, std::move(failed_providers)};
+        auto maybe_existing = try_load_retry_entry(m_fs, entry_path);
+        if (auto existing = maybe_existing.get())
+        {
+            Util::Vectors::append(entry.providers, std::move(existing->providers));
+        }
+
+        Util::sort_unique_erase(entry.providers);
+        if (!ec)
+        {
+            m_fs.write_contents(entry_path, Json::stringify(serialize_binary_cache_retry_entry(entry)), ec);
+        }
+
+        if (ec)
+        {
+            msg_sink.println(Color::warning,
+                             msg::format(msgFailedToStoreBinaryCache, msg::path = target_archive)
+                                 .append_raw('\n')
+                                 .append_raw(ec.message()));
+            m_fs.remove(target_archive, IgnoreErrors{});
+            return false;
+        }
+
+        return true;
+    }
+
+    bool BinaryCacheRetryQueue::record_failure(BinaryCacheRetryEntry& entry, std::error_code& ec) const
+    {
+        ec.clear();
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto maybe_delay = binary_cache_retry_delay(entry.attempts + 1);
+        if (auto delay = maybe_delay.get())
+        {
+            auto updated = entry;
+            ++updated.attempts;
+            updated.next_attempt = seconds_since_epoch_now() + *delay;
+            m_fs.write_contents(retry_entry_path(m_root, entry.package_abi),
+                                Json::stringify(serialize_binary_cache_retry_entry(updated)),
+                                ec);
+            if (!ec)
+            {
+                entry = std::move(updated);
+            }
+
+            return true;
+        }
+
+        ++entry.attempts;
+        remove_unlocked(entry.package_abi);
+        return false;
+    }
+
+    void BinaryCacheRetryQueue::remove(StringView package_abi) const
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        remove_unlocked(package_abi);
+    }
+
+    void BinaryCacheRetryQueue::remove_unlocked(StringView package_abi) const
+    {
+        // remove the metadata first so that a concurrent reader never sees an entry without its archive
+        m_fs.remove(retry_entry_path(m_root, package_abi), IgnoreErrors{});
+        m_fs.remove(archive_path(package_abi), IgnoreErrors{});
+    }
+
+    void BinaryCacheRetryQueue::clear() const
+    {
+        // leave the lock file in place, since the caller holds it
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (auto&& file : m_fs.get_regular_files_non_recursive(m_root, IgnoreErrors{}))
+        {
+            if (file.filename() != ".lock")
+            {
+                m_fs.remove(file, VCPKG_LINE_INFO);
+            }
+        }
+    }
+
     bool BinaryCache::install_providers(const VcpkgCmdArguments& args,
                                         const VcpkgPaths& paths,
                                         MessageSink& status_sink)
     {
+        if (auto stats_file = args.binary_cache_stats_file.get())
+        {
+            m_stats_file.emplace(paths.original_cwd / *stats_file);
+        }
+
         if (args.binary_caching_enabled())
         {
             if (Debug::g_debugging)
@@ -2329,9 +2913,17 @@ namespace vcpkg
 
         m_needs_nuspec_data = Util::any_of(m_config.write, [](auto&& p) { return p->needs_nuspec_data(); });
         m_needs_zip_file = Util::any_of(m_config.write, [](auto&& p) { return p->needs_zip_file(); });
+        m_fetch_archives = args.restore_into_installed.value_or(false);
+        m_keep_restored_archives = m_needs_zip_file;
+        extend_provider_stats(m_stats.write, m_config.write);
         if (m_needs_zip_file)
         {
             m_zip_tool.setup(paths.get_tool_cache(), status_sink);
+            m_retry_queue.emplace(paths.get_filesystem(), paths.downloads);
+            // only retry a few entries per run so that an unrelated install doesn't wait on a large backlog when it
+            // exits; x-binary-cache-queue --drain submits all of them
+            static constexpr size_t automatic_retry_batch = 4;
+            submit_queued_retries(automatic_retry_batch, false, false);
         }
 
         return true;
@@ -2362,7 +2954,20 @@ namespace vcpkg
                 m_status.erase(it);
             }
 
-            if (!restored && !m_config.write.empty())
+            if (restored)
+            {
+                auto kept = m_kept_archives.find(*abi);
+                if (kept != m_kept_archives.end())
+                {
+                    RestoredArchive archive = std::move(kept->second);
+                    m_kept_archives.erase(kept);
+                    if (push_restored_archive(clean_packages, action, std::move(archive)))
+                    {
+                        return;
+                    }
+                }
+            }
+            else if (!m_config.write.empty())
             {
                 ElapsedTimer timer;
                 BinaryPackageWriteInfo request{action};
@@ -2382,7 +2987,7 @@ namespace vcpkg
                 msg::println(msg::format(msgSubmittingBinaryCacheBackground,
                                          msg::spec = action.display_name(),
                                          msg::count = m_config.write.size()));
-                m_actions_to_push.push(ActionToPush{std::move(request), clean_packages});
+                m_actions_to_push.push(ActionToPush{std::move(request), clean_packages, nullopt, nullopt});
                 return;
             }
         }
@@ -2393,6 +2998,117 @@ namespace vcpkg
         }
     }
 
+    static bool stores_to_any_of(const IWriteBinaryProvider& provider, const std::vector<std::string>& ids)
+    {
+        return Util::any_of(provider.destination_ids(),
+                            [&](const std::string& id) { return Util::Vectors::contains(ids, id); });
+    }
+
+    static bool should_push_restored_archive(const IWriteBinaryProvider& provider, const RestoredArchive& archive)
+    {
+        // Only upload to caches which were checked for the package and don't have it; that excludes the one it came
+        // from, and caches which were never asked because an earlier one had it.
+        return provider.needs_zip_file() && stores_to_any_of(provider, archive.missing_from);
+    }
+
+    bool BinaryCache::push_restored_archive(CleanPackages clean_packages,
+                                            const InstallPlanAction& action,
+                                            RestoredArchive&& archive)
+    {
+        const auto destinations =
+            static_cast<size_t>(std::count_if(m_config.write.begin(), m_config.write.end(), [&](auto&& provider) {
+                return should_push_restored_archive(*provider, archive);
+            }));
+        if (destinations == 0)
+        {
+            if (archive.remove_after_use)
+            {
+                m_fs.remove(archive.path, IgnoreErrors{});
+            }
+
+            return false;
+        }
+
+        BinaryPackageWriteInfo request{action};
+        request.zip_path = archive.path;
+        request.unique_write_provider = destinations == 1 && archive.remove_after_use;
+        m_synchronizer.add_submitted();
+        msg::println(msg::format(
+            msgSubmittingBinaryCacheBackground, msg::spec = action.display_name(), msg::count = destinations));
+        m_actions_to_push.push(ActionToPush{std::move(request), clean_packages, nullopt, std::move(archive)});
+        return true;
+    }
+
+    size_t BinaryCache::submit_queued_retries(size_t max_entries, bool ignore_backoff, bool wait)
+    {
+        auto retry_queue = m_retry_queue.get();
+        if (!retry_queue)
+        {
+            return 0;
+        }
+
+        if (!m_retry_queue_lock)
+        {
+            m_retry_queue_lock = retry_queue->lock(wait, stderr_sink);
+            if (!m_retry_queue_lock)
+            {
+                Debug::print("Not retrying queued binary cache submissions; another vcpkg process is retrying them\n");
+                return 0;
+            }
+        }
+
+        std::vector<std::string> configured_providers;
+        for (auto&& provider : m_config.write)
+        {
+            if (provider->needs_zip_file())
+            {
+                Util::Vectors::append(configured_providers, provider->destination_ids());
+            }
+        }
+
+        size_t submitted = 0;
+        const auto now = seconds_since_epoch_now();
+        for (auto&& entry : retry_queue->load_entries())
+        {
+            if (submitted >= max_entries)
+            {
+                break;
+            }
+
+            if (Util::Sets::contains(m_submitted_retries, entry.package_abi))
+            {
+                continue;
+            }
+
+            Util::erase_remove_if(entry.providers, [&](const std::string& provider) {
+                return !Util::Vectors::contains(configured_providers, provider);
+            });
+            if (entry.providers.empty())
+            {
+                retry_queue->remove(entry.package_abi);
+                msg::println_warning(msgBinaryCacheQueueDiscardedUnconfigured, msg::spec = entry.display_name);
+                continue;
+            }
+
+            if (!ignore_backoff && entry.next_attempt > now)
+            {
+                continue;
+            }
+
+            m_submitted_retries.insert(entry.package_abi);
+
+            BinaryPackageWriteInfo request{
+                entry.spec, entry.package_abi, entry.display_name, entry.version, retry_queue->root()};
+            request.zip_path = retry_queue->archive_path(entry.package_abi);
+            m_synchronizer.add_submitted();
+            msg::println(msgSubmittingBinaryCacheRetry, msg::spec = entry.display_name, msg::count = entry.attempts);
+            m_actions_to_push.push(ActionToPush{std::move(request), CleanPackages::No, std::move(entry), nullopt});
+            ++submitted;
+        }
+
+        return submitted;
+    }
+
     void BinaryCache::print_updates() { m_bg_msg_sink.print_published(); }
 
     void BinaryCache::wait_for_async_complete_and_join()
@@ -2410,6 +3126,32 @@ namespace vcpkg
         {
             m_push_thread.join();
         }
+
+        for (auto&& kept : m_kept_archives)
+        {
+            if (kept.second.remove_after_use)
+            {
+                m_fs.remove(kept.second.path, IgnoreErrors{});
+            }
+        }
+
+        m_kept_archives.clear();
+        m_retry_queue_lock.reset();
+
+        if (auto stats_file = m_stats_file.get())
+        {
+            extend_provider_stats(m_stats.read, m_config.read);
+            std::error_code ec;
+            m_fs.write_contents(*stats_file, Json::stringify(serialize_binary_cache_stats(m_stats)), ec);
+            if (ec)
+            {
+                msg::println_warning(msg::format(msgErrorWhileWriting, msg::path = *stats_file)
+                                         .append_raw('\n')
+                                         .append_raw(ec.message()));
+            }
+
+            m_stats_file.clear();
+        }
     }
 
     void BinaryCache::push_thread_main()
@@ -2420,26 +3162,134 @@ namespace vcpkg
             for (auto& action_to_push : my_tasks)
             {
                 ElapsedTimer timer;
-                if (m_needs_zip_file)
+                // retries already have zip_path pointing into the retry queue
+                auto retry_entry = action_to_push.retry_entry.get();
+                // restored archives are uploaded as they are
+                auto restored_archive = action_to_push.restored_archive.get();
+                // whether request.zip_path may be moved or deleted once it has been uploaded
+                const bool owns_zip = !restored_archive || restored_archive->remove_after_use;
+                if (!retry_entry && !restored_archive && m_needs_zip_file)
                 {
                     Path zip_path = action_to_push.request.package_dir + ".zip";
                     PrintingDiagnosticContext pdc{m_bg_msg_sink};
+                    ElapsedTimer compression_timer;
+                    auto& compression_stats = m_stats.compression;
+                    ++compression_stats.requests;
                     if (m_zip_tool.compress_directory_to_zip(pdc, m_fs, action_to_push.request.package_dir, zip_path))
                     {
+                        ++compression_stats.hits;
+                        compression_stats.bytes += m_fs.file_size(zip_path, IgnoreErrors{});
                         action_to_push.request.zip_path = std::move(zip_path);
                     }
+                    else
+                    {
+                        ++compression_stats.misses;
+                    }
+
+                    compression_stats.add_call(compression_timer, 1);
+                }
+
+                uint64_t zip_size = 0;
+                if (auto zip_path = action_to_push.request.zip_path.get())
+                {
+                    zip_size = m_fs.file_size(*zip_path, IgnoreErrors{});
                 }
 
                 size_t num_destinations = 0;
-                for (auto&& provider : m_config.write)
+                // the destination_ids() of each provider which needs the zip file and failed to store it
+                std::vector<std::string> failed_zip_providers;
+                for (size_t provider_idx = 0; provider_idx < m_config.write.size(); ++provider_idx)
                 {
-                    if (!provider->needs_zip_file() || action_to_push.request.zip_path.has_value())
+                    auto& provider = m_config.write[provider_idx];
+                    bool should_push;
+                    if (restored_archive)
+                    {
+                        should_push = should_push_restored_archive(*provider, *restored_archive);
+                    }
+                    else if (retry_entry)
                     {
-                        num_destinations += provider->push_success(action_to_push.request, m_bg_msg_sink);
+                        // only retry against the providers the upload failed for
+                        should_push = provider->needs_zip_file() && stores_to_any_of(*provider, retry_entry->providers);
+                    }
+                    else
+                    {
+                        should_push = !provider->needs_zip_file() || action_to_push.request.zip_path.has_value();
+                    }
+
+                    if (should_push)
+                    {
+                        ElapsedTimer upload_timer;
+                        const auto stored = provider->push_success(action_to_push.request, m_bg_msg_sink);
+                        auto& upload_stats = m_stats.write[provider_idx].upload;
+                        const auto attempted = provider->destination_count();
+                        upload_stats.add_call(upload_timer, attempted);
+                        upload_stats.requests += attempted;
+                        upload_stats.hits += stored;
+                        upload_stats.misses += attempted > stored ? attempted - stored : 0;
+                        if (provider->needs_zip_file())
+                        {
+                            upload_stats.bytes += zip_size * stored;
+                        }
+
+                        num_destinations += stored;
+                        if (provider->needs_zip_file() && stored < attempted)
+                        {
+                            Util::Vectors::append(failed_zip_providers, provider->destination_ids());
+                        }
+                    }
+                }
+
+                if (auto retry_queue = m_retry_queue.get())
+                {
+                    if (retry_entry)
+                    {
+                        if (failed_zip_providers.empty())
+                        {
+                            retry_queue->remove(retry_entry->package_abi);
+                        }
+                        else
+                        {
+                            Util::sort(failed_zip_providers);
+                            retry_entry->providers = std::move(failed_zip_providers);
+                            std::error_code ec;
+                            if (!retry_queue->record_failure(*retry_entry, ec))
+                            {
+                                m_bg_msg_sink.println(Color::warning,
+                                                      msgSubmittingBinaryCacheAbandoned,
+                                                      msg::spec = action_to_push.request.display_name,
+                                                      msg::count = retry_entry->attempts);
+                            }
+                            else if (ec)
+                            {
+                                m_bg_msg_sink.println(Color::warning,
+                                                      msg::format(msgErrorWhileWriting, msg::path = retry_queue->root())
+                                                          .append_raw('\n')
+                                                          .append_raw(ec.message()));
+                            }
+                        }
+
+                        action_to_push.request.zip_path.clear();
+                    }
+                    else if (!failed_zip_providers.empty() && owns_zip)
+                    {
+                        if (auto zip_path = action_to_push.request.zip_path.get())
+                        {
+                            if (m_fs.exists(*zip_path, IgnoreErrors{}) &&
+                                retry_queue->enqueue(action_to_push.request,
+                                                     *zip_path,
+                                                     std::move(failed_zip_providers),
+                                                     m_bg_msg_sink))
+                            {
+                                m_bg_msg_sink.println(Color::warning,
+                                                      msgSubmittingBinaryCacheQueued,
+                                                      msg::spec = action_to_push.request.display_name,
+                                                      msg::path = retry_queue->root());
+                            }
+                        }
                     }
                 }
 
-                if (action_to_push.request.zip_path)
+                if (action_to_push.request.zip_path && owns_zip)
                 {
                     m_fs.remove(*action_to_push.request.zip_path.get(), IgnoreErrors{});
                 }
@@ -2558,6 +3408,15 @@ namespace vcpkg
         , package_dir(action.package_dir.value_or_exit(VCPKG_LINE_INFO))
     {
     }
+
+    BinaryPackageReadInfo::BinaryPackageReadInfo(const PackageSpec& spec,
+                                                 const std::string& package_abi,
+                                                 const std::string& display_name,
+                                                 const Version& version,
+                                                 const Path& package_dir)
+        : package_abi(package_abi), spec(spec), display_name(display_name), version(version), package_dir(package_dir)
+    {
+    }
 }
 
 ExpectedL<AssetCachingSettings> vcpkg::parse_download_configuration(const Optional<std::string>& arg)
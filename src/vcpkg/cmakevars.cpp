@@ -21,11 +21,31 @@ namespace vcpkg::CMakeVars
         std::vector<Path> port_locations;
         install_package_specs.reserve(action_plan.install_actions.size());
         port_locations.reserve(action_plan.install_actions.size());
+        LocalizedString extraction_errors;
         for (auto&& action : action_plan.install_actions)
         {
-            install_package_specs.emplace_back(action.spec, action.feature_list);
-            port_locations.emplace_back(
-                action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).port_directory());
+            install_package_specs.emplace_back(action.spec, InternalFeatureSet(action.feature_list));
+            // the tag variables can be overridden by the port, so this is where ports read from git are extracted
+            const auto& scfl = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO);
+            auto maybe_port_dir = scfl.extract_port_directory();
+            if (auto port_dir = maybe_port_dir.get())
+            {
+                port_locations.emplace_back(std::move(*port_dir));
+            }
+            else
+            {
+                if (!extraction_errors.empty())
+                {
+                    extraction_errors.append_raw('\n');
+                }
+
+                extraction_errors.append(maybe_port_dir.error());
+            }
+        }
+
+        if (!extraction_errors.empty())
+        {
+            Checks::msg_exit_with_error(VCPKG_LINE_INFO, extraction_errors);
         }
 
         load_tag_vars(install_package_specs, port_locations, host_triplet);
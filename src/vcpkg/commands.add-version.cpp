@@ -478,7 +478,8 @@ namespace vcpkg
         for (auto&& port_git_tree_entry : port_git_trees)
         {
             auto& port_name = port_git_tree_entry.file_name;
-            auto load_result = Paragraphs::try_load_builtin_port_required(fs, port_name, builtin_ports_directory);
+            auto load_result = Paragraphs::try_load_builtin_port_required(
+                fs, port_name, builtin_ports_directory, &paths.parsed_manifest_cache());
             auto& maybe_scfl = load_result.maybe_scfl;
             auto scfl = maybe_scfl.get();
             if (!scfl)
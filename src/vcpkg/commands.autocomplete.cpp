@@ -106,7 +106,7 @@ namespace vcpkg
                 StringView triplet_prefix{colon + 1, last_arg.end()};
                 // TODO: Support autocomplete for ports in --overlay-ports
                 auto maybe_port = Paragraphs::try_load_builtin_port_required(
-                    paths.get_filesystem(), port_name, paths.builtin_ports_directory());
+                    paths.get_filesystem(), port_name, paths.builtin_ports_directory(), &paths.parsed_manifest_cache());
                 if (!maybe_port.maybe_scfl)
                 {
                     Checks::exit_success(VCPKG_LINE_INFO);
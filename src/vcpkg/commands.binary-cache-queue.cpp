@@ -0,0 +1,95 @@
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/messages.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/binarycaching.h>
+#include <vcpkg/commands.binary-cache-queue.h>
+#include <vcpkg/vcpkgcmdarguments.h>
+#include <vcpkg/vcpkgpaths.h>
+
+using namespace vcpkg;
+
+namespace
+{
+    constexpr CommandSwitch BINARY_CACHE_QUEUE_SWITCHES[]{
+        {SwitchClear, msgCmdBinaryCacheQueueSwitchClear},
+        {SwitchDrain, msgCmdBinaryCacheQueueSwitchDrain},
+    };
+
+    std::string format_next_attempt(int64_t next_attempt)
+    {
+        auto maybe_tm = to_utc_time(static_cast<std::time_t>(next_attempt));
+        if (auto tm = maybe_tm.get())
+        {
+            return CTime(*tm).to_string();
+        }
+
+        return std::to_string(next_attempt);
+    }
+} // unnamed namespace
+
+namespace vcpkg
+{
+    constexpr CommandMetadata CommandBinaryCacheQueueMetadata{
+        "x-binary-cache-queue",
+        msgCmdBinaryCacheQueueSynopsis,
+        {"vcpkg x-binary-cache-queue", "vcpkg x-binary-cache-queue --drain"},
+        Undocumented,
+        AutocompletePriority::Internal,
+        0,
+        0,
+        {BINARY_CACHE_QUEUE_SWITCHES},
+        nullptr,
+    };
+
+    void command_binary_cache_queue_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        auto parsed_args = args.parse_arguments(CommandBinaryCacheQueueMetadata);
+        auto& fs = paths.get_filesystem();
+        BinaryCacheRetryQueue queue(fs, paths.downloads);
+
+        if (Util::Sets::contains(parsed_args.switches, SwitchClear))
+        {
+            auto lock = queue.lock(true, stderr_sink);
+            if (!lock)
+            {
+                Checks::msg_exit_with_error(VCPKG_LINE_INFO, msgErrorWhileWriting, msg::path = queue.root());
+            }
+
+            queue.clear();
+            msg::println(msgBinaryCacheQueueCleared, msg::path = queue.root());
+            Checks::exit_success(VCPKG_LINE_INFO);
+        }
+
+        if (Util::Sets::contains(parsed_args.switches, SwitchDrain))
+        {
+            BinaryCache binary_cache(fs);
+            if (!binary_cache.install_providers(args, paths, out_sink))
+            {
+                Checks::exit_fail(VCPKG_LINE_INFO);
+            }
+
+            binary_cache.submit_queued_retries(SIZE_MAX, true, true);
+            binary_cache.wait_for_async_complete_and_join();
+        }
+
+        auto entries = queue.load_entries();
+        if (entries.empty())
+        {
+            msg::println(msgBinaryCacheQueueEmpty, msg::path = queue.root());
+        }
+
+        for (auto&& entry : entries)
+        {
+            msg::println(msgBinaryCacheQueueEntry,
+                         msg::spec = entry.spec,
+                         msg::sha = entry.package_abi,
+                         msg::count = entry.attempts,
+                         msg::value = format_next_attempt(entry.next_attempt));
+        }
+
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
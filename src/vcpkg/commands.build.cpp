@@ -1028,9 +1028,7 @@ namespace vcpkg
         }
     }
 
-    static void write_sbom(const VcpkgPaths& paths,
-                           const InstallPlanAction& action,
-                           std::vector<Json::Object> heuristic_resources)
+    static void write_sbom(const VcpkgPaths& paths, const InstallPlanAction& action)
     {
         auto& fs = paths.get_filesystem();
         const auto& scfl = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO);
@@ -1047,13 +1045,22 @@ namespace vcpkg
 
         const auto now = CTime::now_string();
         const auto& abi = action.abi_info.value_or_exit(VCPKG_LINE_INFO);
+        View<Path> relative_port_files;
+        View<std::string> relative_port_hashes;
+        std::vector<Json::Object> heuristic_resources;
+        if (auto port_dir_info = abi.port_dir_info.get())
+        {
+            relative_port_files = port_dir_info->files;
+            relative_port_hashes = port_dir_info->hashes;
+            heuristic_resources.push_back(port_dir_info->heuristic_resources);
+        }
 
         const auto json_path =
             action.package_dir.value_or_exit(VCPKG_LINE_INFO) / FileShare / action.spec.name() / FileVcpkgSpdxJson;
         fs.write_contents_and_dirs(
             json_path,
             create_spdx_sbom(
-                action, abi.relative_port_files, abi.relative_port_hashes, now, doc_ns, std::move(heuristic_resources)),
+                action, relative_port_files, relative_port_hashes, now, doc_ns, std::move(heuristic_resources)),
             VCPKG_LINE_INFO);
     }
 
@@ -1068,6 +1075,12 @@ namespace vcpkg
 
         auto& fs = paths.get_filesystem();
         auto&& scfl = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO);
+        auto maybe_port_dir = scfl.extract_port_directory();
+        if (!maybe_port_dir)
+        {
+            msg::println(Color::error, maybe_port_dir.error());
+            return ExtendedBuildResult{BuildResult::BuildFailed};
+        }
 
         Triplet triplet = action.spec.triplet();
         const auto& triplet_db = paths.get_triplet_db();
@@ -1204,7 +1217,7 @@ namespace vcpkg
 
         std::unique_ptr<BinaryControlFile> bcf = create_binary_control_file(action, build_info);
 
-        write_sbom(paths, action, abi_info.heuristic_resources);
+        write_sbom(paths, action);
         write_binary_control_file(paths.get_filesystem(), action.package_dir.value_or_exit(VCPKG_LINE_INFO), *bcf);
         return {BuildResult::Succeeded, std::move(bcf)};
     }
@@ -1288,9 +1301,42 @@ namespace vcpkg
         }
     }
 
+    namespace
+    {
+        // Shares one PreBuildInfo between the actions whose triplets and triplet variables are the same, which is
+        // every action of a triplet unless ports customize the triplet
+        struct PreBuildInfoCache
+        {
+            std::shared_ptr<const PreBuildInfo> get(const VcpkgPaths& paths,
+                                                    Triplet triplet,
+                                                    const std::unordered_map<std::string, std::string>& cmakevars)
+            {
+                auto& candidates = m_pre_build_infos[triplet];
+                for (auto&& candidate : candidates)
+                {
+                    if (candidate.first == &cmakevars || *candidate.first == cmakevars)
+                    {
+                        return candidate.second;
+                    }
+                }
+
+                auto pre_build_info = std::make_shared<const PreBuildInfo>(paths, triplet, cmakevars);
+                candidates.emplace_back(&cmakevars, pre_build_info);
+                return pre_build_info;
+            }
+
+        private:
+            // the variables are owned by the CMakeVarProvider
+            std::unordered_map<Triplet,
+                               std::vector<std::pair<const std::unordered_map<std::string, std::string>*,
+                                                     std::shared_ptr<const PreBuildInfo>>>>
+                m_pre_build_infos;
+        };
+    }
+
     static void populate_abi_tag(const VcpkgPaths& paths,
                                  InstallPlanAction& action,
-                                 std::unique_ptr<PreBuildInfo>&& proto_pre_build_info,
+                                 std::shared_ptr<const PreBuildInfo>&& proto_pre_build_info,
                                  Span<const AbiEntry> dependency_abis,
                                  PortDirAbiInfoCache& port_dir_cache,
                                  Cache<Path, Optional<std::string>>& grdk_cache)
@@ -1337,9 +1383,11 @@ namespace vcpkg
         auto& fs = paths.get_filesystem();
         abi_entries_from_pre_build_info(fs, grdk_cache, pre_build_info, abi_tag_entries);
 
-        auto&& port_dir = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).port_directory();
+        const auto port_dir = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO)
+                                  .extract_port_directory()
+                                  .value_or_exit(VCPKG_LINE_INFO);
         const auto& port_dir_cache_entry = port_dir_cache.get_lazy(port_dir, [&]() {
-            PortDirAbiInfoCacheEntry port_dir_cache_entry;
+            auto port_dir_cache_entry = std::make_shared<PortDirAbiInfoCacheEntry>();
 
             std::string portfile_cmake_contents;
             {
@@ -1355,9 +1403,9 @@ namespace vcpkg
                                          msg::package_name = action.spec.name(),
                                          msg::count = rel_port_files.size());
                 }
-                port_dir_cache_entry.files = std::move(rel_port_files);
+                port_dir_cache_entry->files = std::move(rel_port_files);
             }
-            const auto& rel_port_files = port_dir_cache_entry.files;
+            const auto& rel_port_files = port_dir_cache_entry->files;
             // Technically the pre_build_info is not part of the port_dir cache key, but a given port_dir is only going
             // to be associated with 1 port
             for (size_t i = 0; i < abi_info.pre_build_info->hash_additional_files.size(); ++i)
@@ -1381,19 +1429,19 @@ namespace vcpkg
                 {
                     const auto contents = fs.read_contents(abs_port_file, VCPKG_LINE_INFO);
                     portfile_cmake_contents += contents;
-                    port_dir_cache_entry.hashes.push_back(vcpkg::Hash::get_string_sha256(contents));
+                    port_dir_cache_entry->hashes.push_back(vcpkg::Hash::get_string_sha256(contents));
                 }
                 else
                 {
-                    port_dir_cache_entry.hashes.push_back(
+                    port_dir_cache_entry->hashes.push_back(
                         vcpkg::Hash::get_file_hash(fs, abs_port_file, Hash::Algorithm::Sha256)
                             .value_or_exit(VCPKG_LINE_INFO));
                 }
-                port_dir_cache_entry.abi_entries.emplace_back(rel_port_file, port_dir_cache_entry.hashes.back());
+                port_dir_cache_entry->abi_entries.emplace_back(rel_port_file, port_dir_cache_entry->hashes.back());
             }
 
             auto& scf = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).source_control_file;
-            port_dir_cache_entry.heuristic_resources =
+            port_dir_cache_entry->heuristic_resources =
                 run_resource_heuristics(portfile_cmake_contents, scf->core_paragraph->version.text);
 
             auto& helpers = paths.get_cmake_script_hashes();
@@ -1401,14 +1449,14 @@ namespace vcpkg
             {
                 if (Strings::case_insensitive_ascii_contains(portfile_cmake_contents, helper.first))
                 {
-                    port_dir_cache_entry.abi_entries.emplace_back(helper.first, helper.second);
+                    port_dir_cache_entry->abi_entries.emplace_back(helper.first, helper.second);
                 }
             }
 
-            return port_dir_cache_entry;
+            return std::shared_ptr<const PortDirAbiInfoCacheEntry>(std::move(port_dir_cache_entry));
         });
 
-        Util::Vectors::append(abi_tag_entries, port_dir_cache_entry.abi_entries);
+        Util::Vectors::append(abi_tag_entries, port_dir_cache_entry->abi_entries);
 
         {
             size_t i = 0;
@@ -1448,7 +1496,7 @@ namespace vcpkg
 
         abi_tag_entries.emplace_back(AbiTagPortsDotCMake, paths.get_ports_cmake_hash().to_string());
         abi_tag_entries.emplace_back(AbiTagPostBuildChecks, "2");
-        InternalFeatureSet sorted_feature_list = action.feature_list;
+        InternalFeatureSet sorted_feature_list(action.feature_list.begin(), action.feature_list.end());
         // Check that no "default" feature is present. Default features must be resolved before attempting to calculate
         // a package ABI, so the "default" should not have made it here.
         const bool has_no_pseudo_features = std::none_of(sorted_feature_list.begin(),
@@ -1495,9 +1543,7 @@ namespace vcpkg
         fs.write_contents_and_dirs(abi_file_path, full_abi_info, VCPKG_LINE_INFO);
         abi_info.package_abi = Hash::get_string_sha256(full_abi_info);
         abi_info.abi_tag_file.emplace(std::move(abi_file_path));
-        abi_info.relative_port_files = port_dir_cache_entry.files;
-        abi_info.relative_port_hashes = port_dir_cache_entry.hashes;
-        abi_info.heuristic_resources.push_back(port_dir_cache_entry.heuristic_resources);
+        abi_info.port_dir_info = port_dir_cache_entry;
     }
 
     void compute_all_abis(const VcpkgPaths& paths,
@@ -1516,6 +1562,7 @@ namespace vcpkg
                           PortDirAbiInfoCache& port_dir_cache)
     {
         Cache<Path, Optional<std::string>> grdk_cache;
+        PreBuildInfoCache pre_build_infos;
         for (auto it = action_plan.install_actions.begin(); it != action_plan.install_actions.end(); ++it)
         {
             auto& action = *it;
@@ -1547,16 +1594,179 @@ namespace vcpkg
                 }
             }
 
-            populate_abi_tag(
-                paths,
-                action,
-                std::make_unique<PreBuildInfo>(paths,
-                                               action.spec.triplet(),
-                                               var_provider.get_tag_vars(action.spec).value_or_exit(VCPKG_LINE_INFO)),
-                dependency_abis,
-                port_dir_cache,
-                grdk_cache);
+            const auto& tag_vars = var_provider.get_tag_vars(action.spec).value_or_exit(VCPKG_LINE_INFO);
+            populate_abi_tag(paths,
+                             action,
+                             pre_build_infos.get(paths, action.spec.triplet(), tag_vars),
+                             dependency_abis,
+                             port_dir_cache,
+                             grdk_cache);
+        }
+
+        if (Debug::g_debugging)
+        {
+            Debug::println("Install plan memory: ", estimate_memory_usage(action_plan).to_string());
+        }
+    }
+
+    namespace
+    {
+        // Heap memory estimates: the sizes of what the containers own, not of the containers themselves, and an
+        // assumed 4 pointers of overhead per tree node and 2 per shared_ptr control block
+        constexpr size_t tree_node_overhead = 4 * sizeof(void*);
+        constexpr size_t control_block_overhead = 2 * sizeof(void*);
+
+        size_t heap_bytes(const std::string& value)
+        {
+            // strings short enough to be stored inline own no heap memory
+            static const size_t inline_capacity = std::string{}.capacity();
+            if (value.capacity() <= inline_capacity)
+            {
+                return 0;
+            }
+
+            return value.capacity() + 1;
+        }
+
+        size_t heap_bytes(const Path& value) { return heap_bytes(value.native()); }
+        size_t heap_bytes(const LocalizedString& value) { return heap_bytes(value.data()); }
+        size_t heap_bytes(const AbiEntry& entry) { return heap_bytes(entry.key) + heap_bytes(entry.value); }
+
+        template<class T>
+        size_t heap_bytes(const std::vector<T>& values);
+        template<class Key, class Value>
+        size_t heap_bytes(const std::map<Key, Value>& values);
+
+        template<class T>
+        size_t heap_bytes(const Optional<T>& value)
+        {
+            if (auto p = value.get())
+            {
+                return heap_bytes(*p);
+            }
+
+            return 0;
+        }
+
+        template<class T>
+        size_t heap_bytes(const std::vector<T>& values)
+        {
+            size_t result = values.capacity() * sizeof(T);
+            if constexpr (!std::is_trivially_copyable_v<T>)
+            {
+                for (auto&& value : values)
+                {
+                    result += heap_bytes(value);
+                }
+            }
+
+            return result;
+        }
+
+        // the elements of a shared list, along with the vector that owns them, which lives in its control block
+        template<class T>
+        size_t heap_bytes(const SharedVector<T>& values)
+        {
+            size_t result = control_block_overhead + sizeof(std::vector<T>) + values.size() * sizeof(T);
+            if constexpr (!std::is_trivially_copyable_v<T>)
+            {
+                for (auto&& value : values)
+                {
+                    result += heap_bytes(value);
+                }
+            }
+
+            return result;
         }
+
+        template<class Key, class Value>
+        size_t heap_bytes(const std::map<Key, Value>& values)
+        {
+            size_t result = values.size() * (sizeof(std::pair<const Key, Value>) + tree_node_overhead);
+            for (auto&& value : values)
+            {
+                result += heap_bytes(value.first) + heap_bytes(value.second);
+            }
+
+            return result;
+        }
+
+        size_t heap_bytes(const PreBuildInfo& info)
+        {
+            return sizeof(info) + heap_bytes(info.target_architecture) + heap_bytes(info.cmake_system_name) +
+                   heap_bytes(info.cmake_system_version) + heap_bytes(info.platform_toolset) +
+                   heap_bytes(info.platform_toolset_version) + heap_bytes(info.visual_studio_path) +
+                   heap_bytes(info.external_toolchain_file) + heap_bytes(info.public_abi_override) +
+                   heap_bytes(info.passthrough_env_vars) + heap_bytes(info.passthrough_env_vars_tracked) +
+                   heap_bytes(info.hash_additional_files) + heap_bytes(info.post_portfile_includes) +
+                   heap_bytes(info.gamedk_latest_path);
+        }
+
+        size_t heap_bytes(const PortDirAbiInfoCacheEntry& entry)
+        {
+            // JSON documents are estimated by the length of their text
+            return sizeof(entry) + heap_bytes(entry.abi_entries) + heap_bytes(entry.files) + heap_bytes(entry.hashes) +
+                   Json::stringify(entry.heuristic_resources, Json::JsonStyle::with_spaces(0)).size();
+        }
+    }
+
+    std::string ActionPlanMemoryUsage::to_string() const
+    {
+        return fmt::format("{} install actions use {:.1f} KiB, and share {:.1f} KiB of {} pre-build infos, {} port "
+                           "directories and {} dependency or feature lists",
+                           install_actions,
+                           action_bytes / 1024.0,
+                           shared_bytes / 1024.0,
+                           pre_build_infos,
+                           port_dirs,
+                           dependency_lists);
+    }
+
+    ActionPlanMemoryUsage estimate_memory_usage(const ActionPlan& action_plan)
+    {
+        ActionPlanMemoryUsage result;
+        std::unordered_set<const void*> shared;
+        const auto add_shared = [&](const auto& maybe_shared, size_t& count) {
+            if (maybe_shared && shared.insert(maybe_shared.get()).second)
+            {
+                ++count;
+                result.shared_bytes += heap_bytes(*maybe_shared);
+            }
+        };
+        const auto add_shared_list = [&](const auto& list) {
+            if (!list.empty() && shared.insert(list.data()).second)
+            {
+                ++result.dependency_lists;
+                result.shared_bytes += heap_bytes(list);
+            }
+        };
+
+        for (auto&& action : action_plan.install_actions)
+        {
+            ++result.install_actions;
+            result.action_bytes += sizeof(action) + heap_bytes(action.default_features) +
+                                   heap_bytes(action.build_failure_messages) + heap_bytes(action.package_dir);
+            add_shared_list(action.package_dependencies);
+            add_shared_list(action.feature_list);
+            for (auto&& fdeps : action.feature_dependencies)
+            {
+                result.action_bytes += sizeof(fdeps) + tree_node_overhead + heap_bytes(fdeps.first);
+                add_shared_list(fdeps.second);
+            }
+            if (auto installed = action.installed_package.get())
+            {
+                result.action_bytes += heap_bytes(installed->features);
+            }
+
+            if (auto abi_info = action.abi_info.get())
+            {
+                result.action_bytes += heap_bytes(abi_info->package_abi) + heap_bytes(abi_info->abi_tag_file);
+                add_shared(abi_info->pre_build_info, result.pre_build_infos);
+                add_shared(abi_info->port_dir_info, result.port_dirs);
+            }
+        }
+
+        return result;
     }
 
     ExtendedBuildResult build_package(const VcpkgCmdArguments& args,
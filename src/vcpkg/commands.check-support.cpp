@@ -1,5 +1,6 @@
 #include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/json.h>
+#include <vcpkg/base/shared-vector.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/util.h>
 
@@ -21,7 +22,7 @@ namespace
     struct Port
     {
         std::string port_name;
-        std::vector<std::string> features;
+        SharedVector<std::string> features;
         Triplet triplet;
         std::string supports_expr;
     };
@@ -59,7 +59,8 @@ namespace
             port_name,
             PortLocation(*extracted_tree,
                          Paragraphs::builtin_git_tree_spdx_location(version_entry.git_tree),
-                         PortSourceKind::Git));
+                         PortSourceKind::Git),
+            &paths.parsed_manifest_cache());
         auto scfl = load_result.maybe_scfl.get();
         if (!scfl)
         {
@@ -539,7 +540,9 @@ namespace vcpkg
         {
             auto& port_name = tree_entry.file_name;
             auto maybe_loaded_port =
-                Paragraphs::try_load_builtin_port_required(fs, port_name, paths.builtin_ports_directory()).maybe_scfl;
+                Paragraphs::try_load_builtin_port_required(
+                    fs, port_name, paths.builtin_ports_directory(), &paths.parsed_manifest_cache())
+                    .maybe_scfl;
             auto loaded_port = maybe_loaded_port.get();
             if (loaded_port)
             {
@@ -1,6 +1,7 @@
 #include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/graphs.h>
+#include <vcpkg/base/shared-vector.h>
 #include <vcpkg/base/sortedvector.h>
 #include <vcpkg/base/span.h>
 #include <vcpkg/base/strings.h>
@@ -53,7 +54,7 @@ namespace
     struct UnknownCIPortsResults
     {
         std::map<PackageSpec, BuildResult> known;
-        std::map<PackageSpec, std::vector<std::string>> features;
+        std::map<PackageSpec, SharedVector<std::string>> features;
         std::map<PackageSpec, std::string> abi_map;
         // action_state_string.size() will equal install_actions.size()
         std::vector<StringLiteral> action_state_string;
@@ -100,15 +101,19 @@ namespace
 
         var_provider.load_dep_info_vars(packages_with_qualified_deps, serialize_options.host_triplet);
 
+        // The plans for each spec and the full plan resolve mostly the same port features
+        ResolutionContext resolution_context;
+        CreateInstallPlanOptions plan_options = serialize_options;
+        plan_options.resolution_context = &resolution_context;
         const auto applicable_specs = Util::filter(specs, [&](auto& spec) -> bool {
             PackagesDirAssigner this_packages_dir_not_used{""};
             return create_feature_install_plan(
-                       provider, var_provider, {&spec, 1}, {}, this_packages_dir_not_used, serialize_options)
+                       provider, var_provider, {&spec, 1}, {}, this_packages_dir_not_used, plan_options)
                 .unsupported_features.empty();
         });
 
         auto action_plan = create_feature_install_plan(
-            provider, var_provider, applicable_specs, {}, packages_dir_assigner, serialize_options);
+            provider, var_provider, applicable_specs, {}, packages_dir_assigner, plan_options);
         var_provider.load_tag_vars(action_plan, serialize_options.host_triplet);
 
         Checks::check_exit(VCPKG_LINE_INFO, action_plan.already_installed.empty());
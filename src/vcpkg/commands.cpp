@@ -4,6 +4,7 @@
 #include <vcpkg/commands.add-version.h>
 #include <vcpkg/commands.add.h>
 #include <vcpkg/commands.autocomplete.h>
+#include <vcpkg/commands.binary-cache-queue.h>
 #include <vcpkg/commands.bootstrap-standalone.h>
 #include <vcpkg/commands.build-external.h>
 #include <vcpkg/commands.build.h>
@@ -86,6 +87,7 @@ namespace vcpkg
         {CommandAddMetadata, command_add_and_exit},
         {CommandAddVersionMetadata, command_add_version_and_exit},
         {CommandAutocompleteMetadata, command_autocomplete_and_exit},
+        {CommandBinaryCacheQueueMetadata, command_binary_cache_queue_and_exit},
         {CommandCiCleanMetadata, command_ci_clean_and_exit},
         {CommandCiVerifyVersionsMetadata, command_ci_verify_versions_and_exit},
         {CommandCreateMetadata, command_create_and_exit},
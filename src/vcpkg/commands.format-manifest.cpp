@@ -166,7 +166,8 @@ namespace vcpkg
             for (const auto& dir : fs.get_directories_non_recursive(paths.builtin_ports_directory(), VCPKG_LINE_INFO))
             {
                 auto maybe_manifest =
-                    Paragraphs::try_load_builtin_port_required(fs, dir.filename(), paths.builtin_ports_directory());
+                    Paragraphs::try_load_builtin_port_required(
+                        fs, dir.filename(), paths.builtin_ports_directory(), &paths.parsed_manifest_cache());
                 if (auto manifest = maybe_manifest.maybe_scfl.get())
                 {
                     auto original = manifest->control_path;
@@ -1,6 +1,7 @@
 #include <vcpkg/base/fwd/message_sinks.h>
 
 #include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/delayed-init.h>
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/hash.h>
 #include <vcpkg/base/messages.h>
@@ -8,6 +9,7 @@
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 
+#include <vcpkg/archives.h>
 #include <vcpkg/binarycaching.h>
 #include <vcpkg/cmakevars.h>
 #include <vcpkg/commands.build.h>
@@ -19,6 +21,7 @@
 #include <vcpkg/documentation.h>
 #include <vcpkg/input.h>
 #include <vcpkg/installedpaths.h>
+#include <vcpkg/installplancache.h>
 #include <vcpkg/metrics.h>
 #include <vcpkg/paragraphs.h>
 #include <vcpkg/portfileprovider.h>
@@ -217,10 +220,85 @@ namespace vcpkg
         return SortedVector<file_pack>(std::move(installed_files));
     }
 
-    static InstallResult install_package(const VcpkgPaths& paths,
-                                         const Path& package_dir,
-                                         const BinaryControlFile& bcf,
-                                         StatusParagraphs* status_db)
+    static SortedVector<std::string> build_list_of_archive_files(View<std::string> archive_entries)
+    {
+        auto package_files = Util::fmap(archive_entries, [](const std::string& entry) {
+            StringView name = entry;
+            if (name.ends_with("/"))
+            {
+                name = name.substr(0, name.size() - 1);
+            }
+
+            return name.to_string();
+        });
+
+        Util::erase_remove_if(package_files, [](const std::string& name) {
+            return name.empty() || Path(name).filename() == FileDotDsStore;
+        });
+        return SortedVector<std::string>(std::move(package_files));
+    }
+
+    // Returns whether the archive entry `name`, without any trailing '/', is extracted into the installed tree
+    static bool is_installed_archive_entry(StringView name, bool is_directory)
+    {
+        if (name.empty())
+        {
+            return false;
+        }
+
+        const auto filename = Path(name).filename();
+        return filename != FileDotDsStore &&
+               (is_directory || (filename != FileControl && filename != FileVcpkgDotJson && filename != FileBuildInfo));
+    }
+
+    // Builds the listfile contents that install_files_and_write_listfile would record for a package directory with
+    // the contents `archive_entries`, including the directories which are only implied by the zip entry names.
+    static std::vector<std::string> build_listfile_from_archive_entries(StringView destination_subdirectory,
+                                                                        View<std::string> archive_entries)
+    {
+        std::vector<std::string> output;
+        output.push_back(Strings::concat(destination_subdirectory, "/"));
+        for (auto&& entry : archive_entries)
+        {
+            StringView name = entry;
+            const bool is_directory = name.ends_with("/");
+            if (is_directory)
+            {
+                name = name.substr(0, name.size() - 1);
+            }
+
+            if (!is_installed_archive_entry(name, is_directory))
+            {
+                continue;
+            }
+
+            for (size_t i = 0; i < name.size(); ++i)
+            {
+                if (name[i] == '/')
+                {
+                    output.push_back(Strings::concat(destination_subdirectory, "/", name.substr(0, i), "/"));
+                }
+            }
+
+            auto this_output = Strings::concat(destination_subdirectory, "/", name);
+            if (is_directory)
+            {
+                this_output.push_back('/');
+            }
+
+            output.push_back(std::move(this_output));
+        }
+
+        Util::sort_unique_erase(output);
+        return output;
+    }
+
+    template<class InstallFiles>
+    static InstallResult install_package_files(const VcpkgPaths& paths,
+                                               const SortedVector<std::string>& package_files,
+                                               const BinaryControlFile& bcf,
+                                               StatusParagraphs* status_db,
+                                               InstallFiles install_files)
     {
         auto& fs = paths.get_filesystem();
         const auto& installed = paths.installed();
@@ -228,7 +306,6 @@ namespace vcpkg
         const std::vector<StatusParagraphAndAssociatedFiles> pgh_and_files =
             get_installed_files_and_upgrade(fs, installed, *status_db);
 
-        const SortedVector<std::string> package_files = build_list_of_package_files(fs, package_dir);
         const SortedVector<file_pack> installed_files = build_list_of_installed_files(pgh_and_files, triplet);
 
         struct intersection_compare
@@ -301,7 +378,7 @@ namespace vcpkg
         const InstallDir install_dir =
             InstallDir::from_destination_root(paths.installed(), triplet, bcf.core_paragraph);
 
-        install_package_and_write_listfile(fs, package_dir, install_dir);
+        install_files(install_dir);
 
         source_paragraph.status.state = InstallState::INSTALLED;
         write_update(fs, installed, source_paragraph);
@@ -317,6 +394,107 @@ namespace vcpkg
         return InstallResult::SUCCESS;
     }
 
+    static InstallResult install_package(const VcpkgPaths& paths,
+                                         const Path& package_dir,
+                                         const BinaryControlFile& bcf,
+                                         StatusParagraphs* status_db)
+    {
+        auto& fs = paths.get_filesystem();
+        return install_package_files(
+            paths, build_list_of_package_files(fs, package_dir), bcf, status_db, [&](const InstallDir& install_dir) {
+                install_package_and_write_listfile(fs, package_dir, install_dir);
+            });
+    }
+
+    // Installs a package restored by --x-restore-into-installed by extracting `archive` directly into the installed
+    // tree rather than copying it out of packages/. `archive_entries` is the archive's central directory listing.
+    static InstallResult install_package_from_archive(const VcpkgPaths& paths,
+                                                      const ZipTool& zip,
+                                                      const Path& archive,
+                                                      View<std::string> archive_entries,
+                                                      const BinaryControlFile& bcf,
+                                                      StatusParagraphs* status_db)
+    {
+        auto& fs = paths.get_filesystem();
+        return install_package_files(
+            paths, build_list_of_archive_files(archive_entries), bcf, status_db, [&](const InstallDir& install_dir) {
+                const Path& destination = install_dir.destination();
+                const Path& listfile = install_dir.listfile();
+                fs.create_directories(destination, VCPKG_LINE_INFO);
+                fs.create_directories(listfile.parent_path(), VCPKG_LINE_INFO);
+                for (auto&& entry : archive_entries)
+                {
+                    if (entry.empty() || entry.back() == '/' || !is_installed_archive_entry(entry, false))
+                    {
+                        continue;
+                    }
+
+                    const auto target = destination / entry;
+                    if (fs.exists(target, IgnoreErrors{}))
+                    {
+                        msg::println_warning(msgOverwritingFile, msg::path = target);
+                    }
+                }
+
+                const auto cmd = zip.decompress_zip_archive_into_installed_cmd(destination, archive);
+                auto results = decompress_in_parallel(View<Command>{&cmd, 1});
+                if (!results[0])
+                {
+                    Checks::msg_exit_with_message(VCPKG_LINE_INFO, results[0].error());
+                }
+
+                fs.write_lines(listfile,
+                               build_listfile_from_archive_entries(destination.filename(), archive_entries),
+                               VCPKG_LINE_INFO);
+            });
+    }
+
+    // Prepares a package restored as an unextracted archive for install_package_from_archive: lists the archive and
+    // extracts only its CONTROL file into `package_dir`. If the archive can't be listed that way, extracts the whole
+    // package into `package_dir` instead and returns nullopt so that it is installed in the usual way.
+    static Optional<std::vector<std::string>> prepare_restored_archive(const Filesystem& fs,
+                                                                       const ZipTool& zip,
+                                                                       const Path& package_dir,
+                                                                       const RestoredArchive& archive)
+    {
+        fs.remove_all(package_dir, VCPKG_LINE_INFO);
+        fs.create_directories(package_dir, VCPKG_LINE_INFO);
+        auto maybe_entries = list_zip_archive_entries(fs, archive.path);
+        if (auto entries = maybe_entries.get())
+        {
+            const auto cmd = zip.decompress_zip_archive_entry_cmd(package_dir, archive.path, FileControl);
+            auto results = decompress_in_parallel(View<Command>{&cmd, 1});
+            if (results[0])
+            {
+                return std::move(*entries);
+            }
+
+            Debug::println(results[0].error());
+        }
+        else
+        {
+            Debug::println(maybe_entries.error());
+        }
+
+        const auto cmd = zip.decompress_zip_archive_cmd(package_dir, archive.path);
+        auto results = decompress_in_parallel(View<Command>{&cmd, 1});
+        if (!results[0])
+        {
+            Checks::msg_exit_with_message(VCPKG_LINE_INFO, results[0].error());
+        }
+
+        return nullopt;
+    }
+
+    static const ZipTool& get_zip_tool(const VcpkgPaths& paths, const DelayedInit<ZipTool>& zip_tool)
+    {
+        return zip_tool.get([&] {
+            ZipTool zip;
+            zip.setup(paths.get_tool_cache(), out_sink);
+            return zip;
+        });
+    }
+
     static ExtendedBuildResult perform_install_plan_action(const VcpkgCmdArguments& args,
                                                            const VcpkgPaths& paths,
                                                            Triplet host_triplet,
@@ -324,6 +502,7 @@ namespace vcpkg
                                                            const InstallPlanAction& action,
                                                            StatusParagraphs& status_db,
                                                            BinaryCache& binary_cache,
+                                                           const DelayedInit<ZipTool>& zip_tool,
                                                            const IBuildLogsRecorder& build_logs_recorder)
     {
         auto& fs = paths.get_filesystem();
@@ -337,8 +516,17 @@ namespace vcpkg
         if (plan_type == InstallPlanType::BUILD_AND_INSTALL)
         {
             std::unique_ptr<BinaryControlFile> bcf;
+            Optional<RestoredArchive> restored_archive;
+            Optional<std::vector<std::string>> archive_entries;
             if (binary_cache.is_restored(action))
             {
+                restored_archive = binary_cache.take_restored_archive(action);
+                if (auto archive = restored_archive.get())
+                {
+                    archive_entries = prepare_restored_archive(
+                        fs, get_zip_tool(paths, zip_tool), action.package_dir.value_or_exit(VCPKG_LINE_INFO), *archive);
+                }
+
                 auto maybe_bcf = Paragraphs::try_load_cached_package(
                     fs, action.package_dir.value_or_exit(VCPKG_LINE_INFO), action.spec);
                 bcf = std::make_unique<BinaryControlFile>(std::move(maybe_bcf).value_or_exit(VCPKG_LINE_INFO));
@@ -387,8 +575,20 @@ namespace vcpkg
             BuildResult code;
             if (all_dependencies_satisfied)
             {
-                const auto install_result =
-                    install_package(paths, action.package_dir.value_or_exit(VCPKG_LINE_INFO), *bcf, &status_db);
+                InstallResult install_result;
+                auto archive = restored_archive.get();
+                auto entries = archive_entries.get();
+                if (archive && entries)
+                {
+                    install_result = install_package_from_archive(
+                        paths, get_zip_tool(paths, zip_tool), archive->path, *entries, *bcf, &status_db);
+                }
+                else
+                {
+                    install_result =
+                        install_package(paths, action.package_dir.value_or_exit(VCPKG_LINE_INFO), *bcf, &status_db);
+                }
+
                 switch (install_result)
                 {
                     case InstallResult::SUCCESS: code = BuildResult::Succeeded; break;
@@ -403,6 +603,14 @@ namespace vcpkg
                 code = BuildResult::Downloaded;
             }
 
+            if (auto archive = restored_archive.get())
+            {
+                if (archive->remove_after_use)
+                {
+                    fs.remove(archive->path, IgnoreErrors{});
+                }
+            }
+
             if (build_options.clean_downloads == CleanDownloads::Yes)
             {
                 for (auto& p : fs.get_regular_files_non_recursive(paths.downloads, IgnoreErrors{}))
@@ -572,6 +780,8 @@ namespace vcpkg
         size_t action_index = 1;
 
         auto& fs = paths.get_filesystem();
+        // only set up if a package restored by --x-restore-into-installed needs extracting
+        DelayedInit<ZipTool> zip_tool;
         for (auto&& action : action_plan.remove_actions)
         {
             TrackedPackageInstallGuard this_install(action_index++, action_count, summary.results, action);
@@ -581,16 +791,30 @@ namespace vcpkg
 
         for (auto&& action : action_plan.already_installed)
         {
-            summary.results.emplace_back(action).build_result.emplace(perform_install_plan_action(
-                args, paths, host_triplet, build_options, action, status_db, binary_cache, build_logs_recorder));
+            summary.results.emplace_back(action).build_result.emplace(perform_install_plan_action(args,
+                                                                                                  paths,
+                                                                                                  host_triplet,
+                                                                                                  build_options,
+                                                                                                  action,
+                                                                                                  status_db,
+                                                                                                  binary_cache,
+                                                                                                  zip_tool,
+                                                                                                  build_logs_recorder));
         }
 
         for (auto&& action : action_plan.install_actions)
         {
             binary_cache.print_updates();
             TrackedPackageInstallGuard this_install(action_index++, action_count, summary.results, action);
-            auto result = perform_install_plan_action(
-                args, paths, host_triplet, build_options, action, status_db, binary_cache, build_logs_recorder);
+            auto result = perform_install_plan_action(args,
+                                                      paths,
+                                                      host_triplet,
+                                                      build_options,
+                                                      action,
+                                                      status_db,
+                                                      binary_cache,
+                                                      zip_tool,
+                                                      build_logs_recorder);
             if (result.code != BuildResult::Succeeded && build_options.keep_going == KeepGoing::No)
             {
                 this_install.print_elapsed_time();
@@ -1148,6 +1372,35 @@ namespace vcpkg
                 get_global_metrics_collector().track_define(DefineMetric::X_WriteNugetPackagesConfig);
                 pkgsconfig = Path(it_pkgsconfig->second);
             }
+
+            // The cache can't reproduce the plan printed by a dry run, the packages.config, or the dependency graph
+            Optional<InstallPlanCache> install_plan_cache;
+            if (!dry_run && !pkgsconfig && !paths.get_feature_flags().dependency_graph)
+            {
+                auto& cache = install_plan_cache.emplace(args, paths, default_triplet, host_triplet);
+                const auto status_db = database_load_collapse(fs, paths.installed());
+                auto maybe_user_requested_specs = cache.find_up_to_date(status_db);
+                if (auto user_requested_specs = maybe_user_requested_specs.get())
+                {
+                    msg::println(msgInstallPlanUpToDate);
+                    if (print_cmake_usage)
+                    {
+                        std::set<std::string> printed_usages;
+                        for (auto&& ur_spec : *user_requested_specs)
+                        {
+                            auto it = status_db.find_installed(ur_spec);
+                            if (it != status_db.end())
+                            {
+                                install_print_usage_information(
+                                    it->get()->package, printed_usages, fs, paths.installed());
+                            }
+                        }
+                    }
+
+                    Checks::exit_success(VCPKG_LINE_INFO);
+                }
+            }
+
             auto maybe_manifest_scf =
                 SourceControlFile::parse_project_manifest_object(manifest->path, manifest->manifest, out_sink);
             if (!maybe_manifest_scf)
@@ -1274,7 +1527,8 @@ namespace vcpkg
                                               dry_run ? DryRun::Yes : DryRun::No,
                                               print_cmake_usage ? PrintUsage::Yes : PrintUsage::No,
                                               pkgsconfig,
-                                              true);
+                                              true,
+                                              install_plan_cache.get());
         }
 
         auto registry_set = paths.make_registry_set();
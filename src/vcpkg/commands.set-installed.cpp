@@ -9,6 +9,7 @@
 #include <vcpkg/commands.set-installed.h>
 #include <vcpkg/input.h>
 #include <vcpkg/installedpaths.h>
+#include <vcpkg/installplancache.h>
 #include <vcpkg/metrics.h>
 #include <vcpkg/portfileprovider.h>
 #include <vcpkg/registries.h>
@@ -193,12 +194,17 @@ namespace vcpkg
                                            DryRun dry_run,
                                            PrintUsage print_usage,
                                            const Optional<Path>& maybe_pkgconfig,
-                                           bool include_manifest_in_github_issue)
+                                           bool include_manifest_in_github_issue,
+                                           InstallPlanCache* install_plan_cache)
     {
         auto& fs = paths.get_filesystem();
 
         cmake_vars.load_tag_vars(action_plan, host_triplet);
         compute_all_abis(paths, action_plan, cmake_vars, StatusParagraphs{});
+        if (install_plan_cache)
+        {
+            install_plan_cache->capture(action_plan);
+        }
 
         std::vector<PackageSpec> user_requested_specs;
         for (const auto& action : action_plan.install_actions)
@@ -316,6 +322,11 @@ namespace vcpkg
             fs.write_contents(json_file_path, json_contents, VCPKG_LINE_INFO);
         }
 
+        if (install_plan_cache && build_options.only_downloads == OnlyDownloads::No && !summary.failed)
+        {
+            install_plan_cache->save();
+        }
+
         binary_cache.wait_for_async_complete_and_join();
         summary.print_complete_message();
         Checks::exit_success(VCPKG_LINE_INFO);
@@ -393,6 +404,7 @@ namespace vcpkg
             Util::Sets::contains(options.switches, SwitchDryRun) ? DryRun::Yes : DryRun::No,
             Util::Sets::contains(options.switches, SwitchNoPrintUsage) ? PrintUsage::No : PrintUsage::Yes,
             pkgsconfig,
-            false);
+            false,
+            nullptr);
     }
 } // namespace vcpkg
@@ -543,6 +543,9 @@ namespace vcpkg
         PackagesDirAssigner packages_dir_assigner{paths.packages()};
         CreateInstallPlanOptions install_plan_options{
             nullptr, host_triplet, UnsupportedPortAction::Warn, UseHeadVersion::No, Editable::No};
+        // Each feature combination of a port resolves mostly the same port features
+        ResolutionContext resolution_context;
+        install_plan_options.resolution_context = &resolution_context;
         static constexpr BuildPackageOptions build_options{
             BuildMissing::Yes,
             AllowDownloads::Yes,
@@ -687,9 +690,11 @@ namespace vcpkg
             {
                 for (auto& actions : test_spec.plan.install_actions)
                 {
-                    specs.emplace_back(actions.spec, actions.feature_list);
+                    specs.emplace_back(actions.spec, InternalFeatureSet(actions.feature_list));
                     port_locations.emplace_back(
-                        actions.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).port_directory());
+                        actions.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO)
+                            .extract_port_directory()
+                            .value_or_exit(VCPKG_LINE_INFO));
                 }
                 actions_to_check.push_back(&test_spec.plan.install_actions.back());
             }
@@ -8,15 +8,232 @@
 #include <vcpkg/dependencies.h>
 #include <vcpkg/documentation.h>
 #include <vcpkg/packagespec.h>
+#include <vcpkg/platform-expression.h>
 #include <vcpkg/portfileprovider.h>
 #include <vcpkg/statusparagraphs.h>
 #include <vcpkg/vcpkglib.h>
+#include <vcpkg/versions.h>
 
+#include <deque>
+#include <numeric>
 #include <unordered_map>
 #include <unordered_set>
 
 namespace vcpkg
 {
+    struct ResolutionContext::Impl
+    {
+        // The dependencies of one feature of a package in the classic graph, once its dep info vars are loaded
+        struct ClassicFeatureEdges
+        {
+            const SourceControlFileAndLocation* scfl;
+            std::vector<FeatureSpec> dependencies;
+            std::vector<std::pair<PackageSpec, Version>> version_constraints;
+        };
+
+        struct DepSpec
+        {
+            PackageSpec spec;
+            DependencyConstraint dc;
+            std::vector<DependencyRequestedFeature> features;
+        };
+
+        // The dependencies of one feature of a package in the versioned graph
+        struct VersionedFeatureEdges
+        {
+            const SourceControlFileAndLocation* scfl;
+            // false if this version of the port has no such feature
+            bool exists = false;
+            std::vector<FeatureSpec> dependencies;
+            std::vector<DepSpec> dep_specs;
+        };
+
+        void bind(const PortFileProvider& port_provider,
+                  const CMakeVars::CMakeVarProvider& var_provider,
+                  Triplet host_triplet)
+        {
+            bind_providers({&port_provider, nullptr, nullptr, nullptr}, var_provider, host_triplet);
+        }
+
+        void bind(const IVersionedPortfileProvider& ver_provider,
+                  const IBaselineProvider& base_provider,
+                  const IOverlayProvider& o_provider,
+                  const CMakeVars::CMakeVarProvider& var_provider,
+                  Triplet host_triplet)
+        {
+            bind_providers({nullptr, &ver_provider, &base_provider, &o_provider}, var_provider, host_triplet);
+        }
+
+        const PlatformExpression::ResolvedContext& platform_context(const PackageSpec& spec)
+        {
+            auto it = m_platform_contexts.find(spec);
+            if (it == m_platform_contexts.end())
+            {
+                it = m_platform_contexts
+                         .emplace(spec,
+                                  PlatformExpression::resolve_context(
+                                      m_var_provider->get_or_load_dep_info_vars(spec, m_host_triplet)))
+                         .first;
+            }
+
+            return it->second;
+        }
+
+        const VersionKey& version_key(const SourceControlFileAndLocation* scfl)
+        {
+            auto it = m_version_keys.find(scfl);
+            if (it == m_version_keys.end())
+            {
+                it = m_version_keys
+                         .emplace(scfl, VersionKey::try_parse(scfl->schemed_version()).value_or_exit(VCPKG_LINE_INFO))
+                         .first;
+            }
+
+            return it->second;
+        }
+
+        const ExpectedL<const SourceControlFileAndLocation&>& version_scfl(const VersionSpec& version_spec)
+        {
+            auto it = m_version_scfls.find(version_spec);
+            if (it == m_version_scfls.end())
+            {
+                it = m_version_scfls.emplace(version_spec, m_providers.ver->get_control_file(version_spec)).first;
+            }
+
+            return it->second;
+        }
+
+        bool has_version_scfl(const VersionSpec& version_spec) const
+        {
+            return m_version_scfls.find(version_spec) != m_version_scfls.end();
+        }
+
+        // Loads the manifests of `version_specs` that haven't been loaded yet together; see
+        // IVersionedPortfileProvider::prefetch
+        void prefetch(std::vector<VersionSpec>& version_specs)
+        {
+            Util::erase_remove_if(version_specs,
+                                  [this](const VersionSpec& version_spec) { return has_version_scfl(version_spec); });
+            if (!version_specs.empty())
+            {
+                m_providers.ver->prefetch(version_specs);
+            }
+        }
+
+        const ExpectedL<Version>& baseline_version(const std::string& name)
+        {
+            auto it = m_baseline_versions.find(name);
+            if (it == m_baseline_versions.end())
+            {
+                it = m_baseline_versions.emplace(name, m_providers.base->get_baseline_version(name)).first;
+            }
+
+            return it->second;
+        }
+
+        const ExpectedL<const SourceControlFileAndLocation&>& baseline_scfl(const std::string& name)
+        {
+            auto it = m_baseline_scfls.find(name);
+            if (it == m_baseline_scfls.end())
+            {
+                auto maybe_scfl = baseline_version(name).then(
+                    [&](const Version& ver) -> ExpectedL<const SourceControlFileAndLocation&> {
+                        return version_scfl({name, ver});
+                    });
+                it = m_baseline_scfls.emplace(name, std::move(maybe_scfl)).first;
+            }
+
+            return it->second;
+        }
+
+        // The returned edges are only valid until the next call
+        template<class Compute>
+        const ClassicFeatureEdges& classic_feature_edges(const FeatureSpec& spec,
+                                                         const SourceControlFileAndLocation& scfl,
+                                                         Compute compute)
+        {
+            return find_or_compute(m_classic_edges, spec, scfl, compute);
+        }
+
+        // The returned edges are only valid until the next call
+        template<class Compute>
+        const VersionedFeatureEdges& versioned_feature_edges(const FeatureSpec& spec,
+                                                             const SourceControlFileAndLocation& scfl,
+                                                             Compute compute)
+        {
+            return find_or_compute(m_versioned_edges, spec, scfl, compute);
+        }
+
+    private:
+        struct Providers
+        {
+            const PortFileProvider* port;
+            const IVersionedPortfileProvider* ver;
+            const IBaselineProvider* base;
+            const IOverlayProvider* overlay;
+
+            bool operator==(const Providers& other) const
+            {
+                return port == other.port && ver == other.ver && base == other.base && overlay == other.overlay;
+            }
+        };
+
+        void bind_providers(const Providers& providers,
+                            const CMakeVars::CMakeVarProvider& var_provider,
+                            Triplet host_triplet)
+        {
+            if (!m_var_provider)
+            {
+                m_providers = providers;
+                m_var_provider = &var_provider;
+                m_host_triplet = host_triplet;
+                return;
+            }
+
+            // everything cached here depends on the providers and host triplet
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               m_providers == providers && m_var_provider == &var_provider &&
+                                   m_host_triplet == host_triplet);
+        }
+
+        // Each package version has one edges entry per feature, replaced when a plan selects another version
+        template<class Edges, class Compute>
+        static const Edges& find_or_compute(std::unordered_map<FeatureSpec, Edges>& cache,
+                                            const FeatureSpec& spec,
+                                            const SourceControlFileAndLocation& scfl,
+                                            Compute& compute)
+        {
+            auto it = cache.find(spec);
+            if (it == cache.end())
+            {
+                it = cache.emplace(spec, compute()).first;
+            }
+            else if (it->second.scfl != &scfl)
+            {
+                it->second = compute();
+            }
+
+            return it->second;
+        }
+
+        Providers m_providers{};
+        const CMakeVars::CMakeVarProvider* m_var_provider = nullptr;
+        Triplet m_host_triplet;
+
+        std::unordered_map<PackageSpec, PlatformExpression::ResolvedContext> m_platform_contexts;
+        // the parsed version of each scfl that has been compared, so that each version is only parsed once
+        std::unordered_map<const SourceControlFileAndLocation*, VersionKey> m_version_keys;
+        std::unordered_map<VersionSpec, ExpectedL<const SourceControlFileAndLocation&>, VersionSpecHasher>
+            m_version_scfls;
+        std::unordered_map<std::string, ExpectedL<Version>> m_baseline_versions;
+        std::unordered_map<std::string, ExpectedL<const SourceControlFileAndLocation&>> m_baseline_scfls;
+        std::unordered_map<FeatureSpec, ClassicFeatureEdges> m_classic_edges;
+        std::unordered_map<FeatureSpec, VersionedFeatureEdges> m_versioned_edges;
+    };
+
+    ResolutionContext::ResolutionContext() : m_impl(std::make_unique<Impl>()) { }
+    ResolutionContext::~ResolutionContext() = default;
+
     namespace
     {
         struct ClusterGraph;
@@ -92,6 +309,7 @@ namespace vcpkg
             // Precondition: must have called "mark_for_reinstall()" or "create_install_info()" on this cluster
             void add_feature(const std::string& feature,
                              const CMakeVars::CMakeVarProvider& var_provider,
+                             ResolutionContext::Impl& context,
                              std::vector<FeatureSpec>& out_new_dependencies,
                              Triplet host_triplet)
             {
@@ -105,12 +323,13 @@ namespace vcpkg
                         if (Util::any_of(scfl.source_control_file->core_paragraph->default_features,
                                          [](const auto& feature) { return !feature.platform.is_empty(); }))
                         {
-                            if (auto maybe_vars = var_provider.get_dep_info_vars(m_spec))
+                            if (var_provider.get_dep_info_vars(m_spec).has_value())
                             {
                                 info.defaults_requested = true;
+                                const auto& platform_context = context.platform_context(m_spec);
                                 for (auto&& f : scfl.source_control_file->core_paragraph->default_features)
                                 {
-                                    if (f.platform.evaluate(maybe_vars.value_or_exit(VCPKG_LINE_INFO)))
+                                    if (f.platform.evaluate(platform_context))
                                     {
                                         info.default_features.push_back(f.name);
                                     }
@@ -177,33 +396,45 @@ namespace vcpkg
                 const std::vector<Dependency>* qualified_deps = &maybe_qualified_deps.value_or_exit(VCPKG_LINE_INFO);
 
                 std::vector<FeatureSpec> dep_list;
-                if (auto vars = maybe_vars.get())
+                if (maybe_vars.has_value())
                 {
                     // Qualified dependency resolution is available
-                    for (auto&& dep : *qualified_deps)
-                    {
-                        if (dep.platform.evaluate(*vars))
+                    const auto& edges = context.classic_feature_edges(FeatureSpec{m_spec, feature}, scfl, [&] {
+                        ResolutionContext::Impl::ClassicFeatureEdges result{&scfl};
+                        const auto& platform_context = context.platform_context(m_spec);
+                        for (auto&& dep : *qualified_deps)
                         {
-                            std::vector<std::string> features;
-                            features.reserve(dep.features.size());
-                            for (const auto& f : dep.features)
+                            if (dep.platform.evaluate(platform_context))
                             {
-                                if (f.platform.evaluate(*vars))
+                                std::vector<std::string> features;
+                                features.reserve(dep.features.size());
+                                for (const auto& f : dep.features)
                                 {
-                                    features.push_back(f.name);
+                                    if (f.platform.evaluate(platform_context))
+                                    {
+                                        features.push_back(f.name);
+                                    }
+                                }
+                                auto fullspec = dep.to_full_spec(features, m_spec.triplet(), host_triplet);
+                                fullspec.expand_fspecs_to(result.dependencies);
+                                if (auto opt = dep.constraint.try_get_minimum_version())
+                                {
+                                    result.version_constraints.emplace_back(
+                                        fullspec.package_spec, std::move(opt).value_or_exit(VCPKG_LINE_INFO));
                                 }
-                            }
-                            auto fullspec = dep.to_full_spec(features, m_spec.triplet(), host_triplet);
-                            fullspec.expand_fspecs_to(dep_list);
-                            if (auto opt = dep.constraint.try_get_minimum_version())
-                            {
-                                info.version_constraints[fullspec.package_spec].insert(
-                                    std::move(opt).value_or_exit(VCPKG_LINE_INFO));
                             }
                         }
+
+                        Util::sort_unique_erase(result.dependencies);
+                        return result;
+                    });
+
+                    for (auto&& constraint : edges.version_constraints)
+                    {
+                        info.version_constraints[constraint.first].insert(constraint.second);
                     }
 
-                    Util::sort_unique_erase(dep_list);
+                    dep_list = edges.dependencies;
                     info.build_edges.emplace(feature, dep_list);
                 }
                 else
@@ -336,7 +567,8 @@ namespace vcpkg
                          const CMakeVars::CMakeVarProvider& var_provider,
                          const StatusParagraphs& status_db,
                          Triplet host_triplet,
-                         PackagesDirAssigner& packages_dir_assigner);
+                         PackagesDirAssigner& packages_dir_assigner,
+                         ResolutionContext* resolution_context);
             ~PackageGraph() = default;
 
             void install(Span<const FeatureSpec> specs, UnsupportedPortAction unsupported_port_action);
@@ -350,6 +582,9 @@ namespace vcpkg
             void mark_for_reinstall(const PackageSpec& spec,
                                     std::vector<FeatureSpec>& out_reinstall_requirements) const;
             const CMakeVars::CMakeVarProvider& m_var_provider;
+            // used when the caller doesn't share a context
+            ResolutionContext m_local_context;
+            ResolutionContext::Impl& m_context;
 
             std::unique_ptr<ClusterGraph> m_graph;
             PackagesDirAssigner& m_packages_dir_assigner;
@@ -376,28 +611,23 @@ namespace vcpkg
             /// <returns>The cluster found or created for spec.</returns>
             Cluster& get(const PackageSpec& spec)
             {
-                auto it = m_graph.find(spec);
-                if (it == m_graph.end())
+                auto maybe_id = m_ids.find(spec);
+                if (auto id = maybe_id.get())
                 {
-                    auto maybe_scfl = m_port_provider.get_control_file(spec.name());
-                    if (auto scfl = maybe_scfl.get())
-                    {
-                        it = m_graph
-                                 .emplace(std::piecewise_construct,
-                                          std::forward_as_tuple(spec),
-                                          std::forward_as_tuple(spec, *scfl))
-                                 .first;
-                    }
-                    else
-                    {
-                        Checks::msg_exit_with_error(VCPKG_LINE_INFO,
-                                                    msg::format(msgWhileLookingForSpec, msg::spec = spec)
-                                                        .append_raw('\n')
-                                                        .append_raw(maybe_scfl.error()));
-                    }
+                    return m_clusters[*id];
                 }
 
-                return it->second;
+                auto maybe_scfl = m_port_provider.get_control_file(spec.name());
+                if (auto scfl = maybe_scfl.get())
+                {
+                    m_ids.add(spec);
+                    return m_clusters.emplace_back(spec, *scfl);
+                }
+
+                Checks::msg_exit_with_error(VCPKG_LINE_INFO,
+                                            msg::format(msgWhileLookingForSpec, msg::spec = spec)
+                                                .append_raw('\n')
+                                                .append_raw(maybe_scfl.error()));
             }
 
             Cluster& insert(const InstalledPackageView& ipv)
@@ -405,25 +635,42 @@ namespace vcpkg
                 ExpectedL<const SourceControlFileAndLocation&> maybe_scfl =
                     m_port_provider.get_control_file(ipv.spec().name());
 
-                return m_graph
-                    .emplace(std::piecewise_construct,
-                             std::forward_as_tuple(ipv.spec()),
-                             std::forward_as_tuple(ipv, std::move(maybe_scfl)))
-                    .first->second;
+                auto added = m_ids.add(ipv.spec());
+                if (!added.second)
+                {
+                    return m_clusters[added.first];
+                }
+
+                return m_clusters.emplace_back(ipv, std::move(maybe_scfl));
             }
 
-            const Cluster& find_or_exit(const PackageSpec& spec, LineInfo li) const
+            std::size_t id_or_exit(const PackageSpec& spec, LineInfo li) const
             {
-                auto it = m_graph.find(spec);
-                Checks::msg_check_exit(li, it != m_graph.end(), msgFailedToLocateSpec, msg::spec = spec);
-                return it->second;
+                auto maybe_id = m_ids.find(spec);
+                auto id = maybe_id.get();
+                Checks::msg_check_exit(li, id != nullptr, msgFailedToLocateSpec, msg::spec = spec);
+                return *id;
             }
 
-            auto begin() const { return m_graph.begin(); }
-            auto end() const { return m_graph.end(); }
+            std::size_t size() const noexcept { return m_clusters.size(); }
+
+            const Cluster& at(std::size_t id) const { return m_clusters[id]; }
+
+            // Returns the number of every cluster, ordered by spec
+            std::vector<std::size_t> sorted_ids() const
+            {
+                std::vector<std::size_t> result(m_clusters.size());
+                std::iota(result.begin(), result.end(), std::size_t{0});
+                std::sort(result.begin(), result.end(), [this](std::size_t lhs, std::size_t rhs) {
+                    return m_clusters[lhs].m_spec < m_clusters[rhs].m_spec;
+                });
+                return result;
+            }
 
         private:
-            std::map<PackageSpec, Cluster> m_graph;
+            PackageIds m_ids;
+            // indexed by the numbers in m_ids; a deque so that references to clusters stay valid as more are added
+            std::deque<Cluster> m_clusters;
             const PortFileProvider& m_port_provider;
 
         public:
@@ -484,9 +731,10 @@ namespace vcpkg
         return {specs.begin(), specs.end()};
     }
 
-    static InternalFeatureSet fdeps_to_feature_list(const std::map<std::string, std::vector<FeatureSpec>>& fdeps)
+    static std::vector<std::string> fdeps_to_feature_list(
+        const std::map<std::string, std::vector<FeatureSpec>>& fdeps)
     {
-        InternalFeatureSet ret;
+        std::vector<std::string> ret;
         for (auto&& d : fdeps)
         {
             ret.push_back(d.first);
@@ -494,6 +742,17 @@ namespace vcpkg
         return ret;
     }
 
+    static std::map<std::string, SharedVector<FeatureSpec>> to_shared_fdeps(
+        std::map<std::string, std::vector<FeatureSpec>>&& fdeps)
+    {
+        std::map<std::string, SharedVector<FeatureSpec>> ret;
+        for (auto&& d : fdeps)
+        {
+            ret.emplace_hint(ret.end(), d.first, std::move(d.second));
+        }
+        return ret;
+    }
+
     InstallPlanAction::InstallPlanAction(InstalledPackageView&& ipv,
                                          RequestType request_type,
                                          UseHeadVersion use_head_version,
@@ -504,7 +763,7 @@ namespace vcpkg
         , request_type(request_type)
         , use_head_version(use_head_version)
         , editable(editable)
-        , feature_dependencies(installed_package.get()->feature_dependencies())
+        , feature_dependencies(to_shared_fdeps(installed_package.get()->feature_dependencies()))
     {
     }
 
@@ -524,7 +783,7 @@ namespace vcpkg
         , request_type(request_type)
         , use_head_version(use_head_version)
         , editable(editable)
-        , feature_dependencies(std::move(dependencies))
+        , feature_dependencies(to_shared_fdeps(std::move(dependencies)))
         , build_failure_messages(std::move(build_failure_messages))
         , package_dir(packages_dir_assigner.generate(spec))
     {
@@ -581,7 +840,7 @@ namespace vcpkg
     std::string InstallPlanAction::display_name() const
     {
         auto version = this->version();
-        if (this->feature_list.empty_or_only_core())
+        if (empty_or_only_core(feature_list))
         {
             return fmt::format("{}@{}", this->spec.to_string(), version);
         }
@@ -626,6 +885,44 @@ namespace vcpkg
         }
     }
 
+    namespace
+    {
+        // Collects one copy of each distinct list, so that equal lists can be replaced by that copy
+        template<class Ty>
+        struct SharedVectorPool
+        {
+            void share(SharedVector<Ty>& values)
+            {
+                if (!values.empty())
+                {
+                    values = *m_lists.insert(values).first;
+                }
+            }
+
+        private:
+            std::set<SharedVector<Ty>> m_lists;
+        };
+    }
+
+    void ActionPlan::share_dependency_lists()
+    {
+        SharedVectorPool<PackageSpec> package_lists;
+        SharedVectorPool<std::string> feature_lists;
+        SharedVectorPool<FeatureSpec> feature_spec_lists;
+        for (auto* actions : {&already_installed, &install_actions})
+        {
+            for (auto&& action : *actions)
+            {
+                package_lists.share(action.package_dependencies);
+                feature_lists.share(action.feature_list);
+                for (auto&& fdeps : action.feature_dependencies)
+                {
+                    feature_spec_lists.share(fdeps.second);
+                }
+            }
+        }
+    }
+
     ExportPlanAction::ExportPlanAction(const PackageSpec& spec,
                                        InstalledPackageView&& installed_package,
                                        RequestType request_type)
@@ -668,34 +965,45 @@ namespace vcpkg
 
     RemovePlan create_remove_plan(const std::vector<PackageSpec>& specs, const StatusParagraphs& status_db)
     {
-        struct RemoveAdjacencyProvider final : AdjacencyProvider<PackageSpec, PackageSpec>
-        {
-            std::unordered_map<PackageSpec, std::vector<PackageSpec>> rev_edges;
-
-            std::vector<PackageSpec> adjacency_list(const PackageSpec& spec) const override
+        // Every installed package and every dependency of one is numbered first; requested packages numbered after
+        // them are not installed
+        PackageIds ids;
+        std::vector<PackageSpec> vertex_specs;
+        const auto add_vertex = [&](const PackageSpec& spec) {
+            auto added = ids.add(spec);
+            if (added.second)
             {
-                return Util::copy_or_default(rev_edges, spec);
+                vertex_specs.push_back(spec);
             }
 
-            PackageSpec load_vertex_data(const PackageSpec& s) const override { return s; }
+            return added.first;
         };
 
-        RemoveAdjacencyProvider p;
+        std::vector<std::pair<std::size_t, std::size_t>> rev_edges;
         for (auto&& a : get_installed_ports(status_db))
         {
-            p.rev_edges.emplace(a.spec(), std::initializer_list<PackageSpec>{});
+            const auto a_id = add_vertex(a.spec());
             for (auto&& b : a.dependencies())
             {
-                p.rev_edges[b].push_back(a.spec());
+                rev_edges.emplace_back(add_vertex(b), a_id);
             }
         }
-        auto remove_order = topological_sort(specs, p, nullptr);
+
+        const auto known_count = vertex_specs.size();
+        const auto starting_vertices = Util::fmap(specs, add_vertex);
+        const auto remove_order = topological_sort(
+            AdjacencyArrays::from_edges(vertex_specs.size(), rev_edges), starting_vertices, nullptr);
+        if (!remove_order.cycle.empty())
+        {
+            exit_graph_cycle(remove_order.cycle, [&](std::size_t id) { return vertex_specs[id].to_string(); });
+        }
 
         const std::unordered_set<PackageSpec> requested(specs.cbegin(), specs.cend());
         RemovePlan plan;
-        for (auto&& step : remove_order)
+        for (auto id : remove_order.sorted)
         {
-            if (p.rev_edges.find(step) != p.rev_edges.end())
+            auto&& step = vertex_specs[id];
+            if (id < known_count)
             {
                 // installed
                 plan.remove.emplace_back(step,
@@ -713,41 +1021,53 @@ namespace vcpkg
     std::vector<ExportPlanAction> create_export_plan(const std::vector<PackageSpec>& specs,
                                                      const StatusParagraphs& status_db)
     {
-        struct ExportAdjacencyProvider final : AdjacencyProvider<PackageSpec, ExportPlanAction>
-        {
-            const StatusParagraphs& status_db;
-            const std::unordered_set<PackageSpec>& specs_as_set;
-
-            ExportAdjacencyProvider(const StatusParagraphs& s, const std::unordered_set<PackageSpec>& specs_as_set)
-                : status_db(s), specs_as_set(specs_as_set)
-            {
-            }
-
-            std::vector<PackageSpec> adjacency_list(const ExportPlanAction& plan) const override
-            {
-                return plan.dependencies();
-            }
+        const std::unordered_set<PackageSpec> specs_as_set(specs.cbegin(), specs.cend());
 
-            ExportPlanAction load_vertex_data(const PackageSpec& spec) const override
+        // Numbers each package reachable from `specs` in the order it is found, breadth first
+        PackageIds ids;
+        std::vector<ExportPlanAction> actions;
+        const auto add_vertex = [&](const PackageSpec& spec) {
+            auto added = ids.add(spec);
+            if (added.second)
             {
                 const RequestType request_type =
                     Util::Sets::contains(specs_as_set, spec) ? RequestType::USER_REQUESTED : RequestType::AUTO_SELECTED;
 
                 auto maybe_ipv = status_db.get_installed_package_view(spec);
-
                 if (auto p_ipv = maybe_ipv.get())
                 {
-                    return ExportPlanAction{spec, std::move(*p_ipv), request_type};
+                    actions.emplace_back(spec, std::move(*p_ipv), request_type);
+                }
+                else
+                {
+                    actions.emplace_back(spec, request_type);
                 }
-
-                return ExportPlanAction{spec, request_type};
             }
+
+            return added.first;
         };
 
-        const std::unordered_set<PackageSpec> specs_as_set(specs.cbegin(), specs.cend());
-        std::vector<ExportPlanAction> toposort =
-            topological_sort(specs, ExportAdjacencyProvider{status_db, specs_as_set}, {});
-        return toposort;
+        const auto starting_vertices = Util::fmap(specs, add_vertex);
+        AdjacencyArrays graph;
+        std::vector<std::size_t> adjacent;
+        for (std::size_t id = 0; id < actions.size(); ++id)
+        {
+            adjacent.clear();
+            for (auto&& dependency : actions[id].dependencies())
+            {
+                adjacent.push_back(add_vertex(dependency));
+            }
+
+            graph.add_vertex(adjacent);
+        }
+
+        const auto toposort = topological_sort(graph, starting_vertices, nullptr);
+        if (!toposort.cycle.empty())
+        {
+            exit_graph_cycle(toposort.cycle, [&](std::size_t id) { return actions[id].spec.to_string(); });
+        }
+
+        return Util::fmap(toposort.sorted, [&](std::size_t id) { return std::move(actions[id]); });
     }
 
     void PackageGraph::mark_user_requested(const PackageSpec& spec)
@@ -762,7 +1082,12 @@ namespace vcpkg
                                            PackagesDirAssigner& packages_dir_assigner,
                                            const CreateInstallPlanOptions& options)
     {
-        PackageGraph pgraph(port_provider, var_provider, status_db, options.host_triplet, packages_dir_assigner);
+        PackageGraph pgraph(port_provider,
+                            var_provider,
+                            status_db,
+                            options.host_triplet,
+                            packages_dir_assigner,
+                            options.resolution_context);
 
         std::vector<FeatureSpec> feature_specs;
         for (const FullPackageSpec& spec : specs)
@@ -882,8 +1207,7 @@ namespace vcpkg
                     auto supports_expression = maybe_supports_expression.get();
                     if (supports_expression && !supports_expression->is_empty())
                     {
-                        if (!supports_expression->evaluate(
-                                m_var_provider.get_dep_info_vars(spec.spec()).value_or_exit(VCPKG_LINE_INFO)))
+                        if (!supports_expression->evaluate(m_context.platform_context(spec.spec())))
                         {
                             const auto supports_expression_text = to_string(*supports_expression);
                             if (unsupported_port_action == UnsupportedPortAction::Error)
@@ -903,14 +1227,16 @@ namespace vcpkg
 
                 if (clust.m_install_info.has_value())
                 {
-                    clust.add_feature(spec.feature(), m_var_provider, next_dependencies, m_graph->m_host_triplet);
+                    clust.add_feature(
+                        spec.feature(), m_var_provider, m_context, next_dependencies, m_graph->m_host_triplet);
                 }
                 else
                 {
                     if (!clust.m_installed.has_value())
                     {
                         clust.create_install_info(next_dependencies);
-                        clust.add_feature(spec.feature(), m_var_provider, next_dependencies, m_graph->m_host_triplet);
+                        clust.add_feature(
+                            spec.feature(), m_var_provider, m_context, next_dependencies, m_graph->m_host_triplet);
                     }
                     else
                     {
@@ -931,8 +1257,11 @@ namespace vcpkg
                             // which hasn't already been installed to this cluster. In this case, we need to reinstall
                             // the port if the feature isn't already present.
                             mark_for_reinstall(spec.spec(), next_dependencies);
-                            clust.add_feature(
-                                spec.feature(), m_var_provider, next_dependencies, m_graph->m_host_triplet);
+                            clust.add_feature(spec.feature(),
+                                              m_var_provider,
+                                              m_context,
+                                              next_dependencies,
+                                              m_graph->m_host_triplet);
                         }
                     }
                 }
@@ -978,7 +1307,8 @@ namespace vcpkg
                                    PackagesDirAssigner& packages_dir_assigner,
                                    const CreateUpgradePlanOptions& options)
     {
-        PackageGraph pgraph(port_provider, var_provider, status_db, options.host_triplet, packages_dir_assigner);
+        PackageGraph pgraph(
+            port_provider, var_provider, status_db, options.host_triplet, packages_dir_assigner, nullptr);
 
         pgraph.upgrade(specs, options.unsupported_port_action);
 
@@ -989,75 +1319,87 @@ namespace vcpkg
                                        UseHeadVersion use_head_version_if_user_requested,
                                        Editable editable_if_user_requested) const
     {
-        struct BaseEdgeProvider : AdjacencyProvider<PackageSpec, const Cluster*>
+        // Both graphs are of every cluster, numbered as in m_graph
+        AdjacencyArrays remove_graph;
+        AdjacencyArrays install_graph;
+        std::vector<std::size_t> adjacent;
+        for (std::size_t id = 0; id < m_graph->size(); ++id)
         {
-            BaseEdgeProvider(const ClusterGraph& parent) : m_parent(parent) { }
-
-            const Cluster* load_vertex_data(const PackageSpec& spec) const override
+            const Cluster& cluster = m_graph->at(id);
+            adjacent.clear();
+            if (auto installed = cluster.m_installed.get())
             {
-                return &m_parent.find_or_exit(spec, VCPKG_LINE_INFO);
-            }
-
-            const ClusterGraph& m_parent;
-        };
-
-        struct RemoveEdgeProvider final : BaseEdgeProvider
-        {
-            using BaseEdgeProvider::BaseEdgeProvider;
-
-            std::vector<PackageSpec> adjacency_list(const Cluster* const& vertex) const override
-            {
-                auto&& set = vertex->m_installed.value_or_exit(VCPKG_LINE_INFO).remove_edges;
-                return {set.begin(), set.end()};
+                for (auto&& spec : installed->remove_edges)
+                {
+                    adjacent.push_back(m_graph->id_or_exit(spec, VCPKG_LINE_INFO));
+                }
             }
-        } removeedgeprovider(*m_graph);
-
-        struct InstallEdgeProvider final : BaseEdgeProvider
-        {
-            using BaseEdgeProvider::BaseEdgeProvider;
 
-            std::vector<PackageSpec> adjacency_list(const Cluster* const& vertex) const override
+            remove_graph.add_vertex(adjacent);
+            adjacent.clear();
+            if (auto info = cluster.m_install_info.get())
             {
-                if (!vertex->m_install_info.has_value()) return {};
-
-                auto& info = vertex->m_install_info.value_or_exit(VCPKG_LINE_INFO);
-                std::vector<PackageSpec> deps;
-                for (auto&& kv : info.build_edges)
+                for (auto&& kv : info->build_edges)
+                {
                     for (auto&& e : kv.second)
                     {
                         auto spec = e.spec();
-                        if (spec != vertex->m_spec) deps.push_back(std::move(spec));
+                        if (spec != cluster.m_spec)
+                        {
+                            adjacent.push_back(m_graph->id_or_exit(spec, VCPKG_LINE_INFO));
+                        }
                     }
-                Util::sort_unique_erase(deps);
-                return deps;
+                }
+
+                // dependencies are visited in order of their specs
+                std::sort(adjacent.begin(), adjacent.end(), [&](std::size_t lhs, std::size_t rhs) {
+                    return m_graph->at(lhs).m_spec < m_graph->at(rhs).m_spec;
+                });
+                adjacent.erase(std::unique(adjacent.begin(), adjacent.end()), adjacent.end());
             }
-        } installedgeprovider(*m_graph);
 
-        std::vector<PackageSpec> removed_vertices;
-        std::vector<PackageSpec> installed_vertices;
-        for (auto&& kv : *m_graph)
+            install_graph.add_vertex(adjacent);
+        }
+
+        std::vector<std::size_t> removed_vertices;
+        std::vector<std::size_t> installed_vertices;
+        for (auto id : m_graph->sorted_ids())
         {
-            if (kv.second.m_install_info.has_value() && kv.second.m_installed.has_value())
+            const Cluster& cluster = m_graph->at(id);
+            if (cluster.m_install_info.has_value() && cluster.m_installed.has_value())
             {
-                removed_vertices.push_back(kv.first);
+                removed_vertices.push_back(id);
             }
-            if (kv.second.m_install_info.has_value() || kv.second.request_type == RequestType::USER_REQUESTED)
+            if (cluster.m_install_info.has_value() || cluster.request_type == RequestType::USER_REQUESTED)
             {
-                installed_vertices.push_back(kv.first);
+                installed_vertices.push_back(id);
             }
         }
-        auto remove_toposort = topological_sort(removed_vertices, removeedgeprovider, randomizer);
-        auto insert_toposort = topological_sort(installed_vertices, installedgeprovider, randomizer);
+
+        const auto cluster_name = [&](std::size_t id) { return m_graph->at(id).m_spec.to_string(); };
+        const auto remove_toposort = topological_sort(remove_graph, removed_vertices, randomizer);
+        if (!remove_toposort.cycle.empty())
+        {
+            exit_graph_cycle(remove_toposort.cycle, cluster_name);
+        }
+
+        const auto insert_toposort = topological_sort(install_graph, installed_vertices, randomizer);
+        if (!insert_toposort.cycle.empty())
+        {
+            exit_graph_cycle(insert_toposort.cycle, cluster_name);
+        }
 
         ActionPlan plan;
 
-        for (const auto* p_cluster : remove_toposort)
+        for (auto id : remove_toposort.sorted)
         {
+            const Cluster* p_cluster = &m_graph->at(id);
             plan.remove_actions.emplace_back(p_cluster->m_spec, p_cluster->request_type);
         }
 
-        for (const auto* p_cluster : insert_toposort)
+        for (auto id : insert_toposort.sorted)
         {
+            const Cluster* p_cluster = &m_graph->at(id);
             // Every cluster that has an install_info needs to be built
             // If a cluster only has an installed object and is marked as user requested we should still report it.
             if (auto info_ptr = p_cluster->m_install_info.get())
@@ -1153,6 +1495,7 @@ namespace vcpkg
             }
         }
         plan.unsupported_features = m_unsupported_features;
+        plan.share_dependency_lists();
         return plan;
     }
 
@@ -1196,11 +1539,14 @@ namespace vcpkg
                                const CMakeVars::CMakeVarProvider& var_provider,
                                const StatusParagraphs& status_db,
                                Triplet host_triplet,
-                               PackagesDirAssigner& packages_dir_assigner)
+                               PackagesDirAssigner& packages_dir_assigner,
+                               ResolutionContext* resolution_context)
         : m_var_provider(var_provider)
+        , m_context(resolution_context ? resolution_context->impl() : m_local_context.impl())
         , m_graph(create_feature_install_graph(port_provider, status_db, host_triplet))
         , m_packages_dir_assigner(packages_dir_assigner)
     {
+        m_context.bind(port_provider, var_provider, host_triplet);
     }
 
     static void format_plan_block(LocalizedString& msg,
@@ -1379,15 +1725,16 @@ namespace vcpkg
                                   const CMakeVars::CMakeVarProvider& var_provider,
                                   const PackageSpec& toplevel,
                                   Triplet host_triplet,
-                                  PackagesDirAssigner& packages_dir_assigner)
-                : m_ver_provider(ver_provider)
-                , m_base_provider(base_provider)
-                , m_o_provider(oprovider)
+                                  PackagesDirAssigner& packages_dir_assigner,
+                                  ResolutionContext* resolution_context)
+                : m_o_provider(oprovider)
                 , m_var_provider(var_provider)
                 , m_toplevel(toplevel)
                 , m_host_triplet(host_triplet)
                 , m_packages_dir_assigner(packages_dir_assigner)
+                , m_context(resolution_context ? resolution_context->impl() : m_local_context.impl())
             {
+                m_context.bind(ver_provider, base_provider, oprovider, var_provider, host_triplet);
             }
 
             void add_override(const std::string& name, const Version& v);
@@ -1399,36 +1746,30 @@ namespace vcpkg
                                                         Editable editable_if_user_requested);
 
         private:
-            const IVersionedPortfileProvider& m_ver_provider;
-            const IBaselineProvider& m_base_provider;
             const IOverlayProvider& m_o_provider;
             const CMakeVars::CMakeVarProvider& m_var_provider;
             const PackageSpec& m_toplevel;
             const Triplet m_host_triplet;
             PackagesDirAssigner& m_packages_dir_assigner;
+            // used when the caller doesn't share a context
+            ResolutionContext m_local_context;
+            // versioned manifests and baselines are looked up through the context
+            ResolutionContext::Impl& m_context;
 
-            struct DepSpec
-            {
-                PackageSpec spec;
-                DependencyConstraint dc;
-                std::vector<DependencyRequestedFeature> features;
-            };
+            using DepSpec = ResolutionContext::Impl::DepSpec;
 
             struct PackageNodeData
             {
-                // set of all scfls that have been considered
-                std::set<const SourceControlFileAndLocation*> considered;
+                // all scfls that have been considered; there are only ever a few
+                std::vector<const SourceControlFileAndLocation*> considered;
 
                 // Versions occluded by the baseline constraint are not considered.
-                SchemedVersion baseline;
-                // If overlay_or_override is true, ignore scheme and baseline_version
+                const SourceControlFileAndLocation* baseline = nullptr;
+                // If overlay_or_override is true, ignore scheme and baseline
                 bool overlay_or_override = false;
                 // The current "best" scfl
                 const SourceControlFileAndLocation* scfl = nullptr;
 
-                // This tracks a list of constraint sources for debugging purposes
-                std::set<std::string> origins;
-
                 // The set of features that have been requested across all constraints
                 std::set<std::string> requested_features;
                 bool default_features = false;
@@ -1441,11 +1782,13 @@ namespace vcpkg
             // direct dependencies in unevaluated form
             std::vector<DepSpec> m_roots;
             // set of direct dependencies
-            std::set<PackageSpec> m_user_requested;
-            // mapping from { package specifier -> node containing resolution information for that package }
-            std::map<PackageSpec, PackageNodeData> m_graph;
+            std::unordered_set<PackageSpec> m_user_requested;
+            // the number of each package in m_graph
+            PackageIds m_ids;
+            // nodes containing resolution information for each package, indexed by the numbers in m_ids
+            std::deque<PackageNode> m_graph;
             // the set of nodes that could not be constructed in the graph due to failures
-            std::set<std::string> m_failed_nodes;
+            std::unordered_set<std::string> m_failed_nodes;
 
             struct ConstraintFrame
             {
@@ -1453,21 +1796,22 @@ namespace vcpkg
                 View<Dependency> deps;
             };
             std::vector<ConstraintFrame> m_resolve_stack;
+            // the number of frames at the bottom of m_resolve_stack whose port versions have been prefetched
+            std::size_t m_prefetched_frames = 0;
 
             // Add an initial requirement for a package.
             // Returns a reference to the node to place additional constraints
             Optional<PackageNode&> require_package(const PackageSpec& spec, const std::string& origin);
 
-            void require_scfl(PackageNode& ref, const SourceControlFileAndLocation* scfl, const std::string& origin);
+            void require_scfl(PackageNode& ref, const SourceControlFileAndLocation* scfl);
 
-            void require_port_feature(PackageNode& ref, const std::string& feature, const std::string& origin);
+            void require_port_feature(PackageNode& ref, const std::string& feature);
 
-            void require_port_defaults(PackageNode& ref, const std::string& origin);
+            void require_port_defaults(PackageNode& ref);
 
             void resolve_stack(const ConstraintFrame& frame);
             const CMakeVars::CMakeVars& batch_load_vars(const PackageSpec& spec);
-
-            Optional<const PackageNode&> find_package(const PackageSpec& spec) const;
+            void prefetch_versions(const ConstraintFrame& frame);
 
             // For node, for each requested feature existing in the best scfl, calculate the set of package and feature
             // dependencies.
@@ -1505,11 +1849,91 @@ namespace vcpkg
             return *vars.get();
         }
 
+        void VersionedPackageGraph::prefetch_versions(const ConstraintFrame& frame)
+        {
+            // Appends the port versions `from` may require that haven't been loaded: minimum versions, and the
+            // override or baseline version of ports not yet in the graph
+            std::vector<VersionSpec> version_specs;
+            auto append_candidates = [&](const ConstraintFrame& from) {
+                for (auto&& dep : from.deps)
+                {
+                    if (!dep.platform.is_empty())
+                    {
+                        // only dependencies that already evaluate as applicable are worth loading ahead of time
+                        if (!m_var_provider.get_dep_info_vars(from.spec).has_value() ||
+                            !evaluate(from.spec, dep.platform))
+                        {
+                            continue;
+                        }
+                    }
+
+                    // mirror require_package and resolve_stack: the minimum version is only loaded for ports that
+                    // are neither overlaid nor overridden
+                    const PackageSpec dep_spec(dep.name, dep.host ? m_host_triplet : from.spec.triplet());
+                    const auto maybe_id = m_ids.find(dep_spec);
+                    if (auto id = maybe_id.get())
+                    {
+                        if (m_graph[*id].second.overlay_or_override)
+                        {
+                            continue;
+                        }
+                    }
+                    else if (Util::Sets::contains(m_failed_nodes, dep.name) ||
+                             m_o_provider.get_control_file(dep.name).has_value())
+                    {
+                        continue;
+                    }
+                    else if (const auto over_it = m_overrides.find(dep.name); over_it != m_overrides.end())
+                    {
+                        version_specs.emplace_back(dep.name, over_it->second);
+                        continue;
+                    }
+                    else if (auto baseline = m_context.baseline_version(dep.name).get())
+                    {
+                        version_specs.emplace_back(dep.name, *baseline);
+                    }
+                    else
+                    {
+                        // require_package will fail to add this port
+                        continue;
+                    }
+
+                    if (auto dep_ver = dep.constraint.try_get_minimum_version())
+                    {
+                        version_specs.emplace_back(dep.name, std::move(*dep_ver.get()));
+                    }
+                }
+            };
+
+            append_candidates(frame);
+            Util::erase_remove_if(version_specs, [this](const VersionSpec& version_spec) {
+                return m_context.has_version_scfl(version_spec);
+            });
+            if (version_specs.empty())
+            {
+                return;
+            }
+
+            // Loading a port version may read files or git objects, so rather than load what this frame needs one
+            // version at a time, look ahead in the stack and load everything the pending frames need together
+            for (; m_prefetched_frames < m_resolve_stack.size(); ++m_prefetched_frames)
+            {
+                append_candidates(m_resolve_stack[m_prefetched_frames]);
+            }
+
+            m_context.prefetch(version_specs);
+        }
+
         void VersionedPackageGraph::resolve_stack(const ConstraintFrame& frame)
         {
+            prefetch_versions(frame);
             for (auto&& dep : frame.deps)
             {
-                if (!dep.platform.is_empty() && !dep.platform.evaluate(batch_load_vars(frame.spec))) continue;
+                if (!dep.platform.is_empty())
+                {
+                    batch_load_vars(frame.spec);
+                    if (!evaluate(frame.spec, dep.platform)) continue;
+                }
 
                 PackageSpec dep_spec(dep.name, dep.host ? m_host_triplet : frame.spec.triplet());
                 auto maybe_node = require_package(dep_spec, frame.spec.name());
@@ -1522,20 +1946,20 @@ namespace vcpkg
                         const auto maybe_dep_ver = dep.constraint.try_get_minimum_version();
                         if (auto dep_ver = maybe_dep_ver.get())
                         {
-                            auto maybe_scfl = m_ver_provider.get_control_file({dep.name, *dep_ver});
+                            const auto& maybe_scfl = m_context.version_scfl({dep.name, *dep_ver});
                             if (auto p_scfl = maybe_scfl.get())
                             {
-                                const auto sver = p_scfl->schemed_version();
-                                if (compare_versions(node->second.scfl->schemed_version(), sver) == VerComp::lt)
+                                const auto& key = m_context.version_key(p_scfl);
+                                if (compare(m_context.version_key(node->second.scfl), key) == VerComp::lt)
                                 {
                                     // mark as current best and apply constraints
                                     node->second.scfl = p_scfl;
-                                    require_scfl(*node, p_scfl, frame.spec.name());
+                                    require_scfl(*node, p_scfl);
                                 }
-                                else if (compare_versions(node->second.baseline, sver) == VerComp::lt)
+                                else if (compare(m_context.version_key(node->second.baseline), key) == VerComp::lt)
                                 {
                                     // apply constraints
-                                    require_scfl(*node, p_scfl, frame.spec.name());
+                                    require_scfl(*node, p_scfl);
                                 }
                             }
                         }
@@ -1547,20 +1971,19 @@ namespace vcpkg
                         if (f.name == FeatureNameDefault) abort();
                         if (evaluate(frame.spec, f.platform))
                         {
-                            require_port_feature(*node, f.name, frame.spec.name());
+                            require_port_feature(*node, f.name);
                         }
                     }
                     if (dep.default_features)
                     {
-                        require_port_defaults(*node, frame.spec.name());
+                        require_port_defaults(*node);
                     }
                 }
             }
         }
 
-        void VersionedPackageGraph::require_port_defaults(PackageNode& ref, const std::string& origin)
+        void VersionedPackageGraph::require_port_defaults(PackageNode& ref)
         {
-            ref.second.origins.insert(origin);
             if (!ref.second.default_features)
             {
                 ref.second.default_features = true;
@@ -1580,11 +2003,8 @@ namespace vcpkg
                 }
             }
         }
-        void VersionedPackageGraph::require_port_feature(PackageNode& ref,
-                                                         const std::string& feature,
-                                                         const std::string& origin)
+        void VersionedPackageGraph::require_port_feature(PackageNode& ref, const std::string& feature)
         {
-            ref.second.origins.insert(origin);
             auto inserted = ref.second.requested_features.emplace(feature).second;
             if (inserted)
             {
@@ -1597,14 +2017,10 @@ namespace vcpkg
                 }
             }
         }
-        void VersionedPackageGraph::require_scfl(PackageNode& ref,
-                                                 const SourceControlFileAndLocation* scfl,
-                                                 const std::string& origin)
+        void VersionedPackageGraph::require_scfl(PackageNode& ref, const SourceControlFileAndLocation* scfl)
         {
-            ref.second.origins.insert(origin);
-
-            if (Util::Sets::contains(ref.second.considered, scfl)) return;
-            ref.second.considered.insert(scfl);
+            if (Util::Vectors::contains(ref.second.considered, scfl)) return;
+            ref.second.considered.push_back(scfl);
 
             auto features = ref.second.requested_features;
             if (ref.second.default_features)
@@ -1631,91 +2047,88 @@ namespace vcpkg
             }
         }
 
-        Optional<const VersionedPackageGraph::PackageNode&> VersionedPackageGraph::find_package(
-            const PackageSpec& spec) const
-        {
-            auto it = m_graph.find(spec);
-            if (it == m_graph.end()) return nullopt;
-            return *it;
-        }
-
         Optional<VersionedPackageGraph::PackageNode&> VersionedPackageGraph::require_package(const PackageSpec& spec,
                                                                                              const std::string& origin)
         {
             // Implicit defaults are disabled if spec is requested from top-level spec.
             const bool default_features_mask = origin != m_toplevel.name();
 
-            auto it = m_graph.find(spec);
-            if (it != m_graph.end())
+            auto maybe_id = m_ids.find(spec);
+            if (auto id = maybe_id.get())
             {
-                it->second.origins.insert(origin);
-                it->second.default_features &= default_features_mask;
-                return *it;
+                auto& node = m_graph[*id];
+                node.second.default_features &= default_features_mask;
+                return node;
             }
 
-            if (Util::Maps::contains(m_failed_nodes, spec.name()))
+            if (Util::Sets::contains(m_failed_nodes, spec.name()))
             {
                 return nullopt;
             }
 
+            auto add_node = [&]() -> PackageNode& {
+                m_ids.add(spec);
+                return m_graph.emplace_back(spec, PackageNodeData{});
+            };
+
+            PackageNode* node;
+
             const auto maybe_overlay = m_o_provider.get_control_file(spec.name());
             if (auto p_overlay = maybe_overlay.get())
             {
-                it = m_graph.emplace(spec, PackageNodeData{}).first;
-                it->second.overlay_or_override = true;
-                it->second.scfl = p_overlay;
+                node = &add_node();
+                node->second.overlay_or_override = true;
+                node->second.scfl = p_overlay;
             }
             else
             {
                 Version ver;
                 if (const auto over_it = m_overrides.find(spec.name()); over_it != m_overrides.end())
                 {
-                    auto maybe_scfl = m_ver_provider.get_control_file({spec.name(), over_it->second});
+                    const auto& maybe_scfl = m_context.version_scfl({spec.name(), over_it->second});
                     if (auto p_scfl = maybe_scfl.get())
                     {
-                        it = m_graph.emplace(spec, PackageNodeData{}).first;
-                        it->second.overlay_or_override = true;
-                        it->second.scfl = p_scfl;
+                        node = &add_node();
+                        node->second.overlay_or_override = true;
+                        node->second.scfl = p_scfl;
                     }
                     else
                     {
-                        m_errors.push_back(std::move(maybe_scfl).error());
+                        m_errors.push_back(maybe_scfl.error());
                         m_failed_nodes.insert(spec.name());
                         return nullopt;
                     }
                 }
                 else
                 {
-                    auto maybe_scfl = m_base_provider.get_baseline_version(spec.name()).then([&](const Version& ver) {
-                        return m_ver_provider.get_control_file({spec.name(), ver});
-                    });
+                    const auto& maybe_scfl = m_context.baseline_scfl(spec.name());
                     if (auto p_scfl = maybe_scfl.get())
                     {
-                        it = m_graph.emplace(spec, PackageNodeData{}).first;
-                        it->second.baseline = p_scfl->schemed_version();
-                        it->second.scfl = p_scfl;
+                        node = &add_node();
+                        node->second.baseline = p_scfl;
+                        node->second.scfl = p_scfl;
                     }
                     else
                     {
-                        m_errors.push_back(std::move(maybe_scfl).error());
+                        m_errors.push_back(maybe_scfl.error());
                         m_failed_nodes.insert(spec.name());
                         return nullopt;
                     }
                 }
             }
 
-            it->second.default_features = default_features_mask;
+            node->second.default_features = default_features_mask;
             // Note that if top-level doesn't also mark that reference as `[core]`, defaults will be re-engaged.
-            it->second.requested_features.insert(FeatureNameCore.to_string());
+            node->second.requested_features.insert(FeatureNameCore.to_string());
 
-            require_scfl(*it, it->second.scfl, origin);
-            return *it;
+            require_scfl(*node, node->second.scfl);
+            return *node;
         }
 
         bool VersionedPackageGraph::evaluate(const PackageSpec& spec,
                                              const PlatformExpression::Expr& platform_expr) const
         {
-            return platform_expr.evaluate(m_var_provider.get_or_load_dep_info_vars(spec, m_host_triplet));
+            return platform_expr.is_empty() || platform_expr.evaluate(m_context.platform_context(spec));
         }
 
         void VersionedPackageGraph::add_override(const std::string& name, const Version& v)
@@ -1734,8 +2147,7 @@ namespace vcpkg
             Util::sort_unique_erase(specs);
             for (auto&& dep : deps)
             {
-                if (!dep.platform.is_empty() &&
-                    !dep.platform.evaluate(m_var_provider.get_or_load_dep_info_vars(m_toplevel, m_host_triplet)))
+                if (!evaluate(m_toplevel, dep.platform))
                 {
                     continue;
                 }
@@ -1751,6 +2163,7 @@ namespace vcpkg
             {
                 ConstraintFrame frame = std::move(m_resolve_stack.back());
                 m_resolve_stack.pop_back();
+                m_prefetched_frames = std::min(m_prefetched_frames, m_resolve_stack.size());
                 // Frame must be passed as a local because resolve_stack() will add new elements to m_resolve_stack
                 resolve_stack(frame);
             }
@@ -1810,39 +2223,47 @@ namespace vcpkg
                     }
                 }
             }
-            std::vector<FeatureSpec> fspecs;
+            const auto& scfl = *node.second.scfl;
             for (auto&& f : all_features)
             {
-                auto maybe_fdeps = node.second.scfl->source_control_file->find_dependencies_for_feature(f);
-                if (auto fdeps = maybe_fdeps.get())
-                {
-                    fspecs.clear();
-                    for (auto&& fdep : *fdeps)
+                const auto& edges = m_context.versioned_feature_edges(FeatureSpec{node.first, f}, scfl, [&] {
+                    ResolutionContext::Impl::VersionedFeatureEdges result{&scfl};
+                    auto maybe_fdeps = scfl.source_control_file->find_dependencies_for_feature(f);
+                    if (auto fdeps = maybe_fdeps.get())
                     {
-                        PackageSpec fspec{fdep.name, fdep.host ? m_host_triplet : node.first.triplet()};
+                        result.exists = true;
+                        for (auto&& fdep : *fdeps)
+                        {
+                            PackageSpec fspec{fdep.name, fdep.host ? m_host_triplet : node.first.triplet()};
 
-                        // Ignore intra-package dependencies
-                        if (fspec == node.first) continue;
+                            // Ignore intra-package dependencies
+                            if (fspec == node.first) continue;
 
-                        if (!fdep.platform.is_empty() &&
-                            !fdep.platform.evaluate(
-                                m_var_provider.get_or_load_dep_info_vars(node.first, m_host_triplet)))
-                        {
-                            continue;
-                        }
+                            if (!evaluate(node.first, fdep.platform))
+                            {
+                                continue;
+                            }
 
-                        fspecs.emplace_back(fspec, FeatureNameCore);
-                        for (auto&& g : fdep.features)
-                        {
-                            if (evaluate(fspec, g.platform))
+                            result.dependencies.emplace_back(fspec, FeatureNameCore);
+                            for (auto&& g : fdep.features)
                             {
-                                fspecs.emplace_back(fspec, g.name);
+                                if (evaluate(fspec, g.platform))
+                                {
+                                    result.dependencies.emplace_back(fspec, g.name);
+                                }
                             }
+                            result.dep_specs.push_back({std::move(fspec), fdep.constraint, fdep.features});
                         }
-                        out_dep_specs.push_back({std::move(fspec), fdep.constraint, fdep.features});
+                        Util::sort_unique_erase(result.dependencies);
                     }
-                    Util::sort_unique_erase(fspecs);
-                    feature_deps.emplace(f, fspecs);
+
+                    return result;
+                });
+
+                if (edges.exists)
+                {
+                    feature_deps.emplace(f, edges.dependencies);
+                    out_dep_specs.insert(out_dep_specs.end(), edges.dep_specs.begin(), edges.dep_specs.end());
                 }
             }
             return feature_deps;
@@ -1863,10 +2284,18 @@ namespace vcpkg
 
             ActionPlan ret;
 
-            // second == false means "in progress"
-            std::map<PackageSpec, bool> emitted;
+            enum class EmitState : unsigned char
+            {
+                NotEmitted,
+                InProgress,
+                Emitted
+            };
+
+            // indexed by the numbers in m_ids
+            std::vector<EmitState> emitted(m_graph.size(), EmitState::NotEmitted);
             struct Frame
             {
+                std::size_t id;
                 InstallPlanAction ipa;
                 std::vector<DepSpec> deps;
             };
@@ -1875,27 +2304,30 @@ namespace vcpkg
             // Adds a new Frame to the stack if the spec was not already added
             auto push = [&emitted, this, &stack, use_head_version_if_user_requested, editable_if_user_requested](
                             const DepSpec& dep, StringView origin) -> ExpectedL<Unit> {
-                auto p = emitted.emplace(dep.spec, false);
                 // Dependency resolution should have ensured that either every node exists OR an error should have been
                 // logged to m_errors
-                const auto& node = find_package(dep.spec).value_or_exit(VCPKG_LINE_INFO);
+                const auto id = m_ids.find(dep.spec).value_or_exit(VCPKG_LINE_INFO);
+                const auto& node = m_graph[id];
+                const auto state = emitted[id];
+                if (state == EmitState::NotEmitted)
+                {
+                    emitted[id] = EmitState::InProgress;
+                }
 
                 // Evaluate the >=version constraint (if any)
                 auto maybe_min = dep.dc.try_get_minimum_version();
                 if (!node.second.overlay_or_override && maybe_min)
                 {
                     // Dependency resolution should have already logged any errors retrieving the scfl
-                    const auto& dep_scfl = m_ver_provider.get_control_file({dep.spec.name(), *maybe_min.get()})
-                                               .value_or_exit(VCPKG_LINE_INFO);
-                    const auto constraint_sver = dep_scfl.schemed_version();
-                    const auto selected_sver = node.second.scfl->schemed_version();
-                    auto r = compare_versions(selected_sver, constraint_sver);
+                    const auto& dep_scfl =
+                        m_context.version_scfl({dep.spec.name(), *maybe_min.get()}).value_or_exit(VCPKG_LINE_INFO);
+                    auto r = compare(m_context.version_key(node.second.scfl), m_context.version_key(&dep_scfl));
                     if (r == VerComp::unk)
                     {
                         // In the error message, we report the baseline version instead of the "best selected" version
                         // to give the user simpler data to work with.
                         return format_incomparable_versions_message(
-                            dep.spec, origin, node.second.baseline, constraint_sver);
+                            dep.spec, origin, node.second.baseline->schemed_version(), dep_scfl.schemed_version());
                     }
                     Checks::check_exit(
                         VCPKG_LINE_INFO,
@@ -1919,15 +2351,13 @@ namespace vcpkg
                     }
                 }
 
-                if (p.second)
+                if (state == EmitState::NotEmitted)
                 {
                     // Newly inserted -> Add stack frame
-                    auto maybe_vars = m_var_provider.get_or_load_dep_info_vars(p.first->first, m_host_triplet);
-
                     std::vector<std::string> default_features;
                     for (const auto& feature : node.second.scfl->source_control_file->core_paragraph->default_features)
                     {
-                        if (feature.platform.evaluate(maybe_vars))
+                        if (evaluate(dep.spec, feature.platform))
                         {
                             default_features.push_back(feature.name);
                         }
@@ -1958,9 +2388,9 @@ namespace vcpkg
                                           compute_feature_dependencies(node, deps),
                                           {},
                                           std::move(default_features));
-                    stack.push_back(Frame{std::move(ipa), std::move(deps)});
+                    stack.push_back(Frame{id, std::move(ipa), std::move(deps)});
                 }
-                else if (p.first->second == false)
+                else if (state == EmitState::InProgress)
                 {
                     return msg::format_error(msgCycleDetectedDuring, msg::spec = dep.spec)
                         .append_raw('\n')
@@ -1987,7 +2417,7 @@ namespace vcpkg
                     auto& back = stack.back();
                     if (back.deps.empty())
                     {
-                        emitted[back.ipa.spec] = true;
+                        emitted[back.id] = EmitState::Emitted;
                         ret.install_actions.push_back(std::move(back.ipa));
                         stack.pop_back();
                     }
@@ -2016,10 +2446,10 @@ namespace vcpkg
             for (auto&& action : ret.install_actions)
             {
                 const auto& scfl = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO);
-                const auto& vars = m_var_provider.get_or_load_dep_info_vars(action.spec, m_host_triplet);
+                const auto& context = m_context.platform_context(action.spec);
                 // Evaluate core supports condition
                 const auto& supports_expr = scfl.source_control_file->core_paragraph->supports_expression;
-                if (!supports_expr.evaluate(vars))
+                if (!supports_expr.evaluate(context))
                 {
                     ret.unsupported_features.emplace(std::piecewise_construct,
                                                      std::forward_as_tuple(action.spec, FeatureNameCore),
@@ -2032,7 +2462,7 @@ namespace vcpkg
                     if (fdeps.first == FeatureNameCore) continue;
 
                     auto& fpgh = scfl.source_control_file->find_feature(fdeps.first).value_or_exit(VCPKG_LINE_INFO);
-                    if (!fpgh.supports_expression.evaluate(vars))
+                    if (!fpgh.supports_expression.evaluate(context))
                     {
                         ret.unsupported_features.emplace(std::piecewise_construct,
                                                          std::forward_as_tuple(action.spec, fdeps.first),
@@ -2062,6 +2492,7 @@ namespace vcpkg
 
                 return msg;
             }
+            ret.share_dependency_lists();
             return ret;
         }
     }
@@ -2076,8 +2507,14 @@ namespace vcpkg
                                                         PackagesDirAssigner& packages_dir_assigner,
                                                         const CreateInstallPlanOptions& options)
     {
-        VersionedPackageGraph vpg(
-            provider, bprovider, oprovider, var_provider, toplevel, options.host_triplet, packages_dir_assigner);
+        VersionedPackageGraph vpg(provider,
+                                  bprovider,
+                                  oprovider,
+                                  var_provider,
+                                  toplevel,
+                                  options.host_triplet,
+                                  packages_dir_assigner,
+                                  options.resolution_context);
         for (auto&& o : overrides)
         {
             vpg.add_override(o.name, o.version);
@@ -0,0 +1,491 @@
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/message_sinks.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.debug.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/commands.build.h>
+#include <vcpkg/commands.version.h>
+#include <vcpkg/configuration.h>
+#include <vcpkg/dependencies.h>
+#include <vcpkg/installedpaths.h>
+#include <vcpkg/installplancache.h>
+#include <vcpkg/statusparagraphs.h>
+#include <vcpkg/tools.h>
+#include <vcpkg/vcpkgcmdarguments.h>
+#include <vcpkg/vcpkgpaths.h>
+
+#include <set>
+
+namespace
+{
+    using namespace vcpkg;
+
+    // Install plan cache records are keyed by manifest path. Each payload is the inputs hash, then the number of
+    // watched files and each one's path, last write time, and size, then the number of tracked environment variables
+    // and each one's name and value hash, then the number of actions and each one's port name, triplet, package ABI,
+    // and whether it was user requested.
+    constexpr StringLiteral InstallPlanCacheHeader = "vcpkg-install-plan-cache 1\n";
+
+    void write_strings(BinaryWriter& writer, const std::vector<std::string>& values)
+    {
+        writer.write_scalar(static_cast<uint32_t>(values.size()));
+        for (auto&& value : values)
+        {
+            writer.write_string(value);
+        }
+    }
+
+    // Hashes everything that selects the plan or contributes to its ABIs other than the contents of files, which
+    // are instead watched by InstallPlanRecord
+    std::string hash_install_inputs(const VcpkgCmdArguments& args,
+                                    const VcpkgPaths& paths,
+                                    Triplet default_triplet,
+                                    Triplet host_triplet)
+    {
+        BinaryWriter writer;
+        writer.write_string(vcpkg_executable_version);
+        writer.write_string(paths.root.native());
+        writer.write_string(paths.installed().root().native());
+        writer.write_string(paths.builtin_ports_directory().native());
+        writer.write_string(default_triplet.canonical_name());
+        writer.write_string(host_triplet.canonical_name());
+        write_strings(writer, args.get_forwardable_arguments());
+        write_strings(writer, args.cmake_args);
+        writer.write_scalar(args.exact_abi_tools_versions.value_or(false));
+
+        const auto& feature_flags = paths.get_feature_flags();
+        writer.write_scalar(feature_flags.registries);
+        writer.write_scalar(feature_flags.compiler_tracking);
+        writer.write_scalar(feature_flags.binary_caching);
+        writer.write_scalar(feature_flags.versions);
+        writer.write_scalar(feature_flags.dependency_graph);
+
+        if (auto manifest = paths.get_manifest().get())
+        {
+            writer.write_string(manifest->path.native());
+            writer.write_string(Json::stringify(manifest->manifest));
+        }
+
+        const auto& configuration = paths.get_configuration();
+        writer.write_string(configuration.directory.native());
+        writer.write_string(Json::stringify(configuration.config.serialize()));
+
+        const auto builtin_overlay_port_dir = paths.overlay_ports.builtin_overlay_port_dir.get();
+        writer.write_string(builtin_overlay_port_dir ? builtin_overlay_port_dir->native() : std::string());
+        writer.write_scalar(static_cast<uint32_t>(paths.overlay_ports.overlay_ports.size()));
+        for (auto&& overlay_port : paths.overlay_ports.overlay_ports)
+        {
+            writer.write_string(overlay_port.native());
+        }
+
+        const auto& available_triplets = paths.get_triplet_db().available_triplets;
+        writer.write_scalar(static_cast<uint32_t>(available_triplets.size()));
+        for (auto&& triplet_file : available_triplets)
+        {
+            writer.write_string(triplet_file.name);
+            writer.write_string(triplet_file.location.native());
+        }
+
+        // PATH, CC, and CXX select the compiler and tools; VCPKG_ variables configure vcpkg itself
+        for (auto&& name : {"PATH", "CC", "CXX"})
+        {
+            writer.write_string(get_environment_variable(name).value_or(""));
+        }
+
+        auto environment = get_environment_variables();
+        Util::erase_remove_if(environment,
+                              [](const std::string& entry) { return !Strings::starts_with(entry, "VCPKG_"); });
+        Util::sort(environment);
+        write_strings(writer, environment);
+
+        return Hash::get_string_sha256(writer.buffer);
+    }
+
+    std::string hash_environment_variable(const std::string& name)
+    {
+        auto maybe_value = get_environment_variable(name);
+        if (auto value = maybe_value.get())
+        {
+            return Hash::get_string_sha256(*value);
+        }
+
+        return std::string();
+    }
+
+    // Collects the files and directories a plan was resolved from, stating them once all are known
+    struct WatchedFilesCollector
+    {
+        explicit WatchedFilesCollector(const Filesystem& fs) : fs(fs) { }
+
+        void watch(const Path& path) { paths.insert(path.native()); }
+
+        // Watches `root`, and every file and directory under it, so that files being added or removed is also noticed
+        void watch_tree(const Path& root)
+        {
+            watch(root);
+            std::error_code ec;
+            for (auto&& path : fs.get_files_recursive(root, ec))
+            {
+                watch(path);
+            }
+        }
+
+        std::vector<InstallPlanWatchedFile> stat_all() const
+        {
+            std::vector<InstallPlanWatchedFile> result;
+            result.reserve(paths.size());
+            for (auto&& path : paths)
+            {
+                std::error_code ec;
+                const auto last_write_time = fs.last_write_time(path, ec);
+                if (ec)
+                {
+                    // nothing that matters can have been read from a path that doesn't exist
+                    continue;
+                }
+
+                auto size = fs.file_size(path, ec);
+                if (ec)
+                {
+                    size = 0;
+                }
+
+                result.push_back(InstallPlanWatchedFile{path, last_write_time, size});
+            }
+
+            return result;
+        }
+
+        const Filesystem& fs;
+        std::set<std::string> paths;
+    };
+}
+
+namespace vcpkg
+{
+    std::string InstallPlanRecord::serialize() const
+    {
+        BinaryWriter writer;
+        writer.write_string(inputs_hash);
+        writer.write_scalar(static_cast<uint32_t>(watched_files.size()));
+        for (auto&& watched_file : watched_files)
+        {
+            writer.write_string(watched_file.path.native());
+            writer.write_scalar(watched_file.last_write_time);
+            writer.write_scalar(watched_file.size);
+        }
+
+        writer.write_scalar(static_cast<uint32_t>(tracked_environment.size()));
+        for (auto&& variable : tracked_environment)
+        {
+            writer.write_string(variable.first);
+            writer.write_string(variable.second);
+        }
+
+        writer.write_scalar(static_cast<uint32_t>(actions.size()));
+        for (auto&& action : actions)
+        {
+            writer.write_string(action.spec.name());
+            writer.write_string(action.spec.triplet().canonical_name());
+            writer.write_string(action.package_abi);
+            writer.write_scalar(static_cast<uint8_t>(action.user_requested));
+        }
+
+        return std::move(writer.buffer);
+    }
+
+    Optional<InstallPlanRecord> InstallPlanRecord::parse(StringView payload)
+    {
+        BinaryReader reader{payload};
+        InstallPlanRecord record;
+        uint32_t count;
+        if (!reader.read_string(record.inputs_hash) || !reader.read_scalar(count))
+        {
+            return nullopt;
+        }
+
+        for (uint32_t idx = 0; idx < count; ++idx)
+        {
+            std::string path;
+            int64_t last_write_time;
+            uint64_t size;
+            if (!reader.read_string(path) || !reader.read_scalar(last_write_time) || !reader.read_scalar(size))
+            {
+                return nullopt;
+            }
+
+            record.watched_files.push_back(InstallPlanWatchedFile{std::move(path), last_write_time, size});
+        }
+
+        if (!reader.read_scalar(count))
+        {
+            return nullopt;
+        }
+
+        for (uint32_t idx = 0; idx < count; ++idx)
+        {
+            std::string name;
+            std::string value_hash;
+            if (!reader.read_string(name) || !reader.read_string(value_hash))
+            {
+                return nullopt;
+            }
+
+            record.tracked_environment.emplace_back(std::move(name), std::move(value_hash));
+        }
+
+        if (!reader.read_scalar(count))
+        {
+            return nullopt;
+        }
+
+        for (uint32_t idx = 0; idx < count; ++idx)
+        {
+            std::string name;
+            std::string triplet;
+            std::string package_abi;
+            uint8_t user_requested;
+            if (!reader.read_string(name) || !reader.read_string(triplet) || !reader.read_string(package_abi) ||
+                !reader.read_scalar(user_requested) || user_requested > 1)
+            {
+                return nullopt;
+            }
+
+            record.actions.push_back(InstallPlanRecordAction{
+                PackageSpec{std::move(name), Triplet::from_canonical_name(std::move(triplet))},
+                std::move(package_abi),
+                user_requested != 0});
+        }
+
+        if (!reader.empty())
+        {
+            return nullopt;
+        }
+
+        return record;
+    }
+
+    bool InstallPlanRecord::inputs_unchanged(const Filesystem& fs) const
+    {
+        for (auto&& watched_file : watched_files)
+        {
+            std::error_code ec;
+            const auto last_write_time = fs.last_write_time(watched_file.path, ec);
+            if (ec || last_write_time != watched_file.last_write_time)
+            {
+                Debug::print("The cached install plan is out of date because ", watched_file.path, " changed\n");
+                return false;
+            }
+
+            auto size = fs.file_size(watched_file.path, ec);
+            if (ec)
+            {
+                size = 0;
+            }
+
+            if (size != watched_file.size)
+            {
+                Debug::print("The cached install plan is out of date because ", watched_file.path, " changed\n");
+                return false;
+            }
+        }
+
+        for (auto&& variable : tracked_environment)
+        {
+            if (hash_environment_variable(variable.first) != variable.second)
+            {
+                Debug::print("The cached install plan is out of date because ", variable.first, " changed\n");
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool InstallPlanRecord::is_installed(const StatusParagraphs& status_db) const
+    {
+        size_t installed_count = 0;
+        for (auto&& status_pgh : status_db)
+        {
+            if (status_pgh->is_installed() && !status_pgh->package.is_feature())
+            {
+                ++installed_count;
+            }
+        }
+
+        if (installed_count != actions.size())
+        {
+            return false;
+        }
+
+        return Util::all_of(actions, [&](const InstallPlanRecordAction& action) {
+            auto it = status_db.find_installed(action.spec);
+            return it != status_db.end() && (*it)->package.abi == action.package_abi;
+        });
+    }
+
+    InstallPlanCache::InstallPlanCache(const VcpkgCmdArguments& args,
+                                       const VcpkgPaths& paths,
+                                       Triplet default_triplet,
+                                       Triplet host_triplet)
+        : m_paths(&paths)
+        , m_key(paths.get_manifest().value_or_exit(VCPKG_LINE_INFO).path.native())
+        , m_inputs_hash(hash_install_inputs(args, paths, default_triplet, host_triplet))
+        , m_file(paths.get_filesystem(), paths.installed().install_plan_cache_file(), InstallPlanCacheHeader)
+    {
+    }
+
+    Optional<std::vector<PackageSpec>> InstallPlanCache::find_up_to_date(const StatusParagraphs& status_db) const
+    {
+        const auto records = m_file.load();
+        const auto it = records.find(m_key);
+        if (it == records.end())
+        {
+            Debug::print("No install plan is cached for ", m_key, '\n');
+            return nullopt;
+        }
+
+        auto maybe_record = InstallPlanRecord::parse(it->second);
+        const auto record = maybe_record.get();
+        if (!record)
+        {
+            Debug::print("The cached install plan for ", m_key, " is damaged\n");
+            return nullopt;
+        }
+
+        if (record->inputs_hash != m_inputs_hash)
+        {
+            Debug::print("The cached install plan was resolved from a different command line, manifest, "
+                         "configuration, or environment\n");
+            return nullopt;
+        }
+
+        if (!record->inputs_unchanged(m_paths->get_filesystem()))
+        {
+            return nullopt;
+        }
+
+        if (!record->is_installed(status_db))
+        {
+            Debug::print("The installed packages differ from the cached install plan\n");
+            return nullopt;
+        }
+
+        std::vector<PackageSpec> user_requested_specs;
+        for (auto&& action : record->actions)
+        {
+            if (action.user_requested)
+            {
+                user_requested_specs.push_back(action.spec);
+            }
+        }
+
+        return user_requested_specs;
+    }
+
+    void InstallPlanCache::capture(const ActionPlan& action_plan)
+    {
+        m_captured.clear();
+        const auto& fs = m_paths->get_filesystem();
+        const auto& triplet_db = m_paths->get_triplet_db();
+        WatchedFilesCollector collector{fs};
+        std::set<std::string> tracked_variables;
+        InstallPlanRecord record;
+        record.inputs_hash = m_inputs_hash;
+        for (auto&& action : action_plan.install_actions)
+        {
+            auto abi_info = action.abi_info.get();
+            if (!abi_info || abi_info->package_abi.empty())
+            {
+                Debug::print("The install plan is not cached because the ABI of ", action.spec, " is unknown\n");
+                return;
+            }
+
+            const auto& scfl = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO);
+            collector.watch_tree(scfl.port_directory());
+            const auto& pre_build_info = *abi_info->pre_build_info;
+            collector.watch(triplet_db.get_triplet_file_path(action.spec.triplet()));
+            collector.watch(pre_build_info.toolchain_file());
+            for (auto&& file : pre_build_info.hash_additional_files)
+            {
+                collector.watch(file);
+            }
+
+            for (auto&& file : pre_build_info.post_portfile_includes)
+            {
+                collector.watch(file);
+            }
+
+            if (auto game_dk_latest = pre_build_info.gamedk_latest_path.get())
+            {
+                collector.watch(*game_dk_latest / "GRDK/gameKit/Include/grdk.h");
+            }
+
+            if (auto compiler_info = abi_info->compiler_info.get())
+            {
+                collector.watch(compiler_info->path);
+            }
+
+            tracked_variables.insert(pre_build_info.passthrough_env_vars_tracked.begin(),
+                                     pre_build_info.passthrough_env_vars_tracked.end());
+            record.actions.push_back(InstallPlanRecordAction{
+                action.spec, abi_info->package_abi, action.request_type == RequestType::USER_REQUESTED});
+        }
+
+        // ports.cmake, the helper functions ports call, toolchains, and the scripts that detect the compiler and load
+        // triplet variables all live under scripts
+        collector.watch_tree(m_paths->scripts);
+        for (auto&& overlay_port : m_paths->overlay_ports.overlay_ports)
+        {
+            collector.watch(overlay_port);
+        }
+
+        // git registries are pinned to a baseline commit in the configuration, but filesystem registries can change
+        // in place
+        const auto& configuration = m_paths->get_configuration();
+        auto watch_filesystem_registry = [&](const RegistryConfig& registry) {
+            auto kind = registry.kind.get();
+            auto path = registry.path.get();
+            if (kind && path && *kind == JsonIdFilesystem)
+            {
+                collector.watch_tree(configuration.directory / *path / FileVersions);
+            }
+        };
+
+        if (auto default_registry = configuration.config.default_reg.get())
+        {
+            watch_filesystem_registry(*default_registry);
+        }
+
+        for (auto&& registry : configuration.config.registries)
+        {
+            watch_filesystem_registry(registry);
+        }
+
+        collector.watch(m_paths->get_tool_exe(Tools::CMAKE, null_sink));
+#if defined(_WIN32)
+        collector.watch(m_paths->get_tool_exe("powershell-core", null_sink));
+#endif
+
+        record.watched_files = collector.stat_all();
+        for (auto&& name : tracked_variables)
+        {
+            record.tracked_environment.emplace_back(name, hash_environment_variable(name));
+        }
+
+        m_captured = std::move(record);
+    }
+
+    void InstallPlanCache::save() const
+    {
+        if (auto captured = m_captured.get())
+        {
+            m_file.replace(m_key, captured->serialize());
+        }
+    }
+}
@@ -117,9 +117,11 @@ namespace vcpkg
             })};
     }
 
-    bool InternalFeatureSet::empty_or_only_core() const
+    bool InternalFeatureSet::empty_or_only_core() const { return vcpkg::empty_or_only_core(*this); }
+
+    bool empty_or_only_core(View<std::string> features)
     {
-        return empty() || (size() == 1 && *begin() == FeatureNameCore);
+        return features.empty() || (features.size() == 1 && features[0] == FeatureNameCore);
     }
 
     InternalFeatureSet internalize_feature_list(View<Located<std::string>> fs, ImplicitDefault id)
@@ -154,10 +156,6 @@ namespace vcpkg
         }
     }
 
-    const std::string& PackageSpec::name() const { return this->m_name; }
-
-    Triplet PackageSpec::triplet() const { return this->m_triplet; }
-
     std::string PackageSpec::dir() const { return fmt::format("{}_{}", this->m_name, this->m_triplet); }
 
     std::string PackageSpec::to_string() const { return adapt_to_string(*this); }
@@ -168,7 +166,7 @@ namespace vcpkg
 
     bool operator==(const PackageSpec& left, const PackageSpec& right)
     {
-        return left.name() == right.name() && left.triplet() == right.triplet();
+        return left.interned_name() == right.interned_name() && left.triplet() == right.triplet();
     }
 
     const PlatformExpression::Expr& ParsedQualifiedSpecifier::platform_or_always_true() const
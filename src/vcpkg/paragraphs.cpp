@@ -1,23 +1,31 @@
 #include <vcpkg/base/fwd/message_sinks.h>
 
+#include <vcpkg/base/binary-records.h>
 #include <vcpkg/base/chrono.h>
 #include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/message_sinks.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/parse.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/util.h>
 
 #include <vcpkg/binaryparagraph.h>
+#include <vcpkg/commands.version.h>
 #include <vcpkg/paragraphparser.h>
 #include <vcpkg/paragraphs.h>
 #include <vcpkg/registries.h>
 
+#include <memory>
+#include <mutex>
 #include <tuple>
 
 using namespace vcpkg;
 
 static std::atomic<uint64_t> g_load_ports_stats(0);
+static thread_local MessageSink* g_port_warning_sink = nullptr;
 
 namespace vcpkg
 {
@@ -107,6 +115,31 @@ namespace
             result.append_raw('\n');
         }
     }
+
+    // Forwards to another sink, remembering whether anything was printed
+    struct WarningDetectingSink final : MessageSink
+    {
+        explicit WarningDetectingSink(MessageSink& sink) : m_sink(sink) { }
+
+        virtual void println(const MessageLine& line) override
+        {
+            any_printed = true;
+            m_sink.println(line);
+        }
+
+        virtual void println(MessageLine&& line) override
+        {
+            any_printed = true;
+            m_sink.println(std::move(line));
+        }
+
+        using MessageSink::println;
+
+        bool any_printed = false;
+
+    private:
+        MessageSink& m_sink;
+    };
 } // unnamed namespace
 
 namespace vcpkg
@@ -379,14 +412,89 @@ namespace vcpkg::Paragraphs
         });
     }
 
+    ParsedManifestCache::ParsedManifestCache(const Filesystem& fs, const Path& cache_file)
+        : m_file(fs,
+                 cache_file,
+                 fmt::format("vcpkg-manifest-cache 1 {}\n", vcpkg_executable_version),
+                 // records are keyed by content, so nothing ever supersedes them; bound the file instead
+                 8192)
+    {
+    }
+
+    std::unique_ptr<SourceControlFile> ParsedManifestCache::find(StringView key) const
+    {
+        std::string payload;
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (!m_loaded)
+            {
+                m_records = m_file.load();
+                m_loaded = true;
+            }
+
+            auto it = m_records.find(key);
+            if (it == m_records.end())
+            {
+                return nullptr;
+            }
+
+            payload = it->second;
+        }
+
+        return deserialize_binary_source_control_file(payload);
+    }
+
+    void ParsedManifestCache::add(StringView key, std::string&& payload) const
+    {
+        // the append doesn't need m_mtx, so parallel port loads only wait on each other for the file itself
+        m_file.append(key, payload);
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_records.insert_or_assign(key.to_string(), std::move(payload));
+    }
+
+    MessageSink& port_warning_sink() { return g_port_warning_sink ? *g_port_warning_sink : out_sink; }
+
+    PortWarningRedirect::PortWarningRedirect(MessageSink& sink) : m_previous(g_port_warning_sink)
+    {
+        g_port_warning_sink = &sink;
+    }
+
+    PortWarningRedirect::~PortWarningRedirect() { g_port_warning_sink = m_previous; }
+
     ExpectedL<std::unique_ptr<SourceControlFile>> try_load_port_manifest_text(StringView text,
                                                                               StringView control_path,
-                                                                              MessageSink& warning_sink)
+                                                                              MessageSink& warning_sink,
+                                                                              const ParsedManifestCache* manifest_cache)
     {
         StatsTimer timer(g_load_ports_stats);
-        return Json::parse_object(text, control_path).then([&](Json::Object&& object) {
-            return SourceControlFile::parse_port_manifest_object(control_path, std::move(object), warning_sink);
+        std::string cache_key;
+        if (manifest_cache)
+        {
+            cache_key = Hash::get_string_sha256(text);
+            if (auto cached = manifest_cache->find(cache_key))
+            {
+                return cached;
+            }
+        }
+
+        WarningDetectingSink detecting_sink{warning_sink};
+        auto maybe_scf = Json::parse_object(text, control_path).then([&](Json::Object&& object) {
+            return SourceControlFile::parse_port_manifest_object(control_path, std::move(object), detecting_sink);
         });
+
+        if (auto scf = maybe_scf.get())
+        {
+            if (!cache_key.empty() && !detecting_sink.any_printed)
+            {
+                auto maybe_payload = serialize_binary_source_control_file(**scf);
+                if (auto payload = maybe_payload.get())
+                {
+                    manifest_cache->add(cache_key, std::move(*payload));
+                }
+            }
+        }
+
+        return maybe_scf;
     }
 
     ExpectedL<std::unique_ptr<SourceControlFile>> try_load_control_file_text(StringView text, StringView control_path)
@@ -397,7 +505,9 @@ namespace vcpkg::Paragraphs
         });
     }
 
-    PortLoadResult try_load_port(const ReadOnlyFilesystem& fs, const PortLocation& port_location)
+    PortLoadResult try_load_port(const ReadOnlyFilesystem& fs,
+                                 const PortLocation& port_location,
+                                 const ParsedManifestCache* manifest_cache)
     {
         StatsTimer timer(g_load_ports_stats);
 
@@ -416,7 +526,8 @@ namespace vcpkg::Paragraphs
                                       std::string{}};
             }
 
-            return PortLoadResult{try_load_port_manifest_text(manifest_contents, manifest_path, out_sink)
+            return PortLoadResult{try_load_port_manifest_text(
+                                      manifest_contents, manifest_path, port_warning_sink(), manifest_cache)
                                       .map([&](std::unique_ptr<SourceControlFile>&& scf) {
                                           return SourceControlFileAndLocation{std::move(scf),
                                                                               std::move(manifest_path),
@@ -461,9 +572,10 @@ namespace vcpkg::Paragraphs
 
     PortLoadResult try_load_port_required(const ReadOnlyFilesystem& fs,
                                           StringView port_name,
-                                          const PortLocation& port_location)
+                                          const PortLocation& port_location,
+                                          const ParsedManifestCache* manifest_cache)
     {
-        auto load_result = try_load_port(fs, port_location);
+        auto load_result = try_load_port(fs, port_location, manifest_cache);
         auto maybe_res = load_result.maybe_scfl.get();
         if (maybe_res)
         {
@@ -506,13 +618,15 @@ namespace vcpkg::Paragraphs
 
     PortLoadResult try_load_builtin_port_required(const ReadOnlyFilesystem& fs,
                                                   StringView port_name,
-                                                  const Path& builtin_ports_directory)
+                                                  const Path& builtin_ports_directory,
+                                                  const ParsedManifestCache* manifest_cache)
     {
         return Paragraphs::try_load_port_required(fs,
                                                   port_name,
                                                   PortLocation{builtin_ports_directory / port_name,
                                                                builtin_port_spdx_location(port_name),
-                                                               PortSourceKind::Builtin});
+                                                               PortSourceKind::Builtin},
+                                                  manifest_cache);
     }
 
     ExpectedL<BinaryControlFile> try_load_cached_package(const ReadOnlyFilesystem& fs,
@@ -548,38 +662,75 @@ namespace vcpkg::Paragraphs
         return maybe_paragraphs.error();
     }
 
+    // Returns an empty Optional if the port should be skipped. The outer error is a failure to load the baseline, which
+    // is fatal; it is returned rather than reported here because this runs on worker threads.
+    static ExpectedL<Optional<ExpectedL<SourceControlFileAndLocation>>> try_load_registry_port(
+        const RegistryImplementation& impl, StringView port_name)
+    {
+        using MaybePort = Optional<ExpectedL<SourceControlFileAndLocation>>;
+        auto maybe_maybe_baseline_version = impl.get_baseline_version(port_name);
+        auto maybe_baseline_version = maybe_maybe_baseline_version.get();
+        if (!maybe_baseline_version) return std::move(maybe_maybe_baseline_version).error();
+        auto baseline_version = maybe_baseline_version->get();
+        if (!baseline_version) return MaybePort{}; // port is attributed to this registry, but it is not in the baseline
+        auto maybe_port_entry = impl.get_port_entry(port_name);
+        const auto port_entry = maybe_port_entry.get();
+        if (!port_entry) return MaybePort{};  // port is attributed to this registry, but loading it failed
+        if (!*port_entry) return MaybePort{}; // port is attributed to this registry, but doesn't exist in this registry
+        return MaybePort{(*port_entry)->try_load_port(*baseline_version)};
+    }
+
     LoadResults try_load_all_registry_ports(const RegistrySet& registries)
     {
         LoadResults ret;
         std::vector<std::string> ports = registries.get_all_reachable_port_names().value_or_exit(VCPKG_LINE_INFO);
-        for (const auto& port_name : ports)
+        std::vector<const RegistryImplementation*> impls;
+        impls.reserve(ports.size());
+        std::vector<ExpectedL<Optional<ExpectedL<SourceControlFileAndLocation>>>> loaded;
+        loaded.reserve(ports.size());
+        // each port's warnings are printed after all ports are loaded, in port order
+        std::vector<BufferedMessageSink> warnings(ports.size());
+        std::vector<size_t> parallel_ports;
+        for (size_t idx = 0; idx < ports.size(); ++idx)
         {
-            const auto impl = registries.registry_for_port(port_name);
-            if (!impl)
+            // if no registry is set for a port, it is skipped. This can happen when there's no default registry,
+            // and a registry has a port definition which it doesn't own the name of.
+            const auto impl = registries.registry_for_port(ports[idx]);
+            impls.push_back(impl);
+            loaded.emplace_back(Optional<ExpectedL<SourceControlFileAndLocation>>{});
+            if (impl)
             {
-                // this is a port for which no registry is set
-                // this can happen when there's no default registry,
-                // and a registry has a port definition which it doesn't own the name of.
-                continue;
+                if (impl->kind() == JsonIdGit)
+                {
+                    // git registries may fetch and update the shared lockfile, so their ports are loaded serially
+                    PortWarningRedirect redirect{warnings[idx]};
+                    loaded[idx] = try_load_registry_port(*impl, ports[idx]);
+                }
+                else
+                {
+                    parallel_ports.push_back(idx);
+                }
             }
+        }
 
-            auto maybe_baseline_version = impl->get_baseline_version(port_name).value_or_exit(VCPKG_LINE_INFO);
-            auto baseline_version = maybe_baseline_version.get();
-            if (!baseline_version) continue; // port is attributed to this registry, but it is not in the baseline
-            auto maybe_port_entry = impl->get_port_entry(port_name);
-            const auto port_entry = maybe_port_entry.get();
-            if (!port_entry) continue;  // port is attributed to this registry, but loading it failed
-            if (!*port_entry) continue; // port is attributed to this registry, but doesn't exist in this registry
-            auto maybe_scfl = (*port_entry)->try_load_port(*baseline_version);
-            if (const auto scfl = maybe_scfl.get())
+        execute_in_parallel(parallel_ports.size(), [&](size_t offset) {
+            const auto idx = parallel_ports[offset];
+            PortWarningRedirect redirect{warnings[idx]};
+            loaded[idx] = try_load_registry_port(*impls[idx], ports[idx]);
+        });
+
+        for (size_t idx = 0; idx < ports.size(); ++idx)
+        {
+            warnings[idx].print_to(port_warning_sink());
+            auto maybe_scfl = loaded[idx].value_or_exit(VCPKG_LINE_INFO).get();
+            if (!maybe_scfl) continue;
+            if (const auto scfl = maybe_scfl->get())
             {
                 ret.paragraphs.push_back(std::move(*scfl));
             }
             else
             {
-                ret.errors.emplace_back(std::piecewise_construct,
-                                        std::forward_as_tuple(port_name.data(), port_name.size()),
-                                        std::forward_as_tuple(std::move(maybe_scfl).error()));
+                ret.errors.emplace_back(std::move(ports[idx]), std::move(*maybe_scfl).error());
             }
         }
 
@@ -4,6 +4,9 @@
 
 #include <vcpkg/platform-expression.h>
 
+#include <stdint.h>
+
+#include <memory>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -42,6 +45,10 @@ namespace vcpkg::PlatformExpression
         native, // HOST_TRIPLET == TARGET_TRIPLET
     };
 
+    static_assert(static_cast<int>(Identifier::native) < 32, "ResolvedContext stores one bit per identifier");
+
+    static constexpr uint32_t identifier_bit(Identifier id) { return uint32_t(1) << static_cast<int>(id); }
+
     static Identifier string2identifier(StringView name)
     {
         static const std::map<StringView, Identifier> id_map = {
@@ -94,6 +101,8 @@ namespace vcpkg::PlatformExpression
             op_invalid
         };
 
+        struct Program;
+
         struct ExprImpl
         {
             ExprImpl(ExprKind k, std::string i, std::vector<std::unique_ptr<ExprImpl>> es)
@@ -108,6 +117,8 @@ namespace vcpkg::PlatformExpression
             ExprKind kind;
             std::string identifier;
             std::vector<std::unique_ptr<ExprImpl>> exprs;
+            // only set on the root of an expression; see compile()
+            std::shared_ptr<const Program> program;
 
             std::unique_ptr<ExprImpl> clone() const
             {
@@ -116,6 +127,79 @@ namespace vcpkg::PlatformExpression
             }
         };
 
+        enum class OpCode : uint8_t
+        {
+            identifier,       // operand is the Identifier
+            other_identifier, // operand indexes Program::other_identifiers
+            op_not,           // followed by its operand
+            op_and,           // operand is the number of operands which follow
+            op_or,            // operand is the number of operands which follow
+            op_invalid,
+        };
+
+        struct Instruction
+        {
+            OpCode op;
+            uint32_t operand;
+        };
+
+        // An expression flattened into prefix order, so that evaluating it is a walk over one array which needs no
+        // string comparisons for built-in identifiers
+        struct Program
+        {
+            std::vector<Instruction> instructions;
+            std::vector<std::string> other_identifiers;
+        };
+
+        static void compile_into(const ExprImpl& expr, Program& program)
+        {
+            switch (expr.kind)
+            {
+                case ExprKind::identifier:
+                {
+                    auto id = string2identifier(expr.identifier);
+                    if (id == Identifier::invalid)
+                    {
+                        program.instructions.push_back(
+                            {OpCode::other_identifier, static_cast<uint32_t>(program.other_identifiers.size())});
+                        program.other_identifiers.push_back(expr.identifier);
+                    }
+                    else
+                    {
+                        program.instructions.push_back({OpCode::identifier, static_cast<uint32_t>(id)});
+                    }
+
+                    return;
+                }
+                case ExprKind::op_not: program.instructions.push_back({OpCode::op_not, 0}); break;
+                case ExprKind::op_and:
+                    program.instructions.push_back({OpCode::op_and, static_cast<uint32_t>(expr.exprs.size())});
+                    break;
+                case ExprKind::op_or:
+                case ExprKind::op_list:
+                    program.instructions.push_back({OpCode::op_or, static_cast<uint32_t>(expr.exprs.size())});
+                    break;
+                default: program.instructions.push_back({OpCode::op_invalid, 0}); return;
+            }
+
+            for (auto&& operand : expr.exprs)
+            {
+                compile_into(*operand, program);
+            }
+        }
+
+        static std::unique_ptr<ExprImpl> compile(std::unique_ptr<ExprImpl>&& expr)
+        {
+            if (expr)
+            {
+                auto program = std::make_shared<Program>();
+                compile_into(*expr, *program);
+                expr->program = std::move(program);
+            }
+
+            return std::move(expr);
+        }
+
         struct ExpressionParser : ParserBase
         {
             ExpressionParser(StringView str, MultipleBinaryOperators multiple_binary_operators)
@@ -427,13 +511,16 @@ namespace vcpkg::PlatformExpression
         if (other.underlying_)
         {
             this->underlying_ = other.underlying_->clone();
+            this->underlying_->program = other.underlying_->program;
         }
     }
     Expr& Expr::operator=(const Expr& other)
     {
         if (other.underlying_)
         {
+            auto program = other.underlying_->program;
             this->underlying_ = other.underlying_->clone();
+            this->underlying_->program = std::move(program);
         }
         else
         {
@@ -443,7 +530,7 @@ namespace vcpkg::PlatformExpression
         return *this;
     }
 
-    Expr::Expr(std::unique_ptr<ExprImpl>&& e) : underlying_(std::move(e)) { }
+    Expr::Expr(std::unique_ptr<ExprImpl>&& e) : underlying_(compile(std::move(e))) { }
     Expr::~Expr() = default;
 
     Expr Expr::Identifier(StringView id)
@@ -462,168 +549,199 @@ namespace vcpkg::PlatformExpression
             ExprKind::op_or, Util::fmap(exprs, [](Expr& expr) { return std::move(expr.underlying_); })));
     }
 
-    bool Expr::evaluate(const Context& context) const
+    ResolvedContext resolve_context(const Context& context)
     {
-        if (!this->underlying_)
+        ResolvedContext resolved;
+        static const std::string architecture_name = "VCPKG_TARGET_ARCHITECTURE";
+        static const std::string system_name_name = "VCPKG_CMAKE_SYSTEM_NAME";
+        static const std::string xbox_console_target_name = "VCPKG_XBOX_CONSOLE_TARGET";
+        static const std::string library_linkage_name = "VCPKG_LIBRARY_LINKAGE";
+        static const std::string crt_linkage_name = "VCPKG_CRT_LINKAGE";
+        static const std::string is_native_name = "Z_VCPKG_IS_NATIVE";
+        static const std::string override_vars_name = "VCPKG_DEP_INFO_OVERRIDE_VARS";
+        const auto find = [&](const std::string& variable_name) -> const std::string* {
+            auto iter = context.find(variable_name);
+            return iter == context.end() ? nullptr : &iter->second;
+        };
+
+        const auto architecture = find(architecture_name);
+        const auto system_name = find(system_name_name);
+        const auto xbox_console_target = find(xbox_console_target_name);
+        const auto library_linkage = find(library_linkage_name);
+        const auto crt_linkage = find(crt_linkage_name);
+        const auto is_native = find(is_native_name);
+        const auto equals = [](const std::string* value, StringLiteral expected) {
+            return value && *value == expected;
+        };
+
+        const auto set = [&](Identifier id, bool value) {
+            if (value)
+            {
+                resolved.identifiers |= identifier_bit(id);
+            }
+        };
+
+        set(Identifier::x64, equals(architecture, "x64"));
+        set(Identifier::x86, equals(architecture, "x86"));
+        // For backwards compatability arm is also true for arm64.
+        // This is because it previously was only checking for a substring.
+        set(Identifier::arm, equals(architecture, "arm") || equals(architecture, "arm64"));
+        set(Identifier::arm32, equals(architecture, "arm"));
+        set(Identifier::arm64, equals(architecture, "arm64"));
+        set(Identifier::arm64ec, equals(architecture, "arm64ec"));
+        set(Identifier::wasm32, equals(architecture, "wasm32"));
+        set(Identifier::mips64, equals(architecture, "mips64"));
+        set(Identifier::windows,
+            equals(system_name, "") || equals(system_name, "WindowsStore") || equals(system_name, "MinGW"));
+        set(Identifier::mingw, equals(system_name, "MinGW"));
+        set(Identifier::linux, equals(system_name, "Linux"));
+        set(Identifier::freebsd, equals(system_name, "FreeBSD"));
+        set(Identifier::openbsd, equals(system_name, "OpenBSD"));
+        set(Identifier::osx, equals(system_name, "Darwin"));
+        set(Identifier::uwp, equals(system_name, "WindowsStore"));
+        set(Identifier::xbox, xbox_console_target && !xbox_console_target->empty());
+        set(Identifier::android, equals(system_name, "Android"));
+        set(Identifier::emscripten, equals(system_name, "Emscripten"));
+        set(Identifier::ios, equals(system_name, "iOS"));
+        set(Identifier::qnx, equals(system_name, "QNX"));
+        set(Identifier::vxworks, equals(system_name, "VxWorks"));
+        set(Identifier::static_link, equals(library_linkage, "static"));
+        set(Identifier::static_crt, equals(crt_linkage, "static"));
+        set(Identifier::native, equals(is_native, "1"));
+        resolved.has_native = is_native != nullptr;
+
+        const auto override_vars = find(override_vars_name);
+        if (!override_vars)
         {
-            return true; // empty expression is always true
+            return resolved;
         }
 
-        std::map<std::string, bool> override_ctxt;
+        uint32_t overridden = 0;
+        for (auto& override_id : Strings::split(*override_vars, ';'))
         {
-            auto override_vars = context.find("VCPKG_DEP_INFO_OVERRIDE_VARS");
-            if (override_vars != context.end())
+            if (override_id.empty())
             {
-                auto cmake_list = Strings::split(override_vars->second, ';');
-                for (auto& override_id : cmake_list)
-                {
-                    if (!override_id.empty())
-                    {
-                        if (override_id[0] == '!')
-                        {
-                            override_ctxt.emplace(override_id.substr(1), false);
-                        }
-                        else
-                        {
-                            override_ctxt.emplace(override_id, true);
-                        }
-                    }
-                }
+                continue;
             }
-        }
 
-        struct Visitor
-        {
-            const Context& context;
-            const std::map<std::string, bool>& override_ctxt;
+            const bool value = override_id[0] != '!';
+            if (!value)
+            {
+                override_id.erase(0, 1);
+            }
 
-            bool true_if_exists_and_nonempty(const std::string& variable_name) const
+            // the first override of an identifier wins
+            auto id = string2identifier(override_id);
+            if (id == Identifier::invalid)
             {
-                auto iter = context.find(variable_name);
-                if (iter == context.end())
+                if (!Util::any_of(resolved.other_overrides, [&](auto&& other) { return other.first == override_id; }))
                 {
-                    return false;
+                    resolved.other_overrides.emplace_back(std::move(override_id), value);
                 }
-
-                return !iter->second.empty();
             }
-
-            bool true_if_exists_and_equal(const std::string& variable_name, const std::string& value) const
+            else if (!(overridden & identifier_bit(id)))
             {
-                auto iter = context.find(variable_name);
-                if (iter == context.end())
+                overridden |= identifier_bit(id);
+                if (value)
+                {
+                    resolved.identifiers |= identifier_bit(id);
+                }
+                else
                 {
-                    return false;
+                    resolved.identifiers &= ~identifier_bit(id);
                 }
-                return iter->second == value;
+
+                resolved.has_native |= id == Identifier::native;
             }
+        }
+
+        return resolved;
+    }
+
+    bool Expr::evaluate(const Context& context) const
+    {
+        if (!this->underlying_)
+        {
+            return true; // empty expression is always true
+        }
+
+        return evaluate(resolve_context(context));
+    }
+
+    bool Expr::evaluate(const ResolvedContext& context) const
+    {
+        if (!this->underlying_)
+        {
+            return true; // empty expression is always true
+        }
 
-            bool visit(const ExprImpl& expr) const
+        struct Evaluator
+        {
+            const Program& program;
+            const ResolvedContext& context;
+            std::size_t next;
+
+            bool evaluate_next()
             {
-                if (expr.kind == ExprKind::identifier)
+                const auto& instruction = program.instructions[next++];
+                switch (instruction.op)
                 {
-                    if (!override_ctxt.empty())
-                    {
-                        auto override_id = override_ctxt.find(expr.identifier);
-                        if (override_id != override_ctxt.end())
+                    case OpCode::identifier:
+                        if (instruction.operand == static_cast<uint32_t>(Identifier::native) && !context.has_native)
                         {
-                            return override_id->second;
+                            Checks::unreachable(VCPKG_LINE_INFO);
                         }
-                        // Fall through to use the cmake logic if the id does not have an override
-                    }
 
-                    auto id = string2identifier(expr.identifier);
-                    switch (id)
+                        return (context.identifiers >> instruction.operand) & 1;
+                    case OpCode::other_identifier:
                     {
-                        case Identifier::invalid:
-                            // Point out in the diagnostic that they should add to the override list because that is
-                            // what most users should do, however it is also valid to update the built in identifiers to
-                            // recognize the name.
-                            msg::println_warning(msgUnrecognizedIdentifier, msg::value = expr.identifier);
-                            return false;
-                        case Identifier::x64: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "x64");
-                        case Identifier::x86: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "x86");
-                        case Identifier::arm:
-                            // For backwards compatability arm is also true for arm64.
-                            // This is because it previously was only checking for a substring.
-                            return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm") ||
-                                   true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm64");
-                        case Identifier::arm32: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm");
-                        case Identifier::arm64: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm64");
-                        case Identifier::arm64ec:
-                            return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm64ec");
-                        case Identifier::windows:
-                            return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "") ||
-                                   true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "WindowsStore") ||
-                                   true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "MinGW");
-                        case Identifier::mingw: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "MinGW");
-                        case Identifier::linux: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "Linux");
-                        case Identifier::freebsd: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "FreeBSD");
-                        case Identifier::openbsd: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "OpenBSD");
-                        case Identifier::osx: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "Darwin");
-                        case Identifier::uwp:
-                            return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "WindowsStore");
-                        case Identifier::xbox: return true_if_exists_and_nonempty("VCPKG_XBOX_CONSOLE_TARGET");
-                        case Identifier::android: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "Android");
-                        case Identifier::emscripten:
-                            return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "Emscripten");
-                        case Identifier::ios: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "iOS");
-                        case Identifier::qnx: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "QNX");
-                        case Identifier::vxworks: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "VxWorks");
-                        case Identifier::wasm32: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "wasm32");
-                        case Identifier::mips64: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "mips64");
-                        case Identifier::static_link:
-                            return true_if_exists_and_equal("VCPKG_LIBRARY_LINKAGE", "static");
-                        case Identifier::static_crt: return true_if_exists_and_equal("VCPKG_CRT_LINKAGE", "static");
-                        case Identifier::native:
+                        const auto& name = program.other_identifiers[instruction.operand];
+                        for (auto&& other_override : context.other_overrides)
                         {
-                            auto is_native = context.find("Z_VCPKG_IS_NATIVE");
-                            if (is_native == context.end())
+                            if (other_override.first == name)
                             {
-                                Checks::unreachable(VCPKG_LINE_INFO);
+                                return other_override.second;
                             }
-
-                            return is_native->second == "1";
                         }
-                    }
-                    Checks::unreachable(VCPKG_LINE_INFO);
-                }
-                else if (expr.kind == ExprKind::op_not)
-                {
-                    return !visit(*expr.exprs.at(0));
-                }
-                else if (expr.kind == ExprKind::op_and)
-                {
-                    bool valid = true;
 
-                    // we want to print errors in all expressions, so we check all of the expressions all the time
-                    for (const auto& e : expr.exprs)
-                    {
-                        valid &= visit(*e);
+                        // Point out in the diagnostic that they should add to the override list because that is
+                        // what most users should do, however it is also valid to update the built in identifiers to
+                        // recognize the name.
+                        msg::println_warning(msgUnrecognizedIdentifier, msg::value = name);
+                        return false;
                     }
+                    case OpCode::op_not: return !evaluate_next();
+                    case OpCode::op_and:
+                    {
+                        bool valid = true;
 
-                    return valid;
-                }
-                else if ((expr.kind == ExprKind::op_or) || (expr.kind == ExprKind::op_list))
-                {
-                    bool valid = false;
+                        // we want to print errors in all expressions, so we check all of the expressions all the time
+                        for (uint32_t idx = 0; idx < instruction.operand; ++idx)
+                        {
+                            valid &= evaluate_next();
+                        }
 
-                    // we want to print errors in all expressions, so we check all of the expressions all the time
-                    for (const auto& e : expr.exprs)
-                    {
-                        valid |= visit(*e);
+                        return valid;
                     }
+                    case OpCode::op_or:
+                    {
+                        bool valid = false;
 
-                    return valid;
-                }
-                else
-                {
-                    Checks::unreachable(VCPKG_LINE_INFO);
+                        // we want to print errors in all expressions, so we check all of the expressions all the time
+                        for (uint32_t idx = 0; idx < instruction.operand; ++idx)
+                        {
+                            valid |= evaluate_next();
+                        }
+
+                        return valid;
+                    }
+                    case OpCode::op_invalid:
+                    default: Checks::unreachable(VCPKG_LINE_INFO);
                 }
             }
         };
 
-        return Visitor{context, override_ctxt}.visit(*this->underlying_);
+        return Evaluator{*this->underlying_->program, context, 0}.evaluate_next();
     }
 
     int Expr::complexity() const
@@ -1,7 +1,9 @@
 #include <vcpkg/base/cache.h>
 #include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/message_sinks.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/util.h>
 
@@ -13,6 +15,7 @@
 
 #include <functional>
 #include <map>
+#include <set>
 
 using namespace vcpkg;
 
@@ -59,7 +62,7 @@ namespace vcpkg
             }
 
             auto maybe_scfl =
-                Paragraphs::try_load_port(fs, PortLocation{m_directory, no_assertion, PortSourceKind::Overlay})
+                Paragraphs::try_load_port(fs, PortLocation{m_directory, no_assertion, PortSourceKind::Overlay}, nullptr)
                     .maybe_scfl;
             if (auto scfl = maybe_scfl.get())
             {
@@ -107,11 +110,11 @@ namespace vcpkg
         return &this_overlay.second;
     }
 
-    OverlayPortIndexEntry::MapT::iterator OverlayPortIndexEntry::try_load_port_subdirectory_uncached(
-        MapT::iterator hint, const ReadOnlyFilesystem& fs, StringView port_name)
+    Optional<ExpectedL<SourceControlFileAndLocation>> OverlayPortIndexEntry::load_port_subdirectory(
+        const ReadOnlyFilesystem& fs, StringView port_name) const
     {
         auto load_result = Paragraphs::try_load_port(
-            fs, get_try_load_port_subdirectory_uncached_location(m_kind, m_directory, port_name));
+            fs, get_try_load_port_subdirectory_uncached_location(m_kind, m_directory, port_name), nullptr);
         auto& maybe_scfl = load_result.maybe_scfl;
         if (auto scfl = maybe_scfl.get())
         {
@@ -129,11 +132,23 @@ namespace vcpkg
             }
             else
             {
-                return m_loaded_ports.end();
+                return nullopt;
             }
         }
 
-        return m_loaded_ports.emplace_hint(hint, port_name.to_string(), std::move(maybe_scfl));
+        return std::move(maybe_scfl);
+    }
+
+    OverlayPortIndexEntry::MapT::iterator OverlayPortIndexEntry::try_load_port_subdirectory_uncached(
+        MapT::iterator hint, const ReadOnlyFilesystem& fs, StringView port_name)
+    {
+        auto maybe_loaded = load_port_subdirectory(fs, port_name);
+        if (auto loaded = maybe_loaded.get())
+        {
+            return m_loaded_ports.emplace_hint(hint, port_name.to_string(), std::move(*loaded));
+        }
+
+        return m_loaded_ports.end();
     }
 
     const ExpectedL<SourceControlFileAndLocation>* OverlayPortIndexEntry::try_load_port_subdirectory_with_cache(
@@ -204,49 +219,66 @@ namespace vcpkg
                 auto maybe_subdirectories = fs.try_get_directories_non_recursive(m_directory);
                 if (auto subdirectories = maybe_subdirectories.get())
                 {
-                    std::vector<LocalizedString> errors;
                     Util::sort(*subdirectories);
-                    auto first_loaded = m_loaded_ports.begin();
-                    const auto last_loaded = m_loaded_ports.end();
-                    auto first_out = out.begin();
-                    const auto last_out = out.end();
+                    std::vector<std::string> port_names;
+                    port_names.reserve(subdirectories->size());
+                    std::vector<std::string> uncached_port_names;
                     for (const auto& full_subdirectory : *subdirectories)
                     {
-                        auto subdirectory = full_subdirectory.filename();
-                        while (first_out != last_out && first_out->first < subdirectory)
+                        auto subdirectory = full_subdirectory.filename().to_string();
+                        if (out.find(subdirectory) != out.end())
                         {
-                            ++first_out;
+                            // this subdirectory is already in the output; we shouldn't replace or attempt to load it
+                            continue;
                         }
 
-                        if (first_out != last_out && first_out->first == subdirectory)
+                        if (m_loaded_ports.find(subdirectory) == m_loaded_ports.end())
                         {
-                            // this subdirectory is already in the output; we shouldn't replace or attempt to load it
-                            ++first_out;
-                            continue;
+                            uncached_port_names.push_back(subdirectory);
                         }
 
-                        while (first_loaded != last_loaded && first_loaded->first < subdirectory)
+                        port_names.push_back(std::move(subdirectory));
+                    }
+
+                    // parse the uncached subdirectories in parallel, then add them to the cache and print their
+                    // warnings in order
+                    std::vector<Optional<ExpectedL<SourceControlFileAndLocation>>> uncached_ports(
+                        uncached_port_names.size());
+                    std::vector<BufferedMessageSink> warnings(uncached_port_names.size());
+                    execute_in_parallel(uncached_port_names.size(), [&](size_t idx) {
+                        Paragraphs::PortWarningRedirect redirect{warnings[idx]};
+                        uncached_ports[idx] = load_port_subdirectory(fs, uncached_port_names[idx]);
+                    });
+
+                    for (size_t idx = 0; idx < uncached_port_names.size(); ++idx)
+                    {
+                        warnings[idx].print_to(Paragraphs::port_warning_sink());
+                        if (auto loaded = uncached_ports[idx].get())
                         {
-                            ++first_loaded;
+                            m_loaded_ports.emplace(std::move(uncached_port_names[idx]), std::move(*loaded));
                         }
+                    }
 
-                        if (first_loaded == last_loaded || first_loaded->first != subdirectory)
+                    std::vector<LocalizedString> errors;
+                    auto first_out = out.begin();
+                    for (const auto& port_name : port_names)
+                    {
+                        auto loaded = m_loaded_ports.find(port_name);
+                        if (loaded == m_loaded_ports.end())
                         {
-                            // the subdirectory isn't cached, load it into the cache
-                            first_loaded = try_load_port_subdirectory_uncached(first_loaded, fs, subdirectory);
-                        } // else: the subdirectory is already loaded
+                            // the subdirectory doesn't contain a port
+                            continue;
+                        }
 
-                        if (auto this_port = first_loaded->second.get())
+                        if (auto this_port = loaded->second.get())
                         {
-                            first_out = out.emplace_hint(first_out, first_loaded->first, this_port);
+                            first_out = out.emplace_hint(first_out, loaded->first, this_port);
                             ++first_out;
                         }
                         else
                         {
-                            errors.push_back(first_loaded->second.error());
+                            errors.push_back(loaded->second.error());
                         }
-
-                        ++first_loaded;
                     }
 
                     if (errors.empty())
@@ -356,6 +388,8 @@ namespace vcpkg
         return Util::fmap(ports, [](auto&& kvpair) -> const SourceControlFileAndLocation* { return &kvpair.second; });
     }
 
+    void IVersionedPortfileProvider::prefetch(View<VersionSpec>) const { }
+
     PathsPortFileProvider::PathsPortFileProvider(const RegistrySet& registry_set,
                                                  std::unique_ptr<IFullOverlayProvider>&& overlay)
         : m_baseline(make_baseline_provider(registry_set))
@@ -426,39 +460,36 @@ namespace vcpkg
             VersionedPortfileProviderImpl(const VersionedPortfileProviderImpl&) = delete;
             VersionedPortfileProviderImpl& operator=(const VersionedPortfileProviderImpl&) = delete;
 
+            static ExpectedL<std::unique_ptr<RegistryEntry>> load_entry(const RegistryImplementation* reg,
+                                                                        StringView name)
+            {
+                if (reg)
+                {
+                    if (auto entry = reg->get_port_entry(name))
+                    {
+                        return entry;
+                    }
+
+                    return msg::format(msgPortDoesNotExist, msg::package_name = name);
+                }
+
+                return msg::format_error(msgNoRegistryForPort, msg::package_name = name);
+            }
+
             const ExpectedL<std::unique_ptr<RegistryEntry>>& entry(StringView name) const
             {
                 auto entry_it = m_entry_cache.find(name);
                 if (entry_it == m_entry_cache.end())
                 {
-                    if (auto reg = m_registry_set.registry_for_port(name))
-                    {
-                        if (auto entry = reg->get_port_entry(name))
-                        {
-                            entry_it = m_entry_cache.emplace(name.to_string(), std::move(entry)).first;
-                        }
-                        else
-                        {
-                            entry_it = m_entry_cache
-                                           .emplace(name.to_string(),
-                                                    msg::format(msgPortDoesNotExist, msg::package_name = name))
-                                           .first;
-                        }
-                    }
-                    else
-                    {
-                        entry_it = m_entry_cache
-                                       .emplace(name.to_string(),
-                                                msg::format_error(msgNoRegistryForPort, msg::package_name = name))
-                                       .first;
-                    }
+                    auto loaded = load_entry(m_registry_set.registry_for_port(name), name);
+                    entry_it = m_entry_cache.emplace(name.to_string(), std::move(loaded)).first;
                 }
                 return entry_it->second;
             }
 
-            ExpectedL<SourceControlFileAndLocation> load_control_file(const VersionSpec& version_spec) const
+            static ExpectedL<SourceControlFileAndLocation> load_control_file(
+                const ExpectedL<std::unique_ptr<RegistryEntry>>& maybe_ent, const VersionSpec& version_spec)
             {
-                const auto& maybe_ent = entry(version_spec.port_name);
                 if (auto ent = maybe_ent.get())
                 {
                     if (!ent->get())
@@ -501,13 +532,89 @@ namespace vcpkg
                 auto it = m_control_cache.find(version_spec);
                 if (it == m_control_cache.end())
                 {
-                    it = m_control_cache.emplace(version_spec, load_control_file(version_spec)).first;
+                    it = m_control_cache
+                             .emplace(version_spec, load_control_file(entry(version_spec.port_name), version_spec))
+                             .first;
                 }
 
                 return it->second.map(
                     [](const SourceControlFileAndLocation& x) -> const SourceControlFileAndLocation& { return x; });
             }
 
+            virtual void prefetch(View<VersionSpec> version_specs) const override
+            {
+                std::map<std::string, std::set<Version, VersionMapLess>, std::less<>> versions_by_port;
+                for (auto&& version_spec : version_specs)
+                {
+                    if (m_control_cache.find(version_spec) == m_control_cache.end())
+                    {
+                        versions_by_port[version_spec.port_name].insert(version_spec.version);
+                    }
+                }
+
+                struct PortLoad
+                {
+                    const std::string* port_name;
+                    const std::set<Version, VersionMapLess>* versions;
+                    const RegistryImplementation* registry;
+                    Optional<ExpectedL<std::unique_ptr<RegistryEntry>>> loaded_entry;
+                    std::vector<ExpectedL<SourceControlFileAndLocation>> loaded;
+                };
+
+                std::vector<PortLoad> loads;
+                for (auto&& port : versions_by_port)
+                {
+                    // git registries may fetch and update the shared lockfile, so like try_load_all_registry_ports,
+                    // their ports are left to be loaded on demand
+                    const auto registry = m_registry_set.registry_for_port(port.first);
+                    if (registry && registry->kind() != JsonIdGit)
+                    {
+                        loads.push_back(PortLoad{&port.first, &port.second, registry});
+                    }
+                }
+
+                // Each port is loaded by one thread, which loads its versions in turn; m_entry_cache is only read
+                // until every thread is done. Warnings are printed afterwards, in port order.
+                std::vector<BufferedMessageSink> warnings(loads.size());
+                execute_in_parallel(loads.size(), [&](size_t offset) {
+                    auto& load = loads[offset];
+                    Paragraphs::PortWarningRedirect redirect{warnings[offset]};
+                    const ExpectedL<std::unique_ptr<RegistryEntry>>* maybe_entry;
+                    const auto entry_it = m_entry_cache.find(*load.port_name);
+                    if (entry_it == m_entry_cache.end())
+                    {
+                        maybe_entry = &load.loaded_entry.emplace(load_entry(load.registry, *load.port_name));
+                    }
+                    else
+                    {
+                        maybe_entry = &entry_it->second;
+                    }
+
+                    load.loaded.reserve(load.versions->size());
+                    for (auto&& version : *load.versions)
+                    {
+                        load.loaded.push_back(load_control_file(*maybe_entry, VersionSpec{*load.port_name, version}));
+                    }
+                });
+
+                for (size_t offset = 0; offset < loads.size(); ++offset)
+                {
+                    auto& load = loads[offset];
+                    warnings[offset].print_to(Paragraphs::port_warning_sink());
+                    if (auto loaded_entry = load.loaded_entry.get())
+                    {
+                        m_entry_cache.emplace(*load.port_name, std::move(*loaded_entry));
+                    }
+
+                    auto loaded = load.loaded.begin();
+                    for (auto&& version : *load.versions)
+                    {
+                        m_control_cache.emplace(VersionSpec{*load.port_name, version}, std::move(*loaded));
+                        ++loaded;
+                    }
+                }
+            }
+
             virtual void load_all_control_files(
                 std::map<std::string, const SourceControlFileAndLocation*>& out) const override
             {
@@ -1,4 +1,4 @@
-#include <vcpkg/base/cache.h>
+#include <vcpkg/base/binary-records.h>
 #include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/delayed-init.h>
 #include <vcpkg/base/files.h>
@@ -19,8 +19,10 @@
 #include <vcpkg/versions.h>
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -47,6 +49,29 @@ namespace
 
     using Baseline = std::map<std::string, Version, std::less<>>;
 
+    // A baseline in a baseline.json whose entries are located by one scan of the file's text and only deserialized
+    // when looked up, so that resolving a few ports doesn't cost a parse of every port in the registry. The scan
+    // checks the syntax of the whole file, but an entry that isn't a valid baseline version is only reported when
+    // that port is looked up.
+    struct BaselineIndex
+    {
+        ExpectedL<Optional<Version>> lookup(StringView port_name) const;
+
+        std::string contents;
+        std::string origin;
+        // port name -> offset and size of the text of its entry in `contents`
+        std::map<std::string, std::pair<std::size_t, std::size_t>, std::less<>> entries;
+        // The fully parsed baseline, for the rare files the scan can't index
+        Optional<Baseline> parsed;
+
+    private:
+        ExpectedL<Optional<Version>> parse_entry(StringView port_name, std::size_t offset, std::size_t size) const;
+
+        // port name -> the result of deserializing its entry, so that each entry is deserialized at most once
+        mutable std::map<std::string, ExpectedL<Optional<Version>>, std::less<>> m_looked_up;
+        mutable std::unique_ptr<std::mutex> m_looked_up_mutex = std::make_unique<std::mutex>();
+    };
+
     struct GitRegistry;
 
     struct GitRegistryEntry final : RegistryEntry
@@ -206,7 +231,7 @@ namespace
         DelayedInit<ExpectedL<LockFile::Entry>> m_lock_entry;
         mutable Optional<Path> m_stale_versions_tree;
         DelayedInit<ExpectedL<Path>> m_versions_tree;
-        DelayedInit<ExpectedL<Baseline>> m_baseline;
+        DelayedInit<ExpectedL<BaselineIndex>> m_baseline;
     };
 
     struct BuiltinPortTreeRegistryEntry final : RegistryEntry
@@ -264,7 +289,9 @@ namespace
     struct BuiltinFilesRegistry final : RegistryImplementation
     {
         BuiltinFilesRegistry(const VcpkgPaths& paths)
-            : m_fs(paths.get_filesystem()), m_builtin_ports_directory(paths.builtin_ports_directory())
+            : m_fs(paths.get_filesystem())
+            , m_builtin_ports_directory(paths.builtin_ports_directory())
+            , m_manifest_cache(paths.parsed_manifest_cache())
         {
         }
 
@@ -283,18 +310,27 @@ namespace
         DelayedInit<Baseline> m_baseline;
 
     private:
+        // Safe to call concurrently; each port is loaded once, and different ports are loaded in parallel
         const ExpectedL<SourceControlFileAndLocation>& get_scfl(StringView port_name) const
         {
-            auto path = m_builtin_ports_directory / port_name;
-            return m_scfls.get_lazy(path, [&, this]() {
-                return Paragraphs::try_load_builtin_port_required(m_fs, port_name, m_builtin_ports_directory)
+            const DelayedInit<ExpectedL<SourceControlFileAndLocation>>* scfl;
+            {
+                std::lock_guard<std::mutex> lock(m_scfls_mutex);
+                scfl = &m_scfls[m_builtin_ports_directory / port_name];
+            }
+
+            return scfl->get([&, this]() {
+                return Paragraphs::try_load_builtin_port_required(
+                           m_fs, port_name, m_builtin_ports_directory, &m_manifest_cache)
                     .maybe_scfl;
             });
         }
 
         const ReadOnlyFilesystem& m_fs;
         const Path m_builtin_ports_directory;
-        Cache<Path, ExpectedL<SourceControlFileAndLocation>> m_scfls;
+        const Paragraphs::ParsedManifestCache& m_manifest_cache;
+        mutable std::mutex m_scfls_mutex;
+        mutable std::map<Path, DelayedInit<ExpectedL<SourceControlFileAndLocation>>> m_scfls;
     };
 
     // This registry implementation is a builtin registry with a provided
@@ -321,7 +357,7 @@ namespace
         ~BuiltinGitRegistry() = default;
 
         std::string m_baseline_identifier;
-        DelayedInit<ExpectedL<Baseline>> m_baseline;
+        DelayedInit<ExpectedL<BaselineIndex>> m_baseline;
 
     private:
         std::unique_ptr<BuiltinFilesRegistry> m_files_impl;
@@ -380,7 +416,7 @@ namespace
 
         Path m_path;
         std::string m_baseline_identifier;
-        DelayedInit<ExpectedL<Baseline>> m_baseline;
+        DelayedInit<ExpectedL<BaselineIndex>> m_baseline;
     };
 
     Path relative_path_to_versions(StringView port_name);
@@ -391,6 +427,12 @@ namespace
     ExpectedL<Baseline> load_baseline_versions(const ReadOnlyFilesystem& fs,
                                                const Path& baseline_path,
                                                StringView identifier = {});
+    ExpectedL<BaselineIndex> index_baseline_versions(std::string&& contents,
+                                                     StringView baseline,
+                                                     std::string&& origin);
+    ExpectedL<BaselineIndex> load_baseline_index(const ReadOnlyFilesystem& fs,
+                                                 const Path& baseline_path,
+                                                 StringView identifier = {});
 
     ExpectedL<Unit> load_all_port_names_from_registry_versions(std::vector<std::string>& out,
                                                                const ReadOnlyFilesystem& fs,
@@ -561,8 +603,6 @@ namespace
     ExpectedL<std::unique_ptr<RegistryEntry>> BuiltinGitRegistry::get_port_entry(StringView port_name) const
     {
         const auto& fs = m_paths.get_filesystem();
-
-        auto versions_path = m_paths.builtin_registry_versions / relative_path_to_versions(port_name);
         return load_git_versions_file(fs, m_paths.builtin_registry_versions, port_name)
             .entries.then([this, &port_name](Optional<std::vector<GitVersionDbEntry>>&& maybe_version_entries)
                               -> ExpectedL<std::unique_ptr<RegistryEntry>> {
@@ -579,7 +619,7 @@ namespace
             });
     }
 
-    ExpectedL<Optional<Version>> lookup_in_maybe_baseline(const ExpectedL<Baseline>& maybe_baseline,
+    ExpectedL<Optional<Version>> lookup_in_maybe_baseline(const ExpectedL<BaselineIndex>& maybe_baseline,
                                                           StringView port_name)
     {
         auto baseline = maybe_baseline.get();
@@ -590,20 +630,14 @@ namespace
                 .append(msgWhileLoadingBaselineVersionForPort, msg::package_name = port_name);
         }
 
-        auto it = baseline->find(port_name);
-        if (it != baseline->end())
-        {
-            return it->second;
-        }
-
-        return Optional<Version>();
+        return baseline->lookup(port_name);
     }
 
     ExpectedL<Optional<Version>> BuiltinGitRegistry::get_baseline_version(StringView port_name) const
     {
-        return lookup_in_maybe_baseline(m_baseline.get([this]() -> ExpectedL<Baseline> {
+        return lookup_in_maybe_baseline(m_baseline.get([this]() -> ExpectedL<BaselineIndex> {
             return git_checkout_baseline(m_paths, m_baseline_identifier)
-                .then([&](Path&& path) { return load_baseline_versions(m_paths.get_filesystem(), path); })
+                .then([&](Path&& path) { return load_baseline_index(m_paths.get_filesystem(), path); })
                 .map_error([&](LocalizedString&& error) {
                     return std::move(error).append(msgWhileCheckingOutBaseline,
                                                    msg::commit_sha = m_baseline_identifier);
@@ -636,7 +670,7 @@ namespace
     ExpectedL<Optional<Version>> FilesystemRegistry::get_baseline_version(StringView port_name) const
     {
         return lookup_in_maybe_baseline(m_baseline.get([this]() {
-            return load_baseline_versions(m_fs, m_path / FileVersions / FileBaselineDotJson, m_baseline_identifier);
+            return load_baseline_index(m_fs, m_path / FileVersions / FileBaselineDotJson, m_baseline_identifier);
         }),
                                         port_name);
     }
@@ -730,7 +764,7 @@ namespace
 
     ExpectedL<Optional<Version>> GitRegistry::get_baseline_version(StringView port_name) const
     {
-        return lookup_in_maybe_baseline(m_baseline.get([this, port_name]() -> ExpectedL<Baseline> {
+        return lookup_in_maybe_baseline(m_baseline.get([this, port_name]() -> ExpectedL<BaselineIndex> {
             // We delay baseline validation until here to give better error messages and suggestions
             if (!is_git_sha(m_baseline_identifier))
             {
@@ -798,7 +832,7 @@ namespace
             }
 
             auto contents = maybe_contents.get();
-            return parse_baseline_versions(*contents, JsonIdDefault, path_to_baseline)
+            return index_baseline_versions(std::move(*contents), JsonIdDefault, std::string{path_to_baseline.native()})
                 .map_error([&](LocalizedString&& error) {
                     get_global_metrics_collector().track_define(DefineMetric::RegistriesErrorCouldNotFindBaseline);
                     return msg::format_error(msgErrorWhileFetchingBaseline,
@@ -851,6 +885,72 @@ namespace
         return error_msg;
     }
 
+    // Loads the port in `git_tree` by reading only its vcpkg.json or CONTROL blob, so that exploring historical
+    // versions doesn't check out every tree considered. The port directory of the result is
+    // port_location.port_directory, which `extract` fills the first time it is used.
+    ExpectedL<SourceControlFileAndLocation> try_load_port_from_git_tree(const ReadOnlyFilesystem& fs,
+                                                                        GitObjectReader& reader,
+                                                                        StringView port_name,
+                                                                        StringView git_tree,
+                                                                        PortLocation&& port_location,
+                                                                        std::function<ExpectedL<Path>()>&& extract,
+                                                                        const Paragraphs::ParsedManifestCache& cache)
+    {
+        if (fs.exists(port_location.port_directory, IgnoreErrors{}))
+        {
+            // already extracted by an earlier run
+            return Paragraphs::try_load_port_required(fs, port_name, port_location, &cache).maybe_scfl;
+        }
+
+        // one request for the tree tells whether it has a vcpkg.json, a CONTROL file, or doesn't exist at all
+        BufferedDiagnosticContext bdc{out_sink};
+        auto maybe_entry_names = reader.read_tree_entry_names(bdc, git_tree);
+        const auto entry_names = maybe_entry_names.get();
+        if (!entry_names)
+        {
+            return LocalizedString::from_raw(std::move(bdc).to_string());
+        }
+
+        const bool has_manifest = Util::contains(*entry_names, FileVcpkgDotJson);
+        const bool has_control = Util::contains(*entry_names, FileControl);
+        if (has_manifest && has_control)
+        {
+            return LocalizedString::from_raw(port_location.port_directory)
+                .append_raw(": ")
+                .append_raw(ErrorPrefix)
+                .append(msgManifestConflict2);
+        }
+
+        if (!has_manifest && !has_control)
+        {
+            return LocalizedString::from_raw(port_location.port_directory)
+                .append_raw(": ")
+                .append_raw(ErrorPrefix)
+                .append(msgPortMissingManifest2, msg::package_name = port_name);
+        }
+
+        const StringLiteral control_file_name = has_manifest ? FileVcpkgDotJson : FileControl;
+        auto control_path = port_location.port_directory / control_file_name;
+        auto maybe_contents = reader.read_object(bdc, fmt::format("{}:{}", git_tree, control_file_name));
+        auto contents = maybe_contents.get();
+        if (!contents)
+        {
+            return LocalizedString::from_raw(std::move(bdc).to_string());
+        }
+
+        auto maybe_scf = has_manifest
+                             ? Paragraphs::try_load_port_manifest_text(
+                                   *contents, control_path, Paragraphs::port_warning_sink(), &cache)
+                             : Paragraphs::try_load_control_file_text(*contents, control_path);
+        return std::move(maybe_scf).map([&](std::unique_ptr<SourceControlFile>&& scf) {
+            return SourceControlFileAndLocation{std::move(scf),
+                                                std::move(control_path),
+                                                std::move(port_location.spdx_location),
+                                                port_location.kind,
+                                                std::make_shared<DeferredPortDirectory>(std::move(extract))};
+        });
+    }
+
     // { RegistryEntry
 
     // { BuiltinRegistryEntry::RegistryEntry
@@ -870,21 +970,24 @@ namespace
 
         return m_paths.versions_dot_git_dir()
             .then([&, this](Path&& dot_git) {
-                return m_paths.git_checkout_port(port_name, it->git_tree, dot_git).map_error([](LocalizedString&& err) {
-                    return std::move(err)
-                        .append_raw('\n')
-                        .append_raw(NotePrefix)
-                        .append(msgSeeURL, msg::url = docs::troubleshoot_versioning_url);
-                });
+                return try_load_port_from_git_tree(
+                    m_paths.get_filesystem(),
+                    m_paths.git_object_reader(dot_git),
+                    port_name,
+                    it->git_tree,
+                    PortLocation{m_paths.git_checkout_port_directory(port_name, it->git_tree),
+                                 Paragraphs::builtin_git_tree_spdx_location(it->git_tree),
+                                 PortSourceKind::Builtin},
+                    [&paths = m_paths, port_name = port_name, git_tree = it->git_tree, dot_git]() {
+                        return paths.git_checkout_port(port_name, git_tree, dot_git);
+                    },
+                    m_paths.parsed_manifest_cache());
             })
-            .then([this, &it](Path&& p) -> ExpectedL<SourceControlFileAndLocation> {
-                return Paragraphs::try_load_port_required(
-                           m_paths.get_filesystem(),
-                           port_name,
-                           PortLocation{std::move(p),
-                                        Paragraphs::builtin_git_tree_spdx_location(it->git_tree),
-                                        PortSourceKind::Builtin})
-                    .maybe_scfl;
+            .map_error([](LocalizedString&& err) {
+                return std::move(err)
+                    .append_raw('\n')
+                    .append_raw(NotePrefix)
+                    .append(msgSeeURL, msg::url = docs::troubleshoot_versioning_url);
             });
     }
     // } BuiltinRegistryEntry::RegistryEntry
@@ -903,7 +1006,7 @@ namespace
         }
 
         return Paragraphs::try_load_port_required(
-                   fs, port_name, PortLocation{it->p, no_assertion, PortSourceKind::Filesystem})
+                   fs, port_name, PortLocation{it->p, no_assertion, PortSourceKind::Filesystem}, nullptr)
             .maybe_scfl;
     }
     // } FilesystemRegistryEntry::RegistryEntry
@@ -965,14 +1068,17 @@ namespace
             return format_version_git_entry_missing(port_name, version, last_loaded);
         }
 
-        return parent.m_paths.git_extract_tree_from_remote_registry(it->git_tree)
-            .then([this, &it](Path&& p) -> ExpectedL<SourceControlFileAndLocation> {
-                return Paragraphs::try_load_port_required(
-                           parent.m_paths.get_filesystem(),
-                           port_name,
-                           PortLocation{p, fmt::format("git+{}@{}", parent.m_repo, it->git_tree), PortSourceKind::Git})
-                    .maybe_scfl;
-            });
+        const auto& paths = parent.m_paths;
+        return try_load_port_from_git_tree(
+            paths.get_filesystem(),
+            paths.git_object_reader_for_remote_registry(),
+            port_name,
+            it->git_tree,
+            PortLocation{paths.git_tree_directory_from_remote_registry(it->git_tree),
+                         fmt::format("git+{}@{}", parent.m_repo, it->git_tree),
+                         PortSourceKind::Git},
+            [&paths, git_tree = it->git_tree]() { return paths.git_extract_tree_from_remote_registry(git_tree); },
+            paths.parsed_manifest_cache());
     }
 
     // } GitRegistryEntry::RegistryEntry
@@ -1016,8 +1122,48 @@ namespace
         return Path(prefix) / port_name.to_string() + ".json";
     }
 
+    // Reads a baseline file with Json::StreamReader if it is exactly the shape BaselineDeserializer accepts without
+    // errors: an object with only the member `baseline`, all of whose entries are valid. Returns nullopt otherwise,
+    // in which case the file is parsed and deserialized as usual to report the problem.
+    Optional<Baseline> stream_baseline_versions(StringView contents, StringView baseline, StringView origin)
+    {
+        Json::StreamReader reader(contents, origin);
+        StringView key;
+        if (!reader.start_object() || !reader.next_member(key) || key != baseline || !reader.start_object())
+        {
+            return nullopt;
+        }
+
+        Baseline result;
+        std::string port_name;
+        while (reader.next_member(key))
+        {
+            port_name.assign(key.data(), key.size());
+            Version version;
+            if (!stream_baseline_version_tag(reader, version) ||
+                !result.emplace(std::move(port_name), std::move(version)).second)
+            {
+                return nullopt;
+            }
+        }
+
+        if (reader.next_member(key) || !reader.finish())
+        {
+            return nullopt;
+        }
+
+        return result;
+    }
+
     ExpectedL<Baseline> parse_baseline_versions(StringView contents, StringView baseline, StringView origin)
     {
+        auto real_baseline = baseline.size() == 0 ? StringView{JsonIdDefault} : baseline;
+        auto maybe_streamed = stream_baseline_versions(contents, real_baseline, origin);
+        if (auto streamed = maybe_streamed.get())
+        {
+            return std::move(*streamed);
+        }
+
         auto maybe_object = Json::parse_object(contents, origin);
         auto object = maybe_object.get();
         if (!object)
@@ -1025,7 +1171,6 @@ namespace
             return std::move(maybe_object).error();
         }
 
-        auto real_baseline = baseline.size() == 0 ? StringView{JsonIdDefault} : baseline;
         auto baseline_value = object->get(real_baseline);
         if (!baseline_value)
         {
@@ -1058,6 +1203,123 @@ namespace
             return parse_baseline_versions(fc.content, baseline, fc.origin);
         });
     }
+
+    ExpectedL<Optional<Version>> BaselineIndex::lookup(StringView port_name) const
+    {
+        if (auto baseline = parsed.get())
+        {
+            auto it = baseline->find(port_name);
+            if (it != baseline->end())
+            {
+                return it->second;
+            }
+
+            return Optional<Version>();
+        }
+
+        auto it = entries.find(port_name);
+        if (it == entries.end())
+        {
+            return Optional<Version>();
+        }
+
+        std::lock_guard<std::mutex> lock(*m_looked_up_mutex);
+        auto looked_up = m_looked_up.find(port_name);
+        if (looked_up == m_looked_up.end())
+        {
+            looked_up =
+                m_looked_up.emplace(it->first, parse_entry(port_name, it->second.first, it->second.second)).first;
+        }
+
+        return looked_up->second;
+    }
+
+    ExpectedL<Optional<Version>> BaselineIndex::parse_entry(StringView port_name,
+                                                            std::size_t offset,
+                                                            std::size_t size) const
+    {
+        const auto value_text = StringView{contents}.substr(offset, size);
+        Json::StreamReader reader(value_text, origin);
+        Version streamed;
+        if (stream_baseline_version_tag(reader, streamed) && reader.finish())
+        {
+            return Optional<Version>(std::move(streamed));
+        }
+
+        // errors point into the whole file rather than into the entry
+        auto maybe_value = Json::parse(value_text, origin, text_row_col_at(contents, offset));
+        auto value = maybe_value.get();
+        if (!value)
+        {
+            return msg::format_error(msgFailedToParseBaseline, msg::path = origin)
+                .append_raw('\n')
+                .append(maybe_value.error());
+        }
+
+        Json::Reader r(origin);
+        Version version;
+        r.visit_in_key(value->value, port_name, version, baseline_version_tag_deserializer);
+        if (!r.messages().any_errors())
+        {
+            return Optional<Version>(std::move(version));
+        }
+
+        return msg::format_error(msgFailedToParseBaseline, msg::path = origin)
+            .append_raw('\n')
+            .append_raw(r.messages().join());
+    }
+
+    ExpectedL<BaselineIndex> index_baseline_versions(std::string&& contents, StringView baseline, std::string&& origin)
+    {
+        auto real_baseline = baseline.size() == 0 ? StringView{JsonIdDefault} : baseline;
+        auto maybe_members = Json::scan_object_members(contents);
+        if (auto members = maybe_members.get())
+        {
+            auto baseline_member = Util::find_if(
+                *members, [&](const Json::ObjectMemberSpan& member) { return member.key == real_baseline; });
+            if (baseline_member == members->end())
+            {
+                return LocalizedString::from_raw(origin)
+                    .append_raw(": ")
+                    .append_raw(ErrorPrefix)
+                    .append(msgMissingRequiredField,
+                            msg::json_field = baseline,
+                            msg::json_type = msg::format(msgABaselineObject));
+            }
+
+            auto maybe_entries = Json::scan_object_members(baseline_member->value);
+            if (auto entries = maybe_entries.get())
+            {
+                BaselineIndex result;
+                for (auto&& entry : *entries)
+                {
+                    const auto offset = static_cast<std::size_t>(entry.value.data() - contents.data());
+                    result.entries.emplace(std::move(entry.key), std::make_pair(offset, entry.value.size()));
+                }
+
+                result.contents = std::move(contents);
+                result.origin = std::move(origin);
+                return result;
+            }
+        }
+
+        // parse everything, which either explains what is wrong or handles what the scan can't
+        return parse_baseline_versions(contents, baseline, origin).map([&](Baseline&& parsed) {
+            BaselineIndex result;
+            result.origin = std::move(origin);
+            result.parsed = std::move(parsed);
+            return result;
+        });
+    }
+
+    ExpectedL<BaselineIndex> load_baseline_index(const ReadOnlyFilesystem& fs,
+                                                 const Path& baseline_path,
+                                                 StringView baseline)
+    {
+        return fs.try_read_contents(baseline_path).then([&](FileContents&& fc) {
+            return index_baseline_versions(std::move(fc.content), baseline, std::move(fc.origin));
+        });
+    }
 }
 
 namespace vcpkg
@@ -1295,19 +1557,70 @@ namespace vcpkg
 
 namespace
 {
-    ExpectedL<Optional<std::vector<GitVersionDbEntry>>> load_git_versions_file_impl(const ReadOnlyFilesystem& fs,
-                                                                                    const Path& versions_file_path)
+    // Reads a versions file with Json::StreamReader if it is exactly the shape GitVersionDbEntryArrayDeserializer
+    // accepts without errors: only a "versions" array of valid entries. Returns nullopt otherwise, in which case the
+    // file is parsed and deserialized as usual to report the problem.
+    Optional<std::vector<GitVersionDbEntry>> stream_git_versions_file(StringView contents, StringView origin)
     {
-        std::error_code ec;
-        auto contents = fs.read_contents(versions_file_path, ec);
-        if (ec)
+        Json::StreamReader reader(contents, origin);
+        StringView key;
+        if (!reader.start_object() || !reader.next_member(key) || key != JsonIdVersions || !reader.start_array())
         {
-            if (ec == std::errc::no_such_file_or_directory)
+            return nullopt;
+        }
+
+        std::vector<GitVersionDbEntry> db_entries;
+        while (reader.next_element())
+        {
+            if (!reader.start_object())
             {
                 return nullopt;
             }
 
-            return format_filesystem_call_error(ec, "read_contents", {versions_file_path});
+            StreamedSchemedVersion version;
+            Optional<std::string> git_tree;
+            while (reader.next_member(key))
+            {
+                if (version.read_field(reader, key))
+                {
+                    continue;
+                }
+
+                StringView text;
+                if (key != JsonIdGitTree || git_tree || !reader.read_string(text))
+                {
+                    return nullopt;
+                }
+
+                git_tree.emplace(text.data(), text.size());
+            }
+
+            auto maybe_version = version.finish();
+            auto parsed_version = maybe_version.get();
+            auto parsed_git_tree = git_tree.get();
+            if (reader.failed() || !parsed_version || !parsed_git_tree)
+            {
+                return nullopt;
+            }
+
+            db_entries.push_back(GitVersionDbEntry{std::move(*parsed_version), std::move(*parsed_git_tree)});
+        }
+
+        if (reader.next_member(key) || !reader.finish())
+        {
+            return nullopt;
+        }
+
+        return db_entries;
+    }
+
+    ExpectedL<Optional<std::vector<GitVersionDbEntry>>> parse_git_versions_file(StringView contents,
+                                                                                const Path& versions_file_path)
+    {
+        auto maybe_streamed = stream_git_versions_file(contents, versions_file_path);
+        if (auto streamed = maybe_streamed.get())
+        {
+            return std::move(*streamed);
         }
 
         return Json::parse_object(contents, versions_file_path)
@@ -1331,6 +1644,24 @@ namespace
             });
     }
 
+    ExpectedL<Optional<std::vector<GitVersionDbEntry>>> load_git_versions_file_impl(const ReadOnlyFilesystem& fs,
+                                                                                    const Path& versions_file_path)
+    {
+        std::error_code ec;
+        auto contents = fs.read_contents(versions_file_path, ec);
+        if (ec)
+        {
+            if (ec == std::errc::no_such_file_or_directory)
+            {
+                return nullopt;
+            }
+
+            return format_filesystem_call_error(ec, "read_contents", {versions_file_path});
+        }
+
+        return parse_git_versions_file(contents, versions_file_path);
+    }
+
     ExpectedL<Optional<std::vector<FilesystemVersionDbEntry>>> load_filesystem_versions_file_impl(
         const ReadOnlyFilesystem& fs, const Path& versions_file_path, const Path& registry_root)
     {
@@ -1,4 +1,5 @@
 #include <vcpkg/base/api-stable-format.h>
+#include <vcpkg/base/binary-records.h>
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/expected.h>
@@ -1395,6 +1396,42 @@ namespace vcpkg
         return ret;
     }
 
+    DeferredPortDirectory::DeferredPortDirectory(std::function<ExpectedL<Path>()>&& extract)
+        : m_extract(std::move(extract))
+    {
+    }
+
+    ExpectedL<Unit> DeferredPortDirectory::ensure_extracted()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_extract)
+        {
+            auto maybe_extracted = m_extract();
+            if (!maybe_extracted)
+            {
+                return std::move(maybe_extracted).error();
+            }
+
+            m_extract = nullptr;
+        }
+
+        return Unit{};
+    }
+
+    ExpectedL<Path> SourceControlFileAndLocation::extract_port_directory() const
+    {
+        if (deferred_port_directory)
+        {
+            auto maybe_extracted = deferred_port_directory->ensure_extracted();
+            if (!maybe_extracted)
+            {
+                return std::move(maybe_extracted).error();
+            }
+        }
+
+        return port_directory();
+    }
+
     template<class ManifestDeserializerType>
     static ExpectedL<std::unique_ptr<SourceControlFile>> parse_manifest_object_impl(StringView control_path,
                                                                                     const Json::Object& manifest,
@@ -1824,4 +1861,342 @@ namespace vcpkg
 
         return obj;
     }
+
+    namespace
+    {
+        // The binary encoding of a SourceControlFile used by the parsed manifest cache. Platform expressions and
+        // JSON objects are stored as text, and are only written if that text reads back to the same value.
+        struct BinaryScfWriter
+        {
+            BinaryWriter writer;
+            bool exact = true;
+
+            void write_bool(bool value) { writer.write_scalar(static_cast<uint8_t>(value)); }
+
+            void write_strings(const std::vector<std::string>& values)
+            {
+                writer.write_scalar(static_cast<uint32_t>(values.size()));
+                for (auto&& value : values)
+                {
+                    writer.write_string(value);
+                }
+            }
+
+            void write_optional_string(const Optional<std::string>& value)
+            {
+                write_bool(value.has_value());
+                if (auto present = value.get())
+                {
+                    writer.write_string(*present);
+                }
+            }
+
+            void write_version(const Version& version)
+            {
+                writer.write_string(version.text);
+                writer.write_scalar(static_cast<int32_t>(version.port_version));
+            }
+
+            void write_expr(const PlatformExpression::Expr& expr)
+            {
+                auto text = to_string(expr);
+                if (!expr.is_empty())
+                {
+                    auto reparsed = PlatformExpression::parse_platform_expression(
+                        text, PlatformExpression::MultipleBinaryOperators::Allow);
+                    auto maybe_reparsed = reparsed.get();
+                    exact &= maybe_reparsed && structurally_equal(*maybe_reparsed, expr);
+                }
+
+                write_bool(!expr.is_empty());
+                writer.write_string(text);
+            }
+
+            void write_object(const Json::Object& obj)
+            {
+                if (obj.is_empty())
+                {
+                    writer.write_string(StringView{});
+                    return;
+                }
+
+                auto text = Json::stringify(obj, Json::JsonStyle::with_spaces(0));
+                auto reparsed = Json::parse_object(text, "<binary>");
+                auto maybe_reparsed = reparsed.get();
+                exact &= maybe_reparsed && *maybe_reparsed == obj;
+                writer.write_string(text);
+            }
+
+            void write_requested_features(const std::vector<DependencyRequestedFeature>& features)
+            {
+                writer.write_scalar(static_cast<uint32_t>(features.size()));
+                for (auto&& feature : features)
+                {
+                    writer.write_string(feature.name);
+                    write_expr(feature.platform);
+                }
+            }
+
+            void write_dependencies(const std::vector<Dependency>& dependencies)
+            {
+                writer.write_scalar(static_cast<uint32_t>(dependencies.size()));
+                for (auto&& dependency : dependencies)
+                {
+                    writer.write_string(dependency.name);
+                    write_requested_features(dependency.features);
+                    write_expr(dependency.platform);
+                    writer.write_scalar(static_cast<uint8_t>(dependency.constraint.type));
+                    write_version(dependency.constraint.version);
+                    write_bool(dependency.host);
+                    write_bool(dependency.default_features);
+                    write_object(dependency.extra_info);
+                }
+            }
+        };
+
+        struct BinaryScfReader
+        {
+            BinaryReader reader;
+            bool ok = true;
+
+            template<class T>
+            T read_scalar()
+            {
+                T value{};
+                ok = ok && reader.read_scalar(value);
+                return value;
+            }
+
+            bool read_bool() { return read_scalar<uint8_t>() != 0; }
+
+            std::string read_string()
+            {
+                std::string value;
+                ok = ok && reader.read_string(value);
+                return value;
+            }
+
+            // Reads a count of elements, each of which needs at least `min_element_size` more bytes
+            uint32_t read_count(std::size_t min_element_size)
+            {
+                auto count = read_scalar<uint32_t>();
+                if (static_cast<std::size_t>(reader.last - reader.first) / min_element_size < count)
+                {
+                    ok = false;
+                }
+
+                return ok ? count : 0;
+            }
+
+            std::vector<std::string> read_strings()
+            {
+                std::vector<std::string> values;
+                for (auto count = read_count(sizeof(uint32_t)); ok && count != 0; --count)
+                {
+                    values.push_back(read_string());
+                }
+
+                return values;
+            }
+
+            Optional<std::string> read_optional_string()
+            {
+                if (read_bool())
+                {
+                    return read_string();
+                }
+
+                return nullopt;
+            }
+
+            Version read_version()
+            {
+                auto text = read_string();
+                auto port_version = read_scalar<int32_t>();
+                return Version{std::move(text), port_version};
+            }
+
+            PlatformExpression::Expr read_expr()
+            {
+                const bool present = read_bool();
+                auto text = read_string();
+                if (!ok || !present)
+                {
+                    return PlatformExpression::Expr{};
+                }
+
+                auto maybe_expr = PlatformExpression::parse_platform_expression(
+                    text, PlatformExpression::MultipleBinaryOperators::Allow);
+                if (auto expr = maybe_expr.get())
+                {
+                    return std::move(*expr);
+                }
+
+                ok = false;
+                return PlatformExpression::Expr{};
+            }
+
+            Json::Object read_object()
+            {
+                auto text = read_string();
+                if (!ok || text.empty())
+                {
+                    return Json::Object{};
+                }
+
+                auto maybe_obj = Json::parse_object(text, "<binary>");
+                if (auto obj = maybe_obj.get())
+                {
+                    return std::move(*obj);
+                }
+
+                ok = false;
+                return Json::Object{};
+            }
+
+            std::vector<DependencyRequestedFeature> read_requested_features()
+            {
+                std::vector<DependencyRequestedFeature> features;
+                for (auto count = read_count(sizeof(uint32_t)); ok && count != 0; --count)
+                {
+                    auto name = read_string();
+                    features.push_back(DependencyRequestedFeature{std::move(name), read_expr()});
+                }
+
+                return features;
+            }
+
+            std::vector<Dependency> read_dependencies()
+            {
+                std::vector<Dependency> dependencies;
+                for (auto count = read_count(sizeof(uint32_t)); ok && count != 0; --count)
+                {
+                    auto& dependency = dependencies.emplace_back();
+                    dependency.name = read_string();
+                    dependency.features = read_requested_features();
+                    dependency.platform = read_expr();
+                    const auto constraint_type = read_scalar<uint8_t>();
+                    ok = ok && constraint_type <= static_cast<uint8_t>(VersionConstraintKind::Minimum);
+                    dependency.constraint.type = static_cast<VersionConstraintKind>(constraint_type);
+                    dependency.constraint.version = read_version();
+                    dependency.host = read_bool();
+                    dependency.default_features = read_bool();
+                    dependency.extra_info = read_object();
+                }
+
+                return dependencies;
+            }
+        };
+    }
+
+    Optional<std::string> serialize_binary_source_control_file(const SourceControlFile& scf)
+    {
+        BinaryScfWriter out;
+        const auto& core = *scf.core_paragraph;
+        out.writer.write_string(core.name);
+        out.writer.write_scalar(static_cast<uint8_t>(core.version_scheme));
+        out.write_version(core.version);
+        out.write_strings(core.description);
+        out.write_strings(core.summary);
+        out.write_strings(core.maintainers);
+        out.writer.write_string(core.homepage);
+        out.writer.write_string(core.documentation);
+        out.write_dependencies(core.dependencies);
+        out.writer.write_scalar(static_cast<uint32_t>(core.overrides.size()));
+        for (auto&& over : core.overrides)
+        {
+            out.writer.write_string(over.name);
+            out.write_version(over.version);
+            out.write_object(over.extra_info);
+        }
+
+        out.write_requested_features(core.default_features);
+        out.write_optional_string(core.license);
+        out.write_optional_string(core.builtin_baseline);
+        out.write_bool(core.vcpkg_configuration.has_value());
+        if (auto configuration = core.vcpkg_configuration.get())
+        {
+            out.write_object(*configuration);
+        }
+
+        out.write_object(core.contacts);
+        out.write_expr(core.supports_expression);
+        out.write_object(core.extra_info);
+
+        out.writer.write_scalar(static_cast<uint32_t>(scf.feature_paragraphs.size()));
+        for (auto&& feature : scf.feature_paragraphs)
+        {
+            out.writer.write_string(feature->name);
+            out.write_strings(feature->description);
+            out.write_dependencies(feature->dependencies);
+            out.write_expr(feature->supports_expression);
+            out.write_optional_string(feature->license);
+            out.write_object(feature->extra_info);
+        }
+
+        out.write_object(scf.extra_features_info);
+        if (!out.exact)
+        {
+            return nullopt;
+        }
+
+        return std::move(out.writer.buffer);
+    }
+
+    std::unique_ptr<SourceControlFile> deserialize_binary_source_control_file(StringView data)
+    {
+        BinaryScfReader in{BinaryReader{data}};
+        auto scf = std::make_unique<SourceControlFile>();
+        scf->core_paragraph = std::make_unique<SourceParagraph>();
+        auto& core = *scf->core_paragraph;
+        core.name = in.read_string();
+        const auto scheme = in.read_scalar<uint8_t>();
+        in.ok = in.ok && scheme <= static_cast<uint8_t>(VersionScheme::String);
+        core.version_scheme = static_cast<VersionScheme>(scheme);
+        core.version = in.read_version();
+        core.description = in.read_strings();
+        core.summary = in.read_strings();
+        core.maintainers = in.read_strings();
+        core.homepage = in.read_string();
+        core.documentation = in.read_string();
+        core.dependencies = in.read_dependencies();
+        for (auto count = in.read_count(sizeof(uint32_t)); in.ok && count != 0; --count)
+        {
+            auto& over = core.overrides.emplace_back();
+            over.name = in.read_string();
+            over.version = in.read_version();
+            over.extra_info = in.read_object();
+        }
+
+        core.default_features = in.read_requested_features();
+        core.license = in.read_optional_string();
+        core.builtin_baseline = in.read_optional_string();
+        if (in.read_bool())
+        {
+            core.vcpkg_configuration = in.read_object();
+        }
+
+        core.contacts = in.read_object();
+        core.supports_expression = in.read_expr();
+        core.extra_info = in.read_object();
+
+        for (auto count = in.read_count(sizeof(uint32_t)); in.ok && count != 0; --count)
+        {
+            auto& feature = *scf->feature_paragraphs.emplace_back(std::make_unique<FeatureParagraph>());
+            feature.name = in.read_string();
+            feature.description = in.read_strings();
+            feature.dependencies = in.read_dependencies();
+            feature.supports_expression = in.read_expr();
+            feature.license = in.read_optional_string();
+            feature.extra_info = in.read_object();
+        }
+
+        scf->extra_features_info = in.read_object();
+        if (!in.ok || !in.reader.empty())
+        {
+            return nullptr;
+        }
+
+        return scf;
+    }
 }
@@ -22,6 +22,8 @@
 
 #include <fmt/ranges.h>
 
+#include <mutex>
+
 namespace
 {
     using namespace vcpkg;
@@ -750,6 +752,8 @@ namespace vcpkg
         const Path tools;
         const RequireExactVersions abiToolVersionHandling;
 
+        // Guards both caches. Recursive because finding one tool can look up another, such as mono for nuget.
+        mutable std::recursive_mutex m_mtx;
         vcpkg::Cache<std::string, PathAndVersion> path_version_cache;
         vcpkg::Lazy<std::vector<ToolDataEntry>> m_tool_data_cache;
 
@@ -1010,6 +1014,7 @@ namespace vcpkg
 
         const PathAndVersion& get_tool_pathversion(StringView tool, MessageSink& status_sink) const
         {
+            std::lock_guard<std::recursive_mutex> lock(m_mtx);
             return path_version_cache.get_lazy(tool, [&]() -> PathAndVersion {
                 // First deal with specially handled tools.
                 // For these we may look in locations like Program Files, the PATH etc as well as the auto-downloaded
@@ -325,6 +325,7 @@ namespace vcpkg
         args.parser.parse_switch(SwitchIgnoreLockFailures, StabilityTag::Experimental, args.ignore_lock_failures);
         args.parser.parse_switch(
             SwitchAbiToolsUseExactVersions, StabilityTag::Experimental, args.exact_abi_tools_versions);
+        args.parser.parse_switch(SwitchRestoreIntoInstalled, StabilityTag::Experimental, args.restore_into_installed);
 
         args.parser.parse_option(
             SwitchVcpkgRoot,
@@ -370,6 +371,10 @@ namespace vcpkg
                                  StabilityTag::Experimental,
                                  args.asset_sources_template_arg,
                                  msg::format(msgAssetSourcesArg));
+        args.parser.parse_option(SwitchBinarycacheStats,
+                                 StabilityTag::Experimental,
+                                 args.binary_cache_stats_file,
+                                 msg::format(msgBinaryCacheStatsArg));
         {
             std::string raw_cmake_debug;
             if (args.parser.parse_option(SwitchCMakeDebug, StabilityTag::Experimental, raw_cmake_debug))
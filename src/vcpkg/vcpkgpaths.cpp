@@ -27,6 +27,7 @@
 #include <vcpkg/installedpaths.h>
 #include <vcpkg/metrics.h>
 #include <vcpkg/packagespec.h>
+#include <vcpkg/paragraphs.h>
 #include <vcpkg/registries.h>
 #include <vcpkg/sourceparagraph.h>
 #include <vcpkg/tools.h>
@@ -328,6 +329,41 @@ namespace
         return fs.almost_canonical(ret, VCPKG_LINE_INFO);
     }
 
+    // Extracted git trees are shared with other vcpkg roots and processes on this machine through the registries
+    // cache, which evicts the least recently used trees beyond this size. Defaults to 4 GiB; set
+    // X_VCPKG_GIT_TREES_CACHE_MAX_MB to change it.
+    std::uint64_t get_git_trees_cache_max_size()
+    {
+        static std::uint64_t max_size = [] {
+            auto maybe_user_max_mb = get_environment_variable(EnvironmentVariableXVcpkgGitTreesCacheMaxMB);
+            if (auto user_max_mb = maybe_user_max_mb.get())
+            {
+                auto maybe_res = Strings::strto<long long>(*user_max_mb);
+                auto res = maybe_res.get();
+                if (!res)
+                {
+                    Checks::msg_exit_with_message(VCPKG_LINE_INFO,
+                                                  msgOptionMustBeInteger,
+                                                  msg::option = EnvironmentVariableXVcpkgGitTreesCacheMaxMB);
+                }
+
+                if (!(*res > 0))
+                {
+                    Checks::msg_exit_with_message(VCPKG_LINE_INFO,
+                                                  msgEnvInvalidMaxConcurrency,
+                                                  msg::env_var = EnvironmentVariableXVcpkgGitTreesCacheMaxMB,
+                                                  msg::value = *res);
+                }
+
+                return static_cast<std::uint64_t>(*res) * 1024 * 1024;
+            }
+
+            return std::uint64_t{4} * 1024 * 1024 * 1024;
+        }();
+
+        return max_size;
+    }
+
     // This structure holds members that
     // 1. Do not have any inter-member dependencies
     // 2. Are const (and therefore initialized in the initializer list)
@@ -567,6 +603,7 @@ namespace vcpkg
             , m_registries_work_tree_dir(m_registries_cache / "git")
             , m_registries_dot_git_dir(m_registries_cache / "git" / ".git")
             , m_registries_git_trees(m_registries_cache / "git-trees")
+            , m_parsed_manifest_cache(fs, m_registries_cache / "manifest-cache.bin")
             , downloads(compute_downloads_root(fs, args, root, bundle.read_only))
             , tools(downloads / "tools")
             , m_installed(compute_installed(fs, args, root, bundle.read_only, m_manifest_dir))
@@ -647,6 +684,7 @@ namespace vcpkg
         const Path m_registries_work_tree_dir;
         const Path m_registries_dot_git_dir;
         const Path m_registries_git_trees;
+        Paragraphs::ParsedManifestCache m_parsed_manifest_cache;
         const Path downloads;
         const Path tools;
         const Optional<InstalledPaths> m_installed;
@@ -659,6 +697,10 @@ namespace vcpkg
 
         std::unique_ptr<IExclusiveFileLock> file_lock_handle;
 
+        // Keyed by the .git directory the reader reads from
+        std::mutex m_git_object_readers_mutex;
+        std::map<std::string, std::unique_ptr<GitObjectReader>, std::less<>> m_git_object_readers;
+
         Optional<ManifestAndPath> m_manifest_doc;
         ConfigurationAndSource m_config;
     };
@@ -838,6 +880,11 @@ namespace vcpkg
                                         .append(msgSeeURL, msg::url = docs::troubleshoot_build_failures_url));
     }
 
+    const Paragraphs::ParsedManifestCache& VcpkgPaths::parsed_manifest_cache() const
+    {
+        return m_pimpl->m_parsed_manifest_cache;
+    }
+
     Path VcpkgPaths::baselines_output() const { return buildtrees() / "versioning_" / "baselines"; }
     Path VcpkgPaths::versions_output() const { return buildtrees() / "versioning_" / "versions"; }
     bool VcpkgPaths::try_provision_vcpkg_artifacts() const
@@ -917,6 +964,21 @@ namespace vcpkg
         return ret;
     }
 
+    GitObjectReader& VcpkgPaths::git_object_reader(const Path& dot_git_dir) const
+    {
+        // Find git before taking the lock: the first lookup may download it, which shouldn't block readers of other
+        // repositories, and the tool cache does its own locking.
+        const auto& git_exe = get_tool_exe(Tools::GIT, out_sink);
+        std::lock_guard<std::mutex> lock(m_pimpl->m_git_object_readers_mutex);
+        auto& reader = m_pimpl->m_git_object_readers[dot_git_dir.native()];
+        if (!reader)
+        {
+            reader = std::make_unique<GitObjectReader>(git_exe, GitRepoLocatorKind::DotGitDir, dot_git_dir);
+        }
+
+        return *reader;
+    }
+
     ExpectedL<std::string> VcpkgPaths::get_current_git_sha() const
     {
         if (auto sha = m_pimpl->m_bundle.embedded_git_sha.get())
@@ -966,7 +1028,7 @@ namespace vcpkg
          * Because of that, it makes sense to use the git hash as the name for the directory.
          */
         const Filesystem& fs = get_filesystem();
-        auto destination = this->versions_output() / port_name / git_tree;
+        auto destination = git_checkout_port_directory(port_name, git_tree);
         if (fs.exists(destination, IgnoreErrors{}))
         {
             return destination;
@@ -984,13 +1046,21 @@ namespace vcpkg
             .append(msgWhileCheckingOutPortTreeIsh, msg::package_name = port_name, msg::git_tree_sha = git_tree);
     }
 
+    Path VcpkgPaths::git_checkout_port_directory(StringView port_name, StringView git_tree) const
+    {
+        return this->versions_output() / port_name / git_tree;
+    }
+
     ExpectedL<std::string> VcpkgPaths::git_show(StringView treeish, const Path& dot_git_dir) const
     {
-        // All git commands are run with: --git-dir={dot_git_dir} --work-tree={work_tree_temp}
-        // git clone --no-checkout --local {vcpkg_root} {dot_git_dir}
-        return flatten_out(cmd_execute_and_capture_output(
-                               git_cmd_builder(dot_git_dir, dot_git_dir).string_arg("show").string_arg(treeish)),
-                           Tools::GIT);
+        BufferedDiagnosticContext bdc{out_sink};
+        auto maybe_contents = git_object_reader(dot_git_dir).read_object(bdc, treeish);
+        if (auto contents = maybe_contents.get())
+        {
+            return std::move(*contents);
+        }
+
+        return LocalizedString::from_raw(std::move(bdc).to_string());
     }
 
     Optional<std::vector<GitLSTreeEntry>> VcpkgPaths::get_builtin_ports_directory_trees(
@@ -1122,36 +1192,40 @@ namespace vcpkg
     ExpectedL<std::string> VcpkgPaths::git_show_from_remote_registry(StringView hash, const Path& relative_path) const
     {
         auto revision = fmt::format("{}:{}", hash, relative_path.generic_u8string());
-        return flatten_out(cmd_execute_and_capture_output(
-                               git_cmd_builder(m_pimpl->m_registries_dot_git_dir, m_pimpl->m_registries_work_tree_dir)
-                                   .string_arg("show")
-                                   .string_arg(revision)),
-                           Tools::GIT);
+        BufferedDiagnosticContext bdc{out_sink};
+        auto maybe_contents = git_object_reader_for_remote_registry().read_object(bdc, revision);
+        if (auto contents = maybe_contents.get())
+        {
+            return std::move(*contents);
+        }
+
+        return LocalizedString::from_raw(std::move(bdc).to_string());
     }
     ExpectedL<std::string> VcpkgPaths::git_find_object_id_for_remote_registry_path(StringView hash,
                                                                                    const Path& relative_path) const
     {
         auto revision = fmt::format("{}:{}", hash, relative_path.generic_u8string());
-        return flatten_out(cmd_execute_and_capture_output(
-                               git_cmd_builder(m_pimpl->m_registries_dot_git_dir, m_pimpl->m_registries_work_tree_dir)
-                                   .string_arg("rev-parse")
-                                   .string_arg(revision)),
-                           Tools::GIT)
-            .map([](std::string&& output) {
-                Strings::inplace_trim(output);
-                return std::move(output);
-            });
+        BufferedDiagnosticContext bdc{out_sink};
+        auto maybe_object_id = git_object_reader_for_remote_registry().object_id(bdc, revision);
+        if (auto object_id = maybe_object_id.get())
+        {
+            return std::move(*object_id);
+        }
+
+        return LocalizedString::from_raw(std::move(bdc).to_string());
     }
 
     ExpectedL<Unit> VcpkgPaths::git_read_tree(const Path& destination, StringView tree, const Path& dot_git_dir) const
     {
         BufferedDiagnosticContext bdc{out_sink};
-        if (vcpkg::git_extract_tree(bdc,
-                                    get_filesystem(),
-                                    get_tool_exe(Tools::GIT, out_sink),
-                                    GitRepoLocator{GitRepoLocatorKind::DotGitDir, dot_git_dir},
-                                    destination,
-                                    tree))
+        if (vcpkg::git_extract_tree_cached(bdc,
+                                           get_filesystem(),
+                                           get_tool_exe(Tools::GIT, out_sink),
+                                           GitRepoLocator{GitRepoLocatorKind::DotGitDir, dot_git_dir},
+                                           m_pimpl->m_registries_git_trees,
+                                           destination,
+                                           tree,
+                                           get_git_trees_cache_max_size()))
         {
             return Unit{};
         }
@@ -1161,7 +1235,7 @@ namespace vcpkg
 
     ExpectedL<Path> VcpkgPaths::git_extract_tree_from_remote_registry(StringView tree) const
     {
-        auto git_tree_final = m_pimpl->m_registries_git_trees / tree;
+        auto git_tree_final = git_tree_directory_from_remote_registry(tree);
         if (get_filesystem().exists(git_tree_final, IgnoreErrors{}))
         {
             return git_tree_final;
@@ -1176,6 +1250,23 @@ namespace vcpkg
         return std::move(maybe_extraction).error();
     }
 
+    Path VcpkgPaths::git_tree_directory_from_remote_registry(StringView tree) const
+    {
+        if (auto buildtrees_root = m_pimpl->buildtrees.get())
+        {
+            return *buildtrees_root / "versioning_" / "git-trees" / tree;
+        }
+
+        // Not every command has a buildtrees directory, but every one can read registries. This must not be under
+        // m_registries_git_trees, whose entries are evicted by the trees cache.
+        return m_pimpl->m_registries_cache / "extracted-git-trees" / tree;
+    }
+
+    GitObjectReader& VcpkgPaths::git_object_reader_for_remote_registry() const
+    {
+        return git_object_reader(m_pimpl->m_registries_dot_git_dir);
+    }
+
     Optional<const ManifestAndPath&> VcpkgPaths::get_manifest() const
     {
         if (auto p = m_pimpl->m_manifest_doc.get())
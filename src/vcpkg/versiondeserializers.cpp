@@ -4,6 +4,8 @@
 #include <vcpkg/versiondeserializers.h>
 #include <vcpkg/versions.h>
 
+#include <limits>
+
 using namespace vcpkg;
 
 namespace
@@ -196,6 +198,142 @@ namespace vcpkg
         }
     }
 
+    bool StreamedSchemedVersion::read_field(Json::StreamReader& reader, StringView key)
+    {
+        VersionScheme scheme;
+        if (key == JsonIdVersionString)
+        {
+            scheme = VersionScheme::String;
+        }
+        else if (key == JsonIdVersion)
+        {
+            scheme = VersionScheme::Relaxed;
+        }
+        else if (key == JsonIdVersionSemver)
+        {
+            scheme = VersionScheme::Semver;
+        }
+        else if (key == JsonIdVersionDate)
+        {
+            scheme = VersionScheme::Date;
+        }
+        else if (key == JsonIdPortVersion)
+        {
+            int64_t port_version;
+            if (m_port_version || !reader.read_integer(port_version) || port_version < 0 ||
+                port_version > std::numeric_limits<int>::max())
+            {
+                m_invalid = true;
+            }
+            else
+            {
+                m_port_version.emplace(static_cast<int>(port_version));
+            }
+
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+
+        StringView text;
+        // a second versioning field is either a duplicate key or msgExpectedOneVersioningField
+        if (m_scheme || !reader.read_string(text) || text.contains('#'))
+        {
+            m_invalid = true;
+        }
+        else
+        {
+            m_scheme.emplace(scheme);
+            m_text.assign(text.data(), text.size());
+        }
+
+        return true;
+    }
+
+    Optional<SchemedVersion> StreamedSchemedVersion::finish()
+    {
+        Optional<SchemedVersion> result;
+        auto scheme = m_scheme.get();
+        if (m_invalid || !scheme)
+        {
+            return result;
+        }
+
+        switch (*scheme)
+        {
+            case VersionScheme::Relaxed:
+                if (!DotVersion::try_parse_relaxed(m_text))
+                {
+                    return result;
+                }
+                break;
+            case VersionScheme::Semver:
+                if (!DotVersion::try_parse_semver(m_text))
+                {
+                    return result;
+                }
+                break;
+            case VersionScheme::Date:
+                if (!DateVersion::try_parse(m_text))
+                {
+                    return result;
+                }
+                break;
+            default: break;
+        }
+
+        result.emplace(*scheme, std::move(m_text), m_port_version.value_or(0));
+        return result;
+    }
+
+    bool stream_baseline_version_tag(Json::StreamReader& reader, Version& version)
+    {
+        if (!reader.start_object())
+        {
+            return false;
+        }
+
+        bool has_baseline = false;
+        bool has_port_version = false;
+        version.port_version = 0;
+        StringView key;
+        while (reader.next_member(key))
+        {
+            if (key == JsonIdBaseline && !has_baseline)
+            {
+                StringView text;
+                if (!reader.read_string(text) || text.contains('#'))
+                {
+                    return false;
+                }
+
+                version.text.assign(text.data(), text.size());
+                has_baseline = true;
+            }
+            else if (key == JsonIdPortVersion && !has_port_version)
+            {
+                int64_t port_version;
+                if (!reader.read_integer(port_version) || port_version < 0 ||
+                    port_version > std::numeric_limits<int>::max())
+                {
+                    return false;
+                }
+
+                version.port_version = static_cast<int>(port_version);
+                has_port_version = true;
+            }
+            else
+            {
+                // baseline_version_tag_deserializer ignores other fields, but they can be anything
+                return false;
+            }
+        }
+
+        return has_baseline && !reader.failed();
+    }
+
     Version visit_version_override_version(const LocalizedString& parent_type, Json::Reader& r, const Json::Object& obj)
     {
         std::pair<std::string, Optional<int>> proto_version;
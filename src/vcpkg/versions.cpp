@@ -183,7 +183,10 @@ namespace vcpkg
         return nullptr;
     }
 
-    static Optional<DotVersion> try_parse_dot_version(StringView str)
+    // Parses the null terminated `cur` as a semver or relaxed version, appending its dotted numbers to `version` and
+    // pointing `prerelease` at its prerelease identifiers, if any. Returns the end of the dotted numbers, or nullptr if
+    // `cur` is not a valid version.
+    static const char* parse_dot_version(const char* cur, std::vector<uint64_t>& version, StringView& prerelease)
     {
         // Suggested regex by semver.org
         // ^(0|[1-9][0-9]*)\.(0|[1-9][0-9]*)\.(0|[1-9][0-9]*)   (this part replaced here with dotted number parsing)
@@ -191,22 +194,16 @@ namespace vcpkg
         // *[a-zA-Z-][0-9a-zA-Z-]*))*))?
         // (?:\+([0-9a-zA-Z-]+(?:\.[0-9a-zA-Z-]+)*))?$
 
-        DotVersion ret;
-        ret.original_string.assign(str.data(), str.size());
-
         // (0|[1-9][0-9]*)\.(0|[1-9][0-9]*)\.(0|[1-9][0-9]*)
-        int idx = 0;
-        const char* cur = ret.original_string.c_str();
-        for (;; ++idx)
+        for (;;)
         {
-            ret.version.push_back(0);
-            cur = parse_skip_number(cur, ret.version.data() + idx);
+            cur = parse_skip_number(cur, &version.emplace_back(0));
             if (!cur || *cur != '.') break;
             ++cur;
         }
-        if (!cur) return nullopt;
-        ret.version_string.assign(ret.original_string.c_str(), cur);
-        if (*cur == 0) return ret;
+        if (!cur) return nullptr;
+        const char* const end_of_version = cur;
+        if (*cur == 0) return end_of_version;
 
         // pre-release
         if (*cur == '-')
@@ -215,44 +212,60 @@ namespace vcpkg
             const char* const start_of_prerelease = cur;
             for (;;)
             {
-                const auto start_identifier = cur;
                 cur = skip_prerelease_identifier(cur);
                 if (!cur)
                 {
-                    return nullopt;
+                    return nullptr;
                 }
-                ret.identifiers.emplace_back(start_identifier, cur);
                 if (*cur != '.') break;
                 ++cur;
             }
-            ret.prerelease_string.assign(start_of_prerelease, cur);
+            prerelease = StringView{start_of_prerelease, cur};
         }
-        if (*cur == 0) return ret;
+        if (*cur == 0) return end_of_version;
 
         // build
-        if (*cur != '+') return nullopt;
+        if (*cur != '+') return nullptr;
         ++cur;
         for (;;)
         {
             // Require non-empty identifier element
-            if (!ParserBase::is_alphanumdash(*cur)) return nullopt;
+            if (!ParserBase::is_alphanumdash(*cur)) return nullptr;
             ++cur;
             while (ParserBase::is_alphanumdash(*cur))
             {
                 ++cur;
             }
-            if (*cur == 0) return ret;
+            if (*cur == 0) return end_of_version;
             if (*cur == '.')
             {
                 ++cur;
             }
             else
             {
-                return nullopt;
+                return nullptr;
             }
         }
     }
 
+    static Optional<DotVersion> try_parse_dot_version(StringView str)
+    {
+        DotVersion ret;
+        ret.original_string.assign(str.data(), str.size());
+
+        StringView prerelease;
+        const char* const end_of_version = parse_dot_version(ret.original_string.c_str(), ret.version, prerelease);
+        if (!end_of_version) return nullopt;
+        ret.version_string.assign(ret.original_string.c_str(), end_of_version);
+        if (!prerelease.empty())
+        {
+            ret.prerelease_string.assign(prerelease.data(), prerelease.size());
+            ret.identifiers = Strings::split(prerelease, '.');
+        }
+
+        return ret;
+    }
+
     bool operator==(const DotVersion& lhs, const DotVersion& rhs) { return compare(lhs, rhs) == VerComp::eq; }
     bool operator<(const DotVersion& lhs, const DotVersion& rhs) { return compare(lhs, rhs) == VerComp::lt; }
 
@@ -289,7 +302,9 @@ namespace vcpkg
 
     static int uint64_comp(uint64_t a, uint64_t b) { return (a > b) - (a < b); }
 
-    static int semver_id_comp(ZStringView a, ZStringView b)
+    static int char_comp(char a, char b) { return (a > b) - (a < b); }
+
+    static int semver_id_comp(StringView a, StringView b)
     {
         auto maybe_a_num = as_numeric(a);
         auto maybe_b_num = as_numeric(b);
@@ -308,7 +323,36 @@ namespace vcpkg
         }
 
         // both non-numeric -- ascii-betical sorting.
-        return strcmp(a.c_str(), b.c_str());
+        return Util::range_lexcomp(a, b, char_comp);
+    }
+
+    // Compares dot separated prerelease identifiers
+    static int prerelease_comp(StringView a, StringView b)
+    {
+        // having no prerelease is special and sorts after everything else
+        // 1.0.0 > 1.0.0-1
+        if (a.empty() || b.empty())
+        {
+            return a.empty() - b.empty();
+        }
+
+        for (;;)
+        {
+            const auto a_end = std::find(a.begin(), a.end(), '.');
+            const auto b_end = std::find(b.begin(), b.end(), '.');
+            if (auto x = semver_id_comp(StringView{a.begin(), a_end}, StringView{b.begin(), b_end}))
+            {
+                return x;
+            }
+
+            if (a_end == a.end() || b_end == b.end())
+            {
+                return (a_end != a.end()) - (b_end != b.end());
+            }
+
+            a = StringView{a_end + 1, a.end()};
+            b = StringView{b_end + 1, b.end()};
+        }
     }
 
     VerComp compare(const DotVersion& a, const DotVersion& b)
@@ -320,14 +364,7 @@ namespace vcpkg
             return static_cast<VerComp>(x);
         }
 
-        // 'empty' is special and sorts before everything else
-        // 1.0.0 > 1.0.0-1
-        if (a.identifiers.empty() || b.identifiers.empty())
-        {
-            return static_cast<VerComp>(!b.identifiers.empty() - !a.identifiers.empty());
-        }
-
-        return int_to_vercomp(Util::range_lexcomp(a.identifiers, b.identifiers, semver_id_comp));
+        return int_to_vercomp(prerelease_comp(a.prerelease_string, b.prerelease_string));
     }
 
     bool operator==(const DateVersion& lhs, const DateVersion& rhs) { return compare(lhs, rhs) == VerComp::eq; }
@@ -338,6 +375,21 @@ namespace vcpkg
         return msg::format_error(msgVersionInvalidDate, msg::version = version);
     }
 
+    // (\.(0|[1-9][0-9]*))*$
+    static bool parse_date_identifiers(const char* cur, std::vector<uint64_t>& identifiers)
+    {
+        while (*cur == '.')
+        {
+            cur = parse_skip_number(cur + 1, &identifiers.emplace_back(0));
+            if (!cur)
+            {
+                return false;
+            }
+        }
+
+        return *cur == 0;
+    }
+
     ExpectedL<DateVersion> DateVersion::try_parse(StringView version)
     {
         ParsedExternalVersion parsed;
@@ -349,25 +401,75 @@ namespace vcpkg
         DateVersion ret;
         ret.original_string.assign(version.data(), version.size());
         ret.version_string.assign(version.data(), 10);
-        const char* cur = ret.original_string.c_str() + 10;
-        // (\.(0|[1-9][0-9]*))*
-        while (*cur == '.')
+        if (!parse_date_identifiers(ret.original_string.c_str() + 10, ret.identifiers))
         {
-            cur = parse_skip_number(cur + 1, &ret.identifiers.emplace_back(0));
-            if (!cur)
-            {
-                return format_invalid_date_version(version);
-            }
+            return format_invalid_date_version(version);
         }
 
-        if (*cur != 0)
+        return ret;
+    }
+
+    ExpectedL<VersionKey> VersionKey::try_parse(VersionScheme scheme, const Version& version)
+    {
+        VersionKey ret;
+        ret.scheme = scheme;
+        ret.port_version = version.port_version;
+        switch (scheme)
         {
-            return format_invalid_date_version(version);
+            case VersionScheme::Missing: break;
+            case VersionScheme::Relaxed:
+            case VersionScheme::Semver:
+            {
+                StringView prerelease;
+                if (!parse_dot_version(version.text.c_str(), ret.numbers, prerelease))
+                {
+                    if (scheme == VersionScheme::Semver)
+                    {
+                        return msg::format_error(msgVersionInvalidSemver, msg::version = version.text);
+                    }
+
+                    return msg::format_error(msgVersionInvalidRelaxed, msg::version = version.text);
+                }
+
+                if (scheme == VersionScheme::Semver && ret.numbers.size() != 3)
+                {
+                    return msg::format_error(msgVersionInvalidSemver, msg::version = version.text);
+                }
+
+                ret.text.assign(prerelease.data(), prerelease.size());
+                break;
+            }
+            case VersionScheme::Date:
+            {
+                ParsedExternalVersion parsed;
+                if (!try_extract_external_date_version(parsed, version.text))
+                {
+                    return format_invalid_date_version(version.text);
+                }
+
+                const auto date = as_numeric(parsed.major).value_or_exit(VCPKG_LINE_INFO) * 10000 +
+                                  as_numeric(parsed.minor).value_or_exit(VCPKG_LINE_INFO) * 100 +
+                                  as_numeric(parsed.patch).value_or_exit(VCPKG_LINE_INFO);
+                ret.numbers.push_back(date);
+                if (!parse_date_identifiers(version.text.c_str() + 10, ret.numbers))
+                {
+                    return format_invalid_date_version(version.text);
+                }
+
+                break;
+            }
+            case VersionScheme::String: ret.text = version.text; break;
+            default: Checks::unreachable(VCPKG_LINE_INFO);
         }
 
         return ret;
     }
 
+    ExpectedL<VersionKey> VersionKey::try_parse(const SchemedVersion& version)
+    {
+        return try_parse(version.scheme, version.version);
+    }
+
     SchemedVersion::SchemedVersion() noexcept { }
     SchemedVersion::SchemedVersion(VersionScheme scheme, Version&& version) noexcept
         : scheme(scheme), version(std::move(version))
@@ -422,27 +524,15 @@ namespace vcpkg
         return VerComp::eq;
     }
 
-    static VerComp compare_version_texts(VersionScheme sa, const Version& a, VersionScheme sb, const Version& b)
+    static bool is_dot_scheme(VersionScheme scheme)
     {
-        if (sa == VersionScheme::String && sb == VersionScheme::String)
-        {
-            return a.text == b.text ? VerComp::eq : VerComp::unk;
-        }
-
-        if (sa == VersionScheme::Date && sb == VersionScheme::Date)
-        {
-            return compare(DateVersion::try_parse(a.text).value_or_exit(VCPKG_LINE_INFO),
-                           DateVersion::try_parse(b.text).value_or_exit(VCPKG_LINE_INFO));
-        }
-
-        if ((sa == VersionScheme::Semver || sa == VersionScheme::Relaxed) &&
-            (sb == VersionScheme::Semver || sb == VersionScheme::Relaxed))
-        {
-            return compare(DotVersion::try_parse(a.text, sa).value_or_exit(VCPKG_LINE_INFO),
-                           DotVersion::try_parse(b.text, sb).value_or_exit(VCPKG_LINE_INFO));
-        }
+        return scheme == VersionScheme::Semver || scheme == VersionScheme::Relaxed;
+    }
 
-        return VerComp::unk;
+    static bool are_comparable_schemes(VersionScheme sa, VersionScheme sb)
+    {
+        return (sa == sb && (sa == VersionScheme::String || sa == VersionScheme::Date)) ||
+               (is_dot_scheme(sa) && is_dot_scheme(sb));
     }
 
     static VerComp integer_vercomp(int a, int b)
@@ -462,7 +552,13 @@ namespace vcpkg
 
     VerComp compare_versions(VersionScheme sa, const Version& a, VersionScheme sb, const Version& b)
     {
-        return portversion_vercomp(compare_version_texts(sa, a, sb, b), a.port_version, b.port_version);
+        if (!are_comparable_schemes(sa, sb))
+        {
+            return VerComp::unk;
+        }
+
+        return compare(VersionKey::try_parse(sa, a).value_or_exit(VCPKG_LINE_INFO),
+                       VersionKey::try_parse(sb, b).value_or_exit(VCPKG_LINE_INFO));
     }
 
     VerComp compare(const DateVersion& a, const DateVersion& b)
@@ -475,6 +571,27 @@ namespace vcpkg
         return static_cast<VerComp>(Util::range_lexcomp(a.identifiers, b.identifiers, uint64_comp));
     }
 
+    VerComp compare(const VersionKey& a, const VersionKey& b)
+    {
+        if (!are_comparable_schemes(a.scheme, b.scheme))
+        {
+            return VerComp::unk;
+        }
+
+        if (a.scheme == VersionScheme::String)
+        {
+            return portversion_vercomp(a.text == b.text ? VerComp::eq : VerComp::unk, a.port_version, b.port_version);
+        }
+
+        auto x = Util::range_lexcomp(a.numbers, b.numbers, uint64_comp);
+        if (x == 0)
+        {
+            x = prerelease_comp(a.text, b.text);
+        }
+
+        return portversion_vercomp(int_to_vercomp(x), a.port_version, b.port_version);
+    }
+
     VerComp compare_any(const Version& a, const Version& b)
     {
         if (a.text == b.text)
@@ -15,7 +15,7 @@ struct vcpkg::XunitTest
     ElapsedTime time;
     std::chrono::system_clock::time_point start_time;
     std::string abi_tag;
-    std::vector<std::string> features;
+    SharedVector<std::string> features;
 };
 
 namespace
@@ -97,7 +97,7 @@ void XunitWriter::add_test_results(const PackageSpec& spec,
                                    const ElapsedTime& elapsed_time,
                                    const std::chrono::system_clock::time_point& start_time,
                                    const std::string& abi_tag,
-                                   const std::vector<std::string>& features)
+                                   const SharedVector<std::string>& features)
 {
     m_tests[spec.name()].push_back(
         {spec.to_string(),